@@ -0,0 +1,17 @@
+#version 330 core
+
+in vec2 texCoord;
+out vec4 color;
+
+uniform sampler2D tex;
+uniform vec4 spriteColor;
+
+void main()
+{
+	// NOTE(doyle): 0.5 is the glyph edge in the distance field, antialias over
+	// roughly one screen pixel so any font size stays sharp
+	float dist  = texture(tex, texCoord).r;
+	float width = fwidth(dist);
+	float alpha = smoothstep(0.5f - width, 0.5f + width, dist);
+	color = spriteColor * alpha;
+}
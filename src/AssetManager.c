@@ -21,6 +21,8 @@
 #include "Dengine/MemoryArena.h"
 #include "Dengine/OpenGL.h"
 #include "Dengine/Platform.h"
+#include "Dengine/RectPack.h"
+#include "Dengine/TexCompress.h"
 
 enum BytesPerPixel
 {
@@ -35,7 +37,7 @@ INTERNAL GLint getGLFormat(i32 bytesPerPixel, b32 srgb)
 	switch (bytesPerPixel)
 	{
 	case bytesPerPixel_Greyscale:
-		return GL_LUMINANCE;
+		return GL_RED;
 	case bytesPerPixel_GreyscaleAlpha:
 		return GL_LUMINANCE_ALPHA;
 	case bytesPerPixel_RGB:
@@ -73,12 +75,28 @@ Texture textureGen(const GLuint width, const GLuint height,
 	/* Load image into texture */
 	// TODO(doyle) Figure out the gl format
 	tex.imageFormat = getGLFormat(bytesPerPixel, FALSE);
-	ASSERT(tex.imageFormat == GL_RGBA);
+	if (bytesPerPixel == bytesPerPixel_Greyscale)
+	{
+		// NOTE(doyle): Single channel textures are distance fields, they must
+		// be filtered linearly and not bleed into neighbouring atlas cells
+		tex.internalFormat      = GL_R8;
+		tex.wrapS               = GL_CLAMP_TO_EDGE;
+		tex.wrapT               = GL_CLAMP_TO_EDGE;
+		tex.filterMinification  = GL_LINEAR;
+		tex.filterMagnification = GL_LINEAR;
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	}
+	else
+	{
+		ASSERT(tex.imageFormat == GL_RGBA);
+	}
 
 	GL_CHECK_ERROR();
 
+	tex.sizeInBytes = width * height * bytesPerPixel;
 	glTexImage2D(GL_TEXTURE_2D, 0, tex.internalFormat, tex.width, tex.height, 0,
 	             tex.imageFormat, GL_UNSIGNED_BYTE, image);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 	GL_CHECK_ERROR();
 
 	// TODO(doyle): Not needed for sprites? glGenerateMipmap(GL_TEXTURE_2D);
@@ -99,32 +117,132 @@ Texture textureGen(const GLuint width, const GLuint height,
 	return tex;
 }
 
-void asset_init(AssetManager *assetManager, MemoryArena_ *arena)
+/*
+   NOTE(doyle): Upload the mip chain of a texture file built by AssetPacker.
+   Blocks are uploaded as is, if the driver lacks the format each level is
+   decoded on the CPU and uploaded as RGBA instead. Levels blend linearly when
+   minified, texels stay nearest when magnified like other sprites.
+ */
+INTERNAL Texture textureGenCompressed(const TexFileHeader *const header)
 {
-	i32 texAtlasEntries         = 8;
-	assetManager->texAtlas.size = texAtlasEntries;
-	assetManager->texAtlas.entries =
-	    memory_pushBytes(arena, texAtlasEntries * sizeof(HashTableEntry));
+	GL_CHECK_ERROR();
+	Texture tex = {0};
+	tex.width               = header->width;
+	tex.height              = header->height;
+	tex.imageFormat         = GL_RGBA;
+	tex.wrapS               = GL_REPEAT;
+	tex.wrapT               = GL_REPEAT;
+	tex.filterMinification  = GL_LINEAR_MIPMAP_LINEAR;
+	tex.filterMagnification = GL_NEAREST;
 
-	i32 animEntries          = 1024;
-	assetManager->anims.size = animEntries;
-	assetManager->anims.entries =
-	    memory_pushBytes(arena, animEntries * sizeof(HashTableEntry));
+	b32 supported = FALSE;
+	switch (header->format)
+	{
+	case texformat_bc1:
+		tex.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		supported          = GLEW_EXT_texture_compression_s3tc;
+		break;
 
-	i32 texEntries              = 32;
-	assetManager->textures.size = texEntries;
-	assetManager->textures.entries =
-	    memory_pushBytes(arena, texEntries * sizeof(HashTableEntry));
+	case texformat_bc3:
+		tex.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		supported          = GLEW_EXT_texture_compression_s3tc;
+		break;
 
-	/* Create empty 1x1 4bpp black texture */
-	u32 bitmap   = (0xFF << 24) | (0xFF << 16) | (0xFF << 8) | (0xFF << 0);
-	Texture *tex = asset_texGetFreeSlot(assetManager, arena, "nullTex");
-	*tex         = textureGen(1, 1, 4, CAST(u8 *)(&bitmap));
+	case texformat_bc7:
+		tex.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+		supported          = GLEW_ARB_texture_compression_bptc;
+		break;
+
+	default:
+		tex.internalFormat = GL_RGBA;
+		break;
+	}
+
+	enum TexFormat format = CAST(enum TexFormat) header->format;
+	u8 *decoded = NULL;
+	if (!supported)
+	{
+		tex.internalFormat = GL_RGBA;
+		decoded = CAST(u8 *) platform_memoryAlloc(
+		    NULL, texcompress_getSize(texformat_rgba8, tex.width, tex.height));
+	}
+
+	glGenTextures(1, &tex.id);
+	glBindTexture(GL_TEXTURE_2D, tex.id);
+	GL_CHECK_ERROR();
+
+	const u8 *base = CAST(const u8 *) header;
+	for (u32 level = 0; level < header->numMips; level++)
+	{
+		i32 width     = texcompress_getMipDim(tex.width, level);
+		i32 height    = texcompress_getMipDim(tex.height, level);
+		const u8 *mip = base + header->mipOffset[level];
+		if (supported)
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, tex.internalFormat,
+			                       width, height, 0, header->mipSize[level],
+			                       mip);
+			tex.sizeInBytes += header->mipSize[level];
+		}
+		else
+		{
+			texcompress_decode(format, mip, width, height, decoded);
+			glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0,
+			             GL_RGBA, GL_UNSIGNED_BYTE, decoded);
+			tex.sizeInBytes += width * height * 4;
+		}
+	}
+	GL_CHECK_ERROR();
+
+	if (decoded)
+	{
+		platform_memoryFree(
+		    NULL, decoded,
+		    texcompress_getSize(texformat_rgba8, tex.width, tex.height));
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header->numMips - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, tex.wrapS);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tex.wrapT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+	                tex.filterMinification);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+	                tex.filterMagnification);
+	GL_CHECK_ERROR();
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	GL_CHECK_ERROR();
+
+	return tex;
+}
+
+/* Create a texture from an image or texture file in memory */
+INTERNAL i32 textureGenFromFile(const PlatformFileRead *const file,
+                                Texture *const tex)
+{
+	const TexFileHeader *header =
+	    texcompress_getFileHeader(file->buffer, file->size);
+	if (header)
+	{
+		*tex = textureGenCompressed(header);
+		return 0;
+	}
+
+	i32 width, height, bytesPerPixel;
+	stbi_set_flip_vertically_on_load(TRUE);
+	u8 *image =
+	    stbi_load_from_memory(CAST(u8 *) file->buffer, file->size, &width,
+	                          &height, &bytesPerPixel, 0);
+	if (!image)
+	{
+		printf("stbi_load_from_memory() failed: %s\n", stbi_failure_reason());
+		return -1;
+	}
 
-	i32 audioEntries         = 32;
-	assetManager->audio.size = audioEntries;
-	assetManager->audio.entries =
-	    memory_pushBytes(arena, audioEntries * sizeof(HashTableEntry));
+	*tex = textureGen(CAST(GLuint) width, CAST(GLuint) height,
+	                  CAST(GLint) bytesPerPixel, image);
+	stbi_image_free(image);
+	return 0;
 }
 
 /*
@@ -132,53 +250,279 @@ void asset_init(AssetManager *assetManager, MemoryArena_ *arena)
  * Hash Table Operations
  *********************************
  */
+INTERNAL void hashTableInit(HashTable *const table, MemoryArena_ *const arena,
+                            const i32 numEntries)
+{
+	/* Round up to a power of two that keeps us under the max load */
+	i32 minSize = (numEntries * 100) / HASH_TABLE_MAX_LOAD_PERCENT + 1;
+	i32 size    = 1;
+	while (size < minSize)
+		size <<= 1;
+
+	table->size    = size;
+	table->count   = 0;
+	table->entries = MEMORY_PUSH_ARRAY(arena, size, HashTableEntry);
+	common_memset(CAST(u8 *) table->entries, 0, size * sizeof(HashTableEntry));
+}
+
+INTERNAL b32 hashTableIsFull(const HashTable *const table)
+{
+	b32 result =
+	    (table->count + 1 > (table->size * HASH_TABLE_MAX_LOAD_PERCENT) / 100);
+	return result;
+}
+
 INTERNAL HashTableEntry *const getFreeHashSlot(HashTable *const table,
                                                MemoryArena_ *const arena,
                                                const char *const key)
 {
-	u32 hashIndex = common_getHashIndex(key, table->size);
-	HashTableEntry *result = &table->entries[hashIndex];
-	if (result->key)
+	if (hashTableIsFull(table))
+	{
+		DEBUG_LOG("getFreeHashSlot() failed: Hash table is full");
+		return NULL;
+	}
+
+	HashTableEntry toInsert = {0};
+	toInsert.keyLen         = common_strlen(key);
+	toInsert.hash = common_murmurHash64A(key, toInsert.keyLen, RANDOM_SEED);
+
+	// +1 Null terminator
+	toInsert.key = memory_pushBytes(arena, (toInsert.keyLen + 1) * sizeof(char));
+	common_strncpy(toInsert.key, key, toInsert.keyLen + 1);
+
+	/*
+	   NOTE(doyle): Robin hood insertion, if the entry we're probing is closer
+	   to its ideal slot than the one we're inserting, the new entry takes the
+	   slot and we continue inserting the displaced entry. This bounds the
+	   variance of probe lengths so lookups can stop early on a miss.
+	 */
+	HashTableEntry *result = NULL;
+	u32 mask               = table->size - 1;
+	u32 index              = CAST(u32)(toInsert.hash & mask);
+	for (;;)
 	{
-		while (result->next)
+		HashTableEntry *entry = &table->entries[index];
+		if (!entry->key)
 		{
-			if (common_strcmp(result->key, key) == 0)
-			{
-				// TODO(doyle): Error hash item already exists
-				ASSERT(INVALID_CODE_PATH);
-			}
-			result = result->next;
+			*entry = toInsert;
+			if (!result) result = entry;
+			break;
+		}
+
+#ifdef DENGINE_DEBUG
+		if (!result && entry->hash == toInsert.hash &&
+		    common_strcmp(entry->key, key) == 0)
+		{
+			// TODO(doyle): Error hash item already exists
+			ASSERT(INVALID_CODE_PATH);
 		}
+#endif
 
-		result->next = MEMORY_PUSH_STRUCT(arena, HashTableEntry);
-		result       = result->next;
+		if (entry->probeDist < toInsert.probeDist)
+		{
+			HashTableEntry displaced = *entry;
+			*entry                   = toInsert;
+			toInsert                 = displaced;
+
+			if (!result) result = entry;
+		}
 
+		toInsert.probeDist++;
+		index = (index + 1) & mask;
 	}
 
-	/* Check if platform_mem_alloc failed(), otherwise always true if hash table
-	 * entries initialised, assign key to hash entry */
-	if (result)
+	table->count++;
+	return result;
+}
+
+/* If key is NULL, entries are matched by their 64 bit hash only */
+INTERNAL HashTableEntry *const getEntryFromHash(HashTable *const table,
+                                                const u64 hash,
+                                                const char *const key)
+{
+	if (table->size == 0) return NULL;
+
+	u32 mask  = table->size - 1;
+	u32 index = CAST(u32)(hash & mask);
+	for (i32 probeDist = 0; probeDist < table->size; probeDist++)
 	{
-		// +1 Null terminator
-		i32 keyLen  = common_strlen(key) + 1;
-		result->key = memory_pushBytes(arena, keyLen * sizeof(char));
-		common_strncpy(result->key, key, keyLen);
+		HashTableEntry *entry = &table->entries[index];
+
+		// NOTE(doyle): Any entry we would have displaced on insertion means
+		// the key is not in the table
+		if (!entry->key || entry->probeDist < probeDist) break;
+
+		if (entry->hash == hash)
+		{
+			if (!key || common_strcmp(entry->key, key) == 0) return entry;
+		}
+
+		index = (index + 1) & mask;
 	}
 
+	return NULL;
+}
+
+INTERNAL HashTableEntry *const getEntryFromKey(HashTable *const table,
+                                               const char *const key)
+{
+	// NOTE(doyle): Counted so we can see string lookups creeping back into
+	// the frame, game code should use the compile time asset ids
+	debug_countIncrement(debugcount_assetStringLookup);
+	HashTableEntry *result = getEntryFromHash(table, asset_keyHash(key), key);
 	return result;
 }
 
-INTERNAL HashTableEntry *const getEntryFromHash(HashTable *const table,
-                                          const char *const key)
+u64 asset_keyHash(const char *const key)
+{
+	u64 result = common_murmurHash64A(key, common_strlen(key), RANDOM_SEED);
+	return result;
+}
+
+void asset_init(AssetManager *assetManager, MemoryArena_ *arena)
+{
+	hashTableInit(&assetManager->texAtlas, arena, 8);
+	hashTableInit(&assetManager->anims, arena, 1024);
+	hashTableInit(&assetManager->textures, arena, 32);
+
+	/* Create empty 1x1 4bpp black texture */
+	u32 bitmap   = (0xFF << 24) | (0xFF << 16) | (0xFF << 8) | (0xFF << 0);
+	Texture *tex = MEMORY_PUSH_STRUCT(arena, Texture);
+	*tex         = textureGen(1, 1, 4, CAST(u8 *)(&bitmap));
+	assetManager->texList[texlist_null]       = tex;
+	assetManager->texListRegion[texlist_null] = CAST(Rect){V2(0, 0), V2(1, 1)};
+
+	hashTableInit(&assetManager->audio, arena, 32);
+
+	/* Placeholders, an empty font has no glyphs so renders nothing */
+	assetManager->emptyFontAtlas.tex = tex;
+	assetManager->emptyFont.atlas    = &assetManager->emptyFontAtlas;
+
+	assetManager->texResidency.budgetInBytes = ASSET_TEX_BUDGET_DEFAULT;
+}
+
+/*
+ *********************************
+ * Asset Pack Operations
+ *********************************
+ */
+i32 asset_packOpen(AssetManager *const assetManager, const char *const path)
+{
+	PlatformFileMap map = {0};
+	if (platform_mapFile(path, &map)) return -1;
+
+	/*
+	   Validate the header and table of contents before trusting offsets.
+	   Ends are summed in 64 bits, a crafted offset and size summed in 32 bits
+	   could wrap around to pass. Names and data are followed by a null
+	   terminator so must end before the end of the pack.
+	 */
+	AssetPackHeader *header = CAST(AssetPackHeader *) map.base;
+	u64 packSize            = CAST(u64) map.size;
+	b32 valid = (map.size >= CAST(i32) sizeof(AssetPackHeader));
+	if (valid)
+	{
+		u64 entryEnd = CAST(u64) header->entryOffset +
+		               (CAST(u64) header->numEntries * sizeof(AssetPackEntry));
+		valid = (header->magic == ASSET_PACK_MAGIC &&
+		         header->version == ASSET_PACK_VERSION &&
+		         CAST(u64) header->packSize == packSize &&
+		         entryEnd <= packSize);
+	}
+
+	AssetPackEntry *entries = NULL;
+	if (valid)
+	{
+		entries = CAST(AssetPackEntry *)(CAST(u8 *) map.base +
+		                                   header->entryOffset);
+		for (u32 i = 0; i < header->numEntries && valid; i++)
+		{
+			AssetPackEntry *entry = &entries[i];
+			u64 nameEnd = CAST(u64) entry->nameOffset + entry->nameLen;
+			u64 dataEnd = CAST(u64) entry->dataOffset + entry->dataSize;
+			valid       = (nameEnd < packSize && dataEnd < packSize);
+		}
+	}
+
+	if (!valid)
+	{
+		DEBUG_LOG("asset_packOpen() failed: Invalid or outdated asset pack");
+		platform_unmapFile(&map);
+		return -1;
+	}
+
+	asset_packClose(assetManager);
+	assetManager->packMap     = map;
+	assetManager->pack        = header;
+	assetManager->packEntries = entries;
+	return 0;
+}
+
+void asset_packClose(AssetManager *const assetManager)
+{
+	if (!assetManager->pack) return;
+
+	platform_unmapFile(&assetManager->packMap);
+	assetManager->pack        = NULL;
+	assetManager->packEntries = NULL;
+}
+
+b32 asset_packGetFile(AssetManager *const assetManager,
+                      const char *const path, PlatformFileRead *const file)
 {
-	u32 hashIndex = common_getHashIndex(key, table->size);
-	HashTableEntry *result = &table->entries[hashIndex];
-	if (result->key)
+	AssetPackHeader *header = assetManager->pack;
+	if (!header) return FALSE;
+
+	u8 *base = CAST(u8 *) assetManager->packMap.base;
+	u64 hash = asset_keyHash(path);
+
+	/* Binary search for the first entry with the hash */
+	AssetPackEntry *entries = assetManager->packEntries;
+	i32 low  = 0;
+	i32 high = header->numEntries;
+	while (low < high)
+	{
+		i32 mid = low + ((high - low) / 2);
+		if (entries[mid].hash < hash) low = mid + 1;
+		else high = mid;
+	}
+
+	for (i32 i = low; i < CAST(i32) header->numEntries; i++)
 	{
-		while (result && common_strcmp(result->key, key) != 0)
-			result = result->next;
+		AssetPackEntry *entry = &entries[i];
+		if (entry->hash != hash) break;
+
+		char *name = CAST(char *)(base + entry->nameOffset);
+		if (common_strcmp(name, path) == 0)
+		{
+			file->buffer = base + entry->dataOffset;
+			file->size   = entry->dataSize;
+			return TRUE;
+		}
 	}
 
+	return FALSE;
+}
+
+/* Read from the asset pack if one is open, otherwise from disk into arena */
+INTERNAL i32 assetReadFile(AssetManager *const assetManager,
+                           MemoryArena_ *const arena, const char *const path,
+                           PlatformFileRead *const file)
+{
+	if (!assetManager->hotReload.reading &&
+	    asset_packGetFile(assetManager, path, file))
+		return 0;
+
+	i32 result = platform_readFileToBuffer(arena, path, file);
+	return result;
+}
+
+INTERNAL char *assetPathCopy(MemoryArena_ *const arena, const char *const path)
+{
+	i32 pathLen  = common_strlen(path);
+	char *result = MEMORY_PUSH_ARRAY(arena, pathLen + 1, char);
+	common_strncpy(result, path, pathLen);
+	result[pathLen] = 0;
 	return result;
 }
 
@@ -187,15 +531,30 @@ INTERNAL HashTableEntry *const getEntryFromHash(HashTable *const table,
  * Texture Operations
  *********************************
  */
+INTERNAL void atlasInit(TexAtlas *const atlas, MemoryArena_ *const arena,
+                        const i32 numSubTex)
+{
+	hashTableInit(&atlas->subTex, arena, numSubTex);
+	atlas->subTexList     = MEMORY_PUSH_ARRAY(arena, numSubTex, SubTexture);
+	atlas->subTexCapacity = numSubTex;
+	atlas->numSubTex      = 0;
+}
+
 INTERNAL SubTexture *getFreeAtlasSubTexSlot(TexAtlas *const atlas,
                                             MemoryArena_ *const arena,
                                             const char *const key)
 {
+	if (atlas->numSubTex >= atlas->subTexCapacity)
+	{
+		DEBUG_LOG("getFreeAtlasSubTexSlot() failed: Atlas is full");
+		return NULL;
+	}
+
 	HashTableEntry *entry = getFreeHashSlot(&atlas->subTex, arena, key);
 
 	if (entry)
 	{
-		entry->data  = MEMORY_PUSH_STRUCT(arena, SubTexture);
+		entry->data = &atlas->subTexList[atlas->numSubTex++];
 		SubTexture *result = CAST(SubTexture *)entry->data;
 		return result;
 	}
@@ -208,7 +567,7 @@ INTERNAL SubTexture *getFreeAtlasSubTexSlot(TexAtlas *const atlas,
 const SubTexture asset_atlasGetSubTex(TexAtlas *const atlas, const char *const key)
 {
 
-	HashTableEntry *entry = getEntryFromHash(&atlas->subTex, key);
+	HashTableEntry *entry = getEntryFromKey(&atlas->subTex, key);
 
 	SubTexture result       = {0};
 	if (entry)
@@ -221,9 +580,62 @@ const SubTexture asset_atlasGetSubTex(TexAtlas *const atlas, const char *const k
 	return result;
 }
 
-Texture *asset_texGet(AssetManager *const assetManager, const char *const key)
+i32 asset_atlasGetSubTexIndex(TexAtlas *const atlas, const char *const key)
+{
+	HashTableEntry *entry = getEntryFromKey(&atlas->subTex, key);
+
+	i32 result = -1;
+	if (entry)
+	{
+		result = CAST(i32)(CAST(SubTexture *) entry->data - atlas->subTexList);
+	}
+
+	return result;
+}
+
+Texture *asset_texGet(AssetManager *const assetManager,
+                      const enum TexList type)
+{
+	if (type < texlist_count) return assetManager->texList[type];
+
+#ifdef DENGINE_DEBUG
+	ASSERT(INVALID_CODE_PATH);
+#endif
+	return NULL;
+}
+
+Rect asset_texGetRegion(AssetManager *const assetManager,
+                        const enum TexList type)
+{
+	Rect result = {0};
+	if (type < texlist_count) result = assetManager->texListRegion[type];
+
+	return result;
+}
+
+/* Point the id at the sprite's region of the sheet it is packed in, if any */
+INTERNAL b32 texListResolveSheet(AssetManager *const assetManager,
+                                 const enum TexList type,
+                                 const char *const sprite)
+{
+	for (i32 i = 0; i < assetManager->numSheets; i++)
+	{
+		TexAtlas *sheet = assetManager->sheets[i];
+		i32 index       = asset_atlasGetSubTexIndex(sheet, sprite);
+		if (index == -1) continue;
+
+		assetManager->texList[type]       = sheet->tex;
+		assetManager->texListRegion[type] = sheet->subTexList[index].rect;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+Texture *asset_texGetByKey(AssetManager *const assetManager,
+                           const char *const key)
 {
-	HashTableEntry *entry = getEntryFromHash(&assetManager->textures, key);
+	HashTableEntry *entry = getEntryFromKey(&assetManager->textures, key);
 
 	Texture *result = NULL;
 	if (entry) result = CAST(Texture *)entry->data;
@@ -246,18 +658,7 @@ TexAtlas *asset_atlasGetFreeSlot(AssetManager *const assetManager,
 
 		if (result)
 		{
-			result->subTex.size = numSubTex;
-			result->subTex.entries =
-			    memory_pushBytes(arena, numSubTex * sizeof(HashTableEntry));
-
-			if (!result->subTex.entries)
-			{
-				// TODO(doyle): Mem free
-				/*
-				PLATFORM_MEM_FREE(arena, result, sizeof(TexAtlas));
-				result = NULL;
-				*/
-			}
+			atlasInit(result, arena, numSubTex);
 		}
 
 		return result;
@@ -272,7 +673,7 @@ TexAtlas *asset_atlasGet(AssetManager *const assetManager,
                             const char *const key)
 {
 
-	HashTableEntry *entry = getEntryFromHash(&assetManager->texAtlas, key);
+	HashTableEntry *entry = getEntryFromKey(&assetManager->texAtlas, key);
 
 	TexAtlas *result = NULL;
 	if (entry) result = CAST(TexAtlas *)entry->data;
@@ -300,95 +701,186 @@ Texture *asset_texGetFreeSlot(AssetManager *const assetManager,
 	}
 }
 
-Texture *asset_texLoadImage(AssetManager *assetManager, MemoryArena_ *arena,
-                                const char *const path, const char *const key)
+/*
+   Load an image or texture file from the pack or disk, the read is scratch.
+   Loose loads skip the pack.
+ */
+INTERNAL i32 textureLoad(AssetManager *const assetManager,
+                         MemoryArena_ *const arena, const char *const path,
+                         const b32 loose, Texture *const tex)
 {
-	/* Open the texture image */
-	i32 imgWidth, imgHeight, bytesPerPixel;
-	u8 *image =
-	    asset_imageLoad(&imgWidth, &imgHeight, &bytesPerPixel, path, TRUE);
+	TempMemory tempRegion = memory_beginTempRegion(arena);
 
-	Texture *result = NULL;
-	if (image)
+	PlatformFileRead file = {0};
+	i32 result = (loose) ? platform_readFileToBuffer(arena, path, &file)
+	                     : assetReadFile(assetManager, arena, path, &file);
+	if (result == 0)
 	{
-		result = asset_texGetFreeSlot(assetManager, arena, key);
-		*result = textureGen(CAST(GLuint)(imgWidth), CAST(GLuint)(imgHeight),
-		                     CAST(GLint)(bytesPerPixel), image);
-
-		GL_CHECK_ERROR();
-		asset_imageFree(image);
+		result = textureGenFromFile(&file, tex);
+		platform_closeFileRead(arena, &file);
+	}
+	else
+	{
+		printf("textureLoad() failed: Could not read %s\n", path);
 	}
 
+	memory_endTempRegion(tempRegion);
 	return result;
 }
 
-u8 *asset_imageLoad(i32 *width, i32 *height, i32 *bpp, const char *const path,
-                    b32 flipVertically)
+/* Hand a texture loaded from path to the residency budget */
+INTERNAL void texResidencyAdd(AssetManager *const assetManager,
+                              Texture *const tex, char *const path)
 {
-	stbi_set_flip_vertically_on_load(flipVertically);
-	u8 *image = stbi_load(path, width, height, bpp, 0);
+	TexResidency *residency = &assetManager->texResidency;
+	residency->residentInBytes += tex->sizeInBytes;
+	tex->lastUsedFrame = residency->frame;
 
-	if (*width != *height)
+	// NOTE(doyle): Past the managed limit textures stay resident unmanaged
+	if (residency->numTextures < ARRAY_COUNT(residency->textures))
 	{
-		printf(
-		    "asset_texLoadImage() warning: Sprite sheet is not square: "
-		    "%dx%dpx\n",
-		    *width, *height);
+		tex->path = path;
+		residency->textures[residency->numTextures++] = tex;
 	}
-
-	if (!image)
+	else
 	{
-		printf("stdbi_load() failed: %s\n", stbi_failure_reason());
+		DEBUG_LOG("texResidencyAdd() warning: Too many textures to manage");
 	}
-
-	return image;
 }
 
-void asset_imageFree(u8 *image) { stbi_image_free(image); }
-
-/*
- *********************************
- * Animation Asset Managing
- *********************************
- */
-INTERNAL Animation *getFreeAnimationSlot(AssetManager *const assetManager,
-                                         MemoryArena_ *const arena,
-                                         const char *const key)
+Texture *asset_texLoadImage(AssetManager *assetManager, MemoryArena_ *arena,
+                                const char *const path, const char *const key)
 {
-	HashTableEntry *entry = getFreeHashSlot(&assetManager->anims, arena, key);
+	Texture tex = {0};
+	if (textureLoad(assetManager, arena, path, FALSE, &tex)) return NULL;
+	GL_CHECK_ERROR();
 
-	if (entry)
-	{
-		entry->data       = MEMORY_PUSH_STRUCT(arena, Animation);
-		Animation *result = CAST(Animation *) entry->data;
-		return result;
-	}
-	else
+	Texture *result = asset_texGetFreeSlot(assetManager, arena, key);
+	if (result)
 	{
-		return NULL;
+		*result = tex;
+		texResidencyAdd(assetManager, result, assetPathCopy(arena, path));
 	}
+
+	return result;
 }
 
-void asset_animAdd(AssetManager *const assetManager,
-                        MemoryArena_ *const arena, const char *const animName,
-                        TexAtlas *const atlas,
+void asset_texSetBudget(AssetManager *const assetManager,
+                        const u32 budgetInBytes)
+{
+	assetManager->texResidency.budgetInBytes = budgetInBytes;
+}
+
+void asset_texResidencyUpdate(AssetManager *const assetManager,
+                              MemoryArena_ *const transientArena)
+{
+	TexResidency *residency = &assetManager->texResidency;
+	residency->scratchArena = transientArena;
+	residency->frame++;
+
+	/* Evict the least recently used until under budget */
+	while (residency->residentInBytes > residency->budgetInBytes)
+	{
+		Texture *lru = NULL;
+		for (i32 i = 0; i < residency->numTextures; i++)
+		{
+			Texture *tex = residency->textures[i];
+			if (tex->id == 0) continue;
+
+			// NOTE(doyle): Drawn last frame, likely drawn again this frame
+			if (tex->lastUsedFrame + 1 >= residency->frame) continue;
+
+			if (!lru || tex->lastUsedFrame < lru->lastUsedFrame) lru = tex;
+		}
+
+		if (!lru) break;
+
+		glDeleteTextures(1, &lru->id);
+		lru->id = 0;
+		residency->residentInBytes -= lru->sizeInBytes;
+		residency->numEvictions++;
+	}
+}
+
+void asset_texUse(AssetManager *const assetManager, Texture *const tex)
+{
+	TexResidency *residency = &assetManager->texResidency;
+	tex->lastUsedFrame      = residency->frame;
+	if (tex->id != 0 || !tex->path || !residency->scratchArena) return;
+
+	Texture reloaded = {0};
+	if (textureLoad(assetManager, residency->scratchArena, tex->path,
+	                tex->loose, &reloaded) == 0)
+	{
+		reloaded.path          = tex->path;
+		reloaded.loose         = tex->loose;
+		reloaded.lastUsedFrame = residency->frame;
+		*tex                   = reloaded;
+
+		residency->residentInBytes += tex->sizeInBytes;
+		residency->numReloads++;
+	}
+}
+
+u8 *asset_imageLoad(i32 *width, i32 *height, i32 *bpp, const char *const path,
+                    b32 flipVertically)
+{
+	stbi_set_flip_vertically_on_load(flipVertically);
+	u8 *image = stbi_load(path, width, height, bpp, 0);
+
+	if (*width != *height)
+	{
+		printf(
+		    "asset_texLoadImage() warning: Sprite sheet is not square: "
+		    "%dx%dpx\n",
+		    *width, *height);
+	}
+
+	if (!image)
+	{
+		printf("stdbi_load() failed: %s\n", stbi_failure_reason());
+	}
+
+	return image;
+}
+
+void asset_imageFree(u8 *image) { stbi_image_free(image); }
+
+/*
+ *********************************
+ * Animation Asset Managing
+ *********************************
+ */
+void asset_animAdd(AssetManager *const assetManager,
+                        MemoryArena_ *const arena, const char *const animName,
+                        TexAtlas *const atlas,
                         char **const subTextureNames,
                         const i32 numSubTextures, const f32 frameDuration)
 {
-	Animation *anim = getFreeAnimationSlot(assetManager, arena, animName);
+	HashTableEntry *entry = getFreeHashSlot(&assetManager->anims, arena, animName);
+	if (!entry) return;
+
+	entry->data     = MEMORY_PUSH_STRUCT(arena, Animation);
+	Animation *anim = CAST(Animation *) entry->data;
 
 	/* Use same animation ptr for name from entry key */
-	HashTableEntry *entry = getEntryFromHash(&assetManager->anims, animName);
-	anim->name            = entry->key;
+	anim->name = entry->key;
 
 	anim->atlas         = atlas;
 	anim->frameDuration = frameDuration;
 	anim->numFrames     = numSubTextures;
 
 	anim->frameList = memory_pushBytes(arena, numSubTextures * sizeof(char *));
+	anim->frameSubTexList = MEMORY_PUSH_ARRAY(arena, numSubTextures, i32);
 	for (i32 i = 0; i < numSubTextures; i++)
 	{
 		anim->frameList[i] = subTextureNames[i];
+		anim->frameSubTexList[i] =
+		    asset_atlasGetSubTexIndex(atlas, subTextureNames[i]);
+
+#ifdef DENGINE_DEBUG
+		ASSERT(anim->frameSubTexList[i] != -1);
+#endif
 	}
 
 }
@@ -396,7 +888,7 @@ void asset_animAdd(AssetManager *const assetManager,
 Animation *asset_animGet(AssetManager *const assetManager,
                          const char *const key)
 {
-	HashTableEntry *entry = getEntryFromHash(&assetManager->anims, key);
+	HashTableEntry *entry = getEntryFromKey(&assetManager->anims, key);
 
 	Animation *result = NULL;
 	if (entry) result = CAST(Animation *)entry->data;
@@ -409,579 +901,694 @@ Animation *asset_animGet(AssetManager *const assetManager,
  * XML Operations
  *********************************
  */
-enum XmlTokenType
-{
-	xmltokentype_unknown,
-	xmltokentype_openArrow,
-	xmltokentype_closeArrow,
-	xmltokentype_name,
-	xmltokentype_value,
-	xmltokentype_equals,
-	xmltokentype_quotes,
-	xmltokentype_backslash,
-	xmltokentype_count,
+/*
+   NOTE(doyle): Single pass pull parser, the caller asks for the next element
+   open or close and reads the attributes of the element just opened. Names
+   and values are slices into the file buffer, nothing is copied or allocated
+   and the parser is a handful of integers, so copying it by value gives a
+   cheap lookahead. Only the subset of XML the asset files use is handled,
+   the declaration and comments are skipped and text content is ignored.
+ */
+typedef struct XmlString
+{
+	const char *str;
+	i32 len;
+} XmlString;
+
+enum XmlEventType
+{
+	xmleventtype_eof,
+	xmleventtype_error,
+	xmleventtype_open,
+	xmleventtype_close,
+	xmleventtype_count,
 };
 
-typedef struct XmlToken
+typedef struct XmlEvent
 {
-	// TODO(doyle): Dynamic size string in tokens maybe.
-	enum XmlTokenType type;
-	char string[128];
-	i32 len;
-} XmlToken;
+	enum XmlEventType type;
+	XmlString name;
+} XmlEvent;
 
-INTERNAL XmlToken *const tokeniseXmlBuffer(MemoryArena_ *const arena,
-                                           const char *const buffer,
-                                           const i32 bufferSize,
-                                           int *const numTokens)
+typedef struct XmlParser
 {
-	XmlToken *xmlTokens = memory_pushBytes(arena, 8192 * sizeof(XmlToken));
-	i32 tokenIndex      = 0;
-	for (i32 i = 0; i < bufferSize; i++)
-	{
-		char c = (CAST(char *) buffer)[i];
-		switch (c)
-		{
-		case '<':
-		case '>':
-		case '=':
-		case '/':
-		{
+	const char *buffer;
+	i32 size;
+	i32 pos;
 
-			enum XmlTokenType type = xmltokentype_unknown;
-			if (c == '<')
-			{
-				type = xmltokentype_openArrow;
-			}
-			else if (c == '>')
-			{
-				type = xmltokentype_closeArrow;
-			}
-			else if (c == '=')
-			{
-				type = xmltokentype_equals;
-			}
-			else
-			{
-				type = xmltokentype_backslash;
-			}
+	// NOTE(doyle): Depth of the last element opened, decremented on close
+	i32 depth;
+	XmlString tagName;
 
-			xmlTokens[tokenIndex].type = type;
-			xmlTokens[tokenIndex].len  = 1;
-			tokenIndex++;
-			break;
-		}
+	/* Inside an open tag, the attributes have not all been read */
+	b32 inTag;
+	b32 selfClosePending;
+	b32 error;
+} XmlParser;
 
-		case '"':
-		{
-			xmlTokens[tokenIndex].type = xmltokentype_value;
-			for (i32 j = i + 1; j < bufferSize; j++)
-			{
-				char c = (CAST(char *) buffer)[j];
+INTERNAL XmlParser xmlParserInit(const void *const buffer, const i32 size)
+{
+	XmlParser result = {0};
+	result.buffer    = CAST(const char *) buffer;
+	result.size      = size;
+	return result;
+}
 
-				if (c == '"')
-				{
-					break;
-				}
-				else
-				{
-					xmlTokens[tokenIndex].string[xmlTokens[tokenIndex].len++] =
-					    c;
-#ifdef DENGINE_DEBUG
-					ASSERT(xmlTokens[tokenIndex].len <
-					       ARRAY_COUNT(xmlTokens[tokenIndex].string));
-#endif
-				}
-			}
+INTERNAL inline b32 xmlIsWhitespace(const char c)
+{
+	b32 result = (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+	return result;
+}
 
-			// NOTE(doyle): +1 to skip the closing quotes
-			i += (xmlTokens[tokenIndex].len + 1);
-			tokenIndex++;
-			break;
-		}
+INTERNAL inline b32 xmlIsNameChar(const char c)
+{
+	b32 result = !(xmlIsWhitespace(c) || c == '=' || c == '/' || c == '>' ||
+	               c == '<' || c == '"' || c == '\'');
+	return result;
+}
 
-		default:
-		{
-			if ((c >= 'a' && c <= 'z') || c >= 'A' && c <= 'Z')
-			{
-				xmlTokens[tokenIndex].type = xmltokentype_name;
-				for (i32 j = i; j < bufferSize; j++)
-				{
-					char c = (CAST(char *) buffer)[j];
-
-					if (c == ' ' || c == '=' || c == '>' || c == '<' ||
-					    c == '\\')
-					{
-						break;
-					}
-					else
-					{
-						xmlTokens[tokenIndex]
-						    .string[xmlTokens[tokenIndex].len++] = c;
-#ifdef DENGINE_DEBUG
-						ASSERT(xmlTokens[tokenIndex].len <
-						       ARRAY_COUNT(xmlTokens[tokenIndex].string));
-#endif
-					}
-				}
-				i += xmlTokens[tokenIndex].len;
-				tokenIndex++;
-			}
-			break;
-		}
-		}
+INTERNAL b32 xmlStringEquals(const XmlString string, const char *const cString)
+{
+	i32 i = 0;
+	for (; i < string.len; i++)
+	{
+		if (string.str[i] != cString[i]) return FALSE;
 	}
 
-	// TODO(doyle): Dynamic token allocation
-	*numTokens = 8192;
-	return xmlTokens;
+	b32 result = (cString[i] == 0);
+	return result;
+}
+
+INTERNAL i32 xmlStringToI32(const XmlString string)
+{
+	i32 result = common_atoi(string.str, string.len);
+	return result;
 }
 
-INTERNAL XmlNode *const buildXmlTree(MemoryArena_ *const arena,
-                                     XmlToken *const xmlTokens,
-                                     const i32 numTokens)
+INTERNAL void xmlSkipWhitespace(XmlParser *const parser)
 {
-	XmlNode *root = MEMORY_PUSH_STRUCT(arena, XmlNode);
-	if (!root) return NULL;
+	while (parser->pos < parser->size &&
+	       xmlIsWhitespace(parser->buffer[parser->pos]))
+		parser->pos++;
+}
 
-	XmlNode *node = root;
-	node->parent  = node;
+INTERNAL XmlString xmlReadName(XmlParser *const parser)
+{
+	XmlString result = {0};
+	result.str       = &parser->buffer[parser->pos];
+	while (parser->pos < parser->size &&
+	       xmlIsNameChar(parser->buffer[parser->pos]))
+		parser->pos++;
 
-	// NOTE(doyle): Used for when closing a node with many children. We
-	// automatically assign the next child after each child close within
-	// a group. Hence on the last child, we open another node but the next
-	// token indicates the group is closing- we need to set the last child's
-	// next reference to NULL
-	XmlNode *prevNode = NULL;
-	for (i32 i = 0; i < numTokens; i++)
-	{
-		XmlToken *token = &xmlTokens[i];
+	result.len = CAST(i32)(&parser->buffer[parser->pos] - result.str);
+	return result;
+}
 
-		switch (token->type)
-		{
+/* Advance past the terminator, returns FALSE if the buffer ends first */
+INTERNAL b32 xmlSkipPast(XmlParser *const parser, const char *const terminator)
+{
+	i32 len = common_strlen(terminator);
+	for (; parser->pos + len <= parser->size; parser->pos++)
+	{
+		i32 i = 0;
+		while (i < len && parser->buffer[parser->pos + i] == terminator[i])
+			i++;
 
-		case xmltokentype_openArrow:
+		if (i == len)
 		{
-			/* Open arrows indicate closing parent node or new node name */
-			XmlToken *nextToken = &xmlTokens[++i];
-			if (nextToken->type == xmltokentype_backslash)
-			{
-				nextToken = &xmlTokens[++i];
-				if (common_strcmp(nextToken->string, node->parent->name) == 0)
-				{
-					node->parent->isClosed = TRUE;
+			parser->pos += len;
+			return TRUE;
+		}
+	}
 
-					if (prevNode)
-					{
-						prevNode->next = NULL;
-					}
+	parser->pos = parser->size;
+	return FALSE;
+}
 
-					XmlNode *parent = node->parent;
-					// TODO(doyle): Mem free
-					//PLATFORM_MEM_FREE(arena, node, sizeof(XmlNode));
-					node            = node->parent;
-				}
-				else
-				{
-#ifdef DENGINE_DEBUG
-					DEBUG_LOG(
-					    "Closing xml node name does not match parent name");
-#endif
-				}
-			}
-			else if (nextToken->type == xmltokentype_name)
-			{
-				node->name = nextToken->string;
-			}
-			else
-			{
+INTERNAL b32 xmlParserFail(XmlParser *const parser)
+{
 #ifdef DENGINE_DEBUG
-				DEBUG_LOG("Unexpected token type after open arrow");
+	DEBUG_LOG("xmlParser failed: Malformed xml");
 #endif
-			}
-
-			token = nextToken;
-			break;
-		}
-
-		case xmltokentype_name:
-		{
-			// TODO(doyle): Store latest attribute pointer so we aren't always
-			// chasing the linked list each iteration. Do the same for children
-			// node
+	parser->error = TRUE;
+	parser->inTag = FALSE;
+	return FALSE;
+}
 
-			/* Xml Attributes are a linked list, get first free entry */
-			XmlAttribute *attribute = &node->attribute;
-			if (attribute->init)
-			{
-				while (attribute->next)
-					attribute = attribute->next;
+/*
+   Read the next attribute of the element just opened, returns FALSE once the
+   tag is closed. Attributes not read are skipped by xmlParserNext.
+ */
+INTERNAL b32 xmlParserNextAttribute(XmlParser *const parser,
+                                    XmlString *const name,
+                                    XmlString *const value)
+{
+	if (!parser->inTag) return FALSE;
 
-				attribute->next = MEMORY_PUSH_STRUCT(arena, XmlAttribute);
-				attribute       = attribute->next;
-			}
+	xmlSkipWhitespace(parser);
+	if (parser->pos >= parser->size) return xmlParserFail(parser);
 
-			/* Just plain text is a node attribute name */
-			attribute->name = token->string;
+	char c = parser->buffer[parser->pos];
+	if (c == '>')
+	{
+		parser->pos++;
+		parser->inTag = FALSE;
+		return FALSE;
+	}
 
-			/* Followed by the value */
-			token            = &xmlTokens[++i];
-			attribute->value = token->string;
-			attribute->init  = TRUE;
-			break;
-		}
+	if (c == '/')
+	{
+		parser->pos++;
+		if (parser->pos >= parser->size || parser->buffer[parser->pos] != '>')
+			return xmlParserFail(parser);
+
+		parser->pos++;
+		parser->inTag            = FALSE;
+		parser->selfClosePending = TRUE;
+		return FALSE;
+	}
 
-		case xmltokentype_closeArrow:
-		{
-			XmlToken prevToken = xmlTokens[i - 1];
-			prevNode = node;
+	*name = xmlReadName(parser);
+	if (name->len == 0) return xmlParserFail(parser);
 
-			/* Closed node means we can return to parent */
-			if (prevToken.type == xmltokentype_backslash)
-			{
-				node->isClosed = TRUE;
-				node = node->parent;
-			}
-			
-			if (!node->isClosed)
-			{
-				/* Unclosed node means next fields will be children of node */
+	xmlSkipWhitespace(parser);
+	if (parser->pos >= parser->size || parser->buffer[parser->pos] != '=')
+		return xmlParserFail(parser);
 
-				/* If the first child is free allocate, otherwise we have to
-				 * iterate through the child's next node(s) */
-				if (!node->child)
-				{
-					// TODO(doyle): Mem alloc error checking
-					node->child         = MEMORY_PUSH_STRUCT(arena, XmlNode);
-					node->child->parent = node;
-					node                = node->child;
-				}
-				else
-				{
-					XmlNode *nodeToCheck = node->child;
-					while (nodeToCheck->next)
-						nodeToCheck = nodeToCheck->next;
+	parser->pos++;
+	xmlSkipWhitespace(parser);
+	if (parser->pos >= parser->size) return xmlParserFail(parser);
 
-					nodeToCheck->next = MEMORY_PUSH_STRUCT(arena, XmlNode);
-					nodeToCheck->next->parent = node;
-					node                      = nodeToCheck->next;
-				}
-			}
-			break;
-		}
+	char quote = parser->buffer[parser->pos++];
+	if (quote != '"' && quote != '\'') return xmlParserFail(parser);
 
-		default:
-		{
-			break;
-		}
+	value->str = &parser->buffer[parser->pos];
+	while (parser->pos < parser->size && parser->buffer[parser->pos] != quote)
+		parser->pos++;
 
-		}
-	}
+	if (parser->pos >= parser->size) return xmlParserFail(parser);
 
-	return root;
+	value->len = CAST(i32)(&parser->buffer[parser->pos] - value->str);
+	parser->pos++;
+	return TRUE;
 }
 
-INTERNAL void parseXmlTreeToGame(AssetManager *assetManager, MemoryArena_ *arena,
-                                 XmlNode *root)
+/* Returns the next element open or close, self closing tags produce both */
+INTERNAL XmlEvent xmlParserNext(XmlParser *const parser)
 {
-	XmlNode *node = root;
-	while (node)
-	{
-		/*
-		 *********************************
-		 * Branch on node names
-		 *********************************
-		 */
-		if (common_strcmp(node->name, "TextureAtlas") == 0)
-		{
-			XmlNode *atlasXmlNode = node;
-			TexAtlas *atlas  = NULL;
-			if (common_strcmp(node->attribute.name, "imagePath") == 0)
-			{
+	XmlEvent result = {0};
 
-				/*
-				 **********************************************
-				 * Create a texture atlas with imageName as key
-				 **********************************************
-				 */
-				char *imageName = atlasXmlNode->attribute.value;
-				i32 numSubTex   = 1024;
-				atlas           = asset_atlasGetFreeSlot(assetManager, arena,
-				                                  imageName, numSubTex);
-
-				if (!atlas)
-				{
-					DEBUG_LOG(
-					    "parseXmlTreeToGame() failed: Could not get free atlas "
-					    "entry");
-					return;
-				}
+	XmlString name, value;
+	while (xmlParserNextAttribute(parser, &name, &value))
+		;
 
-				/*
-				 *************************************************
-				 * Load a texture to hash, with imageName as key
-				 *************************************************
-				 */
-				char *dataDir    = "data/textures/WorldTraveller/";
-				i32 dataDirLen   = common_strlen(dataDir);
-				i32 imageNameLen = common_strlen(imageName);
-				i32 totalPathLen = (dataDirLen + imageNameLen) + 1;
-
-				char *imagePath =
-				    memory_pushBytes(arena, totalPathLen * sizeof(char));
-				common_strncat(imagePath, dataDir, dataDirLen);
-				common_strncat(imagePath, imageName, imageNameLen);
-
-				Texture *tex = asset_texLoadImage(assetManager, arena,
-				                                      imagePath, imageName);
-
-				if (!tex)
-				{
-					DEBUG_LOG("parseXmlTreeToGame() failed: Could not load image");
-					// TODO(doyle): Mem free
-					//PLATFORM_MEM_FREE(arena, imagePath,
-					//                  totalPathLen * sizeof(char));
-					return;
-				}
+	if (parser->error)
+	{
+		result.type = xmleventtype_error;
+		return result;
+	}
 
-				// TODO(doyle): Mem free
-				//PLATFORM_MEM_FREE(arena, imagePath,
-				//                  totalPathLen * sizeof(char));
-				atlas->tex = tex;
-
-				/*
-				 *************************************************
-				 * Iterate over XML attributes
-				 *************************************************
-				 */
-				XmlNode *atlasChildNode = atlasXmlNode->child;
-				while (atlasChildNode)
-				{
-					if (common_strcmp(atlasChildNode->name, "SubTexture") == 0)
-					{
-						XmlAttribute *subTexAttrib = &atlasChildNode->attribute;
-
-						char *key   = NULL;
-						SubTexture subTex = {0};
-						while (subTexAttrib)
-						{
-
-							// TODO(doyle): Work around for now in xml reading,
-							// reading the last node closing node not being
-							// merged to the parent
-							if (!subTexAttrib->name) continue;
-
-							if (common_strcmp(subTexAttrib->name, "name") == 0)
-							{
-								char *value = subTexAttrib->value;
-								key         = value;
-							}
-							else if (common_strcmp(subTexAttrib->name, "x") ==
-							         0)
-							{
-								char *value  = subTexAttrib->value;
-								i32 valueLen = common_strlen(value);
-								i32 intValue = common_atoi(value, valueLen);
-
-								subTex.rect.min.x = CAST(f32) intValue;
-							}
-							else if (common_strcmp(subTexAttrib->name, "y") ==
-							         0)
-							{
-								char *value  = subTexAttrib->value;
-								i32 valueLen = common_strlen(value);
-
-								i32 intValue = common_atoi(value, valueLen);
-								subTex.rect.min.y = CAST(f32) intValue;
-							}
-							else if (common_strcmp(subTexAttrib->name,
-							                       "width") == 0)
-							{
-								char *value  = subTexAttrib->value;
-								i32 valueLen = common_strlen(value);
-								i32 intValue = common_atoi(value, valueLen);
-
-								subTex.rect.max.w = CAST(f32) intValue;
-							}
-							else if (common_strcmp(subTexAttrib->name,
-							                       "height") == 0)
-							{
-								char *value  = subTexAttrib->value;
-								i32 valueLen = common_strlen(value);
-								i32 intValue = common_atoi(value, valueLen);
-
-								subTex.rect.max.h = CAST(f32) intValue;
-							}
-							else if (common_strcmp(subTexAttrib->name,
-							                       "hand_offset_x") == 0)
-							{
-								char *value  = subTexAttrib->value;
-								i32 valueLen = common_strlen(value);
-								i32 intValue = common_atoi(value, valueLen);
-
-								subTex.offset.x = CAST(f32) intValue;
-							}
-							else if (common_strcmp(subTexAttrib->name,
-							                       "hand_offset_y") == 0)
-							{
-								char *value  = subTexAttrib->value;
-								i32 valueLen = common_strlen(value);
-								i32 intValue = common_atoi(value, valueLen);
-
-								subTex.offset.y = CAST(f32) intValue;
-							}
-							else
-							{
-#ifdef DENGINE_DEBUG
-								DEBUG_LOG(
-								    "Unsupported xml attribute in SubTexture");
-#endif
-							}
-							subTexAttrib = subTexAttrib->next;
-						}
+	if (parser->selfClosePending)
+	{
+		parser->selfClosePending = FALSE;
+		parser->depth--;
+		result.type = xmleventtype_close;
+		result.name = parser->tagName;
+		return result;
+	}
 
-						// TODO(doyle): XML specifies 0,0 top left, we
-						// prefer 0,0 bottom right, so offset by size since 0,0
-						// is top left and size creates a bounding box below it
-						subTex.rect.min.y = 1024 - subTex.rect.min.y;
-						subTex.rect.min.y -= subTex.rect.max.h;
-						subTex.offset.y = subTex.rect.max.h - subTex.offset.y;
+	for (;;)
+	{
+		/* Skip text content up to the next tag */
+		while (parser->pos < parser->size && parser->buffer[parser->pos] != '<')
+			parser->pos++;
 
-#ifdef DENGINE_DEBUG
-						ASSERT(key);
-#endif
-						SubTexture *subTexInHash =
-						    getFreeAtlasSubTexSlot(atlas, arena, key);
-						*subTexInHash = subTex;
-					}
-					else
-					{
-#ifdef DENGINE_DEBUG
-						DEBUG_LOG("Unsupported xml node name not parsed");
-#endif
-					}
+		if (parser->pos >= parser->size)
+		{
+			if (parser->depth != 0) xmlParserFail(parser);
+			result.type =
+			    (parser->error) ? xmleventtype_error : xmleventtype_eof;
+			return result;
+		}
 
-					atlasChildNode = atlasChildNode->next;
-				}
-			}
-			else
+		parser->pos++;
+		char c = (parser->pos < parser->size) ? parser->buffer[parser->pos] : 0;
+		if (c == '?')
+		{
+			if (!xmlSkipPast(parser, "?>")) break;
+		}
+		else if (c == '!')
+		{
+			b32 isComment = (parser->pos + 2 < parser->size &&
+			                 parser->buffer[parser->pos + 1] == '-' &&
+			                 parser->buffer[parser->pos + 2] == '-');
+			if (!xmlSkipPast(parser, (isComment) ? "-->" : ">")) break;
+		}
+		else if (c == '/')
+		{
+			parser->pos++;
+			result.name = xmlReadName(parser);
+			xmlSkipWhitespace(parser);
+			if (result.name.len == 0 || parser->depth <= 0 ||
+			    parser->pos >= parser->size ||
+			    parser->buffer[parser->pos] != '>')
 			{
-#ifdef DENGINE_DEBUG
-				DEBUG_LOG("Unsupported xml node");
-#endif
+				break;
 			}
+
+			parser->pos++;
+			parser->depth--;
+			result.type = xmleventtype_close;
+			return result;
 		}
 		else
 		{
-#ifdef DENGINE_DEBUG
-			DEBUG_LOG("Unsupported xml node name not parsed");
-#endif
+			result.name = xmlReadName(parser);
+			if (result.name.len == 0) break;
+
+			parser->depth++;
+			parser->tagName = result.name;
+			parser->inTag   = TRUE;
+			result.type     = xmleventtype_open;
+			return result;
 		}
-		node = node->next;
 	}
+
+	xmlParserFail(parser);
+	result.type = xmleventtype_error;
+	return result;
 }
 
-INTERNAL void recursiveFreeXmlTree(MemoryArena_ *const arena,
-                                   XmlNode *node)
+/* Counts the direct children with the given name of the element just opened */
+INTERNAL i32 xmlCountChildren(XmlParser parser, const char *const name)
 {
-	if (!node)
-	{
-		return;
-	} else
+	i32 result      = 0;
+	i32 parentDepth = parser.depth;
+	for (;;)
 	{
-		// NOTE(doyle): First attribute is statically allocated, only if there's
-		// more attributes do we dynamically allocate
-		XmlAttribute *attrib = node->attribute.next;
-
-		while (attrib)
+		XmlEvent event = xmlParserNext(&parser);
+		if (event.type == xmleventtype_open)
 		{
-			XmlAttribute *next = attrib->next;
-
-			attrib->name  = NULL;
-			attrib->value = NULL;
-			// TODO(doyle): Mem free
-			// PLATFORM_MEM_FREE(arena, attrib, sizeof(XmlAttribute));
-			attrib = next;
+			if (parser.depth == parentDepth + 1 &&
+			    xmlStringEquals(event.name, name))
+				result++;
+		}
+		else if (event.type == xmleventtype_close)
+		{
+			if (parser.depth < parentDepth) break;
+		}
+		else
+		{
+			break;
 		}
-
-		recursiveFreeXmlTree(arena, node->child);
-		recursiveFreeXmlTree(arena, node->next);
-
-		node->name     = NULL;
-		node->isClosed = FALSE;
-		// TODO(doyle): Mem free
-		// PLATFORM_MEM_FREE(arena, node, sizeof(XmlNode));
-		node = NULL;
 	}
-}
 
-INTERNAL void freeXmlData(MemoryArena_ *const arena, XmlToken *tokens,
-                          const i32 numTokens, XmlNode *tree)
-{
-	if (tree) recursiveFreeXmlTree(arena, tree);
-	// TODO(doyle): Mem free
-	// if (tokens) PLATFORM_MEM_FREE(arena, tokens, numTokens * sizeof(XmlToken));
+	return result;
 }
 
-/*
- *********************************
- * Everything else
- *********************************
- */
-const i32 asset_xmlLoad(AssetManager *const assetManager,
-                            MemoryArena_ *const arena,
-                            const PlatformFileRead *const fileRead)
+/* Skip the rest of the element just opened, including its children */
+INTERNAL void xmlSkipElement(XmlParser *const parser)
 {
-	i32 result = 0;
-	/* Tokenise buffer */
-	i32 numTokens       = 0;
-	XmlToken *xmlTokens =
-	    tokeniseXmlBuffer(arena, fileRead->buffer, fileRead->size, &numTokens);
-
-	/* Build XML tree from tokens */
-	XmlNode *xmlTree = buildXmlTree(arena, xmlTokens, numTokens);
-
-	if (xmlTree)
-	{
-		/* Parse XML tree to game structures */
-		parseXmlTreeToGame(assetManager, arena, xmlTree);
-	}
-	else
+	i32 parentDepth = parser->depth;
+	for (;;)
 	{
-		result = -1;
-	}
-
-	/* Free data */
-	freeXmlData(arena, xmlTokens, numTokens, xmlTree);
+		XmlEvent event = xmlParserNext(parser);
+		if (event.type == xmleventtype_eof || event.type == xmleventtype_error)
+			break;
 
-	return result;
+		if (event.type == xmleventtype_close && parser->depth < parentDepth)
+			break;
+	}
 }
 
-AudioVorbis *const asset_vorbisGet(AssetManager *const assetManager,
-                                   const char *const key)
+INTERNAL i32 parseXmlSubTexture(TexAtlas *const atlas,
+                                MemoryArena_ *const arena,
+                                XmlParser *const parser)
 {
+	XmlString key     = {0};
+	SubTexture subTex = {0};
+
+	XmlString name, value;
+	while (xmlParserNextAttribute(parser, &name, &value))
+	{
+		if (xmlStringEquals(name, "name"))
+		{
+			key = value;
+		}
+		else if (xmlStringEquals(name, "x"))
+		{
+			subTex.rect.min.x = CAST(f32) xmlStringToI32(value);
+		}
+		else if (xmlStringEquals(name, "y"))
+		{
+			subTex.rect.min.y = CAST(f32) xmlStringToI32(value);
+		}
+		else if (xmlStringEquals(name, "width"))
+		{
+			subTex.rect.max.w = CAST(f32) xmlStringToI32(value);
+		}
+		else if (xmlStringEquals(name, "height"))
+		{
+			subTex.rect.max.h = CAST(f32) xmlStringToI32(value);
+		}
+		else if (xmlStringEquals(name, "hand_offset_x"))
+		{
+			subTex.offset.x = CAST(f32) xmlStringToI32(value);
+		}
+		else if (xmlStringEquals(name, "hand_offset_y"))
+		{
+			subTex.offset.y = CAST(f32) xmlStringToI32(value);
+		}
+		else
+		{
+#ifdef DENGINE_DEBUG
+			DEBUG_LOG("Unsupported xml attribute in SubTexture");
+#endif
+		}
+	}
+
+	// NOTE(doyle): The hash table copies the key, so the slice only needs to
+	// be terminated long enough to insert it
+	char keyString[128];
+	if (key.len == 0 || key.len >= ARRAY_COUNT(keyString))
+	{
+		DEBUG_LOG("parseXmlSubTexture() failed: Missing or too long name");
+		return -1;
+	}
+	common_memcpy(keyString, key.str, key.len);
+	keyString[key.len] = 0;
+
+	// TODO(doyle): XML specifies 0,0 top left, we
+	// prefer 0,0 bottom right, so offset by size since 0,0
+	// is top left and size creates a bounding box below it
+	subTex.rect.min.y = CAST(f32) atlas->tex->height - subTex.rect.min.y;
+	subTex.rect.min.y -= subTex.rect.max.h;
+	subTex.offset.y = subTex.rect.max.h - subTex.offset.y;
+
+	SubTexture *subTexInHash = getFreeAtlasSubTexSlot(atlas, arena, keyString);
+	if (!subTexInHash) return -1;
+
+	*subTexInHash = subTex;
+	return 0;
+}
+
+/* imageDir is prepended to the atlas image path, sheets are remapped to */
+INTERNAL i32 parseXmlTextureAtlas(AssetManager *const assetManager,
+                                  MemoryArena_ *const arena,
+                                  XmlParser *const parser,
+                                  const char *const imageDir,
+                                  const b32 isSheet)
+{
+	/* Size the atlas up front with a lookahead over its children */
+	i32 numSubTex = xmlCountChildren(*parser, "SubTexture");
+
+	XmlString imageName = {0};
+	XmlString name, value;
+	while (xmlParserNextAttribute(parser, &name, &value))
+	{
+		if (xmlStringEquals(name, "imagePath")) imageName = value;
+	}
+
+	if (imageName.len == 0)
+	{
+#ifdef DENGINE_DEBUG
+		DEBUG_LOG("Unsupported xml node");
+#endif
+		xmlSkipElement(parser);
+		return 0;
+	}
+
+	/*
+	 *************************************************
+	 * Load a texture to hash, with imageName as key
+	 *************************************************
+	 */
+	i32 dataDirLen   = common_strlen(imageDir);
+	i32 totalPathLen = (dataDirLen + imageName.len) + 1;
+
+	char *imagePath = memory_pushBytes(arena, totalPathLen * sizeof(char));
+	common_memcpy(imagePath, imageDir, dataDirLen);
+	common_memcpy(imagePath + dataDirLen, imageName.str, imageName.len);
+	imagePath[totalPathLen - 1] = 0;
+
+	/*
+	 **********************************************
+	 * Create a texture atlas with imageName as key
+	 **********************************************
+	 */
+	char *imageKey  = imagePath + dataDirLen;
+	TexAtlas *atlas = asset_atlasGet(assetManager, imageKey);
+	if (atlas && assetManager->hotReload.reading)
+	{
+		// NOTE(doyle): Rebuild the sub textures of the live atlas in place,
+		// its image is reloaded by its own change
+		atlasInit(atlas, arena, MAX(numSubTex, 1));
+	}
+	else
+	{
+		atlas = asset_atlasGetFreeSlot(assetManager, arena, imageKey,
+		                               MAX(numSubTex, 1));
+		if (!atlas)
+		{
+			DEBUG_LOG("parseXmlTextureAtlas() failed: Could not get free "
+			          "atlas entry");
+			return -1;
+		}
+
+		Texture *tex =
+		    asset_texLoadImage(assetManager, arena, imagePath, imageKey);
+		if (!tex)
+		{
+			DEBUG_LOG("parseXmlTextureAtlas() failed: Could not load image");
+			return -1;
+		}
+		atlas->tex = tex;
+	}
+
+	if (isSheet && !assetManager->hotReload.reading)
+	{
+		if (assetManager->numSheets >= ARRAY_COUNT(assetManager->sheets))
+		{
+			DEBUG_LOG("parseXmlTextureAtlas() failed: Too many sprite sheets");
+			return -1;
+		}
+		assetManager->sheets[assetManager->numSheets++] = atlas;
+	}
+
+	/*
+	 *************************************************
+	 * Iterate over child nodes
+	 *************************************************
+	 */
+	i32 atlasDepth = parser->depth;
+	for (;;)
+	{
+		XmlEvent event = xmlParserNext(parser);
+		if (event.type == xmleventtype_eof || event.type == xmleventtype_error)
+			return -1;
+
+		if (event.type == xmleventtype_close)
+		{
+			if (parser->depth < atlasDepth) break;
+			continue;
+		}
+
+		if (xmlStringEquals(event.name, "SubTexture"))
+		{
+			if (parseXmlSubTexture(atlas, arena, parser)) return -1;
+		}
+		else
+		{
+#ifdef DENGINE_DEBUG
+			DEBUG_LOG("Unsupported xml node name not parsed");
+#endif
+			xmlSkipElement(parser);
+		}
+	}
+
+	return 0;
+}
+
+INTERNAL i32 parseXmlToGame(AssetManager *const assetManager,
+                            MemoryArena_ *const arena, XmlParser *const parser,
+                            const char *const imageDir, const b32 isSheet)
+{
+	for (;;)
+	{
+		XmlEvent event = xmlParserNext(parser);
+		if (event.type == xmleventtype_eof) break;
+		if (event.type == xmleventtype_error) return -1;
+		if (event.type != xmleventtype_open) continue;
+
+		/*
+		 *********************************
+		 * Branch on node names
+		 *********************************
+		 */
+		if (xmlStringEquals(event.name, "TextureAtlas"))
+		{
+			if (parseXmlTextureAtlas(assetManager, arena, parser, imageDir,
+			                         isSheet))
+				return -1;
+		}
+		else
+		{
+#ifdef DENGINE_DEBUG
+			DEBUG_LOG("Unsupported xml node name not parsed");
+#endif
+			xmlSkipElement(parser);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ *********************************
+ * Everything else
+ *********************************
+ */
+const i32 asset_xmlLoad(AssetManager *const assetManager,
+                            MemoryArena_ *const arena,
+                            const PlatformFileRead *const fileRead)
+{
+	XmlParser parser = xmlParserInit(fileRead->buffer, fileRead->size);
+	i32 result = parseXmlToGame(assetManager, arena, &parser,
+	                            "data/textures/WorldTraveller/", FALSE);
+	return result;
+}
+
+i32 asset_sheetLoad(AssetManager *const assetManager,
+                    MemoryArena_ *const persistentArena,
+                    MemoryArena_ *const transientArena,
+                    const char *const xmlPath)
+{
+	/* Sheet images live next to the xml */
+	char imageDir[256] = {0};
+	i32 imageDirLen    = 0;
+	for (i32 i = 0; xmlPath[i]; i++)
+	{
+		if (xmlPath[i] == '/' || xmlPath[i] == '\\') imageDirLen = i + 1;
+	}
+
+	if (imageDirLen >= ARRAY_COUNT(imageDir))
+	{
+		DEBUG_LOG("asset_sheetLoad() failed: Path too long");
+		return -1;
+	}
+	common_memcpy(imageDir, xmlPath, imageDirLen);
+
+	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+
+	i32 result             = -1;
+	PlatformFileRead file  = {0};
+	if (assetReadFile(assetManager, transientArena, xmlPath, &file) == 0)
+	{
+		XmlParser parser = xmlParserInit(file.buffer, file.size);
+		result = parseXmlToGame(assetManager, persistentArena, &parser,
+		                        imageDir, TRUE);
+		platform_closeFileRead(transientArena, &file);
+	}
+	else
+	{
+		DEBUG_LOG("asset_sheetLoad() failed: Could not read sheet xml");
+	}
+
+	memory_endTempRegion(tempRegion);
+
+	AssetHotReload *hotReload = &assetManager->hotReload;
+	if (result == 0 && !hotReload->reading &&
+	    hotReload->numSheetPaths < ARRAY_COUNT(hotReload->sheetPath))
+	{
+		hotReload->sheetPath[hotReload->numSheetPaths++] =
+		    assetPathCopy(persistentArena, xmlPath);
+	}
+
+	return result;
+}
+
+AudioVorbis *const asset_vorbisGet(AssetManager *const assetManager,
+                                   const enum AudioList type)
+{
+	if (type < audiolist_count) return assetManager->audioList[type];
+
+#ifdef DENGINE_DEBUG
+	ASSERT(INVALID_CODE_PATH);
+#endif
+	return NULL;
+}
+
+AudioVorbis *const asset_vorbisGetByKey(AssetManager *const assetManager,
+                                        const char *const key)
+{
+
+	HashTableEntry *entry = getEntryFromKey(&assetManager->audio, key);
 
-	HashTableEntry *entry = getEntryFromHash(&assetManager->audio, key);
-
 	AudioVorbis *result = NULL;
 	if (entry) result = CAST(AudioVorbis *)entry->data;
 
 	return result;
 }
 
+/*
+   Decode the whole clip to interleaved samples if the option asks for it. The
+   file stays open, the compressed data is still used for streaming.
+ */
+INTERNAL i32 vorbisDecodePcm(AudioVorbis *const audio,
+                             const enum AudioDecode decode)
+{
+	b32 decodeToPcm = (decode == audiodecode_pcm);
+	if (decode == audiodecode_auto)
+		decodeToPcm = (audio->lengthInSeconds <= ASSET_AUDIO_PCM_MAX_SECONDS);
+
+	if (!decodeToPcm || audio->lengthInSamples == 0) return 0;
+
+	i32 channels   = audio->info.channels;
+	i32 numSamples = audio->lengthInSamples * channels;
+	i16 *pcm = CAST(i16 *) platform_memoryAlloc(NULL, numSamples * sizeof(i16));
+	if (!pcm) return -1;
+
+	// NOTE(doyle): Returns the number of samples per channel decoded
+	i32 numDecoded = stb_vorbis_get_samples_short_interleaved(
+	    audio->file, channels, pcm, numSamples);
+	stb_vorbis_seek_start(audio->file);
+
+	audio->pcm     = pcm;
+	audio->pcmSize = numDecoded * channels * sizeof(i16);
+	return 0;
+}
+
+INTERNAL void audioLoadStatSet(AssetManager *const assetManager,
+                               const enum AudioList type,
+                               const AudioVorbis *const audio,
+                               const f32 decodeInMs)
+{
+	AudioLoadStat *stat   = &assetManager->audioLoadStats[type];
+	stat->loaded          = TRUE;
+	stat->lengthInSeconds = audio->lengthInSeconds;
+	stat->compressedSize  = audio->size;
+	stat->pcmSize         = audio->pcmSize;
+	stat->decodeInMs      = decodeInMs;
+}
+
 const i32 asset_vorbisLoad(AssetManager *assetManager, MemoryArena_ *arena,
-                           const char *const path, const char *const key)
+                           const char *const path, const char *const key,
+                           const enum AudioList type,
+                           const enum AudioDecode decode)
 {
+	ASSERT(type < audiolist_count);
+
 	HashTableEntry *entry = getFreeHashSlot(&assetManager->audio, arena, key);
 	if (!entry) return -1;
 
 	// TODO(doyle): Remember to free vorbis file if we remove from memory
 	PlatformFileRead fileRead = {0};
-	platform_readFileToBuffer(arena, path, &fileRead);
+	assetReadFile(assetManager, arena, path, &fileRead);
 
 	entry->data = MEMORY_PUSH_STRUCT(arena, AudioVorbis);
 
 	i32 error;
+	f64 startTime      = platform_getTimeInSeconds();
 	AudioVorbis *audio = CAST(AudioVorbis *) entry->data;
 	audio->file =
 	    stb_vorbis_open_memory(fileRead.buffer, fileRead.size, &error, NULL);
@@ -1002,23 +1609,66 @@ const i32 asset_vorbisLoad(AssetManager *assetManager, MemoryArena_ *arena,
 	audio->data            = CAST(u8 *) fileRead.buffer;
 	audio->size            = fileRead.size;
 
+	if (vorbisDecodePcm(audio, decode))
+		DEBUG_LOG("asset_vorbisLoad() warning: No memory to decode to PCM");
+
+	f32 decodeInMs =
+	    CAST(f32)((platform_getTimeInSeconds() - startTime) * 1000.0f);
+	audioLoadStatSet(assetManager, type, audio, decodeInMs);
+
+	assetManager->audioList[type] = audio;
 	return 0;
 }
 
-INTERNAL GLuint createShaderFromPath(MemoryArena_ *arena, const char *const path,
+void asset_audioLoadReport(AssetManager *const assetManager)
+{
+	i32 totalCompressed = 0;
+	i32 totalPcm        = 0;
+	f32 totalDecodeInMs = 0;
+
+	printf("Audio load report\n");
+	printf("%-14s %8s %10s %8s %8s %10s\n", "Clip", "Length", "Decode",
+	       "Ogg", "PCM", "Decode");
+	for (i32 i = 0; i < audiolist_count; i++)
+	{
+		AudioLoadStat *stat = &assetManager->audioLoadStats[i];
+		AudioVorbis *audio  = assetManager->audioList[i];
+		if (!stat->loaded || !audio) continue;
+
+		printf("%-14s %7.2fs %10s %7dK %7dK %8.2fms\n", audio->key,
+		       stat->lengthInSeconds, (stat->pcmSize) ? "pcm" : "compressed",
+		       stat->compressedSize / 1024, stat->pcmSize / 1024,
+		       stat->decodeInMs);
+
+		totalCompressed += stat->compressedSize;
+		totalPcm        += stat->pcmSize;
+		totalDecodeInMs += stat->decodeInMs;
+	}
+
+	// NOTE(doyle): Decode times are summed across the workers, the wall time
+	// of the load is less when they ran in parallel
+	printf("%-14s %8s %10s %7dK %7dK %8.2fms\n", "Total", "", "",
+	       totalCompressed / 1024, totalPcm / 1024, totalDecodeInMs);
+}
+
+INTERNAL GLuint createShaderFromPath(AssetManager *assetManager,
+                                     MemoryArena_ *arena,
+                                     const char *const path,
                                      GLuint shadertype)
 {
 	PlatformFileRead file = {0};
 
 	// TODO(doyle): Revise platform reads
-	i32 status = platform_readFileToBuffer(arena, path, &file);
+	i32 status = assetReadFile(assetManager, arena, path, &file);
 	if (status)
 		return status;
 
+	// NOTE(doyle): File reads are not null terminated, pass the length
 	const GLchar *source = CAST(char *)file.buffer;
+	const GLint sourceLen = file.size;
 
 	GLuint result = glCreateShader(shadertype);
-	glShaderSource(result, 1, &source, NULL);
+	glShaderSource(result, 1, &source, &sourceLen);
 	glCompileShader(result);
 
 	GLint success;
@@ -1026,504 +1676,2093 @@ INTERNAL GLuint createShaderFromPath(MemoryArena_ *arena, const char *const path
 	glGetShaderiv(result, GL_COMPILE_STATUS, &success);
 	if (!success)
 	{
-		glGetShaderInfoLog(result, 512, NULL, infoLog);
-		printf("glCompileShader() failed: %s\n", infoLog);
+		glGetShaderInfoLog(result, 512, NULL, infoLog);
+		printf("glCompileShader() failed: %s\n", infoLog);
+	}
+
+	platform_closeFileRead(arena, &file);
+
+	return result;
+}
+
+INTERNAL u32 shaderLoadProgram(const GLuint vertexShader,
+                               const GLuint fragmentShader)
+{
+	u32 result = glCreateProgram();
+	glAttachShader(result, vertexShader);
+	glAttachShader(result, fragmentShader);
+	glLinkProgram(result);
+	GL_CHECK_ERROR();
+
+	glDeleteShader(fragmentShader);
+	glDeleteShader(vertexShader);
+	GL_CHECK_ERROR();
+
+	GLint success;
+	GLchar infoLog[512];
+	glGetProgramiv(result, GL_LINK_STATUS, &success);
+	GL_CHECK_ERROR();
+	if (result == 0)
+	{
+		glGetProgramInfoLog(result, 512, NULL, infoLog);
+		printf("glLinkProgram failed: %s\n", infoLog);
+		ASSERT(TRUE);
+	}
+	GL_CHECK_ERROR();
+
+	return result;
+}
+
+u32 asset_shaderGet(AssetManager *assetManager, const enum ShaderList type)
+{
+	if (type < shaderlist_count) return assetManager->shaders[type];
+
+#ifdef DENGINE_DEBUG
+	ASSERT(INVALID_CODE_PATH);
+#endif
+	return -1;
+}
+
+const i32 asset_shaderLoad(AssetManager *assetManager, MemoryArena_ *arena,
+                                const char *const vertexPath,
+                                const char *const fragmentPath,
+                                const enum ShaderList type)
+{
+	GLuint vertexShader = createShaderFromPath(assetManager, arena, vertexPath,
+	                                           GL_VERTEX_SHADER);
+	GLuint fragmentShader = createShaderFromPath(
+	    assetManager, arena, fragmentPath, GL_FRAGMENT_SHADER);
+
+	u32 shaderId = shaderLoadProgram(vertexShader, fragmentShader);
+	if (shaderId == 0) return -1;
+
+	assetManager->shaders[type] = shaderId;
+
+	AssetHotReload *hotReload      = &assetManager->hotReload;
+	hotReload->shaderPath[type][0] = assetPathCopy(arena, vertexPath);
+	hotReload->shaderPath[type][1] = assetPathCopy(arena, fragmentPath);
+	return 0;
+}
+
+Font *asset_fontGetOrCreateOnDemand(AssetManager *assetManager,
+                                    MemoryArena_ *persistentArena,
+                                    MemoryArena_ *transientArena,
+                                    const enum FontList type, i32 size)
+{
+
+	Font *result = asset_fontGet(assetManager, type, size);
+
+	if (result == NULL)
+	{
+		FontPack *pack = &assetManager->fontPack[type];
+		if (pack->sdfAtlas)
+		{
+			// NOTE(doyle): Atlas is resident, a new size only computes metrics
+			asset_fontLoadTTF(assetManager, persistentArena, transientArena,
+			                  pack->filePath, type, size);
+
+			result = asset_fontGet(assetManager, type, size);
+		}
+		else if (pack->filePath != NULL && !pack->loadQueued)
+		{
+			asset_fontLoadAsync(assetManager, persistentArena, pack->filePath,
+			                    type, size);
+		}
+		else
+		{
+			// TODO(doyle): Logging
+		}
+	}
+
+	// NOTE(doyle): Empty font until the pack has streamed in
+	if (result == NULL) result = &assetManager->emptyFont;
+
+	return result;
+}
+
+Font *asset_fontGet(AssetManager *assetManager, const enum FontList type,
+                    i32 size)
+{
+	if (type >= fontlist_count)
+	{
+#ifdef DENGINE_DEBUG
+		ASSERT(INVALID_CODE_PATH);
+#endif
+		return NULL;
+	}
+
+	Font *result   = NULL;
+	FontPack *pack = &assetManager->fontPack[type];
+	for (i32 j = 0; j < pack->fontIndex; j++)
+	{
+		if (pack->font[j].fontHeight == size)
+		{
+			result = &pack->font[j];
+			break;
+		}
+	}
+
+	return result;
+}
+
+/*
+ *********************************
+ * Font Operations
+ *********************************
+ */
+// NOTE(doyle): Glyphs are rasterised for the distance field at this height,
+// every other size is a scaled view of the same atlas
+#define FONT_SDF_BASE_HEIGHT 48
+#define FONT_SDF_PADDING 6
+#define FONT_SDF_ATLAS_SIZE 512
+#define FONT_SDF_ON_EDGE_VALUE 128
+#define FONT_SDF_INF 9999
+
+typedef struct SdfPoint
+{
+	i32 dx;
+	i32 dy;
+} SdfPoint;
+
+INTERNAL i32 sdfPointDistSq(SdfPoint p)
+{
+	i32 result = (p.dx * p.dx) + (p.dy * p.dy);
+	return result;
+}
+
+INTERNAL void sdfCompare(SdfPoint *const grid, const i32 width,
+                         const i32 height, const i32 x, const i32 y,
+                         const i32 offsetX, const i32 offsetY)
+{
+	i32 checkX = x + offsetX;
+	i32 checkY = y + offsetY;
+	if (checkX < 0 || checkX >= width || checkY < 0 || checkY >= height)
+		return;
+
+	SdfPoint *point = &grid[x + (y * width)];
+	SdfPoint other  = grid[checkX + (checkY * width)];
+	other.dx += offsetX;
+	other.dy += offsetY;
+
+	if (sdfPointDistSq(other) < sdfPointDistSq(*point)) *point = other;
+}
+
+/*
+   NOTE(doyle): 8 point sequential signed euclidean distance transform. Each
+   point stores the offset to its nearest seed point, seeds start at 0 and
+   everything else at infinity. Two sweeps propagate offsets from neighbours.
+ */
+INTERNAL void sdfPropagate(SdfPoint *const grid, const i32 width,
+                           const i32 height)
+{
+	for (i32 y = 0; y < height; y++)
+	{
+		for (i32 x = 0; x < width; x++)
+		{
+			sdfCompare(grid, width, height, x, y, -1, 0);
+			sdfCompare(grid, width, height, x, y, 0, -1);
+			sdfCompare(grid, width, height, x, y, -1, -1);
+			sdfCompare(grid, width, height, x, y, 1, -1);
+		}
+
+		for (i32 x = width - 1; x >= 0; x--)
+			sdfCompare(grid, width, height, x, y, 1, 0);
+	}
+
+	for (i32 y = height - 1; y >= 0; y--)
+	{
+		for (i32 x = width - 1; x >= 0; x--)
+		{
+			sdfCompare(grid, width, height, x, y, 1, 0);
+			sdfCompare(grid, width, height, x, y, 0, 1);
+			sdfCompare(grid, width, height, x, y, -1, 1);
+			sdfCompare(grid, width, height, x, y, 1, 1);
+		}
+
+		for (i32 x = 0; x < width; x++)
+			sdfCompare(grid, width, height, x, y, -1, 0);
+	}
+}
+
+/*
+   Converts a coverage bitmap into a distance field padded by padding pixels on
+   each side. Values above FONT_SDF_ON_EDGE_VALUE are inside the glyph and each
+   pixel of distance is 127/padding steps of the value.
+ */
+INTERNAL void fontGenerateSdf(MemoryArena_ *const transientArena,
+                              const u8 *const coverage, const i32 width,
+                              const i32 height, const i32 padding,
+                              u8 *const dest, const i32 destPitch)
+{
+	const i32 sdfWidth  = width + (2 * padding);
+	const i32 sdfHeight = height + (2 * padding);
+	const i32 numPoints = sdfWidth * sdfHeight;
+
+	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+
+	// NOTE(doyle): Distance to the nearest inside and outside pixel
+	SdfPoint *toInside  = MEMORY_PUSH_ARRAY(transientArena, numPoints, SdfPoint);
+	SdfPoint *toOutside = MEMORY_PUSH_ARRAY(transientArena, numPoints, SdfPoint);
+
+	const SdfPoint seed     = {0, 0};
+	const SdfPoint infinity = {FONT_SDF_INF, FONT_SDF_INF};
+	for (i32 y = 0; y < sdfHeight; y++)
+	{
+		for (i32 x = 0; x < sdfWidth; x++)
+		{
+			i32 srcX = x - padding;
+			i32 srcY = y - padding;
+
+			b32 inside = FALSE;
+			if (srcX >= 0 && srcX < width && srcY >= 0 && srcY < height)
+			{
+				inside = (coverage[srcX + (srcY * width)] >=
+				          FONT_SDF_ON_EDGE_VALUE);
+			}
+
+			i32 index          = x + (y * sdfWidth);
+			toInside[index]  = (inside) ? seed : infinity;
+			toOutside[index] = (inside) ? infinity : seed;
+		}
+	}
+
+	sdfPropagate(toInside, sdfWidth, sdfHeight);
+	sdfPropagate(toOutside, sdfWidth, sdfHeight);
+
+	const f32 distScale = 127.0f / CAST(f32) padding;
+	for (i32 y = 0; y < sdfHeight; y++)
+	{
+		u8 *destRow = dest + (y * destPitch);
+		for (i32 x = 0; x < sdfWidth; x++)
+		{
+			i32 index = x + (y * sdfWidth);
+			f32 distInside =
+			    SQRT(CAST(f32) sdfPointDistSq(toOutside[index]));
+			f32 distOutside =
+			    SQRT(CAST(f32) sdfPointDistSq(toInside[index]));
+
+			f32 value = FONT_SDF_ON_EDGE_VALUE +
+			            ((distInside - distOutside) * distScale);
+			if (value < 0.0f) value = 0.0f;
+			if (value > 255.0f) value = 255.0f;
+
+			destRow[x] = CAST(u8) value;
+		}
+	}
+
+	memory_endTempRegion(tempRegion);
+}
+
+/*
+   Rasterise every glyph of the pack at FONT_SDF_BASE_HEIGHT as a distance
+   field and shelf pack them into a single channel bitmap. Returns the bitmap
+   allocated on the transient arena, or NULL if the glyphs do not fit.
+ */
+INTERNAL u8 *fontBuildSdfAtlas(FontPack *const fontPack,
+                               const stbtt_fontinfo *const fontInfo,
+                               const v2 codepointRange,
+                               MemoryArena_ *const persistentArena,
+                               MemoryArena_ *const transientArena)
+{
+	const i32 numGlyphs = CAST(i32)(codepointRange.y - codepointRange.x);
+	const i32 pitch     = FONT_SDF_ATLAS_SIZE;
+
+	u8 *atlasBitmap =
+	    MEMORY_PUSH_ARRAY(transientArena, SQUARED(FONT_SDF_ATLAS_SIZE), u8);
+	common_memset(atlasBitmap, 0, SQUARED(FONT_SDF_ATLAS_SIZE));
+
+	fontPack->sdfGlyphRect =
+	    MEMORY_PUSH_ARRAY(persistentArena, numGlyphs, Rect);
+	fontPack->numSdfGlyphs = numGlyphs;
+
+	f32 scale = stbtt_ScaleForPixelHeight(fontInfo, FONT_SDF_BASE_HEIGHT);
+
+	/*
+	 ***************************************************
+	 * Pack glyph cells tallest first into the skyline
+	 ***************************************************
+	 */
+	i32 *packOrder = MEMORY_PUSH_ARRAY(transientArena, numGlyphs, i32);
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		i32 codepoint = CAST(i32) codepointRange.x + i;
+
+		i32 x0, y0, x1, y1;
+		stbtt_GetCodepointBitmapBox(fontInfo, codepoint, scale, scale, &x0, &y0,
+		                            &x1, &y1);
+
+		i32 cellWidth  = (x1 - x0) + (2 * FONT_SDF_PADDING);
+		i32 cellHeight = (y1 - y0) + (2 * FONT_SDF_PADDING);
+		fontPack->sdfGlyphRect[i] =
+		    CAST(Rect){V2(0, 0), V2i(cellWidth, cellHeight)};
+
+		/* Insertion sort by descending cell height */
+		i32 j = i;
+		while (j > 0 &&
+		       fontPack->sdfGlyphRect[packOrder[j - 1]].max.h < cellHeight)
+		{
+			packOrder[j] = packOrder[j - 1];
+			j--;
+		}
+		packOrder[j] = i;
+	}
+
+	RectPack pack = {0};
+	rectpack_init(&pack, transientArena, FONT_SDF_ATLAS_SIZE,
+	              FONT_SDF_ATLAS_SIZE);
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		Rect *cell = &fontPack->sdfGlyphRect[packOrder[i]];
+		if (!rectpack_insert(&pack, CAST(i32) cell->max.w,
+		                     CAST(i32) cell->max.h, &cell->min))
+		{
+			DEBUG_LOG("fontBuildSdfAtlas() failed: Glyphs exceed atlas size");
+			return NULL;
+		}
+	}
+
+	/*
+	 ***************************************************
+	 * Rasterise each glyph's distance field into place
+	 ***************************************************
+	 */
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		i32 codepoint = CAST(i32) codepointRange.x + i;
+
+		i32 width, height, xOffset, yOffset;
+		u8 *monoBitmap = stbtt_GetCodepointBitmap(
+		    fontInfo, 0, scale, codepoint, &width, &height, &xOffset, &yOffset);
+
+		Rect cell = fontPack->sdfGlyphRect[i];
+		ASSERT(cell.max.w == width + (2 * FONT_SDF_PADDING));
+		ASSERT(cell.max.h == height + (2 * FONT_SDF_PADDING));
+
+		u8 *dest = atlasBitmap + CAST(i32) cell.min.x +
+		           (CAST(i32) cell.min.y * pitch);
+		fontGenerateSdf(transientArena, monoBitmap, width, height,
+		                FONT_SDF_PADDING, dest, pitch);
+		stbtt_FreeBitmap(monoBitmap, NULL);
+	}
+
+	return atlasBitmap;
+}
+
+/*
+   NOTE(doyle): Baked font cache, the distance field atlas and glyph cells are
+   written to disk after the first rasterise so later startups skip
+   stb_truetype rasterising. The cache is keyed by font path, a hash of the
+   font file, the base size the field is generated at and the codepoint
+   range, so editing a font in place misses rather than loading a stale atlas.
+
+   Layout: FontCacheHeader, Rect[numGlyphs], u8[atlasSize * atlasSize]
+ */
+#define FONT_CACHE_MAGIC 0x48434644 // "DFCH"
+#define FONT_CACHE_VERSION 2
+
+typedef struct FontCacheHeader
+{
+	u32 magic;
+	u32 version;
+	u64 key;
+
+	u64 ttfHash;
+	i32 ttfSize;
+	i32 baseHeight;
+	i32 padding;
+	i32 atlasSize;
+
+	i32 codepointMin;
+	i32 codepointMax;
+	i32 numGlyphs;
+	i32 unused;
+} FontCacheHeader;
+
+INTERNAL FontCacheHeader fontCacheHeaderMake(const char *const filePath,
+                                             const u8 *const ttfData,
+                                             const i32 ttfSize,
+                                             const v2 codepointRange)
+{
+	u64 ttfHash = common_murmurHash64A(ttfData, ttfSize, RANDOM_SEED);
+
+	FontCacheHeader result = {0};
+	result.magic           = FONT_CACHE_MAGIC;
+	result.version         = FONT_CACHE_VERSION;
+	result.ttfHash         = ttfHash;
+	result.ttfSize         = ttfSize;
+	result.baseHeight      = FONT_SDF_BASE_HEIGHT;
+	result.padding         = FONT_SDF_PADDING;
+	result.atlasSize       = FONT_SDF_ATLAS_SIZE;
+	result.codepointMin    = CAST(i32) codepointRange.x;
+	result.codepointMax    = CAST(i32) codepointRange.y;
+	result.numGlyphs       = result.codepointMax - result.codepointMin;
+
+	// NOTE(doyle): Hash the path, then the file hash and parameters seeded by
+	// the path
+	u64 pathHash = asset_keyHash(filePath);
+	result.key   = common_murmurHash64A(
+	    &result.ttfHash, sizeof(u64) + (sizeof(i32) * 7), pathHash);
+	return result;
+}
+
+INTERNAL void fontCacheGetPath(const FontCacheHeader *const header,
+                               char *const buffer, const i32 bufferSize)
+{
+	const char *const prefix = "data/font_cache_";
+	const char *const suffix = ".bin";
+	const char *const hexDigits = "0123456789abcdef";
+
+	/* Key as 16 hex digits */
+	char keyString[17] = {0};
+	for (i32 i = 0; i < 16; i++)
+	{
+		u32 nibble   = CAST(u32)(header->key >> (60 - (i * 4))) & 0xF;
+		keyString[i] = hexDigits[nibble];
+	}
+
+	ASSERT(common_strlen(prefix) + 16 + common_strlen(suffix) < bufferSize);
+	common_memset(CAST(u8 *) buffer, 0, bufferSize);
+	common_strncat(buffer, prefix, common_strlen(prefix));
+	common_strncat(buffer, keyString, 16);
+	common_strncat(buffer, suffix, common_strlen(suffix));
+}
+
+/* Returns the cached atlas bitmap, on the transient arena or in the asset pack
+ * mapping, or NULL on a miss */
+INTERNAL u8 *fontCacheLoad(AssetManager *const assetManager,
+                           FontPack *const fontPack,
+                           const FontCacheHeader *const expected,
+                           MemoryArena_ *const persistentArena,
+                           MemoryArena_ *const transientArena)
+{
+	char cachePath[128] = {0};
+	fontCacheGetPath(expected, cachePath, ARRAY_COUNT(cachePath));
+
+	PlatformFileRead cacheRead = {0};
+	if (assetReadFile(assetManager, transientArena, cachePath, &cacheRead))
+		return NULL;
+
+	i32 rectSize   = expected->numGlyphs * sizeof(Rect);
+	i32 bitmapSize = SQUARED(expected->atlasSize);
+	if (cacheRead.size != sizeof(FontCacheHeader) + rectSize + bitmapSize)
+		return NULL;
+
+	u8 *data = CAST(u8 *) cacheRead.buffer;
+	FontCacheHeader *header = CAST(FontCacheHeader *) data;
+	for (i32 i = 0; i < sizeof(FontCacheHeader); i++)
+	{
+		if (data[i] != (CAST(u8 *) expected)[i])
+		{
+			DEBUG_LOG("fontCacheLoad() warning: Font cache is stale");
+			return NULL;
+		}
+	}
+
+	data += sizeof(FontCacheHeader);
+	fontPack->sdfGlyphRect =
+	    MEMORY_PUSH_ARRAY(persistentArena, header->numGlyphs, Rect);
+	fontPack->numSdfGlyphs = header->numGlyphs;
+	common_memcpy(CAST(u8 *) fontPack->sdfGlyphRect, data, rectSize);
+
+	data += rectSize;
+	return data;
+}
+
+INTERNAL void fontCacheWrite(FontPack *const fontPack,
+                             const FontCacheHeader *const header,
+                             const u8 *const atlasBitmap,
+                             MemoryArena_ *const transientArena)
+{
+	i32 rectSize   = header->numGlyphs * sizeof(Rect);
+	i32 bitmapSize = SQUARED(header->atlasSize);
+	i32 cacheSize  = sizeof(FontCacheHeader) + rectSize + bitmapSize;
+
+	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+	u8 *cache = MEMORY_PUSH_ARRAY(transientArena, cacheSize, u8);
+
+	u8 *data = cache;
+	common_memcpy(data, CAST(u8 *) header, sizeof(FontCacheHeader));
+	data += sizeof(FontCacheHeader);
+	common_memcpy(data, CAST(u8 *) fontPack->sdfGlyphRect, rectSize);
+	data += rectSize;
+	common_memcpy(data, atlasBitmap, bitmapSize);
+
+	char cachePath[128] = {0};
+	fontCacheGetPath(header, cachePath, ARRAY_COUNT(cachePath));
+	if (platform_writeBufferToFile(cachePath, cache, cacheSize))
+		DEBUG_LOG("fontCacheWrite() warning: Could not write font cache");
+
+	memory_endTempRegion(tempRegion);
+}
+
+/* Compute metrics of the pack's glyphs at the target size, no rasterising */
+INTERNAL void fontInitSize(Font *const font, FontPack *const fontPack,
+                           const stbtt_fontinfo *const fontInfo,
+                           MemoryArena_ *const persistentArena,
+                           MemoryArena_ *const transientArena,
+                           const i32 targetFontHeight)
+{
+	font->codepointRange = V2i(32, 127);
+	v2 codepointRange    = font->codepointRange;
+	const i32 numGlyphs  = CAST(i32)(codepointRange.y - codepointRange.x);
+	ASSERT(numGlyphs == fontPack->numSdfGlyphs);
+
+	font->fontHeight = targetFontHeight;
+	font->atlas      = fontPack->sdfAtlas;
+	f32 scaleY = stbtt_ScaleForPixelHeight(fontInfo, (f32)targetFontHeight);
+
+	i32 ascent, descent, lineGap;
+	stbtt_GetFontVMetrics(fontInfo, &ascent, &descent, &lineGap);
+
+	ascent  = CAST(i32)(ascent * scaleY);
+	descent = CAST(i32)(descent * scaleY);
+	lineGap = CAST(i32)(lineGap * scaleY);
+
+	font->metrics = CAST(FontMetrics){ascent, descent, lineGap};
+
+	font->charMetrics =
+	    memory_pushBytes(persistentArena, numGlyphs * sizeof(CharMetrics));
+	font->numCharMetrics = numGlyphs;
+
+	v2 largestGlyphDimension = V2(0, 0);
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		i32 codepoint = CAST(i32) codepointRange.x + i;
+
+		// NOTE(doyle): Same box stbtt_GetCodepointBitmap would rasterise
+		i32 x0, y0, x1, y1;
+		stbtt_GetCodepointBitmapBox(fontInfo, codepoint, scaleY, scaleY, &x0,
+		                            &y0, &x1, &y1);
+
+		i32 advance, leftSideBearing;
+		stbtt_GetCodepointHMetrics(fontInfo, codepoint, &advance,
+		                           &leftSideBearing);
+
+		advance         = CAST(i32)(advance * scaleY);
+		leftSideBearing = CAST(i32)(leftSideBearing * scaleY);
+
+		i32 width  = x1 - x0;
+		i32 height = y1 - y0;
+		font->charMetrics[i] =
+		    CAST(CharMetrics){advance, leftSideBearing, NULL, V2i(x0, y0),
+		                      V2i(width, height)};
+
+		if (height > CAST(f32)largestGlyphDimension.h)
+			largestGlyphDimension.h = CAST(f32)height;
+		if (width > CAST(f32)largestGlyphDimension.w)
+			largestGlyphDimension.w = CAST(f32)width;
+	}
+
+	font->maxSize = largestGlyphDimension;
+
+	/*
+	   NOTE(doyle): The quad is placed so the glyph's top left lands where the
+	   per size bitmap atlas used to put it, relative to the text baseline
+	 */
+	f32 sdfScale = CAST(f32) targetFontHeight / FONT_SDF_BASE_HEIGHT;
+	f32 padding  = FONT_SDF_PADDING * sdfScale;
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		CharMetrics *metric = &font->charMetrics[i];
+		metric->texRect     = fontPack->sdfGlyphRect[i];
+		metric->quadSize    = v2_scale(metric->texRect.max, sdfScale);
+		metric->quadOffset =
+		    V2(-padding, (font->maxSize.h - metric->offset.y + padding) -
+		                     metric->quadSize.h);
+	}
+
+	// NOTE(doyle): Formula derived from STB Font
+	font->verticalSpacing =
+	    font->metrics.ascent - font->metrics.descent + font->metrics.lineGap;
+
+	/*
+	 *******************************************
+	 * Build kerning table for every glyph pair
+	 *******************************************
+	 */
+	i32 *kerningTable =
+	    MEMORY_PUSH_ARRAY(persistentArena, numGlyphs * numGlyphs, i32);
+	common_memset(CAST(u8 *) kerningTable, 0,
+	              numGlyphs * numGlyphs * sizeof(i32));
+
+	// NOTE(doyle): Resolve glyph indexes once instead of per pair lookup
+	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+	i32 *stbGlyphIndexes  = MEMORY_PUSH_ARRAY(transientArena, numGlyphs, i32);
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		i32 codepoint      = CAST(i32) codepointRange.x + i;
+		stbGlyphIndexes[i] = stbtt_FindGlyphIndex(fontInfo, codepoint);
+	}
+
+	for (i32 i = 0; i < numGlyphs; i++)
+	{
+		i32 *kerningRow              = &kerningTable[i * numGlyphs];
+		font->charMetrics[i].kerning = kerningRow;
+
+		// NOTE(doyle): No kerning table in font, leave the table zeroed
+		if (!fontInfo->kern) continue;
+
+		for (i32 j = 0; j < numGlyphs; j++)
+		{
+			i32 kern = stbtt_GetGlyphKernAdvance(fontInfo, stbGlyphIndexes[i],
+			                                     stbGlyphIndexes[j]);
+			kerningRow[j] = CAST(i32)(kern * scaleY);
+		}
+	}
+	memory_endTempRegion(tempRegion);
+}
+
+/* Returns the atlas bitmap from the font cache, or builds and caches it */
+INTERNAL u8 *fontLoadSdfBitmap(AssetManager *const assetManager,
+                               FontPack *const fontPack,
+                               const stbtt_fontinfo *const fontInfo,
+                               MemoryArena_ *const persistentArena,
+                               MemoryArena_ *const transientArena)
+{
+	v2 codepointRange           = V2i(32, 127);
+	FontCacheHeader cacheHeader = fontCacheHeaderMake(
+	    fontPack->filePath, fontPack->ttfData, fontPack->ttfSize,
+	    codepointRange);
+	u8 *result = fontCacheLoad(assetManager, fontPack, &cacheHeader,
+	                           persistentArena, transientArena);
+	if (!result)
+	{
+		result = fontBuildSdfAtlas(fontPack, fontInfo, codepointRange,
+		                           persistentArena, transientArena);
+		if (result)
+			fontCacheWrite(fontPack, &cacheHeader, result, transientArena);
+	}
+
+	return result;
+}
+
+INTERNAL void fontUploadSdfAtlas(FontPack *const fontPack,
+                                 const u8 *const sdfBitmap,
+                                 MemoryArena_ *const persistentArena)
+{
+	Texture *tex = MEMORY_PUSH_STRUCT(persistentArena, Texture);
+	*tex = textureGen(FONT_SDF_ATLAS_SIZE, FONT_SDF_ATLAS_SIZE,
+	                  bytesPerPixel_Greyscale, sdfBitmap);
+
+#ifdef WT_RENDER_FONT_FILE
+	stbi_write_png("out.png", FONT_SDF_ATLAS_SIZE, FONT_SDF_ATLAS_SIZE, 1,
+	               sdfBitmap, FONT_SDF_ATLAS_SIZE);
+#endif
+
+	// NOTE(doyle): The atlas is owned by the font pack and not registered in
+	// the asset tables, glyph cells live in the char metrics
+	TexAtlas *fontAtlas = MEMORY_PUSH_STRUCT(persistentArena, TexAtlas);
+	fontAtlas->tex      = tex;
+	fontPack->sdfAtlas  = fontAtlas;
+}
+
+const i32 asset_fontLoadTTF(AssetManager *assetManager,
+                           MemoryArena_ *persistentArena,
+                           MemoryArena_ *transientArena, char *filePath,
+                           const enum FontList type, i32 targetFontHeight)
+{
+	/*
+	 ****************************************
+	 * Initialise assetmanager font reference
+	 ****************************************
+	 */
+	ASSERT(type < fontlist_count);
+	FontPack *fontPack = &assetManager->fontPack[type];
+	if (asset_fontGet(assetManager, type, targetFontHeight)) return 0;
+
+	if (fontPack->loadQueued)
+	{
+		DEBUG_LOG("asset_fontLoadTTF() failed: Font pack is loading async");
+		return -1;
+	}
+
+	if (!fontPack->ttfData)
+	{
+		// NOTE(doyle): Font file is kept resident so new sizes can be created
+		// on demand without touching the disk
+		PlatformFileRead fontFileRead = {0};
+		i32 result = assetReadFile(assetManager, persistentArena, filePath,
+		                           &fontFileRead);
+		if (result) return result;
+
+		fontPack->filePath = filePath;
+		fontPack->ttfData  = CAST(u8 *) fontFileRead.buffer;
+		fontPack->ttfSize  = fontFileRead.size;
+	}
+
+	stbtt_fontinfo fontInfo = {0};
+	stbtt_InitFont(&fontInfo, fontPack->ttfData,
+	               stbtt_GetFontOffsetForIndex(fontPack->ttfData, 0));
+
+	/*
+	 *************************************************
+	 * Generate the distance field atlas on first load
+	 *************************************************
+	 */
+	if (!fontPack->sdfAtlas)
+	{
+		TempMemory tempRegion = memory_beginTempRegion(transientArena);
+
+		u8 *sdfBitmap = fontLoadSdfBitmap(assetManager, fontPack, &fontInfo,
+		                                  persistentArena, transientArena);
+		if (!sdfBitmap)
+		{
+			memory_endTempRegion(tempRegion);
+			return -1;
+		}
+
+		fontUploadSdfAtlas(fontPack, sdfBitmap, persistentArena);
+		memory_endTempRegion(tempRegion);
+	}
+
+	if (fontPack->fontIndex >= ARRAY_COUNT(fontPack->font))
+	{
+		DEBUG_LOG("asset_fontLoadTTF() failed: Font pack has no free sizes");
+		return -1;
+	}
+
+	Font *font = &fontPack->font[fontPack->fontIndex++];
+	fontInitSize(font, fontPack, &fontInfo, persistentArena, transientArena,
+	             targetFontHeight);
+
+	return 0;
+}
+
+const v2 asset_fontStringDimInPixels(const Font *const font,
+                                     const char *const string)
+{
+	v2 stringDim = V2(0, 0);
+	i32 strLen   = common_strlen(string);
+	for (i32 i = 0; i < strLen; i++)
+	{
+		// NOTE(doyle): Placeholder fonts have no glyphs and measure as empty
+		const CharMetrics *metric = asset_fontGetCharMetrics(font, string[i]);
+		if (!metric) continue;
+
+		i32 nextCodepoint = (i + 1 < strLen) ? string[i + 1] : 0;
+		stringDim.x += asset_fontPenAdvance(font, metric, nextCodepoint);
+		stringDim.y  = MAX(metric->trueSize.y, stringDim.y);
+	}
+
+	return stringDim;
+}
+
+/*
+ *********************************
+ * Hot Reload
+ *********************************
+ */
+i32 asset_hotReloadInit(AssetManager *const assetManager,
+                        const char *const directory)
+{
+	AssetHotReload *hotReload = &assetManager->hotReload;
+	if (platform_fileWatchInit(&hotReload->watch, directory)) return -1;
+
+	hotReload->enabled = TRUE;
+	return 0;
+}
+
+/* Paths may be written with either separator */
+INTERNAL b32 hotReloadPathEquals(const char *a, const char *b)
+{
+	if (!a || !b) return FALSE;
+
+	for (; *a && *b; a++, b++)
+	{
+		char charA = (*a == '\\') ? '/' : *a;
+		char charB = (*b == '\\') ? '/' : *b;
+		if (charA != charB) return FALSE;
+	}
+
+	b32 result = (*a == *b);
+	return result;
+}
+
+INTERNAL void hotReloadFileChanged(void *userData, const char *const path)
+{
+	AssetHotReload *hotReload = CAST(AssetHotReload *) userData;
+	f64 now                   = platform_getTimeInSeconds();
+
+	/* Saves report a file more than once, restart its settle time */
+	for (i32 i = 0; i < hotReload->numPending; i++)
+	{
+		AssetHotReloadPending *pending = &hotReload->pending[i];
+		if (hotReloadPathEquals(pending->path, path))
+		{
+			pending->lastChangeTime = now;
+			return;
+		}
+	}
+
+	if (hotReload->numPending >= ARRAY_COUNT(hotReload->pending))
+	{
+		DEBUG_LOG("hotReloadFileChanged() warning: Too many changed files");
+		return;
+	}
+
+	i32 pathLen = common_strlen(path);
+	if (pathLen >= ARRAY_COUNT(hotReload->pending[0].path)) return;
+
+	AssetHotReloadPending *pending =
+	    &hotReload->pending[hotReload->numPending++];
+	common_strncpy(pending->path, path, pathLen);
+	pending->path[pathLen]  = 0;
+	pending->lastChangeTime = now;
+}
+
+INTERNAL b32 shaderIsCompiled(const GLuint shader)
+{
+	if (!glIsShader(shader)) return FALSE;
+
+	GLint success = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	return (success == GL_TRUE);
+}
+
+/*
+   NOTE(doyle): The new sources are linked in a scratch program first, only if
+   that succeeds is the live program relinked, so a typo keeps the old shader.
+   Relinking keeps the program id but resets its uniforms.
+ */
+INTERNAL i32 hotReloadShader(AssetManager *const assetManager,
+                             MemoryArena_ *const transientArena,
+                             const enum ShaderList type)
+{
+	char **paths = assetManager->hotReload.shaderPath[type];
+
+	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+	GLuint vertexShader   = createShaderFromPath(assetManager, transientArena,
+	                                           paths[0], GL_VERTEX_SHADER);
+	GLuint fragmentShader = createShaderFromPath(
+	    assetManager, transientArena, paths[1], GL_FRAGMENT_SHADER);
+	memory_endTempRegion(tempRegion);
+
+	GLint linked = GL_FALSE;
+	if (shaderIsCompiled(vertexShader) && shaderIsCompiled(fragmentShader))
+	{
+		GLuint scratch = glCreateProgram();
+		glAttachShader(scratch, vertexShader);
+		glAttachShader(scratch, fragmentShader);
+		glLinkProgram(scratch);
+		glGetProgramiv(scratch, GL_LINK_STATUS, &linked);
+		if (!linked)
+		{
+			GLchar infoLog[512];
+			glGetProgramInfoLog(scratch, 512, NULL, infoLog);
+			printf("glLinkProgram() failed: %s\n", infoLog);
+		}
+		glDeleteProgram(scratch);
+	}
+
+	if (linked)
+	{
+		GLuint program = assetManager->shaders[type];
+		GLuint attached[4];
+		GLsizei numAttached = 0;
+		glGetAttachedShaders(program, ARRAY_COUNT(attached), &numAttached,
+		                     attached);
+		for (i32 i = 0; i < numAttached; i++)
+			glDetachShader(program, attached[i]);
+
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+	}
+
+	// NOTE(doyle): Attached shaders are only flagged and freed on detach
+	if (glIsShader(vertexShader)) glDeleteShader(vertexShader);
+	if (glIsShader(fragmentShader)) glDeleteShader(fragmentShader);
+	GL_CHECK_ERROR();
+
+	i32 result = (linked) ? 0 : -1;
+	return result;
+}
+
+INTERNAL i32 hotReloadTexture(AssetManager *const assetManager,
+                              MemoryArena_ *const transientArena,
+                              Texture *const tex)
+{
+	// NOTE(doyle): Evicted, the next use loads the new file
+	tex->loose = TRUE;
+	if (tex->id == 0) return 0;
+
+	Texture reloaded = {0};
+	if (textureLoad(assetManager, transientArena, tex->path, TRUE, &reloaded))
+		return -1;
+
+	/* Ids that cover the whole texture follow its new size */
+	for (i32 i = 0; i < texlist_count; i++)
+	{
+		Rect *region = &assetManager->texListRegion[i];
+		if (assetManager->texList[i] == tex &&
+		    region->max.w == tex->width && region->max.h == tex->height)
+		{
+			region->max = V2i(reloaded.width, reloaded.height);
+		}
+	}
+
+	TexResidency *residency = &assetManager->texResidency;
+	residency->residentInBytes -= tex->sizeInBytes;
+	residency->residentInBytes += reloaded.sizeInBytes;
+
+	glDeleteTextures(1, &tex->id);
+	reloaded.path          = tex->path;
+	reloaded.loose         = TRUE;
+	reloaded.lastUsedFrame = tex->lastUsedFrame;
+	*tex                   = reloaded;
+	return 0;
+}
+
+INTERNAL i32 hotReloadSheet(AssetManager *const assetManager,
+                            MemoryArena_ *const persistentArena,
+                            MemoryArena_ *const transientArena,
+                            const char *const xmlPath)
+{
+	i32 result = asset_sheetLoad(assetManager, persistentArena,
+	                             transientArena, xmlPath);
+	if (result) return result;
+
+	/* Sprites may have moved or resized, resolve ids remapped into sheets */
+	for (i32 i = 0; i < texlist_count; i++)
+	{
+		char *sprite = assetManager->texListSheetSprite[i];
+		if (!sprite || texListResolveSheet(assetManager, i, sprite)) continue;
+
+		printf("hotReloadSheet() warning: %s is no longer in a sheet\n",
+		       sprite);
+		assetManager->texList[i] = assetManager->texList[texlist_null];
+		assetManager->texListRegion[i] =
+		    assetManager->texListRegion[texlist_null];
+	}
+
+	/* Sub texture indexes may have moved, resolve the animation frames */
+	HashTable *anims = &assetManager->anims;
+	for (i32 i = 0; i < anims->size; i++)
+	{
+		Animation *anim = CAST(Animation *) anims->entries[i].data;
+		if (!anims->entries[i].key || !anim) continue;
+
+		for (i32 frame = 0; frame < anim->numFrames; frame++)
+		{
+			anim->frameSubTexList[frame] =
+			    asset_atlasGetSubTexIndex(anim->atlas, anim->frameList[frame]);
+		}
+	}
+
+	return 0;
+}
+
+/*
+   NOTE(doyle): The atlas texture and char metrics are rebuilt into the
+   existing memory, Font copies held by the game keep valid pointers
+ */
+INTERNAL i32 hotReloadFont(AssetManager *const assetManager,
+                           FontPack *const fontPack,
+                           MemoryArena_ *const persistentArena,
+                           MemoryArena_ *const transientArena)
+{
+	if (fontPack->loadQueued || !fontPack->sdfAtlas) return -1;
+
+	PlatformFileRead fontFileRead = {0};
+	if (assetReadFile(assetManager, persistentArena, fontPack->filePath,
+	                  &fontFileRead))
+		return -1;
+
+	stbtt_fontinfo fontInfo = {0};
+	u8 *ttfData             = CAST(u8 *) fontFileRead.buffer;
+	if (!stbtt_InitFont(&fontInfo, ttfData,
+	                    stbtt_GetFontOffsetForIndex(ttfData, 0)))
+		return -1;
+
+	fontPack->ttfData = ttfData;
+	fontPack->ttfSize = fontFileRead.size;
+
+	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+	v2 codepointRange     = V2i(32, 127);
+	u8 *sdfBitmap = fontBuildSdfAtlas(fontPack, &fontInfo, codepointRange,
+	                                  persistentArena, transientArena);
+	if (!sdfBitmap)
+	{
+		memory_endTempRegion(tempRegion);
+		return -1;
+	}
+
+	FontCacheHeader cacheHeader = fontCacheHeaderMake(
+	    fontPack->filePath, fontPack->ttfData, fontPack->ttfSize,
+	    codepointRange);
+	fontCacheWrite(fontPack, &cacheHeader, sdfBitmap, transientArena);
+
+	Texture *tex = fontPack->sdfAtlas->tex;
+	glDeleteTextures(1, &tex->id);
+	*tex = textureGen(FONT_SDF_ATLAS_SIZE, FONT_SDF_ATLAS_SIZE,
+	                  bytesPerPixel_Greyscale, sdfBitmap);
+	memory_endTempRegion(tempRegion);
+
+	for (i32 i = 0; i < fontPack->fontIndex; i++)
+	{
+		Font *font               = &fontPack->font[i];
+		CharMetrics *charMetrics = font->charMetrics;
+		fontInitSize(font, fontPack, &fontInfo, persistentArena,
+		             transientArena, font->fontHeight);
+
+		common_memcpy(CAST(u8 *) charMetrics, CAST(u8 *) font->charMetrics,
+		              font->numCharMetrics * sizeof(CharMetrics));
+		font->charMetrics = charMetrics;
+	}
+
+	return 0;
+}
+
+/* Rebuild every entry loaded from the path, returns the number rebuilt */
+INTERNAL i32 hotReloadPath(AssetManager *const assetManager,
+                           MemoryArena_ *const persistentArena,
+                           MemoryArena_ *const transientArena,
+                           const char *const path)
+{
+	AssetHotReload *hotReload = &assetManager->hotReload;
+	i32 numRebuilt            = 0;
+	i32 numFailed             = 0;
+
+	for (i32 i = 0; i < shaderlist_count; i++)
+	{
+		if (hotReloadPathEquals(hotReload->shaderPath[i][0], path) ||
+		    hotReloadPathEquals(hotReload->shaderPath[i][1], path))
+		{
+			if (hotReloadShader(assetManager, transientArena, i)) numFailed++;
+			else numRebuilt++;
+		}
+	}
+
+	TexResidency *residency = &assetManager->texResidency;
+	for (i32 i = 0; i < residency->numTextures; i++)
+	{
+		Texture *tex = residency->textures[i];
+		if (hotReloadPathEquals(tex->path, path))
+		{
+			if (hotReloadTexture(assetManager, transientArena, tex))
+				numFailed++;
+			else numRebuilt++;
+		}
+	}
+
+	for (i32 i = 0; i < hotReload->numSheetPaths; i++)
+	{
+		if (hotReloadPathEquals(hotReload->sheetPath[i], path))
+		{
+			if (hotReloadSheet(assetManager, persistentArena, transientArena,
+			                   path))
+				numFailed++;
+			else numRebuilt++;
+		}
+	}
+
+	for (i32 i = 0; i < fontlist_count; i++)
+	{
+		FontPack *fontPack = &assetManager->fontPack[i];
+		if (hotReloadPathEquals(fontPack->filePath, path))
+		{
+			if (hotReloadFont(assetManager, fontPack, persistentArena,
+			                  transientArena))
+				numFailed++;
+			else numRebuilt++;
+		}
+	}
+
+	if (numFailed)
+		printf("asset_hotReloadUpdate() failed: Could not rebuild %s\n", path);
+	else if (numRebuilt)
+		printf("asset_hotReloadUpdate(): Rebuilt %s\n", path);
+
+	hotReload->numReloads += numRebuilt;
+	hotReload->numFailed += numFailed;
+	return numRebuilt;
+}
+
+i32 asset_hotReloadUpdate(AssetManager *const assetManager,
+                          MemoryArena_ *const persistentArena,
+                          MemoryArena_ *const transientArena)
+{
+	AssetHotReload *hotReload = &assetManager->hotReload;
+	if (!hotReload->enabled) return 0;
+
+	platform_fileWatchPoll(&hotReload->watch, hotReloadFileChanged,
+	                       hotReload);
+
+	// NOTE(doyle): Editors write in several steps, wait for the file to settle
+	f64 now    = platform_getTimeInSeconds();
+	i32 result = 0;
+	hotReload->reading = TRUE;
+	for (i32 i = 0; i < hotReload->numPending;)
+	{
+		AssetHotReloadPending *pending = &hotReload->pending[i];
+		if (now - pending->lastChangeTime < ASSET_HOT_RELOAD_SETTLE_SECONDS)
+		{
+			i++;
+			continue;
+		}
+
+		result += hotReloadPath(assetManager, persistentArena, transientArena,
+		                        pending->path);
+		*pending = hotReload->pending[--hotReload->numPending];
+	}
+	hotReload->reading = FALSE;
+
+	return result;
+}
+
+/*
+ *********************************
+ * Asynchronous Loading
+ *********************************
+ */
+// NOTE(doyle): Each worker owns its arenas. Decoded data that outlives the job
+// (vorbis and ttf files) goes on the persistent arena, scratch is reset per
+// job. Bitmaps waiting on upload are heap allocated and freed on upload.
+#define ASSET_LOAD_WORKER_PERSISTENT_SIZE MEGABYTES(4)
+#define ASSET_LOAD_WORKER_TRANSIENT_SIZE MEGABYTES(2)
+
+typedef struct AssetLoadWorker
+{
+	AssetManager *assetManager;
+	MemoryArena_ persistentArena;
+	MemoryArena_ transientArena;
+	PlatformFileReader reader;
+} AssetLoadWorker;
+
+/*
+   NOTE(doyle): Texture files are only needed until decoded so are read to the
+   worker's scratch, audio and font files stay resident on its persistent
+   arena. Only resident files are read in batches, a batch of textures could
+   outgrow the scratch arena.
+ */
+INTERNAL MemoryArena_ *loadJobGetReadArena(AssetLoadWorker *const worker,
+                                           const AssetLoadJob *const job)
+{
+	MemoryArena_ *result = (job->type == assetloadtype_texture)
+	                           ? &worker->transientArena
+	                           : &worker->persistentArena;
+	return result;
+}
+
+/* Decode the job's file and publish the result, readResult 0 on success */
+INTERNAL void loadJobDecode(AssetManager *const assetManager,
+                            AssetLoadWorker *const worker,
+                            AssetLoadJob *const job,
+                            const PlatformFileRead *const fileRead,
+                            const i32 readResult)
+{
+	MemoryArena_ *persistentArena = &worker->persistentArena;
+	MemoryArena_ *transientArena  = &worker->transientArena;
+	TempMemory tempRegion         = memory_beginTempRegion(transientArena);
+
+	i32 result = -1;
+	if (readResult == 0)
+	{
+		switch (job->type)
+		{
+		case assetloadtype_texture:
+		{
+			// NOTE(doyle): Texture files upload as is, copy them out of the
+			// read buffer which is only valid for the job
+			if (texcompress_getFileHeader(fileRead->buffer, fileRead->size))
+			{
+				job->texFileSize = fileRead->size;
+				job->pixels =
+				    CAST(u8 *) platform_memoryAlloc(NULL, fileRead->size);
+				if (job->pixels)
+				{
+					common_memcpy(job->pixels, CAST(u8 *) fileRead->buffer,
+					              fileRead->size);
+					result = 0;
+				}
+				break;
+			}
+
+			// NOTE(doyle): stb_image's flip flag is global, async textures are
+			// always loaded flipped for GL the same as asset_texLoadImage
+			job->pixels = stbi_load_from_memory(
+			    CAST(u8 *) fileRead->buffer, fileRead->size, &job->width,
+			    &job->height, &job->bytesPerPixel, 0);
+
+			if (job->pixels) result = 0;
+			else printf("stbi_load_from_memory() failed: %s\n", job->path);
+		}
+		break;
+
+		case assetloadtype_audio:
+		{
+			i32 error;
+			f64 startTime      = platform_getTimeInSeconds();
+			AudioVorbis *audio = &job->vorbis;
+			audio->file = stb_vorbis_open_memory(CAST(u8 *) fileRead->buffer,
+			                                     fileRead->size, &error, NULL);
+			if (!audio->file)
+			{
+				printf("stb_vorbis_open_memory() failed: Error code %d\n",
+				       error);
+				break;
+			}
+
+			stb_vorbis *file       = audio->file;
+			audio->info            = stb_vorbis_get_info(file);
+			audio->lengthInSamples = stb_vorbis_stream_length_in_samples(file);
+			audio->lengthInSeconds = stb_vorbis_stream_length_in_seconds(file);
+			audio->data            = CAST(u8 *) fileRead->buffer;
+			audio->size            = fileRead->size;
+			result                 = 0;
+
+			if (vorbisDecodePcm(audio, job->audioDecode))
+				printf("loadJobDecode() warning: %s kept compressed\n",
+				       job->path);
+
+			job->decodeInMs = CAST(f32)(
+			    (platform_getTimeInSeconds() - startTime) * 1000.0f);
+		}
+		break;
+
+		case assetloadtype_font:
+		{
+			// NOTE(doyle): Another size of a font already loaded keeps the
+			// first copy of the file
+			FontPack *fontPack = &assetManager->fontPack[job->id];
+			if (!fontPack->ttfData)
+			{
+				fontPack->ttfData = CAST(u8 *) fileRead->buffer;
+				fontPack->ttfSize = fileRead->size;
+			}
+
+			stbtt_fontinfo fontInfo = {0};
+			stbtt_InitFont(&fontInfo, fontPack->ttfData,
+			               stbtt_GetFontOffsetForIndex(fontPack->ttfData, 0));
+
+			u8 *sdfBitmap = fontLoadSdfBitmap(assetManager, fontPack, &fontInfo,
+			                                  persistentArena, transientArena);
+			if (!sdfBitmap) break;
+
+			i32 bitmapSize     = SQUARED(FONT_SDF_ATLAS_SIZE);
+			job->width         = FONT_SDF_ATLAS_SIZE;
+			job->height        = FONT_SDF_ATLAS_SIZE;
+			job->bytesPerPixel = bytesPerPixel_Greyscale;
+			job->pixels = CAST(u8 *) platform_memoryAlloc(NULL, bitmapSize);
+			if (!job->pixels) break;
+
+			common_memcpy(job->pixels, sdfBitmap, bitmapSize);
+			result = 0;
+		}
+		break;
+
+		default:
+		{
+			ASSERT(INVALID_CODE_PATH);
+		}
+		break;
+		}
+	}
+	memory_endTempRegion(tempRegion);
+
+	// NOTE(doyle): Publishes the job, the swap is a full barrier so the
+	// decoded data is visible to the main thread before the new state
+	i32 newState =
+	    (result == 0) ? assetloadstate_decoded : assetloadstate_failed;
+	platform_atomicCompareSwap(&job->state, newState,
+	                           assetloadstate_decoding);
+}
+
+typedef struct LoadBatch
+{
+	AssetManager *assetManager;
+	AssetLoadWorker *worker;
+	AssetLoadJob *jobs[ASSET_LOAD_BATCH_SIZE];
+} LoadBatch;
+
+INTERNAL void loadBatchReadComplete(void *userData, i32 index,
+                                    PlatformFileRead *file, i32 result)
+{
+	LoadBatch *batch = CAST(LoadBatch *) userData;
+	loadJobDecode(batch->assetManager, batch->worker, batch->jobs[index], file,
+	              result);
+}
+
+/*
+   NOTE(doyle): Claims the next queued job along with the run of queued jobs
+   of the same type behind it, so a load group has all its reads in flight at
+   once and each file is decoded as its read completes. Returns FALSE if there
+   was nothing to claim.
+ */
+INTERNAL b32 loadQueueDoNextJobs(AssetManager *const assetManager,
+                                 AssetLoadWorker *const worker)
+{
+	AssetLoadQueue *queue = &assetManager->loadQueue;
+
+	i32 jobIndex     = queue->nextJobToRead;
+	i32 numAvailable = queue->nextJobToWrite - jobIndex;
+	if (numAvailable <= 0) return FALSE;
+
+	// NOTE(doyle): Types are read before the claim, the swap fails if another
+	// worker took any of these jobs in the meantime
+	const i32 mask     = ASSET_LOAD_MAX_JOBS - 1;
+	AssetLoadJob *head = &queue->jobs[jobIndex & mask];
+	i32 numJobs        = 1;
+
+	// NOTE(doyle): Decoding a clip to PCM costs far more than reading it,
+	// those are claimed one at a time so the workers split the decoding
+	b32 claimRun = (head->type != assetloadtype_texture);
+	if (head->type == assetloadtype_audio)
+		claimRun = (head->audioDecode == audiodecode_compressed);
+
+	if (claimRun)
+	{
+		while (numJobs < numAvailable && numJobs < ASSET_LOAD_BATCH_SIZE)
+		{
+			AssetLoadJob *next = &queue->jobs[(jobIndex + numJobs) & mask];
+			if (next->type != head->type) break;
+			if (next->type == assetloadtype_audio &&
+			    next->audioDecode != audiodecode_compressed)
+				break;
+			numJobs++;
+		}
+	}
+
+	if (platform_atomicCompareSwap(&queue->nextJobToRead, jobIndex + numJobs,
+	                               jobIndex) != jobIndex)
+	{
+		return TRUE;
+	}
+
+	MemoryArena_ *transientArena = &worker->transientArena;
+	memory_arenaInit(transientArena, transientArena->base,
+	                 transientArena->size);
+
+	/* Files in the asset pack need no read, decode those straight away */
+	LoadBatch batch = {0};
+	batch.assetManager = assetManager;
+	batch.worker       = worker;
+
+	const char *paths[ASSET_LOAD_BATCH_SIZE];
+	PlatformFileRead files[ASSET_LOAD_BATCH_SIZE];
+	i32 numReads = 0;
+	for (i32 i = 0; i < numJobs; i++)
+	{
+		AssetLoadJob *job = &queue->jobs[(jobIndex + i) & mask];
+		job->state        = assetloadstate_decoding;
+
+		PlatformFileRead packFile = {0};
+		if (asset_packGetFile(assetManager, job->path, &packFile))
+		{
+			loadJobDecode(assetManager, worker, job, &packFile, 0);
+		}
+		else
+		{
+			batch.jobs[numReads] = job;
+			paths[numReads++]    = job->path;
+		}
+	}
+
+	if (numReads == 1)
+	{
+		AssetLoadJob *job     = batch.jobs[0];
+		MemoryArena_ *arena   = loadJobGetReadArena(worker, job);
+		PlatformFileRead file = {0};
+		i32 result = platform_readFileToBuffer(arena, job->path, &file);
+
+		// NOTE(doyle): The job is the main thread's once it is decoded, read
+		// its type first. Textures are copied out by the decode, so close the
+		// file whether it succeeded or not. Audio and fonts keep theirs.
+		b32 closeFile = (job->type == assetloadtype_texture);
+		loadJobDecode(assetManager, worker, job, &file, result);
+		if (closeFile) platform_closeFileRead(arena, &file);
+	}
+	else if (numReads > 1)
+	{
+		platform_readFileBatch(&worker->reader, &worker->persistentArena,
+		                       paths, files, numReads, loadBatchReadComplete,
+		                       &batch);
+	}
+
+	return TRUE;
+}
+
+INTERNAL void loadWorkerThread(void *userData)
+{
+	AssetLoadWorker *worker    = CAST(AssetLoadWorker *) userData;
+	AssetManager *assetManager = worker->assetManager;
+
+	for (;;)
+	{
+		if (!loadQueueDoNextJobs(assetManager, worker))
+			platform_semaphoreWait(&assetManager->loadQueue.semaphore);
+	}
+}
+
+i32 asset_loadQueueInit(AssetManager *const assetManager,
+                        MemoryArena_ *const arena)
+{
+	AssetLoadQueue *queue = &assetManager->loadQueue;
+	ASSERT((ASSET_LOAD_MAX_JOBS & (ASSET_LOAD_MAX_JOBS - 1)) == 0);
+
+	queue->workers =
+	    MEMORY_PUSH_ARRAY(arena, ASSET_LOAD_NUM_WORKERS, AssetLoadWorker);
+	for (i32 i = 0; i < ASSET_LOAD_NUM_WORKERS; i++)
+	{
+		AssetLoadWorker *worker = &queue->workers[i];
+		worker->assetManager    = assetManager;
+
+		memory_arenaInit(
+		    &worker->persistentArena,
+		    memory_pushBytes(arena, ASSET_LOAD_WORKER_PERSISTENT_SIZE),
+		    ASSET_LOAD_WORKER_PERSISTENT_SIZE);
+		memory_arenaInit(
+		    &worker->transientArena,
+		    memory_pushBytes(arena, ASSET_LOAD_WORKER_TRANSIENT_SIZE),
+		    ASSET_LOAD_WORKER_TRANSIENT_SIZE);
+		platform_fileReaderInit(&worker->reader);
 	}
 
-	platform_closeFileRead(arena, &file);
+	if (platform_semaphoreInit(&queue->semaphore, 0, ASSET_LOAD_MAX_JOBS))
+		return -1;
+
+	for (i32 i = 0; i < ASSET_LOAD_NUM_WORKERS; i++)
+	{
+		if (platform_threadCreate(loadWorkerThread, &queue->workers[i])) break;
+		queue->numWorkers++;
+	}
 
+	i32 result = (queue->numWorkers > 0) ? 0 : -1;
 	return result;
 }
 
-INTERNAL u32 shaderLoadProgram(const GLuint vertexShader,
-                               const GLuint fragmentShader)
+INTERNAL AssetLoadJob *loadQueuePush(AssetManager *const assetManager,
+                                     MemoryArena_ *const arena,
+                                     const enum AssetLoadType type,
+                                     const i32 id, const char *const path)
 {
-	u32 result = glCreateProgram();
-	glAttachShader(result, vertexShader);
-	glAttachShader(result, fragmentShader);
-	glLinkProgram(result);
-	GL_CHECK_ERROR();
+	AssetLoadQueue *queue = &assetManager->loadQueue;
 
-	glDeleteShader(fragmentShader);
-	glDeleteShader(vertexShader);
-	GL_CHECK_ERROR();
+	ASSERT(queue->workers);
 
-	GLint success;
-	GLchar infoLog[512];
-	glGetProgramiv(result, GL_LINK_STATUS, &success);
-	GL_CHECK_ERROR();
-	if (result == 0)
+	i32 jobIndex = queue->nextJobToWrite + queue->numUnpublished;
+	if (jobIndex - queue->nextJobToRetire >= ASSET_LOAD_MAX_JOBS)
 	{
-		glGetProgramInfoLog(result, 512, NULL, infoLog);
-		printf("glLinkProgram failed: %s\n", infoLog);
-		ASSERT(TRUE);
+		DEBUG_LOG("loadQueuePush() failed: Asset load queue is full");
+		return NULL;
 	}
-	GL_CHECK_ERROR();
 
-	return result;
+	AssetLoadJob *job = &queue->jobs[jobIndex & (ASSET_LOAD_MAX_JOBS - 1)];
+
+	AssetLoadJob empty = {0};
+	*job               = empty;
+	job->type          = type;
+	job->id            = id;
+
+	i32 pathLen = common_strlen(path);
+	job->path   = MEMORY_PUSH_ARRAY(arena, pathLen + 1, char);
+	common_strncpy(job->path, path, pathLen);
+	job->path[pathLen] = 0;
+
+	job->state = assetloadstate_queued;
+	return job;
 }
 
-u32 asset_shaderGet(AssetManager *assetManager, const enum ShaderList type)
+INTERNAL void loadQueuePublish(AssetLoadQueue *const queue, const i32 count)
 {
-	if (type < shaderlist_count) return assetManager->shaders[type];
+	if (count <= 0) return;
+	platform_atomicAdd(&queue->nextJobToWrite, count);
 
-#ifdef DENGINE_DEBUG
-	ASSERT(INVALID_CODE_PATH);
-#endif
-	return -1;
+	if (queue->numWorkers > 0)
+		platform_semaphoreRelease(&queue->semaphore, count);
 }
 
-const i32 asset_shaderLoad(AssetManager *assetManager, MemoryArena_ *arena,
-                                const char *const vertexPath,
-                                const char *const fragmentPath,
-                                const enum ShaderList type)
+/*
+   Make the job visible to the workers, called after the job is filled out.
+   Inside a load group jobs are held back until asset_loadGroupEnd.
+ */
+INTERNAL void loadQueueSubmit(AssetManager *const assetManager)
 {
-	GLuint vertexShader = createShaderFromPath(arena, vertexPath, GL_VERTEX_SHADER);
-	GLuint fragmentShader =
-	    createShaderFromPath(arena, fragmentPath, GL_FRAGMENT_SHADER);
+	AssetLoadQueue *queue = &assetManager->loadQueue;
+	if (queue->inGroup)
+		queue->numUnpublished++;
+	else
+		loadQueuePublish(queue, 1);
+}
 
-	u32 shaderId = shaderLoadProgram(vertexShader, fragmentShader);
-	if (shaderId == 0) return -1;
+void asset_loadGroupBegin(AssetManager *const assetManager)
+{
+	AssetLoadQueue *queue = &assetManager->loadQueue;
+	ASSERT(!queue->inGroup);
+	queue->inGroup = TRUE;
+}
 
-	assetManager->shaders[type] = shaderId;
+void asset_loadGroupEnd(AssetManager *const assetManager)
+{
+	AssetLoadQueue *queue = &assetManager->loadQueue;
+	ASSERT(queue->inGroup);
+
+	i32 count             = queue->numUnpublished;
+	queue->inGroup        = FALSE;
+	queue->numUnpublished = 0;
+	loadQueuePublish(queue, count);
+}
+
+i32 asset_texLoadAsync(AssetManager *const assetManager,
+                       MemoryArena_ *const arena, const char *const path,
+                       const enum TexList type)
+{
+	ASSERT(type > texlist_null && type < texlist_count);
+
+	// NOTE(doyle): Sprites packed into a loaded sheet need no load, the id
+	// resolves to the sheet texture and the sprite's region of it
+	if (texListResolveSheet(assetManager, type, path))
+	{
+		assetManager->texListSheetSprite[type] = assetPathCopy(arena, path);
+		return 0;
+	}
+
+	AssetLoadJob *job = loadQueuePush(assetManager, arena,
+	                                  assetloadtype_texture, type, path);
+	if (!job) return -1;
+
+	assetManager->texList[type] = assetManager->texList[texlist_null];
+	assetManager->texListRegion[type] =
+	    assetManager->texListRegion[texlist_null];
+	assetManager->texListSheetSprite[type] = NULL;
+	loadQueueSubmit(assetManager);
 	return 0;
 }
 
-INTERNAL FontPack *getMatchingFontPack(AssetManager *assetManager,
-                                       const char *const name)
+i32 asset_vorbisLoadAsync(AssetManager *const assetManager,
+                          MemoryArena_ *const arena, const char *const path,
+                          const char *const key, const enum AudioList type,
+                          const enum AudioDecode decode)
 {
-	FontPack *result = NULL;
-	for (i32 i = 0; i < ARRAY_COUNT(assetManager->fontPack); i++)
+	ASSERT(type < audiolist_count);
+
+	// NOTE(doyle): Checked before the job copies the path onto the arena,
+	// which can't be given back once the table insert fails
+	if (hashTableIsFull(&assetManager->audio))
 	{
-		FontPack *checkFontPack = &assetManager->fontPack[i];
-		if (common_strcmp(checkFontPack->name, name) == 0)
-		{
-			result = checkFontPack;
-			break;
-		}
+		DEBUG_LOG("asset_vorbisLoadAsync() failed: Audio table is full");
+		return -1;
 	}
 
-	return result;
+	AssetLoadJob *job = loadQueuePush(assetManager, arena,
+	                                  assetloadtype_audio, type, path);
+	if (!job) return -1;
+	job->audioDecode = decode;
+
+	HashTableEntry *entry = getFreeHashSlot(&assetManager->audio, arena, key);
+	ASSERT(entry);
+
+	// NOTE(doyle): Table entries move on insert, the upload finds the entry
+	// again by hash to swap the placeholder out
+	entry->data  = &assetManager->silentVorbis;
+	job->keyHash = entry->hash;
+
+	assetManager->audioList[type] = &assetManager->silentVorbis;
+	loadQueueSubmit(assetManager);
+	return 0;
 }
 
-Font *asset_fontGetOrCreateOnDemand(AssetManager *assetManager,
-                                      MemoryArena_ *persistentArena,
-                                      MemoryArena_ *transientArena, char *name,
-                                      i32 size)
+i32 asset_fontLoadAsync(AssetManager *const assetManager,
+                        MemoryArena_ *const arena, const char *const path,
+                        const enum FontList type, const i32 size)
 {
+	ASSERT(type < fontlist_count);
+	FontPack *fontPack = &assetManager->fontPack[type];
 
-	Font *result = asset_fontGet(assetManager, name, size);
+	// NOTE(doyle): Sizes of a resident pack only compute metrics, those are
+	// created by asset_fontGetOrCreateOnDemand
+	if (fontPack->loadQueued || fontPack->sdfAtlas) return 0;
 
-	if (result == NULL)
-	{
-		FontPack *pack = getMatchingFontPack(assetManager, name);
-		if (pack != NULL)
-		{
-			for(i32 i = 0; i < pack->fontIndex; i++)
-			{
-				Font *checkFont = &pack->font[i];
-				if (checkFont->size == size)
-				{
-					result = checkFont;
-					break;
-				}
-			}
+	AssetLoadJob *job =
+	    loadQueuePush(assetManager, arena, assetloadtype_font, type, path);
+	if (!job) return -1;
 
-			if (result == NULL)
-			{
-				asset_fontLoadTTF(assetManager, persistentArena, transientArena,
-				                 pack->filePath, name, size);
+	job->fontSize        = size;
+	fontPack->filePath   = job->path;
+	fontPack->loadQueued = TRUE;
 
-				result = asset_fontGet(assetManager, name, size);
-			}
+	loadQueueSubmit(assetManager);
+	return 0;
+}
+
+/* Create the GPU resources of a decoded job and hand it to the game */
+INTERNAL void loadJobUpload(AssetManager *const assetManager,
+                            AssetLoadJob *const job,
+                            MemoryArena_ *const persistentArena,
+                            MemoryArena_ *const transientArena)
+{
+	switch (job->type)
+	{
+	case assetloadtype_texture:
+	{
+		Texture *tex = MEMORY_PUSH_STRUCT(persistentArena, Texture);
+		if (job->texFileSize)
+		{
+			const TexFileHeader *header =
+			    texcompress_getFileHeader(job->pixels, job->texFileSize);
+			*tex        = textureGenCompressed(header);
+			job->width  = header->width;
+			job->height = header->height;
+			platform_memoryFree(NULL, job->pixels, job->texFileSize);
 		}
 		else
 		{
-			// TODO(doyle): Logging
+			*tex = textureGen(CAST(GLuint) job->width, CAST(GLuint) job->height,
+			                  CAST(GLint) job->bytesPerPixel, job->pixels);
+			asset_imageFree(job->pixels);
 		}
+		GL_CHECK_ERROR();
+
+		texResidencyAdd(assetManager, tex, job->path);
+		assetManager->texList[job->id] = tex;
+		assetManager->texListRegion[job->id] =
+		    CAST(Rect){V2(0, 0), V2i(job->width, job->height)};
 	}
+	break;
 
-	return result;
-}
+	case assetloadtype_audio:
+	{
+		HashTableEntry *entry =
+		    getEntryFromHash(&assetManager->audio, job->keyHash, NULL);
+		ASSERT(entry);
 
-Font *asset_fontGet(AssetManager *assetManager, char *name, i32 size)
-{
-	Font *result = NULL;
-	FontPack *pack = getMatchingFontPack(assetManager, name);
+		AudioVorbis *audio = MEMORY_PUSH_STRUCT(persistentArena, AudioVorbis);
+		*audio             = job->vorbis;
+		audio->key         = entry->key;
+		entry->data        = audio;
 
-	if (pack != NULL) {
-		for (i32 j = 0; j < ARRAY_COUNT(pack->font); j++)
-		{
-			if (pack->font[j].fontHeight == size)
-			{
-				result = &pack->font[j];
-				break;
-			}
-		}
+		assetManager->audioList[job->id] = audio;
+		audioLoadStatSet(assetManager, job->id, audio, job->decodeInMs);
 	}
+	break;
 
-	return result;
+	case assetloadtype_font:
+	{
+		FontPack *fontPack = &assetManager->fontPack[job->id];
+		fontUploadSdfAtlas(fontPack, job->pixels, persistentArena);
+		platform_memoryFree(NULL, job->pixels, SQUARED(FONT_SDF_ATLAS_SIZE));
+
+		fontPack->loadQueued = FALSE;
+		asset_fontLoadTTF(assetManager, persistentArena, transientArena,
+		                  fontPack->filePath, job->id, job->fontSize);
+	}
+	break;
+
+	default:
+	{
+		ASSERT(INVALID_CODE_PATH);
+	}
+	break;
+	}
+
+	job->pixels = NULL;
 }
 
-/* Individual glyph bitmap generated from STB used for creating a font sheet */
-typedef struct GlyphBitmap
+i32 asset_loadQueueUpdate(AssetManager *const assetManager,
+                          MemoryArena_ *const persistentArena,
+                          MemoryArena_ *const transientArena,
+                          const i32 maxUploads)
 {
-	v2 dimensions;
-	u32 *pixels;
-	i32 codepoint;
-} GlyphBitmap;
+	AssetLoadQueue *queue = &assetManager->loadQueue;
 
-const i32 asset_fontLoadTTF(AssetManager *assetManager,
-                           MemoryArena_ *persistentArena,
-                           MemoryArena_ *transientArena, char *filePath,
-                           char *name, i32 targetFontHeight)
-{
-	/*
-	 ****************************************
-	 * Initialise assetmanager font reference
-	 ****************************************
-	 */
-	FontPack *fontPack = NULL;
-	for (i32 i = 0; i < assetManager->fontPackIndex; i++)
+	// NOTE(doyle): No worker threads, decode on the main thread within the
+	// upload budget using the first worker's arenas
+	if (queue->numWorkers == 0 && queue->workers)
 	{
-		FontPack *checkFontPack = &assetManager->fontPack[i];
-		if (common_strcmp(checkFontPack->name, name) == 0)
+		for (i32 i = 0; i < maxUploads; i++)
 		{
-			fontPack = checkFontPack;
-			break;
+			if (!loadQueueDoNextJobs(assetManager, &queue->workers[0])) break;
 		}
 	}
 
-	if (fontPack == NULL) {
-		fontPack = &assetManager->fontPack[assetManager->fontPackIndex++];
-		fontPack->name = name;
-		fontPack->filePath = filePath;
-		ASSERT(assetManager->fontPackIndex <
-		       ARRAY_COUNT(assetManager->fontPack));
-	}
-
-	Font *font = NULL;
-	for (i32 j = 0; j < fontPack->fontIndex; j++)
+	/* Upload finished jobs in any order, a slow job does not block others */
+	i32 numUploads = 0;
+	for (i32 jobIndex = queue->nextJobToRetire;
+	     jobIndex < queue->nextJobToWrite && numUploads < maxUploads;
+	     jobIndex++)
 	{
-		Font *checkFont = &fontPack->font[j];
-		if (checkFont->fontHeight == targetFontHeight)
+		AssetLoadJob *job = &queue->jobs[jobIndex & (ASSET_LOAD_MAX_JOBS - 1)];
+		if (job->state == assetloadstate_decoded)
 		{
-			font = &fontPack->font[j];
-			break;
+			loadJobUpload(assetManager, job, persistentArena, transientArena);
+			job->state = assetloadstate_free;
+			numUploads++;
+		}
+		else if (job->state == assetloadstate_failed)
+		{
+			// NOTE(doyle): The asset keeps resolving to its placeholder, a
+			// failed font stays queued so it is not requested every frame
+			printf("asset_loadQueueUpdate() failed: Could not load %s\n",
+			       job->path);
+			job->state = assetloadstate_free;
 		}
 	}
 
-	if (font == NULL)
+	/* Retire the contiguous run of finished jobs to free their ring slots */
+	while (queue->nextJobToRetire < queue->nextJobToWrite)
 	{
-		font = &fontPack->font[fontPack->fontIndex++];
-		ASSERT(fontPack->fontIndex < ARRAY_COUNT(fontPack->font));
+		AssetLoadJob *job =
+		    &queue->jobs[queue->nextJobToRetire & (ASSET_LOAD_MAX_JOBS - 1)];
+		if (job->state != assetloadstate_free) break;
+		queue->nextJobToRetire++;
 	}
-	else
+
+	i32 result = 0;
+	for (i32 jobIndex = queue->nextJobToRetire;
+	     jobIndex < queue->nextJobToWrite; jobIndex++)
 	{
-		return 0;
+		AssetLoadJob *job = &queue->jobs[jobIndex & (ASSET_LOAD_MAX_JOBS - 1)];
+		if (job->state != assetloadstate_free) result++;
 	}
 
-	TempMemory tempRegion = memory_beginTempRegion(transientArena);
+	return result;
+}
 
-	PlatformFileRead fontFileRead = {0};
-	i32 result =
-	    platform_readFileToBuffer(transientArena, filePath, &fontFileRead);
-	if (result) return result;
+void asset_unitTest(MemoryArena_ *arena)
+{
+	{ // Hash table insert and lookup
+		TempMemory tempRegion = memory_beginTempRegion(arena);
 
-	stbtt_fontinfo fontInfo = {0};
-	stbtt_InitFont(&fontInfo, fontFileRead.buffer,
-	               stbtt_GetFontOffsetForIndex(fontFileRead.buffer, 0));
+		i32 numKeys     = 64;
+		HashTable table = {0};
+		hashTableInit(&table, arena, numKeys);
 
-	font->codepointRange = V2i(32, 127);
-	v2 codepointRange = font->codepointRange;
-	const i32 numGlyphs = CAST(i32)(codepointRange.y - codepointRange.x);
+		i32 *values = MEMORY_PUSH_ARRAY(arena, numKeys, i32);
+		for (i32 i = 0; i < numKeys; i++)
+		{
+			char key[COMMON_ITOA_MAX_BUFFER_32BIT] = {0};
+			common_itoa(i, key, ARRAY_COUNT(key));
 
-	GlyphBitmap *glyphBitmaps =
-	    memory_pushBytes(transientArena, numGlyphs * sizeof(GlyphBitmap));
-	v2 largestGlyphDimension = V2(0, 0);
+			HashTableEntry *entry = getFreeHashSlot(&table, arena, key);
+			ASSERT(entry);
+			values[i]   = i;
+			entry->data = &values[i];
+		}
+		ASSERT(table.count == numKeys);
 
-	font->fontHeight = targetFontHeight;
-	f32 scaleY = stbtt_ScaleForPixelHeight(&fontInfo, (f32)targetFontHeight);
+		for (i32 i = 0; i < numKeys; i++)
+		{
+			char key[COMMON_ITOA_MAX_BUFFER_32BIT] = {0};
+			common_itoa(i, key, ARRAY_COUNT(key));
 
-	i32 ascent, descent, lineGap;
-	stbtt_GetFontVMetrics(&fontInfo, &ascent, &descent, &lineGap);
+			HashTableEntry *entry = getEntryFromKey(&table, key);
+			ASSERT(entry && *(CAST(i32 *) entry->data) == i);
+			ASSERT(entry->keyLen == common_strlen(key));
 
-	ascent  = CAST(i32)(ascent * scaleY);
-	descent = CAST(i32)(descent * scaleY);
-	lineGap = CAST(i32)(lineGap * scaleY);
+			entry = getEntryFromHash(&table, asset_keyHash(key), NULL);
+			ASSERT(entry && *(CAST(i32 *) entry->data) == i);
+		}
 
-	font->metrics = CAST(FontMetrics){ascent, descent, lineGap};
+		ASSERT(getEntryFromKey(&table, "notInTable") == NULL);
+		memory_endTempRegion(tempRegion);
+	}
 
-	font->charMetrics =
-	    memory_pushBytes(persistentArena, numGlyphs * sizeof(CharMetrics));
+	{ // Skyline packed rects stay in bounds and do not overlap
+		TempMemory tempRegion = memory_beginTempRegion(arena);
 
-	/*
-	 ************************************************************
-	 * Use STB_TrueType to generate a series of bitmap characters
-	 ************************************************************
-	 */
-	i32 glyphIndex = 0;
-	for (i32 codepoint = CAST(i32) codepointRange.x;
-	     codepoint < CAST(i32) codepointRange.y; codepoint++)
-	{
-		// NOTE(doyle): ScaleX if not specified, is then calculated based on the
-		// ScaleY component
-		i32 width, height, xOffset, yOffset;
-		u8 *const monoBitmap =
-		    stbtt_GetCodepointBitmap(&fontInfo, 0, scaleY, codepoint, &width,
-		                             &height, &xOffset, &yOffset);
+		RectPack pack = {0};
+		rectpack_init(&pack, arena, 128, 128);
 
-		u8 *source       = monoBitmap;
-		u32 *colorBitmap =
-		    memory_pushBytes(transientArena, width * height * sizeof(u32));
-		u32 *dest        = colorBitmap;
+		i32 numRects = 0;
+		Rect rects[64] = {0};
+		for (i32 i = 0; i < ARRAY_COUNT(rects); i++)
+		{
+			v2 size = V2i(4 + ((i * 7) % 13), 4 + ((i * 5) % 11));
+			v2 pos  = {0};
+			if (!rectpack_insert(&pack, CAST(i32) size.w, CAST(i32) size.h,
+			                     &pos))
+				continue;
+
+			ASSERT(pos.x >= 0 && pos.x + size.w <= pack.width);
+			ASSERT(pos.y >= 0 && pos.y + size.h <= pack.height);
+			rects[numRects++] = CAST(Rect){pos, size};
+		}
+		ASSERT(numRects == ARRAY_COUNT(rects));
 
-		// NOTE(doyle): STB generates 1 byte per pixel bitmaps, we use 4bpp, so
-		// duplicate the alpha byte (essentially) for all RGBA components
-		for (i32 y = 0; y < height; y++)
+		for (i32 i = 0; i < numRects; i++)
 		{
-			for (i32 x = 0; x < width; x++)
+			for (i32 j = i + 1; j < numRects; j++)
 			{
-				u8 monoByte = *source++;
-				*dest++     = (monoByte << 24) | (monoByte << 16) |
-				              (monoByte << 8) | (monoByte << 0);
+				Rect a = rects[i];
+				Rect b = rects[j];
+				b32 overlap = (a.min.x < b.min.x + b.max.w) &&
+				              (b.min.x < a.min.x + a.max.w) &&
+				              (a.min.y < b.min.y + b.max.h) &&
+				              (b.min.y < a.min.y + a.max.h);
+				ASSERT(!overlap);
 			}
 		}
 
-		/* Get individual character metrics */
-		i32 advance, leftSideBearing;
-		stbtt_GetCodepointHMetrics(&fontInfo, codepoint, &advance,
-		                           &leftSideBearing);
-
-		advance = CAST(i32)(advance * scaleY);
-		leftSideBearing = CAST(i32)(leftSideBearing * scaleY);
-
-		font->charMetrics[glyphIndex] =
-		    CAST(CharMetrics){advance, leftSideBearing, NULL,
-		                      V2i(xOffset, yOffset), V2i(width, height)};
-
-		/* Store bitmap into intermediate storage */
-		stbtt_FreeBitmap(monoBitmap, NULL);
+		memory_endTempRegion(tempRegion);
+	}
 
-		// TODO(doyle): Dimensions is used twice in font->trueSize and this
-		glyphBitmaps[glyphIndex].dimensions = V2i(width, height);
-		glyphBitmaps[glyphIndex].codepoint  = codepoint;
-		glyphBitmaps[glyphIndex++].pixels   = colorBitmap;
+	{ // MaxRects packed rects stay in bounds and do not overlap
+		TempMemory tempRegion = memory_beginTempRegion(arena);
 
-		if (height > CAST(f32)largestGlyphDimension.h)
-			largestGlyphDimension.h = CAST(f32)height;
-		if (width > CAST(f32)largestGlyphDimension.w)
-			largestGlyphDimension.w = CAST(f32)width;
+		RectPackMax pack = {0};
+		rectpack_maxInit(&pack, arena, 128, 128, 256);
 
-#ifdef DENGINE_DEBUG
-		if ((largestGlyphDimension.h - CAST(i32)targetFontHeight) >= 50)
+		i32 numRects   = 0;
+		i32 usedArea   = 0;
+		Rect rects[64] = {0};
+		for (i32 i = 0; i < ARRAY_COUNT(rects); i++)
 		{
-			printf(
-			    "asset_fontLoadTTF() warning: The loaded font file has a glyph "
-			    "considerably larger than our target .. font packing is "
-			    "unoptimal\n");
+			v2 size = V2i(4 + ((i * 7) % 13), 4 + ((i * 5) % 11));
+			v2 pos  = {0};
+			if (!rectpack_maxInsert(&pack, CAST(i32) size.w,
+			                        CAST(i32) size.h, &pos))
+				continue;
+
+			ASSERT(pos.x >= 0 && pos.x + size.w <= pack.width);
+			ASSERT(pos.y >= 0 && pos.y + size.h <= pack.height);
+			rects[numRects++] = CAST(Rect){pos, size};
+			usedArea += CAST(i32)(size.w * size.h);
 		}
-#endif
-	}
-
-	/*
-	 * NOTE(doyle): Use rasterised TTF bitmap-characters combine them all into
-	 * one bitmap as an atlas. We determine how many glyphs we can fit per row
-	 * by determining the largest glyph size we have.
-	 *
-	 * For the amount of glyphs we fit per row, we iterate through them and
-	 * write each row of the glyph adjacent to the next until we finish writing
-	 * all pixels for the glyphs, then move onto the next set of glyphs.
-	 */
-	font->maxSize = largestGlyphDimension;
-	i32 glyphsPerRow = (MAX_TEXTURE_SIZE / CAST(i32)font->maxSize.w);
-
-#ifdef DENGINE_DEBUG
-	i32 glyphsPerCol = MAX_TEXTURE_SIZE / CAST(i32)font->maxSize.h;
-	if ((glyphsPerRow * glyphsPerCol) <= numGlyphs)
-	{
-		printf(
-		    "asset_fontLoadTTF() warning: The target font height creates a "
-		    "glyph sheet that exceeds the available space!");
-
-		ASSERT(INVALID_CODE_PATH);
-	}
-#endif
-
-	i32 bitmapSize = SQUARED(TARGET_TEXTURE_SIZE) * TARGET_BYTES_PER_PIXEL;
-	u32 *fontBitmap =
-	    memory_pushBytes(transientArena, bitmapSize * sizeof(u32));
-	const i32 pitch = MAX_TEXTURE_SIZE * TARGET_BYTES_PER_PIXEL;
-
-	// Check value to determine when a row of glyphs is completely printed
-	i32 verticalPixelsBlitted = 0;
+		ASSERT(numRects == ARRAY_COUNT(rects));
+		ASSERT(pack.usedArea == usedArea);
 
-	i32 startingGlyphIndex = 0;
-	i32 glyphsRemaining = numGlyphs;
-	i32 glyphsOnCurrRow =
-	    (glyphsPerRow < glyphsRemaining) ? glyphsPerRow : glyphsRemaining;
-
-	// TODO(doyle): We copy over the bitmap direct to the font sheet, should we
-	// align the baselines up so we don't need to do baseline adjusting at
-	// render?
-	char charToEncode = CAST(char)codepointRange.x;
-
-	i32 numSubTex = numGlyphs;
-	TexAtlas *fontAtlas = asset_atlasGetFreeSlot(
-	    assetManager, persistentArena, "font", numSubTex);
-
-	/*
-	 *********************************************************
-	 * Load individual glyph bitmap data into one font bitmap
-	 *********************************************************
-	 */
-	for (i32 row = 0; row < MAX_TEXTURE_SIZE; row++)
-	{
-		u32 *destRow = fontBitmap + (row * MAX_TEXTURE_SIZE);
-		for (i32 glyphIndex = 0; glyphIndex < glyphsOnCurrRow;
-		     glyphIndex++)
+		for (i32 i = 0; i < numRects; i++)
 		{
-			i32 activeGlyphIndex = startingGlyphIndex + glyphIndex;
-
-			GlyphBitmap activeGlyph = glyphBitmaps[activeGlyphIndex];
-
-			/* Store the location of glyph into atlas */
-			if (verticalPixelsBlitted == 0)
+			Rect a = rects[i];
+			for (i32 j = i + 1; j < numRects; j++)
 			{
-				v2 origin =
-				    V2(CAST(f32)(glyphIndex * font->maxSize.w), CAST(f32) row);
-
-				// NOTE(doyle): Since charToEncode starts from 0 and we record
-				// all ascii characters, charToEncode represents the character
-				// 1:1
-				const char key[2] = {charToEncode, 0};
-				SubTexture *subTex =
-				    getFreeAtlasSubTexSlot(fontAtlas, persistentArena, key);
-				subTex->rect = CAST(Rect){origin, font->maxSize};
-				charToEncode++;
+				Rect b = rects[j];
+				b32 overlap = (a.min.x < b.min.x + b.max.w) &&
+				              (b.min.x < a.min.x + a.max.w) &&
+				              (a.min.y < b.min.y + b.max.h) &&
+				              (b.min.y < a.min.y + a.max.h);
+				ASSERT(!overlap);
 			}
 
-			/* Copy over exactly one row of pixels */
-			i32 numPixelsToPad = CAST(i32)font->maxSize.w;
-			if (verticalPixelsBlitted < activeGlyph.dimensions.h)
+			/* No freeRect rect covers space that was handed out */
+			for (i32 j = 0; j < pack.numFreeRects; j++)
 			{
-				const i32 srcPitch =
-				    CAST(i32) activeGlyph.dimensions.w * verticalPixelsBlitted;
-				const u32 *src = activeGlyph.pixels + srcPitch;
-
-				const i32 numPixelsToCopy = CAST(i32)activeGlyph.dimensions.w;
-
-				for (i32 count = 0; count < numPixelsToCopy; count++)
-					*destRow++ = *src++;
-
-				/*
-				 * NOTE(doyle): If the glyph is smaller than largest glyph
-				 * available size, don't advance src pointer any further
-				 * (NULL/mixes up rows), instead just advance the final bitmap
-				 * pointer by the remaining distance
-				 */
-				numPixelsToPad =
-				    CAST(i32)(font->maxSize.w - activeGlyph.dimensions.w);
+				RectPackFree freeRect = pack.freeRects[j];
+				ASSERT(freeRect.x >= 0 &&
+				       freeRect.x + freeRect.width <= pack.width);
+				ASSERT(freeRect.y >= 0 &&
+				       freeRect.y + freeRect.height <= pack.height);
+
+				b32 overlap = (a.min.x < freeRect.x + freeRect.width) &&
+				              (freeRect.x < a.min.x + a.max.w) &&
+				              (a.min.y < freeRect.y + freeRect.height) &&
+				              (freeRect.y < a.min.y + a.max.h);
+				ASSERT(!overlap);
 			}
-			destRow += numPixelsToPad;
 		}
 
-		/* A row of glyphs has been fully formed on the atlas */
-		if (verticalPixelsBlitted++ >= font->maxSize.h)
-		{
-			verticalPixelsBlitted = 0;
-			startingGlyphIndex += glyphsPerRow;
-
-			glyphsRemaining -= glyphsPerRow;
-
-			if (glyphsRemaining <= 0)
-				break;
-			else if (glyphsRemaining <= glyphsPerRow)
-			{
-				// NOTE(doyle): This allows us to modify the glyph iterator to
-				// prevent over-running of the available glyphs
-				glyphsOnCurrRow = glyphsRemaining;
-			}
-		}
+		/* An insert the free list can't split fails and leaves it untouched,
+		   here the first rect split fits and only the second overflows */
+		RectPackMax fullPack = {0};
+		rectpack_maxInit(&fullPack, arena, 64, 64, 2);
+		fullPack.numFreeRects = 2;
+		fullPack.freeRects[0] = CAST(RectPackFree){0, 8, 64, 56};
+		fullPack.freeRects[1] = CAST(RectPackFree){8, 0, 56, 64};
+
+		v2 pos = {0};
+		ASSERT(!rectpack_maxInsert(&fullPack, 64, 8, &pos));
+		ASSERT(fullPack.numFreeRects == 2 && fullPack.usedArea == 0);
+		RectPackFree top   = fullPack.freeRects[0];
+		RectPackFree right = fullPack.freeRects[1];
+		ASSERT(top.x == 0 && top.y == 8 && top.height == 56);
+		ASSERT(right.x == 8 && right.y == 0 && right.width == 56);
+
+		memory_endTempRegion(tempRegion);
 	}
 
-	/*
-	 *******************************************
-	 * Generate and store font bitmap to assets
-	 *******************************************
-	 */
-	Texture *tex = asset_texGetFreeSlot(assetManager, persistentArena, "font");
-	*tex         = textureGen(MAX_TEXTURE_SIZE, MAX_TEXTURE_SIZE, 4,
-	                   CAST(u8 *) fontBitmap);
+	{ // Distance field font metrics match the per size bitmap rasteriser
+		TempMemory tempRegion = memory_beginTempRegion(arena);
 
-#ifdef WT_RENDER_FONT_FILE
-	/* save out a 4 channel image */
-	stbi_write_png("out.png", MAX_TEXTURE_SIZE, MAX_TEXTURE_SIZE, 4, fontBitmap,
-	               MAX_TEXTURE_SIZE * 4);
-#endif
+		PlatformFileRead fontFileRead = {0};
+		i32 result = platform_readFileToBuffer(
+		    arena, "data/fonts/Lato-Regular.ttf", &fontFileRead);
+		if (result)
+		{
+			DEBUG_LOG("unitTest() error: Could not load TTF for font test");
+		}
+		else
+		{
+			stbtt_fontinfo fontInfo = {0};
+			stbtt_InitFont(&fontInfo, fontFileRead.buffer,
+			               stbtt_GetFontOffsetForIndex(fontFileRead.buffer, 0));
+
+			FontPack fontPack = {0};
+			v2 codepointRange = V2i(32, 127);
+			u8 *sdfBitmap = fontBuildSdfAtlas(&fontPack, &fontInfo,
+			                                  codepointRange, arena, arena);
+			ASSERT(sdfBitmap);
+
+			i32 testSizes[] = {15, 40, 96};
+			for (i32 i = 0; i < ARRAY_COUNT(testSizes); i++)
+			{
+				Font font = {0};
+				fontInitSize(&font, &fontPack, &fontInfo, arena, arena,
+				             testSizes[i]);
 
-	// TODO(doyle): Mem free
-	// PLATFORM_MEM_FREE(arena, fontBitmap, bitmapSize);
+				f32 scale = stbtt_ScaleForPixelHeight(&fontInfo,
+				                                      CAST(f32) testSizes[i]);
+				for (i32 j = 0; j < font.numCharMetrics; j++)
+				{
+					i32 codepoint = CAST(i32) codepointRange.x + j;
+
+					i32 width, height, xOffset, yOffset;
+					u8 *monoBitmap = stbtt_GetCodepointBitmap(
+					    &fontInfo, 0, scale, codepoint, &width, &height,
+					    &xOffset, &yOffset);
+					stbtt_FreeBitmap(monoBitmap, NULL);
+
+					i32 advance, leftSideBearing;
+					stbtt_GetCodepointHMetrics(&fontInfo, codepoint, &advance,
+					                           &leftSideBearing);
+
+					CharMetrics *metric = &font.charMetrics[j];
+					ASSERT(metric->trueSize.w == width);
+					ASSERT(metric->trueSize.h == height);
+					ASSERT(metric->offset.x == xOffset);
+					ASSERT(metric->offset.y == yOffset);
+					ASSERT(metric->advance == CAST(i32)(advance * scale));
+				}
+			}
 
-	fontAtlas->tex = tex;
-	font->atlas   = fontAtlas;
+			/* Inside and outside of the field matches the base coverage */
+			f32 baseScale =
+			    stbtt_ScaleForPixelHeight(&fontInfo, FONT_SDF_BASE_HEIGHT);
+			i32 width, height, xOffset, yOffset;
+			u8 *monoBitmap = stbtt_GetCodepointBitmap(
+			    &fontInfo, 0, baseScale, 'A', &width, &height, &xOffset,
+			    &yOffset);
 
-	// NOTE(doyle): Formula derived from STB Font
-	font->verticalSpacing =
-	    font->metrics.ascent - font->metrics.descent + font->metrics.lineGap;
+			Rect cell = fontPack.sdfGlyphRect['A' - CAST(i32) codepointRange.x];
+			for (i32 y = 0; y < height; y++)
+			{
+				for (i32 x = 0; x < width; x++)
+				{
+					i32 atlasX = CAST(i32) cell.min.x + FONT_SDF_PADDING + x;
+					i32 atlasY = CAST(i32) cell.min.y + FONT_SDF_PADDING + y;
+					u8 dist = sdfBitmap[atlasX + (atlasY * FONT_SDF_ATLAS_SIZE)];
+
+					b32 inside = monoBitmap[x + (y * width)] >=
+					             FONT_SDF_ON_EDGE_VALUE;
+					if (inside) ASSERT(dist > FONT_SDF_ON_EDGE_VALUE);
+					if (!inside) ASSERT(dist < FONT_SDF_ON_EDGE_VALUE);
+				}
+			}
+			stbtt_FreeBitmap(monoBitmap, NULL);
+			platform_closeFileRead(arena, &fontFileRead);
+		}
 
-	for (i32 i = 0; i < numGlyphs; i++)
-	{
-		i32 glyphBitmapSizeInBytes = CAST(i32) glyphBitmaps[i].dimensions.w *
-		                             CAST(i32) glyphBitmaps[i].dimensions.h *
-		                             sizeof(u32);
+		memory_endTempRegion(tempRegion);
 	}
 
-	memory_endTempRegion(tempRegion);
-	return 0;
-}
-
-const v2 asset_fontStringDimInPixels(const Font *const font,
-                                     const char *const string)
-{
-	v2 stringDim = V2(0, 0);
-	for (i32 i = 0; i < common_strlen(string); i++)
-	{
-		i32 codepoint = string[i];
-
-#ifdef DENGINE_DEBUG
-		ASSERT(codepoint >= font->codepointRange.x &&
-		       codepoint <= font->codepointRange.y)
-#endif
+	{ // Font cache key changes with the font file, not just its size
+		u8 ttf[64]  = {0};
+		v2 range    = V2i(32, 127);
+		char *path  = "data/fonts/Test.ttf";
+		i32 ttfSize = ARRAY_COUNT(ttf);
 
-		i32 relativeIndex = CAST(i32)(codepoint - font->codepointRange.x);
+		FontCacheHeader a = fontCacheHeaderMake(path, ttf, ttfSize, range);
+		FontCacheHeader b = fontCacheHeaderMake(path, ttf, ttfSize, range);
+		ASSERT(a.key == b.key);
 
-		v2 charDim  = font->charMetrics[relativeIndex].trueSize;
-		stringDim.x += charDim.x;
-		stringDim.y = (charDim.y > stringDim.y) ? charDim.y : stringDim.y;
+		ttf[ttfSize / 2] = 1;
+		b = fontCacheHeaderMake(path, ttf, ttfSize, range);
+		ASSERT(a.ttfSize == b.ttfSize);
+		ASSERT(a.key != b.key);
 	}
 
-	return stringDim;
-}
+	{ // Test the xml pull parser
+		const char xml[] =
+		    "<?xml version=\"1.0\"?>\n"
+		    "<!-- <NotAnElement> -->\n"
+		    "<TextureAtlas imagePath=\"atlas.png\">\n"
+		    "\t<SubTexture name='a' x=\"12\" y = \"-3\"/>\n"
+		    "\t<Other>text<Inner/></Other>\n"
+		    "\t<SubTexture name=\"b\"></SubTexture>\n"
+		    "</TextureAtlas>\n";
+
+		XmlParser parser = xmlParserInit(xml, ARRAY_COUNT(xml) - 1);
+		ASSERT(xmlCountChildren(parser, "SubTexture") == 0);
+
+		XmlEvent event = xmlParserNext(&parser);
+		ASSERT(event.type == xmleventtype_open);
+		ASSERT(xmlStringEquals(event.name, "TextureAtlas"));
+		ASSERT(xmlCountChildren(parser, "SubTexture") == 2);
+
+		XmlString name, value;
+		ASSERT(xmlParserNextAttribute(&parser, &name, &value));
+		ASSERT(xmlStringEquals(name, "imagePath"));
+		ASSERT(xmlStringEquals(value, "atlas.png"));
+		ASSERT(!xmlParserNextAttribute(&parser, &name, &value));
+
+		/* Names and values are slices into the buffer */
+		event = xmlParserNext(&parser);
+		ASSERT(xmlStringEquals(event.name, "SubTexture"));
+		ASSERT(event.name.str >= xml && event.name.str < xml + sizeof(xml));
+		ASSERT(xmlParserNextAttribute(&parser, &name, &value));
+		ASSERT(xmlStringEquals(value, "a"));
+		ASSERT(xmlParserNextAttribute(&parser, &name, &value));
+		ASSERT(xmlStringToI32(value) == 12);
+
+		/* Unread attributes are skipped, self closing tags also close */
+		event = xmlParserNext(&parser);
+		ASSERT(event.type == xmleventtype_close);
+		ASSERT(xmlStringEquals(event.name, "SubTexture"));
+
+		event = xmlParserNext(&parser);
+		ASSERT(xmlStringEquals(event.name, "Other"));
+		xmlSkipElement(&parser);
+		ASSERT(parser.depth == 1);
+
+		event = xmlParserNext(&parser);
+		ASSERT(event.type == xmleventtype_open);
+		event = xmlParserNext(&parser);
+		ASSERT(event.type == xmleventtype_close);
+		event = xmlParserNext(&parser);
+		ASSERT(event.type == xmleventtype_close);
+		ASSERT(xmlStringEquals(event.name, "TextureAtlas"));
+		ASSERT(xmlParserNext(&parser).type == xmleventtype_eof);
+
+		/* Malformed input reports an error instead of reading past the end */
+		const char *badXml[] = {
+		    "<TextureAtlas imagePath=\"atlas.png>",
+		    "<TextureAtlas imagePath>",
+		    "<TextureAtlas>",
+		    "</TextureAtlas>",
+		    "<!-- unterminated",
+		};
+
+		for (i32 i = 0; i < ARRAY_COUNT(badXml); i++)
+		{
+			parser = xmlParserInit(badXml[i], common_strlen(badXml[i]));
+			for (;;)
+			{
+				event = xmlParserNext(&parser);
+				ASSERT(event.type != xmleventtype_eof);
+				if (event.type == xmleventtype_error) break;
+			}
+		}
+	}
 
-void asset_unitTest(MemoryArena_ *arena)
-{
 	PlatformFileRead xmlFileRead = {0};
 	i32 result = platform_readFileToBuffer(
 	    arena, "data/textures/WorldTraveller/ClaudeSprite.xml", &xmlFileRead);
 	if (result)
 	{
-		DEBUG_LOG(
-		    "unitTest() error: Could not load XML file for memory free test");
+		DEBUG_LOG("unitTest() error: Could not load XML file for parser test");
 	}
 	else
 	{
-		/* Tokenise buffer */
-		i32 numTokens       = 0;
-		XmlToken *xmlTokens = tokeniseXmlBuffer(arena, xmlFileRead.buffer,
-		                                        xmlFileRead.size, &numTokens);
-		/* Build XML tree from tokens */
-		XmlNode *xmlTree = buildXmlTree(arena, xmlTokens, numTokens);
-		freeXmlData(arena, xmlTokens, numTokens, xmlTree);
+		XmlParser parser = xmlParserInit(xmlFileRead.buffer, xmlFileRead.size);
+		XmlEvent event   = {0};
+		do
+		{
+			event = xmlParserNext(&parser);
+		} while (event.type == xmleventtype_open ||
+		         event.type == xmleventtype_close);
+
+		ASSERT(event.type == xmleventtype_eof);
+		platform_closeFileRead(arena, &xmlFileRead);
 	}
+
+	texcompress_unitTest(arena);
 }
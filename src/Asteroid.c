@@ -5,19 +5,27 @@ INTERNAL void loadGameAssets(GameState *state)
 {
 	AssetManager *assetManager = &state->assetManager;
 	MemoryArena_ *arena        = &state->persistentArena;
+	f64 startTime              = platform_getTimeInSeconds();
 
+	// NOTE(doyle): Assets not in the pack are loaded from the data directory
+	b32 packOpened =
+	    (asset_packOpen(assetManager, ASSET_PACK_DEFAULT_PATH) == 0);
+
+	// NOTE(doyle): Fonts, textures and audio stream in on the load workers,
+	// shaders are compiled here since the renderer needs them on init
 	{ // Init font assets
 #if 0
 		i32 result =
-		    asset_fontLoadTTF(assetManager, arena, &state->transientArena,
-		                     "C:/Windows/Fonts/Arialbd.ttf", "Arial", 15);
+		    asset_fontLoadAsync(assetManager, arena,
+		                        "C:/Windows/Fonts/Arialbd.ttf", fontlist_arial,
+		                        15);
 #endif
 
-		asset_fontLoadTTF(assetManager, arena, &state->transientArena,
-		                  "F:/Workspace/Dropbox/Apps/Fonts/"
-		                  "league-spartan-master/_webfonts/"
-		                  "leaguespartan-bold.ttf",
-		                  "Arial", 15);
+		asset_fontLoadAsync(assetManager, arena,
+		                    "F:/Workspace/Dropbox/Apps/Fonts/"
+		                    "league-spartan-master/_webfonts/"
+		                    "leaguespartan-bold.ttf",
+		                    fontlist_arial, 15);
 	}
 
 	{ // Init shaders assets
@@ -28,46 +36,65 @@ INTERNAL void loadGameAssets(GameState *state)
 		asset_shaderLoad(
 		    assetManager, arena, "data/shaders/default_no_tex.vert.glsl",
 		    "data/shaders/default_no_tex.frag.glsl", shaderlist_default_no_tex);
+
+		asset_shaderLoad(assetManager, arena,
+		                 "data/shaders/default_tex.vert.glsl",
+		                 "data/shaders/sdf.frag.glsl", shaderlist_sdf);
 	}
 
 	{ // Init audio assets
-		i32 result = asset_vorbisLoad(assetManager, arena,
-		                              "data/audio/Asteroids/bang_large.ogg",
-		                              "bang_large");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/bang_medium.ogg",
-		                          "bang_medium");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/bang_small.ogg",
-		                          "bang_small");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/beat1.ogg", "beat1");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/beat2.ogg", "beat2");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/extra_ship.ogg",
-		                          "extra_ship");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/fire.ogg", "fire");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/saucer_big.ogg",
-		                          "saucer_big");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/saucer_small.ogg",
-		                          "saucer_small");
-		ASSERT(!result);
-		result = asset_vorbisLoad(assetManager, arena,
-		                          "data/audio/Asteroids/thrust.ogg", "thrust");
-		ASSERT(!result);
+		typedef struct AudioManifest
+		{
+			enum AudioList type;
+			char *key;
+			char *path;
+			enum AudioDecode decode;
+		} AudioManifest;
+
+		// NOTE(doyle): Effects played on every shot and hit are decoded to
+		// PCM on load, the rest decide by length
+		LOCAL_PERSIST AudioManifest manifest[] = {
+		    {audiolist_bang_large, "bang_large",
+		     "data/audio/Asteroids/bang_large.ogg", audiodecode_pcm},
+		    {audiolist_bang_medium, "bang_medium",
+		     "data/audio/Asteroids/bang_medium.ogg", audiodecode_pcm},
+		    {audiolist_bang_small, "bang_small",
+		     "data/audio/Asteroids/bang_small.ogg", audiodecode_pcm},
+		    {audiolist_beat1, "beat1", "data/audio/Asteroids/beat1.ogg",
+		     audiodecode_auto},
+		    {audiolist_beat2, "beat2", "data/audio/Asteroids/beat2.ogg",
+		     audiodecode_auto},
+		    {audiolist_extra_ship, "extra_ship",
+		     "data/audio/Asteroids/extra_ship.ogg", audiodecode_auto},
+		    {audiolist_fire, "fire", "data/audio/Asteroids/fire.ogg",
+		     audiodecode_pcm},
+		    {audiolist_saucer_big, "saucer_big",
+		     "data/audio/Asteroids/saucer_big.ogg", audiodecode_auto},
+		    {audiolist_saucer_small, "saucer_small",
+		     "data/audio/Asteroids/saucer_small.ogg", audiodecode_auto},
+		    {audiolist_thrust, "thrust", "data/audio/Asteroids/thrust.ogg",
+		     audiodecode_auto},
+		};
+		ASSERT(ARRAY_COUNT(manifest) == audiolist_count);
+
+		// NOTE(doyle): Grouped so the workers read every file in one batch
+		asset_loadGroupBegin(assetManager);
+		for (i32 i = 0; i < ARRAY_COUNT(manifest); i++)
+		{
+			AudioManifest *entry = &manifest[i];
+			i32 result =
+			    asset_vorbisLoadAsync(assetManager, arena, entry->path,
+			                          entry->key, entry->type, entry->decode);
+			ASSERT(!result);
+		}
+		asset_loadGroupEnd(assetManager);
 	}
+
+#ifdef DENGINE_DEBUG
+	f64 elapsedInMs = (platform_getTimeInSeconds() - startTime) * 1000.0f;
+	printf("loadGameAssets(): %.2fms to queue, asset pack %s\n", elapsedInMs,
+	       (packOpened) ? "mapped" : "not found, loose files read");
+#endif
 }
 
 #include <stdlib.h>
@@ -452,34 +479,27 @@ INTERNAL void setCollisionRule(GameWorldState *world, enum EntityType a,
 	world->collisionTable[b][a] = rule;
 }
 
-INTERNAL AudioRenderer *getFreeAudioRenderer(GameWorldState *world,
-                                             AudioVorbis *vorbis,
-                                             i32 maxSimultaneousPlayers)
+/*
+   NOTE(doyle): Pan the sound by where it happens on screen, capped at a number
+   of the same sound playing at once so repeats do not stack up. Priority
+   decides what is heard when more sounds play than the mixer can mix.
+ */
+INTERNAL void playSound(GameState *state, GameWorldState *world,
+                        enum AudioList type, v2 pos,
+                        i32 maxSimultaneousPlayers,
+                        enum AudioPriority priority)
 {
-	i32 freeIndex             = -1;
-	i32 sameAudioPlayingCount = 0;
-
-	AudioRenderer *result = NULL;
-	for (i32 i = 0; i < world->numAudioRenderers; i++)
+	AudioVorbis *vorbis = asset_vorbisGet(&state->assetManager, type);
+	if (audio_numPlaying(&state->audioManager, vorbis) >=
+	    maxSimultaneousPlayers)
 	{
-		AudioRenderer *renderer = &world->audioRenderer[i];
-		if (renderer->state == audiostate_playing &&
-		    common_strcmp(renderer->audio->key, vorbis->key) == 0)
-		{
-			sameAudioPlayingCount++;
-		}
-		else if (renderer->state == audiostate_stopped && freeIndex == -1)
-		{
-			freeIndex = i;
-		}
+		return;
 	}
 
-	if (sameAudioPlayingCount < maxSimultaneousPlayers && freeIndex != -1)
-	{
-		result = &world->audioRenderer[freeIndex];
-	}
-
-	return result;
+	f32 halfWidth = (world->camera.max.x - world->camera.min.x) * 0.5f;
+	f32 centreX   = world->camera.min.x + halfWidth;
+	f32 pan       = (halfWidth > 0) ? (pos.x - centreX) / halfWidth : 0;
+	audio_play(&state->audioManager, vorbis, 1.0f, pan, 1, priority);
 }
 
 INTERNAL void addPlayer(GameWorldState *world)
@@ -579,6 +599,37 @@ INTERNAL v2 wrapPAroundBounds(v2 p, Rect bounds)
 	return result;
 }
 
+/*
+   NOTE(doyle): Keys of the HUD and menu geometry cached by the renderer. The
+   hash covers what the geometry is built from, besides the constant colors
+   and depths, so it is tessellated again when any of it changes.
+ */
+enum UiGeometry
+{
+	uigeometry_score = 1,
+	uigeometry_multiplierBarOutline,
+	uigeometry_multiplier,
+	uigeometry_gameOver,
+	uigeometry_menuTitle,
+	uigeometry_menuStartPrompt,
+	uigeometry_menuOptionsPrompt,
+	uigeometry_optionsTitle,
+	uigeometry_optionsResolution,
+	uigeometry_count,
+};
+
+INTERNAL u64 uiGeometryHash(const Font *const font, const char *const string,
+                            const v2 p, const v2 size)
+{
+	u64 result = CAST(u64) CAST(uintptr_t) font;
+	if (string)
+		result = common_murmurHash64A(string, common_strlen(string), result);
+
+	result = common_murmurHash64A(&p, sizeof(p), result);
+	result = common_murmurHash64A(&size, sizeof(size), result);
+	return result;
+}
+
 INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 {
 	GameWorldState *world =
@@ -619,12 +670,6 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 			world->numAsteroids = 15;
 		}
 
-		{ // Init audio renderer
-			world->numAudioRenderers = 8;
-			world->audioRenderer     = MEMORY_PUSH_ARRAY(
-			    &world->entityArena, world->numAudioRenderers, AudioRenderer);
-		}
-
 		{ // Global Collision Rules
 			setCollisionRule(world, entitytype_ship, entitytype_asteroid_small,
 			                 TRUE);
@@ -662,7 +707,9 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 
 	if (common_isSet(world->flags, gameworldstateflags_level_started))
 	{
-		Font *arial40 = asset_fontGet(&state->assetManager, "Arial", 40);
+		Font *arial40 = asset_fontGetOrCreateOnDemand(
+		    &state->assetManager, &state->persistentArena,
+		    &state->transientArena, fontlist_arial, 40);
 
 		Renderer *renderer = &state->renderer;
 
@@ -673,12 +720,18 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 		common_itoa(world->score, gamePointsString,
 		            ARRAY_COUNT(gamePointsString));
 
-		renderer_stringFixedCentered(renderer, &state->transientArena, arial40,
-		                             gamePointsString, stringP, V2(0, 0), 0,
-		                             V4(1.0f, 1.0f, 1.0f, 1.0f), 1, 0);
+		u64 scoreHash =
+		    uiGeometryHash(arial40, gamePointsString, stringP, V2(0, 0));
+		if (!renderer_geometryBegin(renderer, uigeometry_score, scoreHash))
+		{
+			renderer_stringFixedCentered(
+			    renderer, &state->transientArena, arial40, gamePointsString,
+			    stringP, V2(0, 0), 0, V4(1.0f, 1.0f, 1.0f, 1.0f), 1, 0);
+		}
+		renderer_geometryEnd(renderer);
 
 		/* Render multiplier accumulator bar onto screen */
-		v2 stringDim = asset_fontStringDimInPixels(arial40, gamePointsString);
+		v2 stringDim = renderer_stringDim(renderer, arial40, gamePointsString);
 		v2 multiplierOutlineSize =
 		    V2(renderer->size.w * 0.5f, stringDim.h * 0.25f);
 
@@ -686,15 +739,26 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 		multiplierOutlineP.x -= (multiplierOutlineSize.w * 0.5f);
 		multiplierOutlineP.y -= stringDim.h * 1.5f;
 
-		renderer_rectFixedOutline(
-		    renderer, multiplierOutlineP, multiplierOutlineSize, V2(0, 0), 2, 0,
-		    NULL, V4(0.2f, 0.3f, 0.8f, 1.0f), 2, renderflag_no_texture);
+		u64 outlineHash = uiGeometryHash(NULL, NULL, multiplierOutlineP,
+		                                 multiplierOutlineSize);
+		if (!renderer_geometryBegin(
+		        renderer, uigeometry_multiplierBarOutline, outlineHash))
+		{
+			renderer_rectFixedOutline(renderer, multiplierOutlineP,
+			                          multiplierOutlineSize, V2(0, 0), 2, 0,
+			                          NULL, V4(0.2f, 0.3f, 0.8f, 1.0f), 2,
+			                          renderflag_no_texture);
+		}
+		renderer_geometryEnd(renderer);
 
 		f32 progressNormalised = world->scoreMultiplierBarTimer /
 		                         world->scoreMultiplierBarThresholdInS;
-		renderer_rectFixed(renderer, multiplierOutlineP,
-		                   V2(multiplierOutlineSize.w * progressNormalised,
-		                      multiplierOutlineSize.h),
+		v2 multiplierBarSize = V2(multiplierOutlineSize.w * progressNormalised,
+		                          multiplierOutlineSize.h);
+
+		// NOTE(doyle): The fill grows every frame so it is never cached, only
+		// the outline around it is
+		renderer_rectFixed(renderer, multiplierOutlineP, multiplierBarSize,
 		                   V2(0, 0), 0, NULL, V4(0.2f, 0.3f, 0.8f, 1.0f), 1,
 		                   renderflag_no_texture);
 
@@ -703,23 +767,31 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 		v2 multiplierHudSize =
 		    V2((arial40->maxSize.w * 3.5f), arial40->fontHeight * 1.2f);
 
-		renderer_rectFixed(renderer, multiplierHudP, multiplierHudSize,
-		                   V2(0, 0), 0, NULL, V4(1, 1, 1, 0.1f), 2,
-		                   renderflag_no_texture);
-
-		/* Render multiplier counter string to hud */
 		char multiplierToString[COMMON_ITOA_MAX_BUFFER_32BIT + 1] = {0};
 		common_itoa(world->scoreMultiplier, multiplierToString + 1,
 		            ARRAY_COUNT(multiplierToString) - 1);
 		multiplierToString[0] = 'x';
 
-		v2 multiplierToStringP = multiplierHudP;
-		multiplierToStringP =
-		    v2_add(multiplierToStringP, v2_scale(multiplierHudSize, 0.5f));
-
-		renderer_stringFixedCentered(
-		    renderer, &state->transientArena, arial40, multiplierToString,
-		    multiplierToStringP, V2(0, 0), 0, V4(1.0f, 1.0f, 1.0f, 1.0f), 3, 0);
+		u64 multiplierHash = uiGeometryHash(arial40, multiplierToString,
+		                                    multiplierHudP, multiplierHudSize);
+		if (!renderer_geometryBegin(renderer, uigeometry_multiplier,
+		                            multiplierHash))
+		{
+			renderer_rectFixed(renderer, multiplierHudP, multiplierHudSize,
+			                   V2(0, 0), 0, NULL, V4(1, 1, 1, 0.1f), 2,
+			                   renderflag_no_texture);
+
+			/* Render multiplier counter string to hud */
+			v2 multiplierToStringP = multiplierHudP;
+			multiplierToStringP    = v2_add(multiplierToStringP,
+			                             v2_scale(multiplierHudSize, 0.5f));
+
+			renderer_stringFixedCentered(renderer, &state->transientArena,
+			                             arial40, multiplierToString,
+			                             multiplierToStringP, V2(0, 0), 0,
+			                             V4(1.0f, 1.0f, 1.0f, 1.0f), 3, 0);
+		}
+		renderer_geometryEnd(renderer);
 
 		/* Process multiplier bar updates */
 		if (!common_isSet(world->flags, gameworldstateflags_player_lost))
@@ -747,21 +819,32 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 
 	if (common_isSet(world->flags, gameworldstateflags_player_lost))
 	{
-		Font *arial40 = asset_fontGet(&state->assetManager, "Arial", 40);
+		Font *arial40 = asset_fontGetOrCreateOnDemand(
+		    &state->assetManager, &state->persistentArena,
+		    &state->transientArena, fontlist_arial, 40);
 
 		char *gameOver = "Game Over";
-		v2 gameOverP = v2_scale(state->renderer.size, 0.5f);
-		renderer_stringFixedCentered(
-		    &state->renderer, &state->transientArena, arial40, "Game Over",
-		    gameOverP, V2(0, 0), 0, V4(1, 1, 1, 1), 0, 0);
+		v2 gameOverP   = v2_scale(state->renderer.size, 0.5f);
 
-		v2 gameOverSize = asset_fontStringDimInPixels(arial40, gameOver);
-		v2 replayP = V2(gameOverP.x, gameOverP.y - (gameOverSize.h * 1.2f));
-
-		renderer_stringFixedCentered(
-		    &state->renderer, &state->transientArena, arial40,
-		    "Press enter to play again or backspace to return to menu", replayP,
-		    V2(0, 0), 0, V4(1, 1, 1, 1), 0, 0);
+		u64 gameOverHash =
+		    uiGeometryHash(arial40, gameOver, gameOverP, V2(0, 0));
+		if (!renderer_geometryBegin(&state->renderer, uigeometry_gameOver,
+		                            gameOverHash))
+		{
+			renderer_stringFixedCentered(
+			    &state->renderer, &state->transientArena, arial40, "Game Over",
+			    gameOverP, V2(0, 0), 0, V4(1, 1, 1, 1), 0, 0);
+
+			v2 gameOverSize =
+			    renderer_stringDim(&state->renderer, arial40, gameOver);
+			v2 replayP = V2(gameOverP.x, gameOverP.y - (gameOverSize.h * 1.2f));
+
+			renderer_stringFixedCentered(
+			    &state->renderer, &state->transientArena, arial40,
+			    "Press enter to play again or backspace to return to menu",
+			    replayP, V2(0, 0), 0, V4(1, 1, 1, 1), 0, 0);
+		}
+		renderer_geometryEnd(&state->renderer);
 
 		if (platform_queryKey(&state->input.keys[keycode_enter],
 		                      readkeytype_one_shot, 0.0f))
@@ -855,16 +938,8 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 				v2 direction = V2(math_cosf(rotation), math_sinf(rotation));
 				ddP          = direction;
 
-				AudioVorbis *thrust =
-				    asset_vorbisGet(&state->assetManager, "thrust");
-				AudioRenderer *audioRenderer =
-				    getFreeAudioRenderer(world, thrust, 3);
-				if (audioRenderer)
-				{
-					audio_vorbisPlay(&state->transientArena,
-					                 &state->audioManager, audioRenderer,
-					                 thrust, 1);
-				}
+				playSound(state, world, audiolist_thrust, entity->pos, 3,
+				          audiopriority_low);
 			}
 
 			if (platform_queryKey(&state->input.keys[keycode_space],
@@ -880,18 +955,8 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 					world->timeSinceLastShot += multiplierPenalty;
 				}
 
-				AudioVorbis *fire =
-				    asset_vorbisGet(&state->assetManager, "fire");
-				AudioRenderer *audioRenderer =
-				    getFreeAudioRenderer(world, fire, 2);
-				if (audioRenderer)
-				{
-					// TODO(doyle): Atm transient arena is not used, this is
-					// just to fill out the arguments
-					audio_vorbisPlay(&state->transientArena,
-					                 &state->audioManager, audioRenderer, fire,
-					                 1);
-				}
+				playSound(state, world, audiolist_fire, entity->pos, 2,
+				          audiopriority_normal);
 			}
 
 			Degrees rotationsPerSecond = 180.0f;
@@ -1157,37 +1222,31 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 
 				ASSERT(colliderB->type == entitytype_bullet);
 
+				// NOTE(doyle): Deleting swaps the last entity into this slot
+				v2 explodePos = entity->pos;
 				deleteEntity(world, collisionIndex);
 				deleteEntity(world, i--);
 				world->asteroidCounter--;
 
 				ASSERT(world->asteroidCounter >= 0);
 
-				char *sound;
+				enum AudioList sound;
 				i32 choice = rand() % 3;
 				if (choice == 0)
 				{
-					sound = "bang_small";
+					sound = audiolist_bang_small;
 				}
 				else if (choice == 1)
 				{
-					sound = "bang_medium";
+					sound = audiolist_bang_medium;
 				}
 				else
 				{
-					sound = "bang_large";
+					sound = audiolist_bang_large;
 				}
 
-				AudioVorbis *explode =
-				    asset_vorbisGet(&state->assetManager, sound);
-				AudioRenderer *audioRenderer =
-				    getFreeAudioRenderer(world, explode, 3);
-				if (audioRenderer)
-				{
-					audio_vorbisPlay(&state->transientArena,
-					                 &state->audioManager, audioRenderer,
-					                 explode, 1);
-				}
+				playSound(state, world, sound, explodePos, 3,
+				          audiopriority_high);
 
 				continue;
 			}
@@ -1198,6 +1257,7 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 				{
 					world->flags |= gameworldstateflags_player_lost;
 
+					v2 explodePos = entity->pos;
 					if (collideEntity->type == entitytype_ship)
 					{
 						deleteEntity(world, collisionIndex);
@@ -1207,16 +1267,8 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 						deleteEntity(world, i--);
 					}
 
-					AudioVorbis *explode =
-					    asset_vorbisGet(&state->assetManager, "bang_large");
-					AudioRenderer *audioRenderer =
-					    getFreeAudioRenderer(world, explode, 3);
-					if (audioRenderer)
-					{
-						audio_vorbisPlay(&state->transientArena,
-						                 &state->audioManager, audioRenderer,
-						                 explode, 1);
-					}
+					playSound(state, world, audiolist_bang_large, explodePos,
+					          3, audiopriority_high);
 
 					continue;
 				}
@@ -1227,13 +1279,6 @@ INTERNAL void gameUpdate(GameState *state, Memory *memory, f32 dt)
 		renderer_entity(&state->renderer, &state->transientArena, world->camera,
 		                entity, V2(0, 0), 0, collideColor, 0, flags);
 	}
-
-	for (i32 i = 0; i < world->numAudioRenderers; i++)
-	{
-		AudioRenderer *audioRenderer = &world->audioRenderer[i];
-		audio_updateAndPlay(&state->transientArena, &state->audioManager,
-		                    audioRenderer);
-	}
 }
 
 INTERNAL void startMenuUpdate(GameState *state, Memory *memory, f32 dt)
@@ -1287,9 +1332,9 @@ INTERNAL void startMenuUpdate(GameState *state, Memory *memory, f32 dt)
 	}
 
 	Font *arial15 = asset_fontGetOrCreateOnDemand(
-	    assetManager, &state->persistentArena, transientArena, "Arial", 15);
+	    assetManager, &state->persistentArena, transientArena, fontlist_arial, 15);
 	Font *arial40 = asset_fontGetOrCreateOnDemand(
-	    assetManager, &state->persistentArena, transientArena, "Arial", 40);
+	    assetManager, &state->persistentArena, transientArena, fontlist_arial, 40);
 
 	v2 screenCenter = v2_scale(renderer->size, 0.5f);
 
@@ -1349,33 +1394,46 @@ INTERNAL void startMenuUpdate(GameState *state, Memory *memory, f32 dt)
 			}
 
 			f32 textYOffset = arial40->size * 1.5f;
-			{ // Options Title String Display
-				const char *const title = "Options";
-
-				v2 p = v2_add(screenCenter, V2(0, textYOffset));
-				renderer_stringFixedCentered(renderer, transientArena, arial40,
-				                             title, p, V2(0, 0), 0,
-				                             V4(1, 1, 1, 1), uiZDepth, 0);
-			}
+			u64 optionsHash =
+			    uiGeometryHash(arial40, NULL, screenCenter, V2(0, textYOffset));
+			if (!renderer_geometryBegin(renderer, uigeometry_optionsTitle,
+			                            optionsHash))
+			{
+				{ // Options Title String Display
+					const char *const title = "Options";
 
-			{ // Resolution String Display
+					v2 p = v2_add(screenCenter, V2(0, textYOffset));
+					renderer_stringFixedCentered(
+					    renderer, transientArena, arial40, title, p, V2(0, 0),
+					    0, V4(1, 1, 1, 1), uiZDepth, 0);
+				}
 
-				/* Draw label */
-				const char *const resolutionLabel = "Resolution";
+				{ // Resolution Label Display
+					const char *const resolutionLabel = "Resolution";
 
-				v2 p = v2_add(screenCenter, V2(0, 0));
-				renderer_stringFixedCentered(renderer, transientArena, arial40,
-				                             resolutionLabel, p, V2(0, 0), 0,
-				                             V4(1, 1, 1, 1), uiZDepth, 0);
+					v2 p = v2_add(screenCenter, V2(0, 0));
+					renderer_stringFixedCentered(
+					    renderer, transientArena, arial40, resolutionLabel, p,
+					    V2(0, 0), 0, V4(1, 1, 1, 1), uiZDepth, 0);
+				}
+			}
+			renderer_geometryEnd(renderer);
 
-				/* Draw label value */
+			{ // Resolution Value Display
 				char *resStringToDisplay =
 				    menuState->resStrings[menuState->resStringDisplayIndex];
 
-				p = v2_add(screenCenter, V2(0, -textYOffset));
-				renderer_stringFixedCentered(renderer, transientArena, arial40,
-				                             resStringToDisplay, p, V2(0, 0), 0,
-				                             V4(1, 1, 1, 1), uiZDepth, 0);
+				v2 p        = v2_add(screenCenter, V2(0, -textYOffset));
+				u64 resHash = uiGeometryHash(arial40, resStringToDisplay, p,
+				                             V2(0, 0));
+				if (!renderer_geometryBegin(
+				        renderer, uigeometry_optionsResolution, resHash))
+				{
+					renderer_stringFixedCentered(
+					    renderer, transientArena, arial40, resStringToDisplay,
+					    p, V2(0, 0), 0, V4(1, 1, 1, 1), uiZDepth, 0);
+				}
+				renderer_geometryEnd(renderer);
 			}
 		}
 	}
@@ -1384,9 +1442,14 @@ INTERNAL void startMenuUpdate(GameState *state, Memory *memory, f32 dt)
 		/* Draw title text */
 		const char *const title = "Asteroids";
 		v2 p                    = v2_add(screenCenter, V2(0, 40));
-		renderer_stringFixedCentered(renderer, transientArena, arial40, title,
-		                             p, V2(0, 0), 0, V4(1, 1, 1, 1), uiZDepth,
-		                             0);
+		u64 titleHash           = uiGeometryHash(arial40, title, p, V2(0, 0));
+		if (!renderer_geometryBegin(renderer, uigeometry_menuTitle, titleHash))
+		{
+			renderer_stringFixedCentered(renderer, transientArena, arial40,
+			                             title, p, V2(0, 0), 0, V4(1, 1, 1, 1),
+			                             uiZDepth, 0);
+		}
+		renderer_geometryEnd(renderer);
 
 		/* Draw blinking start game prompt */
 		menuState->startPromptBlinkTimer -= dt;
@@ -1401,17 +1464,29 @@ INTERNAL void startMenuUpdate(GameState *state, Memory *memory, f32 dt)
 		{
 			const char *const gameStart = "Press enter to start";
 			v2 p                        = v2_add(screenCenter, V2(0, -40));
-			renderer_stringFixedCentered(renderer, transientArena, arial40,
-			                             gameStart, p, V2(0, 0), 0,
-			                             V4(1, 1, 1, 1), uiZDepth, 0);
+			u64 startHash = uiGeometryHash(arial40, gameStart, p, V2(0, 0));
+			if (!renderer_geometryBegin(renderer, uigeometry_menuStartPrompt,
+			                            startHash))
+			{
+				renderer_stringFixedCentered(renderer, transientArena, arial40,
+				                             gameStart, p, V2(0, 0), 0,
+				                             V4(1, 1, 1, 1), uiZDepth, 0);
+			}
+			renderer_geometryEnd(renderer);
 		}
 
 		{ // Draw show options prompt
 			const char *const optionPrompt = "Press [o] for options ";
 			v2 p                           = v2_add(screenCenter, V2(0, -120));
-			renderer_stringFixedCentered(renderer, transientArena, arial40,
-			                             optionPrompt, p, V2(0, 0), 0,
-			                             V4(1, 1, 1, 1), uiZDepth,  0);
+			u64 promptHash = uiGeometryHash(arial40, optionPrompt, p, V2(0, 0));
+			if (!renderer_geometryBegin(renderer, uigeometry_menuOptionsPrompt,
+			                            promptHash))
+			{
+				renderer_stringFixedCentered(renderer, transientArena, arial40,
+				                             optionPrompt, p, V2(0, 0), 0,
+				                             V4(1, 1, 1, 1), uiZDepth, 0);
+			}
+			renderer_geometryEnd(renderer);
 		}
 
 		if (platform_queryKey(&inputBuffer->keys[keycode_enter],
@@ -1454,7 +1529,16 @@ void asteroid_gameUpdateAndRender(GameState *state, Memory *memory,
 	{
 		srand((u32)time(NULL));
 		asset_init(&state->assetManager, &state->persistentArena);
-		audio_init(&state->audioManager);
+		if (asset_loadQueueInit(&state->assetManager, &state->persistentArena))
+			printf("asset_loadQueueInit() failed: Loading on main thread\n");
+#ifdef DENGINE_DEBUG
+		if (asset_hotReloadInit(&state->assetManager, "data"))
+			printf("asset_hotReloadInit() failed: Assets will not reload\n");
+#endif
+		AudioDeviceConfig audioConfig = {0};
+		audioConfig.type              = audiodevice_openal;
+		audio_init(&state->audioManager, &state->persistentArena,
+		           &audioConfig);
 
 		// NOTE(doyle): Load game assets must be before init_renderer so that
 		// shaders are available for the renderer configuration
@@ -1462,13 +1546,53 @@ void asteroid_gameUpdateAndRender(GameState *state, Memory *memory,
 		renderer_init(&state->renderer, &state->assetManager,
 		              &state->persistentArena, windowSize);
 
-		Font *arial15 = asset_fontGet(&state->assetManager, "Arial", 15);
-		debug_init(windowSize, *arial15);
-
 		state->currState = appstate_StartMenuState;
 		state->init      = TRUE;
 	}
 
+	i32 numAssetsLoading = asset_loadQueueUpdate(
+	    &state->assetManager, &state->persistentArena, &state->transientArena,
+	    ASSET_LOAD_UPLOADS_PER_FRAME);
+	asset_texResidencyUpdate(&state->assetManager, &state->transientArena);
+
+	// NOTE(doyle): Relinked shader programs lose their uniforms, reapply them.
+	// Fonts are rebuilt in place, so labels laid out with them are stale.
+	if (asset_hotReloadUpdate(&state->assetManager, &state->persistentArena,
+	                          &state->transientArena) > 0)
+	{
+		renderer_updateSize(&state->renderer, &state->assetManager,
+		                    state->renderer.size);
+		ui_invalidateLayout(&state->uiState);
+	}
+
+	// NOTE(doyle): The debug font streams in like any other asset, the overlay
+	// starts once it is uploaded
+	if (!state->debugInit)
+	{
+		Font *arial15 = asset_fontGet(&state->assetManager, fontlist_arial, 15);
+		if (arial15)
+		{
+			debug_init(windowSize, *arial15);
+			state->debugInit = TRUE;
+		}
+	}
+	DEBUG_PUSH_VAR("Assets Loading: %d", numAssetsLoading, "i32");
+
+#ifdef DENGINE_DEBUG
+	if (!state->audioReported && numAssetsLoading == 0)
+	{
+		asset_audioLoadReport(&state->assetManager);
+		state->audioReported = TRUE;
+	}
+#endif
+
+	TexResidency *texResidency = &state->assetManager.texResidency;
+	i32 texResidentInKb        = texResidency->residentInBytes / 1024;
+	DEBUG_PUSH_VAR("Textures Resident: %dKB", texResidentInKb, "i32");
+	DEBUG_PUSH_VAR("Texture Evictions: %d", texResidency->numEvictions, "i32");
+	DEBUG_PUSH_VAR("Assets Reloaded: %d",
+	               state->assetManager.hotReload.numReloads, "i32");
+
 	platform_inputBufferProcess(&state->input, dt);
 
 	switch (state->currState)
@@ -1492,6 +1616,12 @@ void asteroid_gameUpdateAndRender(GameState *state, Memory *memory,
 	break;
 	}
 
+	// NOTE(doyle): After the update so sounds started this frame are mixed
+	audio_update(&state->audioManager);
+
 	debug_drawUi(state, dt);
+	debug_phaseMark(debugphase_simulate);
+
 	renderer_renderGroups(&state->renderer);
+	debug_phaseMark(debugphase_render);
 }
@@ -1,506 +1,515 @@
-#include <OpenAL/alc.h>
-
-#define STB_VORBIS_HEADER_ONLY
-#include <STB/stb_vorbis.c>
-
-#include "Dengine/Assets.h"
 #include "Dengine/Audio.h"
 #include "Dengine/Debug.h"
-#include "Dengine/MemoryArena.h"
-
-#define AL_CHECK_ERROR() alCheckError_(__FILE__, __LINE__);
-void alCheckError_(const char *file, int line)
+#include "Dengine/Platform.h"
+
+/*
+ *********************************
+ * Rings
+ *********************************
+ */
+/*
+   NOTE(doyle): Each index is written by one side only. The atomics are full
+   barriers, the slot is written before the write index is published and read
+   before the read index gives it back.
+ */
+INTERNAL i32 ringLoad(volatile i32 *const index)
 {
-	// NOTE(doyle): OpenAL error stack is 1 deep
-	ALenum errorCode;
-	while ((errorCode = alGetError()) != AL_NO_ERROR)
-	{
-		printf("OPENAL ");
-		switch(errorCode)
-		{
-		case AL_INVALID_NAME:
-			printf("INVALID_NAME | ");
-			break;
-		case AL_INVALID_ENUM:
-			printf("INVALID_ENUM | ");
-			break;
-		case AL_INVALID_VALUE:
-			printf("INVALID_VALUE | ");
-			break;
-		case AL_INVALID_OPERATION:
-			printf("INVALID_OPERATION | ");
-			break;
-		case AL_OUT_OF_MEMORY:
-			printf("OUT_OF_MEMORY | ");
-			break;
-		default:
-			printf("UNRECOGNISED ERROR CODE | ");
-			break;
-		}
-		printf("Error %08x, %s (%d)\n", errorCode, file, line);
-	}
-};
+	i32 result = platform_atomicAdd(index, 0);
+	return result;
+}
 
-const i32 audio_init(AudioManager *audioManager)
+INTERNAL b32 commandRingPush(AudioCommandRing *const ring,
+                             const AudioCommand *const command)
 {
-#ifdef DENGINE_DEBUG
-	ASSERT(audioManager);
-#endif
-	/* Clear error stack */
-	alGetError();
+	i32 writeIndex = ring->writeIndex;
+	if (writeIndex - ringLoad(&ring->readIndex) >= AUDIO_COMMAND_RING_SIZE)
+		return FALSE;
 
-	ALboolean enumerateAudioDevice =
-	    alcIsExtensionPresent(NULL, "ALC_ENUMERATION_EXT");
+	ring->commands[writeIndex & (AUDIO_COMMAND_RING_SIZE - 1)] = *command;
+	platform_atomicAdd(&ring->writeIndex, 1);
+	return TRUE;
+}
 
-	const ALCchar *device = NULL;
-	if (enumerateAudioDevice == AL_TRUE)
-	{
-		// TODO(doyle): Actually allow users to choose device to output
-		/*
-		  The OpenAL specification says that the list of devices is organized as
-		  a string devices are separated with a NULL character and the list is
-		  terminated by two NULL characters.
-
-		  alcGetString with NULL = get all device spcifiers not a particular one
-		*/
-		device        = alcGetString(NULL, ALC_DEVICE_SPECIFIER);
-		const ALCchar *next = device + 1;
-		size_t len = 0;
-
-		printf("Devices list:\n");
-		printf("----------\n");
-		while (device && *device != '\0' && next && *next != '\0')
-		{
-			printf("%s\n", device);
-			len = common_strlen(device);
-			device += (len + 1);
-			next += (len + 2);
-		}
-		printf("----------\n");
-	}
+INTERNAL b32 commandRingPop(AudioCommandRing *const ring,
+                            AudioCommand *const command)
+{
+	i32 readIndex = ring->readIndex;
+	if (readIndex == ringLoad(&ring->writeIndex)) return FALSE;
 
-	/* Get audio device */
-	ALCdevice *deviceAL = alcOpenDevice(device);
-	if (!deviceAL)
-	{
-		printf("alcOpenDevice() failed: Failed to init OpenAL device.\n");
-		return -1;
-	}
+	*command = ring->commands[readIndex & (AUDIO_COMMAND_RING_SIZE - 1)];
+	platform_atomicAdd(&ring->readIndex, 1);
+	return TRUE;
+}
 
-	/* Set device context */
-	ALCcontext *contextAL = alcCreateContext(deviceAL, NULL);
-	alcMakeContextCurrent(contextAL);
-	if (!contextAL)
-	{
-		printf("alcCreateContext() failed: Failed create AL context.\n");
-		return -1;
-	}
-	AL_CHECK_ERROR();
+INTERNAL void releaseRingPush(AudioReleaseRing *const ring, const i32 sound)
+{
+	i32 writeIndex = ring->writeIndex;
+	ASSERT(writeIndex - ringLoad(&ring->readIndex) < AUDIO_MAX_SOUNDS);
 
-	for (i32 i = 0; i < ARRAY_COUNT(audioManager->sourceList); i++)
-	{
-		alGenSources(1, &audioManager->sourceList[i].id);
-		AL_CHECK_ERROR();
+	ring->sounds[writeIndex & (AUDIO_MAX_SOUNDS - 1)] = sound;
+	platform_atomicAdd(&ring->writeIndex, 1);
+}
 
-		audioManager->sourceList[i].isFree = TRUE;
-	}
+INTERNAL b32 releaseRingPop(AudioReleaseRing *const ring, i32 *const sound)
+{
+	i32 readIndex = ring->readIndex;
+	if (readIndex == ringLoad(&ring->writeIndex)) return FALSE;
 
-	return 0;
+	*sound = ring->sounds[readIndex & (AUDIO_MAX_SOUNDS - 1)];
+	platform_atomicAdd(&ring->readIndex, 1);
+	return TRUE;
 }
 
-INTERNAL inline u32 getSourceId(AudioManager *audioManager,
-                                AudioRenderer *audioRenderer)
+/*
+ *********************************
+ * Metrics
+ *********************************
+ */
+INTERNAL f32 framesToMs(const i32 numFrames)
 {
-	u32 result = audioManager->sourceList[audioRenderer->sourceIndex].id;
+	f32 result = (numFrames * 1000.0f) / AUDIO_MIXER_SAMPLE_RATE;
 	return result;
 }
 
-INTERNAL i32 rendererAcquire(MemoryArena_ *arena, AudioManager *audioManager,
-                             AudioRenderer *audioRenderer)
+INTERNAL void metricsWindowReset(AudioMetrics *const metrics, const f64 now)
 {
-#ifdef DENGINE_DEBUG
-	ASSERT(arena && audioManager && audioRenderer);
-#endif
-	u32 checkSource = getSourceId(audioManager, audioRenderer);
-	if (alIsSource(checkSource) == AL_TRUE)
-	{
-#if 0
-		DEBUG_LOG(
-		    "rendererAcquire(): Renderer has not been released before "
-		    "acquiring, force release by stopping stream");
-#endif
-		audio_vorbisStop(arena, audioManager, audioRenderer);
-	}
+	metrics->windowStart       = now;
+	metrics->msQueuedLow       = framesToMs(AUDIO_DEVICE_NUM_BLOCKS *
+	                                        AUDIO_DEVICE_BLOCK_FRAMES);
+	metrics->msMixHigh         = 0;
+	metrics->msPlayLatencyHigh = 0;
+}
 
-	// TODO(doyle): Super bad linear O(n) search for every audio-enabled entity
-	i32 vacantSource = AUDIO_SOURCE_UNASSIGNED;
-	for (i32 i = 0; i < ARRAY_COUNT(audioManager->sourceList); i++)
-	{
-		if (audioManager->sourceList[i].isFree)
-		{
-			vacantSource = i;
-			audioManager->sourceList[i].isFree = FALSE;
-			break;
-		}
-	}
+/* Publish the marks of the window to the stats once it has elapsed */
+INTERNAL void metricsWindowUpdate(AudioManager *const audioManager)
+{
+	AudioMetrics *metrics = &audioManager->metrics;
+	f64 now               = platform_getTimeInSeconds();
+	if (now - metrics->windowStart < AUDIO_STATS_WINDOW_SECONDS) return;
+
+	AudioStats *stats        = &audioManager->stats;
+	stats->msQueuedLow       = metrics->msQueuedLow;
+	stats->msMixHigh         = metrics->msMixHigh;
+	stats->msPlayLatencyHigh = metrics->msPlayLatencyHigh;
+	metricsWindowReset(metrics, now);
+}
 
-	if (vacantSource == AUDIO_SOURCE_UNASSIGNED)
+INTERNAL void metricsPlayStarted(AudioMetrics *const metrics,
+                                 const f64 timeRequested)
+{
+	if (metrics->numPendingPlays == 0 ||
+	    timeRequested < metrics->pendingRequestedOldest)
 	{
-		DEBUG_LOG("rendererAcquire(): Failed to acquire free source, all busy");
-		return -1;
+		metrics->pendingRequestedOldest = timeRequested;
 	}
 
-	audioRenderer->sourceIndex = vacantSource;
-
-	/* Generate audio data buffers */
-	alGenBuffers(ARRAY_COUNT(audioRenderer->bufferId), audioRenderer->bufferId);
-	AL_CHECK_ERROR();
-
-	//alSourcef(audioRenderer->sourceId[0], AL_PITCH, 2.0f);
-
-	return 0;
+	metrics->numPendingPlays++;
+	metrics->pendingRequestedSum += timeRequested;
 }
 
-INTERNAL const i32 rendererRelease(MemoryArena_ *arena, AudioManager *audioManager,
-                                   AudioRenderer *audioRenderer)
+INTERNAL void traceBlockPush(AudioTrace *const trace,
+                             const AudioTraceBlock *const block)
 {
+	i32 writeIndex = trace->writeIndex;
+	trace->blocks[writeIndex & (AUDIO_TRACE_SIZE - 1)] = *block;
+	platform_atomicAdd(&trace->writeIndex, 1);
+}
 
-	i32 result = 0;
-	u32 alSourceId = getSourceId(audioManager, audioRenderer);
-	if (alIsSource(alSourceId) == AL_FALSE)
+/*
+ *********************************
+ * Audio Thread
+ *********************************
+ */
+/* Mix the next block of the voices and hand it to the device */
+INTERNAL void streamSubmitBlock(AudioManager *const audioManager)
+{
+	AudioMixer *mixer = &audioManager->mixer;
+	f64 mixStart      = platform_getTimeInSeconds();
+	audio_mixerMix(mixer, audioManager->streamBuffer,
+	               AUDIO_DEVICE_BLOCK_FRAMES);
+	f64 mixEnd = platform_getTimeInSeconds();
+
+	AudioDevice *device    = &audioManager->device;
+	AudioTraceBlock block  = {0};
+	block.time             = mixStart;
+	block.msQueued         = framesToMs(device->numFramesQueued);
+	block.msMix            = CAST(f32)((mixEnd - mixStart) * 1000.0);
+	block.numVoicesAudible = mixer->numAudible;
+	block.numVoicesVirtual = mixer->numVirtual;
+
+	// NOTE(doyle): Sounds started since the last block begin on its first
+	// frame, which leaves the device after the audio queued ahead of it
+	AudioMetrics *metrics = &audioManager->metrics;
+	if (metrics->numPendingPlays > 0)
 	{
-		DEBUG_LOG(
-		    "rendererRelease(): Trying to release invalid source, early exit");
-
-		result = -1;
-		return result;
+		f64 timeHeard = mixEnd + (block.msQueued / 1000.0);
+		f64 requested =
+		    metrics->pendingRequestedSum / metrics->numPendingPlays;
+		f64 oldest = metrics->pendingRequestedOldest;
+
+		block.msPlayLatency = CAST(f32)((timeHeard - requested) * 1000.0);
+		block.numPlays      = metrics->numPendingPlays;
+
+		f32 msOldest = CAST(f32)((timeHeard - oldest) * 1000.0);
+		metrics->msPlayLatencyHigh = MAX(metrics->msPlayLatencyHigh, msOldest);
+		metrics->numPendingPlays     = 0;
+		metrics->pendingRequestedSum = 0;
+		audioManager->stats.msPlayLatency = block.msPlayLatency;
 	}
 
-	/*
-	  NOTE(doyle): Doing an alSourceRewind will result in the source going to
-	  the AL_INITIAL state, but the properties of the source (position,
-	  velocity, etc.) will not change.
-	*/
-	alSourceRewind(alSourceId);
-	AL_CHECK_ERROR();
-
-	// TODO(doyle): We can possible remove this by just attaching the null buffer ..
-	ALint numProcessedBuffers;
-	alGetSourcei(alSourceId, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
-	if (numProcessedBuffers > 0)
+	audio_deviceSubmit(device, audioManager->streamBuffer);
+	block.numUnderruns = device->numUnderruns;
+	traceBlockPush(&audioManager->trace, &block);
+	metrics->msMixHigh = MAX(metrics->msMixHigh, block.msMix);
+
+	AudioStats *stats       = &audioManager->stats;
+	stats->numVoicesAudible = mixer->numAudible;
+	stats->numVoicesVirtual = mixer->numVirtual;
+	stats->msMix            = block.msMix;
+	stats->numBlocksMixed++;
+}
+
+INTERNAL void audioDoCommand(AudioManager *const audioManager,
+                             const AudioCommand *const command)
+{
+	AudioMixer *mixer      = &audioManager->mixer;
+	AudioVoiceHandle voice = audioManager->soundVoice[command->sound];
+	switch (command->type)
 	{
-		alSourceUnqueueBuffers(alSourceId, numProcessedBuffers,
-		                       audioRenderer->bufferId);
-	}
-	AL_CHECK_ERROR();
-
-	// NOTE(doyle): Any buffer queued up that has not been played cannot be
-	// deleted without being played once. We can set the source buffers to NULL
-	// (0) to free up the buffer, since we still hold the reference ids for the
-	// buffer in our audio structure we can delete it afterwards ..
-	alSourcei(alSourceId, AL_BUFFER, 0);
-	alDeleteBuffers(ARRAY_COUNT(audioRenderer->bufferId),
-	                audioRenderer->bufferId);
-	AL_CHECK_ERROR();
-
-	for (i32 i = 0; i < ARRAY_COUNT(audioRenderer->bufferId); i++)
+	case audiocommand_play:
 	{
-		audioRenderer->bufferId[i] = 0;
+		voice = audio_mixerPlay(mixer, command->vorbis, command->gain,
+		                        command->pan, command->numPlays,
+		                        command->priority);
+		audioManager->soundVoice[command->sound] = voice;
+
+		// NOTE(doyle): i.e. the clip is still loading, give the slot back
+		if (voice == AUDIO_VOICE_INVALID)
+			releaseRingPush(&audioManager->releaseRing, command->sound);
+		else
+			metricsPlayStarted(&audioManager->metrics, command->timeRequested);
 	}
+	break;
 
-	if (audioRenderer->isStreaming)
-	{
-		stb_vorbis_close(audioRenderer->audio->file);
+	case audiocommand_stop: audio_mixerStop(mixer, voice); break;
+	case audiocommand_pause: audio_mixerSetPaused(mixer, voice, TRUE); break;
+	case audiocommand_resume: audio_mixerSetPaused(mixer, voice, FALSE); break;
 
-		// TODO(doyle): Mem free
-		// PLATFORM_MEM_FREE(arena, audioRenderer->audio, sizeof(AudioVorbis));
+	case audiocommand_setGainPan:
+	{
+		audio_mixerSetGainPan(mixer, voice, command->gain, command->pan);
 	}
+	break;
 
-	u32 sourceIndexToFree      = audioRenderer->sourceIndex;
-	audioRenderer->sourceIndex = AUDIO_SOURCE_UNASSIGNED;
-
-	audioRenderer->audio       = NULL;
-	audioRenderer->numPlays    = 0;
-
-	audioRenderer->isStreaming = FALSE;
-	audioRenderer->state       = audiostate_stopped;
-
-	audioManager->sourceList[sourceIndexToFree].isFree = TRUE;
-
-	return result;
+	default:
+	{
+		ASSERT(INVALID_CODE_PATH);
+	}
+	break;
+	}
 }
 
-INTERNAL i32 initRendererForPlayback(MemoryArena_ *arena,
-                                     AudioManager *audioManager,
-                                     AudioRenderer *audioRenderer,
-                                     AudioVorbis *vorbis, i32 numPlays)
+INTERNAL void audioThreadUpdate(AudioManager *const audioManager)
 {
-#ifdef DENGINE_DEBUG
-	ASSERT(audioManager && audioRenderer && vorbis);
-	if (numPlays != AUDIO_REPEAT_INFINITE && numPlays <= 0)
+	AudioCommand command;
+	while (commandRingPop(&audioManager->commandRing, &command))
 	{
-		DEBUG_LOG("audio_vorbisStream() warning: Number of plays is less than 0");
+		audioDoCommand(audioManager, &command);
+		audioManager->stats.numCommands++;
 	}
-#endif
 
-	i32 result = rendererAcquire(arena, audioManager, audioRenderer);
-	if (result)
+	AudioDevice *device   = &audioManager->device;
+	AudioMetrics *metrics = &audioManager->metrics;
+	AudioStats *stats     = &audioManager->stats;
+	i32 numBlocks         = audio_deviceNumBlocksWanted(device);
+
+	// NOTE(doyle): The queue is at its lowest right before it is refilled
+	stats->msQueued      = framesToMs(device->numFramesQueued);
+	metrics->msQueuedLow = MIN(metrics->msQueuedLow, stats->msQueued);
+	for (i32 i = 0; i < numBlocks; i++)
+		streamSubmitBlock(audioManager);
+
+	stats->numUnderruns    = device->numUnderruns;
+	stats->numBlocksQueued = (device->numFramesQueued +
+	                          AUDIO_DEVICE_BLOCK_FRAMES - 1) /
+	                         AUDIO_DEVICE_BLOCK_FRAMES;
+	metricsWindowUpdate(audioManager);
+
+	/* Hand the slots of finished sounds back to the game thread */
+	for (i32 i = 0; i < ARRAY_COUNT(audioManager->soundVoice); i++)
 	{
-		DEBUG_LOG("audio_vorbisStream() failed: Could not acquire renderer");
-		return result;
+		AudioVoiceHandle *voice = &audioManager->soundVoice[i];
+		if (*voice == AUDIO_VOICE_INVALID) continue;
+
+		if (!audio_mixerIsPlaying(&audioManager->mixer, *voice))
+		{
+			*voice = AUDIO_VOICE_INVALID;
+			releaseRingPush(&audioManager->releaseRing, i);
+		}
 	}
+}
 
-	/* Determine format */
-	audioRenderer->format = AL_FORMAT_MONO16;
-	if (vorbis->info.channels == 2)
-		audioRenderer->format = AL_FORMAT_STEREO16;
-	else if (vorbis->info.channels != 1)
+INTERNAL void audioThread(void *userData)
+{
+	AudioManager *audioManager = CAST(AudioManager *) userData;
+	for (;;)
 	{
-#ifdef DENGINE_DEBUG
-		DEBUG_LOG(
-		    "audio_vorbisStream() warning: Unexpected channel format");
-#endif
+		audioThreadUpdate(audioManager);
+		platform_sleep(AUDIO_THREAD_SLEEP_SECONDS);
 	}
+}
 
-	audioRenderer->numPlays = numPlays;
+/*
+ *********************************
+ * Game Thread
+ *********************************
+ */
+INTERNAL void soundsInit(AudioManager *const audioManager)
+{
+	for (i32 i = 0; i < ARRAY_COUNT(audioManager->sounds); i++)
+	{
+		audioManager->sounds[i].nextFree = i + 1;
+		audioManager->soundVoice[i]      = AUDIO_VOICE_INVALID;
+	}
 
-	return result;
+	audioManager->sounds[AUDIO_MAX_SOUNDS - 1].nextFree = -1;
+	audioManager->firstFreeSound                        = 0;
 }
 
-#include <stdlib.h>
-const i32 audio_vorbisPlay(MemoryArena_ *arena, AudioManager *audioManager,
-                           AudioRenderer *audioRenderer, AudioVorbis *vorbis,
-                           i32 numPlays)
+INTERNAL void soundFree(AudioManager *const audioManager, const i32 index)
 {
-	if (vorbis == NULL) return -1;
+	AudioSound *sound = &audioManager->sounds[index];
+	sound->vorbis     = NULL;
+	sound->inUse      = FALSE;
+	sound->generation = (sound->generation + 1) & 0x7FFF;
+	sound->nextFree   = audioManager->firstFreeSound;
 
-	i32 result = initRendererForPlayback(arena, audioManager, audioRenderer,
-	                                     vorbis, numPlays);
+	audioManager->firstFreeSound = index;
+}
 
-	i16 *soundSamples;
-	i32 channels, sampleRate;
-	i32 numSamples = stb_vorbis_decode_memory(
-	    vorbis->data, vorbis->size, &channels, &sampleRate, &soundSamples);
-	alBufferData(audioRenderer->bufferId[0], audioRenderer->format,
-	             soundSamples, numSamples * vorbis->info.channels * sizeof(i16),
-	             vorbis->info.sample_rate);
+/* Returns the slot index of the handle or -1 if it has been released */
+INTERNAL i32 soundGetIndex(AudioManager *const audioManager,
+                           const AudioSoundHandle handle)
+{
+	if (handle == AUDIO_SOUND_INVALID) return -1;
 
-	// NOTE(doyle): stb_vorbis specific implementation requires free()
-	// TODO(doyle): Object pool this and use our malloc to avoid dependency in Audio.c
-	free(soundSamples);
+	i32 index      = handle & 0xFFFF;
+	u16 generation = CAST(u16)((handle >> 16) & 0x7FFF);
+	if (index >= ARRAY_COUNT(audioManager->sounds)) return -1;
 
-	audioRenderer->audio       = vorbis;
-	audioRenderer->isStreaming = FALSE;
-	audioRenderer->state       = audiostate_playing;
+	AudioSound *sound = &audioManager->sounds[index];
+	if (!sound->inUse || sound->generation != generation) return -1;
 
-	return result;
+	return index;
 }
 
-const i32 audio_vorbisStream(MemoryArena_ *arena, AudioManager *audioManager,
-                                 AudioRenderer *audioRenderer,
-                                 AudioVorbis *vorbis, i32 numPlays)
+INTERNAL void soundCommand(AudioManager *const audioManager,
+                           const AudioSoundHandle handle,
+                           const enum AudioCommandType type, const f32 gain,
+                           const f32 pan)
 {
+	i32 index = soundGetIndex(audioManager, handle);
+	if (index == -1) return;
+
+	AudioCommand command = {0};
+	command.type         = type;
+	command.sound        = index;
+	command.gain         = gain;
+	command.pan          = pan;
+	if (!commandRingPush(&audioManager->commandRing, &command))
+		audioManager->numCommandsDropped++;
+}
 
-	// TODO(doyle): Streaming leaks memory, we don't free the "copy audio"
-	ASSERT(INVALID_CODE_PATH);
+const i32 audio_init(AudioManager *audioManager, MemoryArena_ *arena,
+                     const AudioDeviceConfig *const deviceConfig)
+{
+#ifdef DENGINE_DEBUG
+	ASSERT(audioManager && arena && deviceConfig);
+#endif
+	audio_mixerInit(&audioManager->mixer, arena);
+	soundsInit(audioManager);
+	metricsWindowReset(&audioManager->metrics, platform_getTimeInSeconds());
 
-	if (vorbis == NULL) return -1;
+	AudioDevice *device = &audioManager->device;
+	if (audio_deviceOpen(device, deviceConfig))
+	{
+		if (deviceConfig->type != audiodevice_openal) return -1;
 
-	i32 result = initRendererForPlayback(arena, audioManager, audioRenderer,
-	                                     vorbis, numPlays);
-	// NOTE(doyle): We make a copy of the audio vorbis file using all the same
-	// data except the file pointer. If the same sound is playing twice
-	// simultaneously, we need unique file pointers into the data to track song
-	// position uniquely
-	AudioVorbis *copyAudio     = MEMORY_PUSH_STRUCT(arena, AudioVorbis);
-	*copyAudio                 = *vorbis;
+		// NOTE(doyle): Keep the audio running without sound hardware
+		DEBUG_LOG("audio_init() warning: No OpenAL device, using null sink");
+		AudioDeviceConfig nullConfig = {0};
+		nullConfig.type              = audiodevice_null;
+		if (audio_deviceOpen(device, &nullConfig)) return -1;
+	}
 
-	i32 error;
-	copyAudio->file =
-	    stb_vorbis_open_memory(copyAudio->data, copyAudio->size, &error, NULL);
+	audioManager->deviceOpened = TRUE;
+	if (deviceConfig->unthrottled) return 0;
 
-	audioRenderer->audio       = copyAudio;
-	audioRenderer->isStreaming = TRUE;
-	audioRenderer->state       = audiostate_playing;
+	// NOTE(doyle): Nothing touches the device on this thread from here on
+	if (platform_threadCreate(audioThread, audioManager) == 0)
+		audioManager->threadRunning = TRUE;
+	else
+		DEBUG_LOG("audio_init() warning: No audio thread, mixing per frame");
 
-	return result;
+	return 0;
 }
 
-const i32 audio_vorbisStop(MemoryArena_ *arena, AudioManager *audioManager,
-                           AudioRenderer *audioRenderer)
+AudioSoundHandle audio_play(AudioManager *const audioManager,
+                            AudioVorbis *const vorbis, const f32 gain,
+                            const f32 pan, const i32 numPlays,
+                            const enum AudioPriority priority)
 {
-	i32 result     = 0;
-	u32 alSourceId = getSourceId(audioManager, audioRenderer);
-	if (alIsSource(alSourceId) == AL_TRUE)
+	if (!audioManager->deviceOpened) return AUDIO_SOUND_INVALID;
+
+	i32 index = audioManager->firstFreeSound;
+	if (index == -1) return AUDIO_SOUND_INVALID;
+
+	AudioCommand command  = {0};
+	command.type          = audiocommand_play;
+	command.sound         = index;
+	command.vorbis        = vorbis;
+	command.gain          = gain;
+	command.pan           = pan;
+	command.numPlays      = numPlays;
+	command.priority      = priority;
+	command.timeRequested = platform_getTimeInSeconds();
+	if (!commandRingPush(&audioManager->commandRing, &command))
 	{
-		alSourceStop(alSourceId);
-		AL_CHECK_ERROR();
-		result = rendererRelease(arena, audioManager, audioRenderer);
-		audioRenderer->state = audiostate_stopped;
-	}
-	else
-	{
-#ifdef DENGINE_DEBUG
-		if (audioRenderer->audio)
-		{
-			DEBUG_LOG(
-			    "audio_streamStopVorbis(): Tried to stop invalid source, but "
-			    "renderer has valid audio ptr");
-		}
-#endif
-		result = -1;
+		audioManager->numCommandsDropped++;
+		return AUDIO_SOUND_INVALID;
 	}
 
+	AudioSound *sound            = &audioManager->sounds[index];
+	audioManager->firstFreeSound = sound->nextFree;
+	sound->vorbis                = vorbis;
+	sound->inUse                 = TRUE;
+
+	AudioSoundHandle result = index | (sound->generation << 16);
 	return result;
 }
 
-const i32 audio_vorbisPause(AudioManager *audioManager,
-                            AudioRenderer *audioRenderer)
+void audio_stop(AudioManager *const audioManager,
+                const AudioSoundHandle sound)
 {
-	i32 result     = 0;
-	u32 alSourceId = getSourceId(audioManager, audioRenderer);
-	if (alIsSource(alSourceId) == AL_TRUE)
-	{
-		alSourcePause(alSourceId);
-		AL_CHECK_ERROR();
-		audioRenderer->state = audiostate_paused;
-	}
-	else
-	{
-		DEBUG_LOG("audio_streamPauseVorbis(): Tried to pause invalid source");
-		result = -1;
-	}
-	return result;
+	soundCommand(audioManager, sound, audiocommand_stop, 0, 0);
+}
+
+void audio_pause(AudioManager *const audioManager,
+                 const AudioSoundHandle sound)
+{
+	soundCommand(audioManager, sound, audiocommand_pause, 0, 0);
+}
+
+void audio_resume(AudioManager *const audioManager,
+                  const AudioSoundHandle sound)
+{
+	soundCommand(audioManager, sound, audiocommand_resume, 0, 0);
 }
 
-const i32 audio_vorbisResume(AudioManager *audioManager,
-                             AudioRenderer *audioRenderer)
+void audio_setGainPan(AudioManager *const audioManager,
+                      const AudioSoundHandle sound, const f32 gain,
+                      const f32 pan)
 {
+	soundCommand(audioManager, sound, audiocommand_setGainPan, gain, pan);
+}
+
+i32 audio_numPlaying(AudioManager *const audioManager,
+                     const AudioVorbis *const vorbis)
+{
+	// NOTE(doyle): Keys are interned by the asset manager, comparing the
+	// pointers identifies the same sound
 	i32 result = 0;
-	u32 alSourceId = getSourceId(audioManager, audioRenderer);
-	if (alIsSource(alSourceId) == AL_TRUE)
-	{
-		alSourcePlay(alSourceId);
-		AL_CHECK_ERROR();
-		audioRenderer->state = audiostate_playing;
-	}
-	else
+	for (i32 i = 0; i < ARRAY_COUNT(audioManager->sounds); i++)
 	{
-#ifdef DENGINE_DEBUG
-		DEBUG_LOG("audio_vorbisResume(): Tried to resume invalid source")
-#endif
-		result = -1;
+		AudioSound *sound = &audioManager->sounds[i];
+		if (sound->inUse && sound->vorbis->key == vorbis->key) result++;
 	}
 
 	return result;
 }
 
-#define AUDIO_CHUNK_SIZE_ 65536
-const i32 audio_updateAndPlay(MemoryArena_ *arena, AudioManager *audioManager,
-                              AudioRenderer *audioRenderer)
+const i32 audio_update(AudioManager *const audioManager)
 {
-	AudioVorbis *audio = audioRenderer->audio;
-	if (!audio) return 0;
+	if (!audioManager->deviceOpened) return -1;
 
-	u32 alSourceId = getSourceId(audioManager, audioRenderer);
-	if (alIsSource(alSourceId) == AL_FALSE)
+	if (!audioManager->threadRunning) audioThreadUpdate(audioManager);
+
+	i32 index;
+	while (releaseRingPop(&audioManager->releaseRing, &index))
+		soundFree(audioManager, index);
+
+	return 0;
+}
+
+i32 audio_traceExport(AudioManager *const audioManager, const char *path)
+{
+	PlatformFileWrite file = {0};
+	if (platform_fileWriteOpen(&file, path))
 	{
-		DEBUG_LOG("audio_updateAndPlay(): Update failed on invalid source id");
+		DEBUG_LOG("audio_traceExport() failed: Could not open file");
 		return -1;
 	}
 
-	ALint audioState;
-	alGetSourcei(alSourceId, AL_SOURCE_STATE, &audioState);
-	AL_CHECK_ERROR();
-	if (audioState == AL_STOPPED || audioState == AL_INITIAL)
+	// NOTE(doyle): Leave out the oldest blocks, the audio thread can be
+	// writing over them while they are read
+	AudioTrace *trace = &audioManager->trace;
+	i32 writeIndex    = ringLoad(&trace->writeIndex);
+	i32 numBlocks     = MIN(writeIndex, AUDIO_TRACE_SIZE - 64);
+
+	const char *header = "{\"traceEvents\":[\n";
+	i32 result = platform_fileWrite(&file, header, common_strlen(header));
+
+	f64 timeStart    = 0;
+	i32 numUnderruns = 0;
+	char event[1024];
+	for (i32 i = 0; i < numBlocks && result == 0; i++)
 	{
-		if (audioState == AL_STOPPED)
+		i32 index              = writeIndex - numBlocks + i;
+		AudioTraceBlock *block = &trace->blocks[index & (AUDIO_TRACE_SIZE - 1)];
+		if (i == 0)
 		{
-			if (audioRenderer->numPlays != AUDIO_REPEAT_INFINITE)
-				audioRenderer->numPlays--;
-
-			if (audioRenderer->numPlays == AUDIO_REPEAT_INFINITE ||
-			    audioRenderer->numPlays > 0)
-			{
-				// TODO(doyle): Delete and recreate fixes clicking when reusing
-				// buffers
-				alDeleteBuffers(ARRAY_COUNT(audioRenderer->bufferId),
-				                audioRenderer->bufferId);
-				AL_CHECK_ERROR();
-
-				alGenBuffers(ARRAY_COUNT(audioRenderer->bufferId),
-				             audioRenderer->bufferId);
-				AL_CHECK_ERROR();
-			}
-			else
-			{
-				i32 result =
-				    rendererRelease(arena, audioManager, audioRenderer);
-				return result;
-			}
+			timeStart    = block->time;
+			numUnderruns = block->numUnderruns;
 		}
 
-		if (audioRenderer->isStreaming)
+		f64 ts  = (block->time - timeStart) * 1000000.0;
+		i32 len = snprintf(
+		    event, ARRAY_COUNT(event),
+		    "%s{\"name\":\"Audio Queued Ms\",\"ph\":\"C\",\"ts\":%.0f,"
+		    "\"pid\":1,\"args\":{\"queued\":%.3f}},\n"
+		    "{\"name\":\"Audio Mix Ms\",\"ph\":\"C\",\"ts\":%.0f,"
+		    "\"pid\":1,\"args\":{\"mix\":%.3f}},\n"
+		    "{\"name\":\"Audio Voices\",\"ph\":\"C\",\"ts\":%.0f,"
+		    "\"pid\":1,\"args\":{\"audible\":%d,\"virtual\":%d}}",
+		    (i == 0) ? "" : ",\n", ts, block->msQueued, ts, block->msMix, ts,
+		    block->numVoicesAudible, block->numVoicesVirtual);
+
+		if (block->numPlays > 0)
 		{
-			stb_vorbis_seek_start(audio->file);
-			for (i32 i = 0; i < ARRAY_COUNT(audioRenderer->bufferId); i++)
-			{
-				i16 audioChunk[AUDIO_CHUNK_SIZE_] = {0};
-				stb_vorbis_get_samples_short_interleaved(
-				    audio->file, audio->info.channels, audioChunk,
-				    AUDIO_CHUNK_SIZE_);
-
-				alBufferData(audioRenderer->bufferId[i], audioRenderer->format,
-				             audioChunk, AUDIO_CHUNK_SIZE_ * sizeof(i16),
-				             audio->info.sample_rate);
-				AL_CHECK_ERROR();
-			}
-
-			alSourceQueueBuffers(alSourceId,
-			                     ARRAY_COUNT(audioRenderer->bufferId),
-			                     audioRenderer->bufferId);
-		}
-		else
-		{
-			alSourceQueueBuffers(alSourceId, 1, audioRenderer->bufferId);
+			len += snprintf(
+			    event + len, ARRAY_COUNT(event) - len,
+			    ",\n{\"name\":\"Audio Play Latency Ms\",\"ph\":\"C\","
+			    "\"ts\":%.0f,\"pid\":1,\"args\":{\"latency\":%.3f,"
+			    "\"plays\":%d}}",
+			    ts, block->msPlayLatency, block->numPlays);
 		}
 
-		AL_CHECK_ERROR();
-		alSourcePlay(alSourceId);
-		AL_CHECK_ERROR();
-	}
-	else if (audioState == AL_PLAYING)
-	{
-		ALint numProcessedBuffers;
-		alGetSourcei(alSourceId, AL_BUFFERS_PROCESSED,
-		             &numProcessedBuffers);
-		AL_CHECK_ERROR();
-		if (numProcessedBuffers > 0)
+		if (block->numUnderruns != numUnderruns)
 		{
-			// TODO(doyle): Possibly wrong, we should pass in all processed buffers?
-			ALint numBuffersToUnqueue = 1;
-			ALuint emptyBufferId;
-			alSourceUnqueueBuffers(alSourceId, numBuffersToUnqueue,
-			                       &emptyBufferId);
-			AL_CHECK_ERROR();
-
-			i16 audioChunk[AUDIO_CHUNK_SIZE_] = {0};
-			i32 sampleCount = stb_vorbis_get_samples_short_interleaved(
-			    audio->file, audio->info.channels, audioChunk,
-			    AUDIO_CHUNK_SIZE_);
-
-			/* There are still samples to play */
-			if (sampleCount > 0)
-			{
-				alBufferData(emptyBufferId, audioRenderer->format, audioChunk,
-				             sampleCount * audio->info.channels * sizeof(i16),
-				             audio->info.sample_rate);
-				AL_CHECK_ERROR();
-				alSourceQueueBuffers(alSourceId, 1, &emptyBufferId);
-				AL_CHECK_ERROR();
-			}
+			len += snprintf(event + len, ARRAY_COUNT(event) - len,
+			                ",\n{\"name\":\"Audio Underrun\",\"ph\":\"i\","
+			                "\"s\":\"g\",\"ts\":%.0f,\"pid\":1}",
+			                ts);
+			numUnderruns = block->numUnderruns;
 		}
+
+		result = platform_fileWrite(&file, event, len);
 	}
 
-	return 0;
+	const char *footer = "\n]}\n";
+	if (result == 0)
+		result = platform_fileWrite(&file, footer, common_strlen(footer));
+
+	platform_fileWriteClose(&file);
+	return result;
 }
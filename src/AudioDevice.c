@@ -0,0 +1,341 @@
+#include "Dengine/AudioDevice.h"
+#include "Dengine/Debug.h"
+
+#define AL_CHECK_ERROR() alCheckError_(__FILE__, __LINE__);
+void alCheckError_(const char *file, int line)
+{
+	// NOTE(doyle): OpenAL error stack is 1 deep
+	ALenum errorCode;
+	while ((errorCode = alGetError()) != AL_NO_ERROR)
+	{
+		printf("OPENAL ");
+		switch(errorCode)
+		{
+		case AL_INVALID_NAME:
+			printf("INVALID_NAME | ");
+			break;
+		case AL_INVALID_ENUM:
+			printf("INVALID_ENUM | ");
+			break;
+		case AL_INVALID_VALUE:
+			printf("INVALID_VALUE | ");
+			break;
+		case AL_INVALID_OPERATION:
+			printf("INVALID_OPERATION | ");
+			break;
+		case AL_OUT_OF_MEMORY:
+			printf("OUT_OF_MEMORY | ");
+			break;
+		default:
+			printf("UNRECOGNISED ERROR CODE | ");
+			break;
+		}
+		printf("Error %08x, %s (%d)\n", errorCode, file, line);
+	}
+};
+
+#define AUDIO_DEVICE_BLOCK_BYTES                                               \
+	(AUDIO_DEVICE_BLOCK_FRAMES * AUDIO_MIXER_NUM_CHANNELS * sizeof(i16))
+
+/*
+ *********************************
+ * OpenAL
+ *********************************
+ */
+INTERNAL i32 openALOpen(AudioDevice *const device)
+{
+	/* Clear error stack */
+	alGetError();
+
+	ALboolean enumerateAudioDevice =
+	    alcIsExtensionPresent(NULL, "ALC_ENUMERATION_EXT");
+
+	const ALCchar *deviceName = NULL;
+	if (enumerateAudioDevice == AL_TRUE)
+	{
+		// TODO(doyle): Actually allow users to choose device to output
+		/*
+		  The OpenAL specification says that the list of devices is organized as
+		  a string devices are separated with a NULL character and the list is
+		  terminated by two NULL characters.
+
+		  alcGetString with NULL = get all device spcifiers not a particular one
+		*/
+		deviceName          = alcGetString(NULL, ALC_DEVICE_SPECIFIER);
+		const ALCchar *next = deviceName + 1;
+		size_t len = 0;
+
+		printf("Devices list:\n");
+		printf("----------\n");
+		while (deviceName && *deviceName != '\0' && next && *next != '\0')
+		{
+			printf("%s\n", deviceName);
+			len = common_strlen(deviceName);
+			deviceName += (len + 1);
+			next += (len + 2);
+		}
+		printf("----------\n");
+	}
+
+	/* Get audio device */
+	device->deviceAL = alcOpenDevice(deviceName);
+	if (!device->deviceAL)
+	{
+		printf("alcOpenDevice() failed: Failed to init OpenAL device.\n");
+		return -1;
+	}
+
+	/* Set device context */
+	device->contextAL = alcCreateContext(device->deviceAL, NULL);
+	alcMakeContextCurrent(device->contextAL);
+	if (!device->contextAL)
+	{
+		printf("alcCreateContext() failed: Failed create AL context.\n");
+		alcCloseDevice(device->deviceAL);
+		device->deviceAL = NULL;
+		return -1;
+	}
+	AL_CHECK_ERROR();
+
+	alGenSources(1, &device->sourceId);
+	alGenBuffers(ARRAY_COUNT(device->bufferId), device->bufferId);
+	AL_CHECK_ERROR();
+
+	for (i32 i = 0; i < ARRAY_COUNT(device->bufferId); i++)
+		device->freeBuffers[i] = device->bufferId[i];
+	device->numFreeBuffers = ARRAY_COUNT(device->bufferId);
+
+	return 0;
+}
+
+INTERNAL i32 openALNumBlocksWanted(AudioDevice *const device)
+{
+	ALint numProcessedBuffers;
+	alGetSourcei(device->sourceId, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
+	for (i32 i = 0; i < numProcessedBuffers; i++)
+	{
+		ALuint bufferId;
+		alSourceUnqueueBuffers(device->sourceId, 1, &bufferId);
+		device->freeBuffers[device->numFreeBuffers++] = bufferId;
+	}
+
+	// NOTE(doyle): Less what the source has played of its current buffer
+	ALint sampleOffset  = 0;
+	i32 numBlocksQueued = AUDIO_DEVICE_NUM_BLOCKS - device->numFreeBuffers;
+	if (numBlocksQueued > 0)
+		alGetSourcei(device->sourceId, AL_SAMPLE_OFFSET, &sampleOffset);
+	AL_CHECK_ERROR();
+
+	device->numFramesQueued =
+	    (numBlocksQueued * AUDIO_DEVICE_BLOCK_FRAMES) - sampleOffset;
+	return device->numFreeBuffers;
+}
+
+INTERNAL void openALSubmit(AudioDevice *const device, const i16 *const block)
+{
+	ASSERT(device->numFreeBuffers > 0);
+	ALuint bufferId = device->freeBuffers[--device->numFreeBuffers];
+	alBufferData(bufferId, AL_FORMAT_STEREO16, block, AUDIO_DEVICE_BLOCK_BYTES,
+	             AUDIO_MIXER_SAMPLE_RATE);
+	alSourceQueueBuffers(device->sourceId, 1, &bufferId);
+
+	// NOTE(doyle): The source stops if every buffer played out before they
+	// were refilled, restart it
+	ALint sourceState;
+	alGetSourcei(device->sourceId, AL_SOURCE_STATE, &sourceState);
+	if (sourceState != AL_PLAYING)
+	{
+		if (device->sourceStarted) device->numUnderruns++;
+
+		alSourcePlay(device->sourceId);
+		device->sourceStarted = TRUE;
+	}
+	AL_CHECK_ERROR();
+}
+
+INTERNAL void openALClose(AudioDevice *const device)
+{
+	alSourceStop(device->sourceId);
+	alDeleteSources(1, &device->sourceId);
+	alDeleteBuffers(ARRAY_COUNT(device->bufferId), device->bufferId);
+	AL_CHECK_ERROR();
+
+	alcMakeContextCurrent(NULL);
+	alcDestroyContext(device->contextAL);
+	alcCloseDevice(device->deviceAL);
+}
+
+/*
+ *********************************
+ * Sinks
+ *********************************
+ */
+INTERNAL void wavPutU16(u8 *const dest, const u16 value)
+{
+	dest[0] = CAST(u8)(value & 0xFF);
+	dest[1] = CAST(u8)((value >> 8) & 0xFF);
+}
+
+INTERNAL void wavPutU32(u8 *const dest, const u32 value)
+{
+	wavPutU16(dest, CAST(u16)(value & 0xFFFF));
+	wavPutU16(dest + 2, CAST(u16)(value >> 16));
+}
+
+/* Canonical 44 byte header of 16 bit PCM, little endian on any host */
+INTERNAL i32 wavWriteHeader(AudioDevice *const device)
+{
+	const i32 bytesPerFrame = AUDIO_MIXER_NUM_CHANNELS * sizeof(i16);
+
+	u8 header[44];
+	common_memcpy(header, CAST(const u8 *) "RIFF", 4);
+	wavPutU32(header + 4, 36 + device->wavDataSize);
+	common_memcpy(header + 8, CAST(const u8 *) "WAVEfmt ", 8);
+	wavPutU32(header + 16, 16);
+	wavPutU16(header + 20, 1);
+	wavPutU16(header + 22, AUDIO_MIXER_NUM_CHANNELS);
+	wavPutU32(header + 24, AUDIO_MIXER_SAMPLE_RATE);
+	wavPutU32(header + 28, AUDIO_MIXER_SAMPLE_RATE * bytesPerFrame);
+	wavPutU16(header + 32, bytesPerFrame);
+	wavPutU16(header + 34, 16);
+	common_memcpy(header + 36, CAST(const u8 *) "data", 4);
+	wavPutU32(header + 40, device->wavDataSize);
+
+	i32 result =
+	    platform_fileWriteAt(&device->wavFile, 0, header, sizeof(header));
+	return result;
+}
+
+INTERNAL i32 sinkNumBlocksWanted(AudioDevice *const device)
+{
+	device->numFramesQueued = 0;
+	if (device->config.unthrottled || device->numFramesSubmitted == 0)
+		return AUDIO_DEVICE_NUM_BLOCKS;
+
+	/* Frames the clock says have played out since the first block */
+	f64 elapsed         = platform_getTimeInSeconds() - device->clockStart;
+	i32 numFramesPlayed = CAST(i32)(elapsed * AUDIO_MIXER_SAMPLE_RATE);
+	i32 numFramesQueued = device->numFramesSubmitted - numFramesPlayed;
+	if (numFramesQueued <= 0)
+	{
+		// NOTE(doyle): Same as a device that ran dry, start the clock over
+		device->numUnderruns++;
+		device->numFramesSubmitted = 0;
+		return AUDIO_DEVICE_NUM_BLOCKS;
+	}
+
+	device->numFramesQueued = numFramesQueued;
+	i32 numBlocksQueued =
+	    (numFramesQueued + AUDIO_DEVICE_BLOCK_FRAMES - 1) /
+	    AUDIO_DEVICE_BLOCK_FRAMES;
+	i32 result = MAX(AUDIO_DEVICE_NUM_BLOCKS - numBlocksQueued, 0);
+	return result;
+}
+
+INTERNAL void sinkSubmit(AudioDevice *const device, const i16 *const block)
+{
+	if (device->numFramesSubmitted == 0)
+		device->clockStart = platform_getTimeInSeconds();
+
+	device->numFramesSubmitted += AUDIO_DEVICE_BLOCK_FRAMES;
+
+	// NOTE(doyle): Move the clock on each minute so the count never overflows
+	const i32 framesPerMinute = AUDIO_MIXER_SAMPLE_RATE * 60;
+	if (device->numFramesSubmitted >= framesPerMinute * 2)
+	{
+		device->clockStart         += 60.0;
+		device->numFramesSubmitted -= framesPerMinute;
+	}
+
+	if (device->config.type == audiodevice_wav && device->wavFile.isOpen)
+	{
+		if (platform_fileWrite(&device->wavFile, block,
+		                       AUDIO_DEVICE_BLOCK_BYTES) == 0)
+		{
+			device->wavDataSize += AUDIO_DEVICE_BLOCK_BYTES;
+			wavWriteHeader(device);
+		}
+		else
+		{
+			DEBUG_LOG("sinkSubmit() failed: WAV capture stopped");
+			platform_fileWriteClose(&device->wavFile);
+		}
+	}
+}
+
+/*
+ *********************************
+ * Device
+ *********************************
+ */
+i32 audio_deviceOpen(AudioDevice *const device,
+                     const AudioDeviceConfig *const config)
+{
+	common_memset(CAST(u8 *) device, 0, sizeof(*device));
+	device->config = *config;
+
+	i32 result = 0;
+	switch (config->type)
+	{
+	case audiodevice_openal: result = openALOpen(device); break;
+	case audiodevice_null: break;
+
+	case audiodevice_wav:
+	{
+		if (!config->wavPath ||
+		    platform_fileWriteOpen(&device->wavFile, config->wavPath))
+		{
+			result = -1;
+			break;
+		}
+
+		result = wavWriteHeader(device);
+		if (result) platform_fileWriteClose(&device->wavFile);
+	}
+	break;
+
+	default:
+	{
+		ASSERT(INVALID_CODE_PATH);
+		result = -1;
+	}
+	break;
+	}
+
+	return result;
+}
+
+i32 audio_deviceNumBlocksWanted(AudioDevice *const device)
+{
+	i32 result;
+	if (device->config.type == audiodevice_openal)
+		result = openALNumBlocksWanted(device);
+	else
+		result = sinkNumBlocksWanted(device);
+
+	return result;
+}
+
+void audio_deviceSubmit(AudioDevice *const device, const i16 *const block)
+{
+	if (device->config.type == audiodevice_openal)
+		openALSubmit(device, block);
+	else
+		sinkSubmit(device, block);
+
+	device->numFramesQueued += AUDIO_DEVICE_BLOCK_FRAMES;
+}
+
+void audio_deviceClose(AudioDevice *const device)
+{
+	if (device->config.type == audiodevice_openal)
+	{
+		if (device->deviceAL) openALClose(device);
+	}
+	else if (device->config.type == audiodevice_wav)
+	{
+		platform_fileWriteClose(&device->wavFile);
+	}
+
+	common_memset(CAST(u8 *) device, 0, sizeof(*device));
+}
@@ -0,0 +1,1221 @@
+#include "Dengine/AudioMixer.h"
+#include "Dengine/Debug.h"
+#include "Dengine/Math.h"
+
+/*
+   NOTE(doyle): The widest instruction set the compiler targets is used, MSVC
+   x86 targets SSE2 by default and AVX2 with /arch:AVX2. Every kernel finishes
+   the frames that do not fill a vector with the scalar version.
+ */
+#if defined(__AVX2__)
+	#define AUDIO_MIXER_AVX2
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define AUDIO_MIXER_SSE2
+	#include <emmintrin.h>
+#endif
+
+/*
+ *********************************
+ * Kernels
+ *********************************
+ */
+// NOTE(doyle): Mix buffer samples are normalised to [-1, 1], the 16 bit scale
+// is folded into the voice gains
+#define AUDIO_MIXER_I16_TO_F32 (1.0f / 32768.0f)
+
+INTERNAL void mixMonoScalar(f32 *const dest, const i16 *const src,
+                            const i32 numFrames, const f32 gainL,
+                            const f32 gainR)
+{
+	for (i32 i = 0; i < numFrames; i++)
+	{
+		f32 sample         = CAST(f32) src[i];
+		dest[(i * 2)]     += sample * gainL;
+		dest[(i * 2) + 1] += sample * gainR;
+	}
+}
+
+INTERNAL void mixStereoScalar(f32 *const dest, const i16 *const src,
+                              const i32 numFrames, const f32 gainL,
+                              const f32 gainR)
+{
+	for (i32 i = 0; i < numFrames; i++)
+	{
+		dest[(i * 2)]     += CAST(f32) src[(i * 2)] * gainL;
+		dest[(i * 2) + 1] += CAST(f32) src[(i * 2) + 1] * gainR;
+	}
+}
+
+INTERNAL void mixToI16Scalar(const f32 *const src, i16 *const dest,
+                             const i32 numSamples)
+{
+	for (i32 i = 0; i < numSamples; i++)
+	{
+		f32 sample = MIN(MAX(src[i], -1.0f), 1.0f) * 32767.0f;
+		dest[i]    = CAST(i16)((sample >= 0) ? sample + 0.5f : sample - 0.5f);
+	}
+}
+
+INTERNAL void mixMono(f32 *const dest, const i16 *const src,
+                      const i32 numFrames, const f32 gainL, const f32 gainR)
+{
+	i32 i = 0;
+#if defined(AUDIO_MIXER_AVX2)
+	__m256 gainL8 = _mm256_set1_ps(gainL);
+	__m256 gainR8 = _mm256_set1_ps(gainR);
+	for (; i + 8 <= numFrames; i += 8)
+	{
+		__m128i src16  = _mm_loadu_si128(CAST(const __m128i *)(src + i));
+		__m256 samples = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(src16));
+		__m256 left    = _mm256_mul_ps(samples, gainL8);
+		__m256 right   = _mm256_mul_ps(samples, gainR8);
+
+		// NOTE(doyle): Unpacks interleave within each 128 bit lane
+		__m256 lo    = _mm256_unpacklo_ps(left, right);
+		__m256 hi    = _mm256_unpackhi_ps(left, right);
+		f32 *frame   = dest + (i * 2);
+		__m256 first = _mm256_permute2f128_ps(lo, hi, 0x20);
+		__m256 last  = _mm256_permute2f128_ps(lo, hi, 0x31);
+		_mm256_storeu_ps(frame, _mm256_add_ps(_mm256_loadu_ps(frame), first));
+		_mm256_storeu_ps(frame + 8,
+		                 _mm256_add_ps(_mm256_loadu_ps(frame + 8), last));
+	}
+#elif defined(AUDIO_MIXER_SSE2)
+	__m128 gainL4 = _mm_set1_ps(gainL);
+	__m128 gainR4 = _mm_set1_ps(gainR);
+	for (; i + 4 <= numFrames; i += 4)
+	{
+		// NOTE(doyle): Sign extend by unpacking into the high half and
+		// shifting back down
+		__m128i src16  = _mm_loadl_epi64(CAST(const __m128i *)(src + i));
+		__m128i src32  = _mm_srai_epi32(_mm_unpacklo_epi16(src16, src16), 16);
+		__m128 samples = _mm_cvtepi32_ps(src32);
+		__m128 left    = _mm_mul_ps(samples, gainL4);
+		__m128 right   = _mm_mul_ps(samples, gainR4);
+
+		f32 *frame = dest + (i * 2);
+		_mm_storeu_ps(frame, _mm_add_ps(_mm_loadu_ps(frame),
+		                                _mm_unpacklo_ps(left, right)));
+		_mm_storeu_ps(frame + 4, _mm_add_ps(_mm_loadu_ps(frame + 4),
+		                                    _mm_unpackhi_ps(left, right)));
+	}
+#endif
+	mixMonoScalar(dest + (i * 2), src + i, numFrames - i, gainL, gainR);
+}
+
+INTERNAL void mixStereo(f32 *const dest, const i16 *const src,
+                        const i32 numFrames, const f32 gainL, const f32 gainR)
+{
+	i32 i = 0;
+#if defined(AUDIO_MIXER_AVX2)
+	__m256 gain = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR,
+	                             gainL, gainR);
+	for (; i + 8 <= numFrames; i += 8)
+	{
+		const i16 *frameSrc = src + (i * 2);
+		f32 *frame          = dest + (i * 2);
+		for (i32 half = 0; half < 2; half++)
+		{
+			__m128i src16 =
+			    _mm_loadu_si128(CAST(const __m128i *)(frameSrc + (half * 8)));
+			__m256 samples = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(src16));
+			f32 *out       = frame + (half * 8);
+			_mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out),
+			                                    _mm256_mul_ps(samples, gain)));
+		}
+	}
+#elif defined(AUDIO_MIXER_SSE2)
+	__m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	for (; i + 4 <= numFrames; i += 4)
+	{
+		__m128i src16 = _mm_loadu_si128(CAST(const __m128i *)(src + (i * 2)));
+		__m128i lo    = _mm_srai_epi32(_mm_unpacklo_epi16(src16, src16), 16);
+		__m128i hi    = _mm_srai_epi32(_mm_unpackhi_epi16(src16, src16), 16);
+
+		f32 *frame = dest + (i * 2);
+		_mm_storeu_ps(frame,
+		              _mm_add_ps(_mm_loadu_ps(frame),
+		                         _mm_mul_ps(_mm_cvtepi32_ps(lo), gain)));
+		_mm_storeu_ps(frame + 4,
+		              _mm_add_ps(_mm_loadu_ps(frame + 4),
+		                         _mm_mul_ps(_mm_cvtepi32_ps(hi), gain)));
+	}
+#endif
+	mixStereoScalar(dest + (i * 2), src + (i * 2), numFrames - i, gainL,
+	                gainR);
+}
+
+/* Clamp and round the mix to 16 bit, the packs saturate as well */
+INTERNAL void mixToI16(const f32 *const src, i16 *const dest,
+                       const i32 numSamples)
+{
+	i32 i = 0;
+#if defined(AUDIO_MIXER_AVX2)
+	__m256 minSample = _mm256_set1_ps(-1.0f);
+	__m256 maxSample = _mm256_set1_ps(1.0f);
+	__m256 scale     = _mm256_set1_ps(32767.0f);
+	for (; i + 16 <= numSamples; i += 16)
+	{
+		__m256 a = _mm256_loadu_ps(src + i);
+		__m256 b = _mm256_loadu_ps(src + i + 8);
+		a = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(a, minSample), maxSample),
+		                  scale);
+		b = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(b, minSample), maxSample),
+		                  scale);
+
+		// NOTE(doyle): Packs work per lane, reorder the 64 bit quarters back
+		__m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a),
+		                                    _mm256_cvtps_epi32(b));
+		packed = _mm256_permute4x64_epi64(packed, 0xD8);
+		_mm256_storeu_si256(CAST(__m256i *)(dest + i), packed);
+	}
+#elif defined(AUDIO_MIXER_SSE2)
+	__m128 minSample = _mm_set1_ps(-1.0f);
+	__m128 maxSample = _mm_set1_ps(1.0f);
+	__m128 scale     = _mm_set1_ps(32767.0f);
+	for (; i + 8 <= numSamples; i += 8)
+	{
+		__m128 a = _mm_loadu_ps(src + i);
+		__m128 b = _mm_loadu_ps(src + i + 4);
+		a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, minSample), maxSample), scale);
+		b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, minSample), maxSample), scale);
+
+		__m128i packed =
+		    _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+		_mm_storeu_si128(CAST(__m128i *)(dest + i), packed);
+	}
+#endif
+	mixToI16Scalar(src + i, dest + i, numSamples - i);
+}
+
+/*
+ *********************************
+ * Resampling
+ *********************************
+ */
+// NOTE(doyle): Cutoff in cycles per source frame when upsampling, the Kaiser
+// window's transition band ends near Nyquist with 32 taps
+#define AUDIO_RESAMPLE_CUTOFF 0.42f
+#define AUDIO_RESAMPLE_KAISER_BETA 8.0f
+
+#define AUDIO_RESAMPLE_FRAC_BITS (32 - AUDIO_RESAMPLE_PHASE_BITS)
+
+/* Zeroth order modified bessel function, the series converges quickly */
+INTERNAL f32 besselI0(const f32 x)
+{
+	f32 result = 1.0f;
+	f32 term   = 1.0f;
+	f32 halfX  = x * 0.5f;
+	for (i32 k = 1; k < 24; k++)
+	{
+		term *= (halfX / k) * (halfX / k);
+		result += term;
+	}
+
+	return result;
+}
+
+INTERNAL void resamplerInit(AudioResampler *const resampler,
+                            const i32 sampleRate)
+{
+	resampler->sampleRate = sampleRate;
+	resampler->step =
+	    (CAST(u64) sampleRate << 32) / CAST(u64) AUDIO_MIXER_SAMPLE_RATE;
+
+	// NOTE(doyle): Downsampling moves the cutoff under the mixer's Nyquist
+	f32 scale  = MIN(1.0f, CAST(f32) AUDIO_MIXER_SAMPLE_RATE / sampleRate);
+	f32 cutoff = AUDIO_RESAMPLE_CUTOFF * scale;
+
+	const f32 halfWidth = AUDIO_RESAMPLE_TAPS * 0.5f;
+	const f32 centreTap = halfWidth - 1.0f;
+	f32 windowNorm      = besselI0(AUDIO_RESAMPLE_KAISER_BETA);
+	for (i32 phase = 0; phase <= AUDIO_RESAMPLE_PHASES; phase++)
+	{
+		f32 *taps = &resampler->filter[phase * AUDIO_RESAMPLE_TAPS];
+		f32 frac  = CAST(f32) phase / AUDIO_RESAMPLE_PHASES;
+		f32 total = 0.0f;
+		for (i32 k = 0; k < AUDIO_RESAMPLE_TAPS; k++)
+		{
+			/* Distance of the tap from the point being sampled */
+			f32 t = (k - centreTap) - frac;
+			f32 x = 2.0f * cutoff * t;
+			f32 sinc =
+			    (ABS(x) < 0.00001f) ? 1.0f : sinf(MATH_PI * x) / (MATH_PI * x);
+
+			f32 ratio  = t / halfWidth;
+			f32 window = 0.0f;
+			if (ABS(ratio) < 1.0f)
+			{
+				window = besselI0(AUDIO_RESAMPLE_KAISER_BETA *
+				                  sqrtf(1.0f - (ratio * ratio))) /
+				         windowNorm;
+			}
+
+			taps[k] = sinc * window;
+			total += taps[k];
+		}
+
+		// NOTE(doyle): Unity gain at DC for every phase
+		for (i32 k = 0; k < AUDIO_RESAMPLE_TAPS; k++)
+			taps[k] /= total;
+	}
+}
+
+/*
+   Filter planar source frames into the interleaved mix, srcR is NULL for mono.
+   Mixed frame i samples the source at (frac + (i * step)) in 32.32 fixed
+   point, relative to the centre tap of src. Taps are blended between the two
+   nearest phases.
+ */
+INTERNAL void resampleScalar(f32 *const dest, const f32 *const srcL,
+                             const f32 *const srcR, const i32 numFrames,
+                             const u32 frac, const u64 step,
+                             const f32 *const filter, const f32 gainL,
+                             const f32 gainR)
+{
+	const f32 blendScale = 1.0f / (1 << AUDIO_RESAMPLE_FRAC_BITS);
+	for (i32 i = 0; i < numFrames; i++)
+	{
+		u64 t      = frac + (i * step);
+		i32 first  = CAST(i32)(t >> 32);
+		u32 offset = CAST(u32) t;
+		f32 blend  = (offset & ((1 << AUDIO_RESAMPLE_FRAC_BITS) - 1)) *
+		            blendScale;
+
+		const f32 *taps0 =
+		    &filter[(offset >> AUDIO_RESAMPLE_FRAC_BITS) * AUDIO_RESAMPLE_TAPS];
+		const f32 *taps1 = taps0 + AUDIO_RESAMPLE_TAPS;
+
+		f32 sumL = 0.0f;
+		f32 sumR = 0.0f;
+		for (i32 k = 0; k < AUDIO_RESAMPLE_TAPS; k++)
+		{
+			f32 tap = taps0[k] + (blend * (taps1[k] - taps0[k]));
+			sumL += srcL[first + k] * tap;
+			if (srcR) sumR += srcR[first + k] * tap;
+		}
+
+		if (!srcR) sumR = sumL;
+		dest[(i * 2)]     += sumL * gainL;
+		dest[(i * 2) + 1] += sumR * gainR;
+	}
+}
+
+#if defined(AUDIO_MIXER_AVX2) || defined(AUDIO_MIXER_SSE2)
+INTERNAL f32 horizontalSum(const __m128 value)
+{
+	__m128 swapped = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+	__m128 sums    = _mm_add_ps(value, swapped);
+	swapped        = _mm_movehl_ps(swapped, sums);
+	sums           = _mm_add_ss(sums, swapped);
+
+	f32 result = _mm_cvtss_f32(sums);
+	return result;
+}
+#endif
+
+INTERNAL void resample(f32 *const dest, const f32 *const srcL,
+                       const f32 *const srcR, const i32 numFrames,
+                       const u32 frac, const u64 step, const f32 *const filter,
+                       const f32 gainL, const f32 gainR)
+{
+#if defined(AUDIO_MIXER_AVX2) || defined(AUDIO_MIXER_SSE2)
+	const f32 blendScale = 1.0f / (1 << AUDIO_RESAMPLE_FRAC_BITS);
+	for (i32 i = 0; i < numFrames; i++)
+	{
+		u64 t      = frac + (i * step);
+		i32 first  = CAST(i32)(t >> 32);
+		u32 offset = CAST(u32) t;
+		f32 blend  = (offset & ((1 << AUDIO_RESAMPLE_FRAC_BITS) - 1)) *
+		            blendScale;
+
+		const f32 *taps0 =
+		    &filter[(offset >> AUDIO_RESAMPLE_FRAC_BITS) * AUDIO_RESAMPLE_TAPS];
+		const f32 *taps1 = taps0 + AUDIO_RESAMPLE_TAPS;
+		const f32 *left  = srcL + first;
+
+	#if defined(AUDIO_MIXER_AVX2)
+		__m256 blend8 = _mm256_set1_ps(blend);
+		__m256 accL   = _mm256_setzero_ps();
+		__m256 accR   = _mm256_setzero_ps();
+		for (i32 k = 0; k < AUDIO_RESAMPLE_TAPS; k += 8)
+		{
+			__m256 tap0 = _mm256_loadu_ps(taps0 + k);
+			__m256 tap  = _mm256_add_ps(
+			    tap0,
+			    _mm256_mul_ps(blend8,
+			                  _mm256_sub_ps(_mm256_loadu_ps(taps1 + k), tap0)));
+			accL = _mm256_add_ps(
+			    accL, _mm256_mul_ps(_mm256_loadu_ps(left + k), tap));
+			if (srcR)
+			{
+				__m256 right = _mm256_loadu_ps(srcR + first + k);
+				accR         = _mm256_add_ps(accR, _mm256_mul_ps(right, tap));
+			}
+		}
+
+		f32 sumL = horizontalSum(_mm_add_ps(_mm256_castps256_ps128(accL),
+		                                    _mm256_extractf128_ps(accL, 1)));
+		f32 sumR = horizontalSum(_mm_add_ps(_mm256_castps256_ps128(accR),
+		                                    _mm256_extractf128_ps(accR, 1)));
+	#else
+		__m128 blend4 = _mm_set1_ps(blend);
+		__m128 accL   = _mm_setzero_ps();
+		__m128 accR   = _mm_setzero_ps();
+		for (i32 k = 0; k < AUDIO_RESAMPLE_TAPS; k += 4)
+		{
+			__m128 tap0 = _mm_loadu_ps(taps0 + k);
+			__m128 tap  = _mm_add_ps(
+			    tap0, _mm_mul_ps(blend4,
+			                     _mm_sub_ps(_mm_loadu_ps(taps1 + k), tap0)));
+			accL = _mm_add_ps(accL, _mm_mul_ps(_mm_loadu_ps(left + k), tap));
+			if (srcR)
+			{
+				accR = _mm_add_ps(
+				    accR, _mm_mul_ps(_mm_loadu_ps(srcR + first + k), tap));
+			}
+		}
+
+		f32 sumL = horizontalSum(accL);
+		f32 sumR = horizontalSum(accR);
+	#endif
+
+		if (!srcR) sumR = sumL;
+		dest[(i * 2)]     += sumL * gainL;
+		dest[(i * 2) + 1] += sumR * gainR;
+	}
+#else
+	resampleScalar(dest, srcL, srcR, numFrames, frac, step, filter, gainL,
+	               gainR);
+#endif
+}
+
+/* Returns the index of the resampler of the rate, building it if needed */
+INTERNAL i32 resamplerGet(AudioMixer *const mixer, const i32 sampleRate)
+{
+	for (i32 i = 0; i < mixer->numResamplers; i++)
+	{
+		if (mixer->resamplers[i].sampleRate == sampleRate) return i;
+	}
+
+	if (mixer->numResamplers == AUDIO_RESAMPLE_MAX_RATES)
+	{
+		DEBUG_LOG("resamplerGet() failed: Too many sample rates playing");
+		return -1;
+	}
+
+	i32 result = mixer->numResamplers++;
+	resamplerInit(&mixer->resamplers[result], sampleRate);
+	return result;
+}
+
+/*
+ *********************************
+ * Voices
+ *********************************
+ */
+void audio_mixerInit(AudioMixer *const mixer, MemoryArena_ *const arena)
+{
+	common_memset(CAST(u8 *) mixer, 0, sizeof(*mixer));
+	mixer->masterGain = 1.0f;
+
+	for (i32 i = 0; i < ARRAY_COUNT(mixer->voices); i++)
+		mixer->voices[i].nextFree = i + 1;
+	mixer->voices[AUDIO_MIXER_MAX_VOICES - 1].nextFree = -1;
+	mixer->firstFreeVoice                              = 0;
+
+	if (arena)
+	{
+		mixer->streamMemory = memory_pushBytes(
+		    arena, AUDIO_MIXER_MAX_STREAMS * AUDIO_MIXER_STREAM_MEMORY);
+		for (i32 i = 0; i < AUDIO_MIXER_MAX_STREAMS; i++)
+			mixer->freeStreams[i] = i;
+		mixer->numFreeStreams = AUDIO_MIXER_MAX_STREAMS;
+	}
+}
+
+INTERNAL AudioVoice *voiceGet(AudioMixer *const mixer,
+                              const AudioVoiceHandle handle)
+{
+	if (handle == AUDIO_VOICE_INVALID) return NULL;
+
+	i32 index      = handle & 0xFFFF;
+	u16 generation = CAST(u16)((handle >> 16) & 0x7FFF);
+	if (index >= ARRAY_COUNT(mixer->voices)) return NULL;
+
+	AudioVoice *voice = &mixer->voices[index];
+	if (!voice->active || voice->generation != generation) return NULL;
+
+	return voice;
+}
+
+INTERNAL void voiceStreamClose(AudioMixer *const mixer,
+                               AudioVoice *const voice)
+{
+	if (!voice->stream) return;
+
+	stb_vorbis_close(voice->stream);
+	if (voice->streamIndex != -1)
+		mixer->freeStreams[mixer->numFreeStreams++] = voice->streamIndex;
+
+	voice->stream      = NULL;
+	voice->streamIndex = -1;
+}
+
+INTERNAL void voiceRelease(AudioMixer *const mixer, AudioVoice *const voice)
+{
+	voiceStreamClose(mixer, voice);
+
+	/* Swap the last playing voice into the hole */
+	i32 index        = CAST(i32)(voice - mixer->voices);
+	i32 lastIndex    = mixer->activeVoices[--mixer->numActive];
+	AudioVoice *last = &mixer->voices[lastIndex];
+	mixer->activeVoices[voice->activeIndex] = lastIndex;
+	last->activeIndex                       = voice->activeIndex;
+
+	voice->audio          = NULL;
+	voice->active         = FALSE;
+	voice->audible        = FALSE;
+	voice->generation     = (voice->generation + 1) & 0x7FFF;
+	voice->nextFree       = mixer->firstFreeVoice;
+	mixer->firstFreeVoice = index;
+}
+
+/*
+   NOTE(doyle): Open the stream of a compressed voice at its position. Returns
+   false if every block of stream memory is taken, the voice stays virtual.
+ */
+INTERNAL b32 voiceStreamOpen(AudioMixer *const mixer, AudioVoice *const voice)
+{
+	AudioVorbis *audio = voice->audio;
+
+	stb_vorbis_alloc alloc  = {0};
+	stb_vorbis_alloc *block = NULL;
+	i32 streamIndex         = -1;
+	if (mixer->numFreeStreams > 0)
+	{
+		streamIndex = mixer->freeStreams[--mixer->numFreeStreams];
+		alloc.alloc_buffer =
+		    CAST(char *)(mixer->streamMemory +
+		                 (streamIndex * AUDIO_MIXER_STREAM_MEMORY));
+		alloc.alloc_buffer_length_in_bytes = AUDIO_MIXER_STREAM_MEMORY;
+		block                              = &alloc;
+	}
+	else if (mixer->streamMemory)
+	{
+		return FALSE;
+	}
+
+	i32 error;
+	voice->stream =
+	    stb_vorbis_open_memory(audio->data, audio->size, &error, block);
+	if (!voice->stream && block)
+	{
+		// NOTE(doyle): The clip needs more than a block, let it allocate
+		mixer->freeStreams[mixer->numFreeStreams++] = streamIndex;
+		streamIndex                                 = -1;
+		if (error == VORBIS_outofmem)
+		{
+			voice->stream = stb_vorbis_open_memory(audio->data, audio->size,
+			                                       &error, NULL);
+		}
+	}
+
+	if (!voice->stream)
+	{
+		printf("stb_vorbis_open_memory() failed: Error code %d\n", error);
+		voiceRelease(mixer, voice);
+		return FALSE;
+	}
+
+	voice->streamIndex = streamIndex;
+	if (voice->position > 0) stb_vorbis_seek(voice->stream, voice->position);
+
+	return TRUE;
+}
+
+AudioVoiceHandle audio_mixerPlay(AudioMixer *const mixer,
+                                 AudioVorbis *const audio, const f32 gain,
+                                 const f32 pan, const i32 numPlays,
+                                 const enum AudioPriority priority)
+{
+	// NOTE(doyle): Placeholder vorbis of a sound still loading has no data
+	if (!audio || (!audio->pcm && !audio->data)) return AUDIO_VOICE_INVALID;
+
+	if (audio->info.channels < 1 || audio->info.channels > 2)
+	{
+		DEBUG_LOG("audio_mixerPlay() failed: Unsupported channel count");
+		return AUDIO_VOICE_INVALID;
+	}
+
+	i32 sampleRate = CAST(i32) audio->info.sample_rate;
+	if (sampleRate <= 0 ||
+	    sampleRate > AUDIO_MIXER_SAMPLE_RATE * AUDIO_RESAMPLE_MAX_RATIO)
+	{
+		DEBUG_LOG("audio_mixerPlay() failed: Unsupported sample rate");
+		return AUDIO_VOICE_INVALID;
+	}
+
+	i32 resampler = -1;
+	if (sampleRate != AUDIO_MIXER_SAMPLE_RATE)
+	{
+		resampler = resamplerGet(mixer, sampleRate);
+		if (resampler == -1) return AUDIO_VOICE_INVALID;
+	}
+
+#ifdef DENGINE_DEBUG
+	if (numPlays != AUDIO_REPEAT_INFINITE && numPlays <= 0)
+		DEBUG_LOG("audio_mixerPlay() warning: Number of plays is less than 0");
+	ASSERT(priority >= 0 && priority < audiopriority_count);
+#endif
+
+	i32 index = mixer->firstFreeVoice;
+	if (index == -1) return AUDIO_VOICE_INVALID;
+
+	AudioVoice *voice     = &mixer->voices[index];
+	mixer->firstFreeVoice = voice->nextFree;
+
+	// NOTE(doyle): The stream is opened the first time the voice is audible
+	voice->audio          = audio;
+	voice->stream         = NULL;
+	voice->streamIndex    = -1;
+	voice->position       = 0;
+	voice->numPlays       = numPlays;
+	voice->priority       = priority;
+	voice->resampler      = resampler;
+	voice->resampleFrac   = 0;
+	voice->resamplePrimed = FALSE;
+	voice->sourceEnded    = FALSE;
+	voice->numTailFrames  = 0;
+	voice->active         = TRUE;
+	voice->paused         = FALSE;
+	voice->audible        = FALSE;
+	voice->activeIndex    = mixer->numActive;
+	mixer->activeVoices[mixer->numActive++] = index;
+
+	AudioVoiceHandle result = index | (voice->generation << 16);
+	audio_mixerSetGainPan(mixer, result, gain, pan);
+	return result;
+}
+
+void audio_mixerStop(AudioMixer *const mixer, const AudioVoiceHandle handle)
+{
+	AudioVoice *voice = voiceGet(mixer, handle);
+	if (voice) voiceRelease(mixer, voice);
+}
+
+void audio_mixerSetGainPan(AudioMixer *const mixer,
+                           const AudioVoiceHandle handle, const f32 gain,
+                           const f32 pan)
+{
+	AudioVoice *voice = voiceGet(mixer, handle);
+	if (!voice) return;
+
+	voice->gain = MAX(gain, 0.0f);
+	voice->pan  = MIN(MAX(pan, -1.0f), 1.0f);
+}
+
+void audio_mixerSetPaused(AudioMixer *const mixer,
+                          const AudioVoiceHandle handle, const b32 paused)
+{
+	AudioVoice *voice = voiceGet(mixer, handle);
+	if (voice) voice->paused = paused;
+}
+
+b32 audio_mixerIsPlaying(AudioMixer *const mixer,
+                         const AudioVoiceHandle handle)
+{
+	b32 result = (voiceGet(mixer, handle) != NULL);
+	return result;
+}
+
+i32 audio_mixerNumPlaying(const AudioMixer *const mixer,
+                          const AudioVorbis *const audio)
+{
+	// NOTE(doyle): Keys are interned by the asset manager, comparing the
+	// pointers identifies the same sound
+	i32 result = 0;
+	for (i32 i = 0; i < mixer->numActive; i++)
+	{
+		const AudioVoice *voice = &mixer->voices[mixer->activeVoices[i]];
+		if (voice->audio->key == audio->key) result++;
+	}
+
+	return result;
+}
+
+/*
+ *********************************
+ * Mixing
+ *********************************
+ */
+/*
+   NOTE(doyle): Priority outranks any gain. Voices already audible get a small
+   bonus so two voices of equal rank do not trade places every block.
+ */
+INTERNAL f32 voiceAudibility(const AudioVoice *const voice)
+{
+	f32 result = (CAST(f32) voice->priority * 2.0f) + MIN(voice->gain, 1.0f);
+	if (voice->audible) result += 0.1f;
+
+	return result;
+}
+
+/* Mark the voices to mix this block, the rest are virtual */
+INTERNAL void voicesSelectAudible(AudioMixer *const mixer)
+{
+	i32 best[AUDIO_MIXER_MAX_AUDIBLE];
+	f32 bestScore[AUDIO_MIXER_MAX_AUDIBLE];
+	i32 numBest = 0;
+
+	// NOTE(doyle): Insertion into the sorted top list, it is short enough
+	// that a heap is not worth it
+	i32 numCandidates = 0;
+	for (i32 i = 0; i < mixer->numActive; i++)
+	{
+		i32 index         = mixer->activeVoices[i];
+		AudioVoice *voice = &mixer->voices[index];
+		if (voice->paused || voice->gain <= 0) continue;
+
+		numCandidates++;
+		f32 score = voiceAudibility(voice);
+		if (numBest == AUDIO_MIXER_MAX_AUDIBLE &&
+		    score <= bestScore[numBest - 1])
+		{
+			continue;
+		}
+
+		i32 insert = MIN(numBest, AUDIO_MIXER_MAX_AUDIBLE - 1);
+		while (insert > 0 && bestScore[insert - 1] < score)
+		{
+			best[insert]      = best[insert - 1];
+			bestScore[insert] = bestScore[insert - 1];
+			insert--;
+		}
+
+		best[insert]      = index;
+		bestScore[insert] = score;
+		numBest           = MIN(numBest + 1, AUDIO_MIXER_MAX_AUDIBLE);
+	}
+
+	/* Demoted voices give their stream back before any are opened */
+	for (i32 i = 0; i < mixer->numActive; i++)
+		mixer->voices[mixer->activeVoices[i]].audible = FALSE;
+
+	for (i32 i = 0; i < numBest; i++)
+		mixer->voices[best[i]].audible = TRUE;
+
+	for (i32 i = 0; i < mixer->numActive; i++)
+	{
+		AudioVoice *voice = &mixer->voices[mixer->activeVoices[i]];
+		if (!voice->audible) voiceStreamClose(mixer, voice);
+	}
+
+	mixer->numAudible = 0;
+	for (i32 i = 0; i < numBest; i++)
+	{
+		AudioVoice *voice = &mixer->voices[best[i]];
+		if (!voice->audio->pcm && !voice->stream &&
+		    !voiceStreamOpen(mixer, voice))
+		{
+			voice->audible = FALSE;
+			continue;
+		}
+
+		mixer->numAudible++;
+	}
+
+	mixer->numVirtual = numCandidates - mixer->numAudible;
+}
+
+/* Move a virtual voice on as if it was mixed */
+INTERNAL void voiceAdvance(AudioMixer *const mixer, AudioVoice *const voice,
+                           const i32 numFrames)
+{
+	AudioVorbis *audio = voice->audio;
+	i32 numClipFrames  = CAST(i32) audio->lengthInSamples;
+	if (audio->pcm)
+		numClipFrames = audio->pcmSize / (audio->info.channels * sizeof(i16));
+
+	i32 numSourceFrames = numFrames;
+	if (voice->resampler != -1)
+	{
+		AudioResampler *resampler = &mixer->resamplers[voice->resampler];
+		u64 end = voice->resampleFrac + (numFrames * resampler->step);
+		numSourceFrames = CAST(i32)(end >> 32);
+
+		// NOTE(doyle): The history is stale, filled again once audible
+		voice->resampleFrac   = CAST(u32) end;
+		voice->resamplePrimed = FALSE;
+	}
+
+	voice->position += numSourceFrames;
+	while (voice->position >= numClipFrames)
+	{
+		if (voice->numPlays != AUDIO_REPEAT_INFINITE) voice->numPlays--;
+
+		if (numClipFrames <= 0 ||
+		    (voice->numPlays != AUDIO_REPEAT_INFINITE && voice->numPlays <= 0))
+		{
+			voiceRelease(mixer, voice);
+			break;
+		}
+
+		voice->position -= numClipFrames;
+	}
+}
+
+/* Reached the end of the clip, returns true if the voice has no plays left */
+INTERNAL b32 voiceEndOfClip(AudioVoice *const voice)
+{
+	if (voice->numPlays != AUDIO_REPEAT_INFINITE) voice->numPlays--;
+
+	b32 clipIsEmpty = (voice->position == 0);
+	if (clipIsEmpty ||
+	    (voice->numPlays != AUDIO_REPEAT_INFINITE && voice->numPlays <= 0))
+	{
+		return TRUE;
+	}
+
+	voice->position = 0;
+	if (voice->stream) stb_vorbis_seek_start(voice->stream);
+	return FALSE;
+}
+
+/* Read the next frames of the clip, silence once it has no plays left */
+INTERNAL void voiceRead(AudioVoice *const voice, i16 *const dest,
+                        const i32 numFrames)
+{
+	AudioVorbis *audio = voice->audio;
+	i32 channels       = audio->info.channels;
+
+	i32 numRead = 0;
+	while (numRead < numFrames)
+	{
+		i16 *frame    = dest + (numRead * channels);
+		i32 numWanted = numFrames - numRead;
+		if (voice->sourceEnded)
+		{
+			common_memset(CAST(u8 *) frame, 0,
+			              numWanted * channels * sizeof(i16));
+			voice->numTailFrames += numWanted;
+			break;
+		}
+
+		i32 numAvailable;
+		b32 clipEnded;
+		if (audio->pcm)
+		{
+			i32 numPcmFrames = audio->pcmSize / (channels * sizeof(i16));
+			numAvailable = MIN(numPcmFrames - voice->position, numWanted);
+			common_memcpy(CAST(u8 *) frame,
+			              CAST(u8 *)(audio->pcm + (voice->position * channels)),
+			              numAvailable * channels * sizeof(i16));
+			clipEnded = (voice->position + numAvailable == numPcmFrames);
+		}
+		else
+		{
+			numAvailable = stb_vorbis_get_samples_short_interleaved(
+			    voice->stream, channels, frame, numWanted * channels);
+			clipEnded = (numAvailable < numWanted);
+		}
+
+		voice->position += numAvailable;
+		numRead         += numAvailable;
+		if (clipEnded) voice->sourceEnded = voiceEndOfClip(voice);
+	}
+}
+
+/* Resample numFrames of the voice into dest, release it once it has rung out */
+INTERNAL void voiceMixResampled(AudioMixer *const mixer,
+                                AudioVoice *const voice, f32 *const dest,
+                                const i32 numFrames, const f32 gainL,
+                                const f32 gainR)
+{
+	AudioResampler *resampler = &mixer->resamplers[voice->resampler];
+	i32 channels              = voice->audio->info.channels;
+	i32 historySize = AUDIO_RESAMPLE_TAPS * channels * sizeof(i16);
+
+	u64 end             = voice->resampleFrac + (numFrames * resampler->step);
+	i32 numSourceFrames = CAST(i32)(end >> 32);
+	ASSERT(AUDIO_RESAMPLE_TAPS + numSourceFrames <=
+	       AUDIO_RESAMPLE_MAX_INPUT_FRAMES);
+
+	i16 *input = mixer->resampleInput;
+	if (voice->resamplePrimed)
+	{
+		common_memcpy(CAST(u8 *) input, CAST(u8 *) voice->resampleHistory,
+		              historySize);
+	}
+	else
+	{
+		// NOTE(doyle): Taps before the current frame start out silent
+		i32 numLeading = (AUDIO_RESAMPLE_TAPS / 2) - 1;
+		common_memset(CAST(u8 *) input, 0,
+		              numLeading * channels * sizeof(i16));
+		voiceRead(voice, input + (numLeading * channels),
+		          AUDIO_RESAMPLE_TAPS - numLeading);
+		voice->resamplePrimed = TRUE;
+	}
+
+	voiceRead(voice, input + (AUDIO_RESAMPLE_TAPS * channels),
+	          numSourceFrames);
+
+	/* Split the channels into floats for the filter */
+	i32 numInput = AUDIO_RESAMPLE_TAPS + numSourceFrames;
+	f32 *left    = mixer->resampleWork[0];
+	f32 *right   = (channels == 2) ? mixer->resampleWork[1] : NULL;
+	for (i32 i = 0; i < numInput; i++)
+	{
+		left[i] = CAST(f32) input[i * channels];
+		if (right) right[i] = CAST(f32) input[(i * channels) + 1];
+	}
+
+	resample(dest, left, right, numFrames, voice->resampleFrac,
+	         resampler->step, resampler->filter, gainL, gainR);
+
+	common_memcpy(CAST(u8 *) voice->resampleHistory,
+	              CAST(u8 *)(input + (numSourceFrames * channels)),
+	              historySize);
+	voice->resampleFrac = CAST(u32) end;
+
+	// NOTE(doyle): Done once the centre tap is past the end of the clip
+	if (voice->numTailFrames >= AUDIO_RESAMPLE_TAPS) voiceRelease(mixer, voice);
+}
+
+/* Mix numFrames of the voice into dest, releasing it once it has finished */
+INTERNAL void voiceMix(AudioMixer *const mixer, AudioVoice *const voice,
+                       f32 *const dest, const i32 numFrames)
+{
+	AudioVorbis *audio = voice->audio;
+	i32 channels       = audio->info.channels;
+
+	// NOTE(doyle): Constant power pan, centre is -3dB on each side
+	Radians angle = (voice->pan + 1.0f) * (MATH_PI * 0.25f);
+	f32 gain  = voice->gain * mixer->masterGain * AUDIO_MIXER_I16_TO_F32;
+	f32 gainL = gain * math_cosf(angle);
+	f32 gainR = gain * math_sinf(angle);
+
+	if (voice->resampler != -1)
+	{
+		voiceMixResampled(mixer, voice, dest, numFrames, gainL, gainR);
+		return;
+	}
+
+	i32 numMixed = 0;
+	while (numMixed < numFrames)
+	{
+		i32 numWanted = numFrames - numMixed;
+		const i16 *src;
+		i32 numAvailable;
+		if (audio->pcm)
+		{
+			i32 numPcmFrames = audio->pcmSize / (channels * sizeof(i16));
+			numAvailable     = numPcmFrames - voice->position;
+			src              = audio->pcm + (voice->position * channels);
+		}
+		else
+		{
+			numAvailable = stb_vorbis_get_samples_short_interleaved(
+			    voice->stream, channels, mixer->decodeBuffer,
+			    numWanted * channels);
+			src = mixer->decodeBuffer;
+		}
+
+		i32 numToMix = MIN(numAvailable, numWanted);
+		if (numToMix > 0)
+		{
+			f32 *frame = dest + (numMixed * AUDIO_MIXER_NUM_CHANNELS);
+			if (channels == 1) mixMono(frame, src, numToMix, gainL, gainR);
+			else mixStereo(frame, src, numToMix, gainL, gainR);
+
+			voice->position += numToMix;
+			numMixed        += numToMix;
+		}
+
+		// NOTE(doyle): A PCM clip is known to end with the block, a stream
+		// only once it comes up short
+		b32 clipEnded = (audio->pcm) ? (numAvailable <= numWanted)
+		                             : (numAvailable < numWanted);
+		if (!clipEnded) break;
+
+		if (voiceEndOfClip(voice))
+		{
+			voiceRelease(mixer, voice);
+			break;
+		}
+	}
+}
+
+void audio_mixerMix(AudioMixer *const mixer, i16 *const out,
+                    const i32 numFrames)
+{
+	ASSERT(numFrames <= AUDIO_MIXER_MAX_FRAMES);
+	i32 numSamples = numFrames * AUDIO_MIXER_NUM_CHANNELS;
+	common_memset(CAST(u8 *) mixer->mixBuffer, 0, numSamples * sizeof(f32));
+
+	voicesSelectAudible(mixer);
+
+	// NOTE(doyle): Walk backwards, a released voice swaps in one already done
+	for (i32 i = mixer->numActive - 1; i >= 0; i--)
+	{
+		AudioVoice *voice = &mixer->voices[mixer->activeVoices[i]];
+		if (voice->paused) continue;
+
+		if (voice->audible)
+			voiceMix(mixer, voice, mixer->mixBuffer, numFrames);
+		else
+			voiceAdvance(mixer, voice, numFrames);
+	}
+
+	mixToI16(mixer->mixBuffer, out, numSamples);
+}
+
+/* THD+N of a tone in the left channel in dB, the frames hold whole cycles */
+INTERNAL f32 unitTestThdN(const i16 *const frames, const i32 numFrames,
+                          const f64 frequency)
+{
+	f64 omega  = 2.0 * 3.14159265358979 * frequency / AUDIO_MIXER_SAMPLE_RATE;
+	f64 sinDot = 0;
+	f64 cosDot = 0;
+	f64 mean   = 0;
+	for (i32 i = 0; i < numFrames; i++)
+	{
+		f64 sample = frames[i * 2];
+		sinDot += sample * sin(omega * i);
+		cosDot += sample * cos(omega * i);
+		mean   += sample;
+	}
+
+	/* Everything but the fitted tone is distortion and noise */
+	f64 a = (2.0 * sinDot) / numFrames;
+	f64 b = (2.0 * cosDot) / numFrames;
+	mean /= numFrames;
+
+	f64 toneEnergy     = 0;
+	f64 residualEnergy = 0;
+	for (i32 i = 0; i < numFrames; i++)
+	{
+		f64 tone     = (a * sin(omega * i)) + (b * cos(omega * i));
+		f64 residual = frames[i * 2] - mean - tone;
+		toneEnergy     += tone * tone;
+		residualEnergy += residual * residual;
+	}
+
+	f32 result = CAST(f32)(10.0 * log10(residualEnergy / toneEnergy));
+	return result;
+}
+
+void audio_mixerUnitTest()
+{
+	LOCAL_PERSIST AudioMixer mixer;
+	LOCAL_PERSIST i16 pcm[2 * 301];
+	LOCAL_PERSIST f32 simd[2 * 301];
+	LOCAL_PERSIST f32 scalar[2 * 301];
+	LOCAL_PERSIST i16 out[2 * 512];
+
+	u32 seed = 1;
+	for (i32 i = 0; i < ARRAY_COUNT(pcm); i++)
+	{
+		seed   = (seed * 1103515245) + 12345;
+		pcm[i] = CAST(i16)(seed >> 16);
+	}
+
+	{ // Vector kernels match the scalar versions, odd counts cover the tails
+		const i32 numFrames = 301;
+		for (i32 channels = 1; channels <= 2; channels++)
+		{
+			common_memset(CAST(u8 *) simd, 0, sizeof(simd));
+			common_memset(CAST(u8 *) scalar, 0, sizeof(scalar));
+			if (channels == 1)
+			{
+				mixMono(simd, pcm, numFrames, 0.25f, -0.5f);
+				mixMonoScalar(scalar, pcm, numFrames, 0.25f, -0.5f);
+			}
+			else
+			{
+				mixStereo(simd, pcm, numFrames, 0.25f, -0.5f);
+				mixStereoScalar(scalar, pcm, numFrames, 0.25f, -0.5f);
+			}
+
+			for (i32 i = 0; i < numFrames * 2; i++)
+				ASSERT(ABS(simd[i] - scalar[i]) < 0.001f);
+		}
+
+		i16 simdI16[2 * 301];
+		i16 scalarI16[2 * 301];
+		for (i32 i = 0; i < ARRAY_COUNT(simd); i++)
+			simd[i] = CAST(f32)(i - 301) / 200.0f;
+
+		mixToI16(simd, simdI16, ARRAY_COUNT(simd));
+		mixToI16Scalar(simd, scalarI16, ARRAY_COUNT(simd));
+		for (i32 i = 0; i < ARRAY_COUNT(simd); i++)
+			ASSERT(ABS(simdI16[i] - scalarI16[i]) <= 1);
+
+		ASSERT(simdI16[0] == -32767);
+		ASSERT(simdI16[ARRAY_COUNT(simd) - 1] == 32767);
+
+		audio_mixerInit(&mixer, NULL);
+		f32 *left  = mixer.resampleWork[0];
+		f32 *right = mixer.resampleWork[1];
+		for (i32 i = 0; i < AUDIO_RESAMPLE_MAX_INPUT_FRAMES; i++)
+		{
+			left[i]  = pcm[i % ARRAY_COUNT(pcm)];
+			right[i] = pcm[(i * 7) % ARRAY_COUNT(pcm)];
+		}
+
+		const i32 rates[] = {22050, 48000};
+		for (i32 r = 0; r < ARRAY_COUNT(rates); r++)
+		{
+			AudioResampler *resampler = &mixer.resamplers[0];
+			resamplerInit(resampler, rates[r]);
+			for (i32 channels = 1; channels <= 2; channels++)
+			{
+				f32 *srcR = (channels == 2) ? right : NULL;
+				common_memset(CAST(u8 *) simd, 0, sizeof(simd));
+				common_memset(CAST(u8 *) scalar, 0, sizeof(scalar));
+				resample(simd, left, srcR, numFrames, 0x12345678,
+				         resampler->step, resampler->filter, 0.25f, -0.5f);
+				resampleScalar(scalar, left, srcR, numFrames, 0x12345678,
+				               resampler->step, resampler->filter, 0.25f,
+				               -0.5f);
+
+				for (i32 i = 0; i < numFrames * 2; i++)
+					ASSERT(ABS(simd[i] - scalar[i]) < 0.05f);
+			}
+		}
+	}
+
+	{ // Voices pan, repeat and release
+		for (i32 i = 0; i < 100; i++) pcm[i] = 16384;
+
+		AudioVorbis clip   = {0};
+		clip.key           = "test";
+		clip.info.channels    = 1;
+		clip.info.sample_rate = AUDIO_MIXER_SAMPLE_RATE;
+		clip.pcm              = pcm;
+		clip.pcmSize          = 100 * sizeof(i16);
+
+		audio_mixerInit(&mixer, NULL);
+		AudioVoiceHandle handle =
+		    audio_mixerPlay(&mixer, &clip, 1.0f, -1, 2, audiopriority_normal);
+		ASSERT(handle != AUDIO_VOICE_INVALID);
+		ASSERT(audio_mixerNumPlaying(&mixer, &clip) == 1);
+
+		audio_mixerMix(&mixer, out, 150);
+		for (i32 i = 0; i < 150; i++)
+		{
+			ASSERT(ABS(out[(i * 2)] - 16383) <= 1);
+			ASSERT(out[(i * 2) + 1] == 0);
+		}
+
+		audio_mixerMix(&mixer, out, 100);
+		ASSERT(mixer.numActive == 0);
+		ASSERT(ABS(out[(49 * 2)] - 16383) <= 1);
+		ASSERT(out[(50 * 2)] == 0);
+
+		/* Paused voices hold their position */
+		handle =
+		    audio_mixerPlay(&mixer, &clip, 1.0f, -1, 1, audiopriority_normal);
+		audio_mixerSetPaused(&mixer, handle, TRUE);
+		audio_mixerMix(&mixer, out, 100);
+		ASSERT(out[0] == 0 && audio_mixerIsPlaying(&mixer, handle));
+		audio_mixerSetPaused(&mixer, handle, FALSE);
+		audio_mixerMix(&mixer, out, 100);
+		ASSERT(ABS(out[(99 * 2)] - 16383) <= 1);
+		ASSERT(!audio_mixerIsPlaying(&mixer, handle));
+
+		/* A stale handle does not touch the voice reusing its slot */
+		AudioVoiceHandle reused =
+		    audio_mixerPlay(&mixer, &clip, 1.0f, 0, 1, audiopriority_normal);
+		ASSERT((reused & 0xFFFF) == (handle & 0xFFFF));
+		audio_mixerStop(&mixer, handle);
+		ASSERT(mixer.numActive == 1);
+		audio_mixerStop(&mixer, reused);
+		ASSERT(mixer.numActive == 0);
+
+		/* Only the most important voices are mixed, the rest keep time */
+		for (i32 i = 200; i < 300; i++) pcm[i] = 100;
+
+		AudioVorbis quiet = clip;
+		quiet.pcm         = pcm + 200;
+		for (i32 i = 0; i < AUDIO_MIXER_MAX_AUDIBLE; i++)
+			audio_mixerPlay(&mixer, &quiet, 1.0f, -1, 1, audiopriority_low);
+
+		handle =
+		    audio_mixerPlay(&mixer, &clip, 1.0f, 1, 1, audiopriority_high);
+		audio_mixerMix(&mixer, out, 50);
+		ASSERT(mixer.numAudible == AUDIO_MIXER_MAX_AUDIBLE);
+		ASSERT(mixer.numVirtual == 1);
+		ASSERT(ABS(out[0] - ((AUDIO_MIXER_MAX_AUDIBLE - 1) * 100)) <= 2);
+		ASSERT(ABS(out[1] - 16383) <= 1);
+
+		// NOTE(doyle): Had the virtual voice not advanced it would still be
+		// half way through its clip
+		audio_mixerStop(&mixer, handle);
+		audio_mixerMix(&mixer, out, 50);
+		ASSERT(ABS(out[0] - (AUDIO_MIXER_MAX_AUDIBLE * 100)) <= 2);
+		ASSERT(mixer.numActive == 0);
+
+		/* Free list hands out every voice once */
+		for (i32 i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+		{
+			handle = audio_mixerPlay(&mixer, &clip, 0.0f, 0, 1,
+			                         audiopriority_low);
+			ASSERT(handle != AUDIO_VOICE_INVALID);
+		}
+
+		ASSERT(audio_mixerPlay(&mixer, &clip, 0.0f, 0, 1,
+		                       audiopriority_low) == AUDIO_VOICE_INVALID);
+		audio_mixerStop(&mixer, handle);
+		reused = audio_mixerPlay(&mixer, &clip, 0.0f, 0, 1, audiopriority_low);
+		ASSERT((reused & 0xFFFF) == (handle & 0xFFFF));
+
+		audio_mixerMix(&mixer, out, 100);
+		ASSERT(mixer.numActive == 0);
+	}
+
+	{ // A 1kHz tone resampled from other rates stays clean
+		LOCAL_PERSIST i16 tone[48000];
+		LOCAL_PERSIST i16 capture[2 * 4410];
+
+		// NOTE(doyle): Outlives the loop, the last voice still plays it while
+		// ringing out below
+		AudioVorbis clip = {0};
+		clip.key         = "tone";
+		clip.pcm         = tone;
+
+		const i32 rates[] = {22050, 32000, 48000};
+		for (i32 r = 0; r < ARRAY_COUNT(rates); r++)
+		{
+			// NOTE(doyle): Phase from whole numbers, f32 loses it over a
+			// second of samples otherwise
+			i32 rate = rates[r];
+			for (i32 i = 0; i < rate; i++)
+			{
+				f32 cycle = CAST(f32)((1000 * i) % rate) / rate;
+				tone[i]   = CAST(i16)(16384.0f * sinf(2.0f * MATH_PI * cycle));
+			}
+
+			clip.info.channels    = 1;
+			clip.info.sample_rate = rate;
+			clip.pcmSize          = rate * sizeof(i16);
+
+			audio_mixerInit(&mixer, NULL);
+			audio_mixerPlay(&mixer, &clip, 1.0f, -1, 1, audiopriority_normal);
+
+			/* Skip the filter filling up, then 100 cycles of the tone */
+			audio_mixerMix(&mixer, out, 512);
+			for (i32 i = 0; i < 4410; i += 441)
+				audio_mixerMix(&mixer, capture + (i * 2), 441);
+
+			ASSERT(unitTestThdN(capture, 4410, 1000.0) < -80.0f);
+		}
+
+		/* Resampled voices ring out and release */
+		for (i32 i = 0; i < 100; i++) audio_mixerMix(&mixer, out, 512);
+		ASSERT(mixer.numActive == 0);
+	}
+}
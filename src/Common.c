@@ -209,6 +209,14 @@ u8 *common_memset(u8 *const ptr, const i32 value, const i32 numBytes)
 	return ptr;
 }
 
+u8 *common_memcpy(u8 *const dest, const u8 *const src, const i32 numBytes)
+{
+	for (i32 i = 0; i < numBytes; i++)
+		dest[i] = src[i];
+
+	return dest;
+}
+
 INTERNAL void reverseString(char *const buf, const i32 bufSize)
 {
 	if (!buf || bufSize == 0 || bufSize == 1) return;
@@ -351,3 +359,55 @@ u32 common_murmurHash2(const void *key, i32 len, u32 seed)
 
 	return h;
 }
+
+u64 common_murmurHash64A(const void *key, i32 len, u64 seed)
+{
+	// NOTE(doyle): MurmurHash64A, 64-bit version of MurmurHash2 for x64
+	// platforms, by Austin Appleby.
+	const u64 m = 0xc6a4a7935bd1e995ULL;
+	const i32 r = 47;
+
+	u64 h = seed ^ (len * m);
+
+	const u8 *data = (const u8 *)key;
+	const u8 *end  = data + (len & ~7);
+
+	while (data != end)
+	{
+		u64 k = *(u64 *)data;
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		h ^= k;
+		h *= m;
+
+		data += 8;
+	}
+
+	switch (len & 7)
+	{
+	case 7:
+		h ^= (u64)data[6] << 48;
+	case 6:
+		h ^= (u64)data[5] << 40;
+	case 5:
+		h ^= (u64)data[4] << 32;
+	case 4:
+		h ^= (u64)data[3] << 24;
+	case 3:
+		h ^= (u64)data[2] << 16;
+	case 2:
+		h ^= (u64)data[1] << 8;
+	case 1:
+		h ^= (u64)data[0];
+		h *= m;
+	};
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
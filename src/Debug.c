@@ -5,11 +5,66 @@
 #include "Dengine/Renderer.h"
 #include "Dengine/Asteroid.h"
 
+/*
+   NOTE(doyle): Histogram buckets are in microseconds. Values below
+   HISTOGRAM_SUB_BUCKETS have a bucket each, above that each power of two is
+   split into HISTOGRAM_SUB_BUCKETS buckets up to HISTOGRAM_MAX_BIT, ~33s.
+ */
+#define HISTOGRAM_SUB_BUCKETS (1 << DEBUG_HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BIT 25
+#define HISTOGRAM_NUM_BUCKETS                                                  \
+	((HISTOGRAM_MAX_BIT - DEBUG_HISTOGRAM_SUB_BITS + 2) * HISTOGRAM_SUB_BUCKETS)
+
+// NOTE(doyle): Frames between refreshing the percentiles of the recent window
+#define FRAME_STATS_REFRESH_FRAMES 30
+
+typedef struct DebugHistogram
+{
+	u32 counts[HISTOGRAM_NUM_BUCKETS];
+	i32 total;
+} DebugHistogram;
+
+typedef struct DebugHitch
+{
+	u32 frameIndex;
+	f32 msThreshold;
+	f32 msPhase[debugphase_num];
+	i32 callCount[debugcount_num];
+} DebugHitch;
+
+typedef struct DebugFrameStats
+{
+	f64 frameStart;
+	f64 lastMark;
+	u32 frameIndex;
+
+	// NOTE(doyle): Of the frame running
+	u32 phaseMicroseconds[debugphase_num];
+
+	u32 window[DEBUG_FRAME_WINDOW][debugphase_num];
+	i32 windowIndex;
+	i32 windowSize;
+
+	DebugHistogram recent[debugphase_num];
+	DebugHistogram run[debugphase_num];
+	f64 runSumMs[debugphase_num];
+	u32 runMaxMicroseconds[debugphase_num];
+
+	// NOTE(doyle): p50, p95, p99 and max of the recent window
+	v4 msRecent[debugphase_num];
+
+	DebugHitch hitches[DEBUG_MAX_HITCHES];
+	i32 numHitches;
+} DebugFrameStats;
+
 typedef struct DebugState
 {
 	b32 init;
 	Font font;
 	i32 callCount[debugcount_num];
+
+	// NOTE(doyle): Counts of the last frame the overlay was drawn in
+	i32 lastCallCount[debugcount_num];
 	f32 stringLineGap;
 
 	/* Debug strings rendered in top left corner */
@@ -24,6 +79,8 @@ typedef struct DebugState
 	char console[20][128];
 	i32 consoleIndex;
 	v2 initialConsoleP;
+
+	DebugFrameStats frameStats;
 } DebugState;
 
 GLOBAL_VAR DebugState GLOBAL_debug;
@@ -57,36 +114,6 @@ void debug_init(v2 windowSize, Font font)
 	GLOBAL_debug.init = TRUE;
 }
 
-void debug_recursivePrintXmlTree(XmlNode *root, i32 levelsDeep)
-{
-	if (!root)
-	{
-		return;
-	}
-	else
-	{
-		for (i32 i = 0; i < levelsDeep; i++)
-		{
-			printf("-");
-		}
-
-		printf("%s ", root->name);
-
-		XmlAttribute *attribute = &root->attribute;
-		printf("| %s = %s", attribute->name, attribute->value);
-
-		while (attribute->next)
-		{
-			attribute = attribute->next;
-			printf("| %s = %04s", attribute->name, attribute->value);
-		}
-		printf("\n");
-
-		debug_recursivePrintXmlTree(root->child, levelsDeep+1);
-		debug_recursivePrintXmlTree(root->next, levelsDeep);
-	}
-}
-
 void debug_countIncrement(i32 id)
 {
 	if (GLOBAL_debug.init == FALSE) return;
@@ -176,6 +203,13 @@ void debug_pushString(char *formatString, void *data, char *dataType)
 			         ARRAY_COUNT(GLOBAL_debug.debugStrings[0]),
 			         formatString, val.x, val.y, val.z);
 		}
+		else if (common_strcmp(dataType, "v4") == 0)
+		{
+			v4 val = *(CAST(v4 *) data);
+			snprintf(GLOBAL_debug.debugStrings[numDebugStrings],
+			         ARRAY_COUNT(GLOBAL_debug.debugStrings[0]),
+			         formatString, val.x, val.y, val.z, val.w);
+		}
 		else if (common_strcmp(dataType, "i32") == 0)
 		{
 			i32 val = *(CAST(i32 *) data);
@@ -264,6 +298,13 @@ INTERNAL void renderConsole(Renderer *renderer, MemoryArena_ *arena)
 
 void debug_drawUi(GameState *state, f32 dt)
 {
+	// NOTE(doyle): Waiting on the debug font to load
+	if (!GLOBAL_debug.init)
+	{
+		GLOBAL_debug.numDebugStrings = 0;
+		return;
+	}
+
 	{ // Print Memory Arena Info
 		DEBUG_PUSH_STRING("== MEMORY ARENAS ==");
 		MemoryArena_ *transient = &state->transientArena;
@@ -294,11 +335,294 @@ void debug_drawUi(GameState *state, f32 dt)
 	               "i32");
 	DEBUG_PUSH_VAR("Num Vertex: %d",
 	               GLOBAL_debug.callCount[debugcount_numVertex], "i32");
+	DEBUG_PUSH_VAR("Asset String Lookups: %d",
+	               GLOBAL_debug.callCount[debugcount_assetStringLookup], "i32");
+
+	RenderGeometryCache *geometryCache = &state->renderer.geometryCache;
+	DEBUG_PUSH_VAR("UI Vertex Regenerated: %d",
+	               geometryCache->numVertexesRegenerated, "i32");
+	DEBUG_PUSH_VAR("UI Vertex Reused: %d", geometryCache->numVertexesReused,
+	               "i32");
+
+	f32 textHitPercent = state->renderer.textCache.hitRate * 100.0f;
+	DEBUG_PUSH_VAR("Text Layout Hit Rate: %.1f%%", textHitPercent, "f32");
+
+	AudioManager *audioManager = &state->audioManager;
+	DEBUG_PUSH_VAR("Audio Underruns: %d", audioManager->stats.numUnderruns,
+	               "i32");
+	DEBUG_PUSH_VAR("Audio Commands Dropped: %d",
+	               audioManager->numCommandsDropped, "i32");
+	DEBUG_PUSH_VAR("Audio Voices Audible: %d",
+	               audioManager->stats.numVoicesAudible, "i32");
+	DEBUG_PUSH_VAR("Audio Voices Virtual: %d",
+	               audioManager->stats.numVoicesVirtual, "i32");
+	DEBUG_PUSH_VAR("Audio Blocks Queued: %d",
+	               audioManager->stats.numBlocksQueued, "i32");
+	DEBUG_PUSH_VAR("Audio Queued Ms: %.1f", audioManager->stats.msQueued,
+	               "f32");
+	DEBUG_PUSH_VAR("Audio Queued Low Ms: %.1f",
+	               audioManager->stats.msQueuedLow, "f32");
+	DEBUG_PUSH_VAR("Audio Mix Ms: %.2f", audioManager->stats.msMix, "f32");
+	DEBUG_PUSH_VAR("Audio Mix High Ms: %.2f", audioManager->stats.msMixHigh,
+	               "f32");
+	DEBUG_PUSH_VAR("Audio Play Latency Ms: %.1f",
+	               audioManager->stats.msPlayLatency, "f32");
+	DEBUG_PUSH_VAR("Audio Play Latency High Ms: %.1f",
+	               audioManager->stats.msPlayLatencyHigh, "f32");
+
+	{ // Print Frame Stats
+		DebugFrameStats *frameStats = &GLOBAL_debug.frameStats;
+		DEBUG_PUSH_STRING("== FRAME MS p50/p95/p99/max ==");
+		DEBUG_PUSH_VAR("Input: %.2f/%.2f/%.2f/%.2f",
+		               frameStats->msRecent[debugphase_input], "v4");
+		DEBUG_PUSH_VAR("Simulate: %.2f/%.2f/%.2f/%.2f",
+		               frameStats->msRecent[debugphase_simulate], "v4");
+		DEBUG_PUSH_VAR("Render: %.2f/%.2f/%.2f/%.2f",
+		               frameStats->msRecent[debugphase_render], "v4");
+		DEBUG_PUSH_VAR("GL Flush: %.2f/%.2f/%.2f/%.2f",
+		               frameStats->msRecent[debugphase_glFlush], "v4");
+		DEBUG_PUSH_VAR("Frame: %.2f/%.2f/%.2f/%.2f",
+		               frameStats->msRecent[debugphase_frame], "v4");
+		DEBUG_PUSH_VAR("Hitches: %d", frameStats->numHitches, "i32");
+
+		if (frameStats->numHitches > 0)
+		{
+			i32 lastIndex = (frameStats->numHitches - 1) % DEBUG_MAX_HITCHES;
+			DebugHitch *lastHitch = &frameStats->hitches[lastIndex];
+			DEBUG_PUSH_VAR("Last Hitch Ms: %.2f",
+			               lastHitch->msPhase[debugphase_frame], "f32");
+		}
+		DEBUG_PUSH_STRING("== ==");
+	}
 
 	updateAndRenderDebugStack(&state->renderer, &state->transientArena, dt);
 	renderConsole(&state->renderer, &state->transientArena);
 
 	{ // Clear debug call counters
-		for (i32 i = 0; i < debugcount_num; i++) GLOBAL_debug.callCount[i] = 0;
+		for (i32 i = 0; i < debugcount_num; i++)
+		{
+			GLOBAL_debug.lastCallCount[i] = GLOBAL_debug.callCount[i];
+			GLOBAL_debug.callCount[i]     = 0;
+		}
 	}
 }
+
+/*
+ *********************************
+ * Frame Stats
+ *********************************
+ */
+INTERNAL const char *const PHASE_NAMES[debugphase_num] = {
+    "Input", "Simulate", "Render", "GL Flush", "Frame",
+};
+
+INTERNAL const char *const COUNT_NAMES[debugcount_num] = {
+    "drawArrays", "platformMemAlloc", "platformMemFree",
+    "numVertex",  "renderGroups",     "assetStringLookup",
+};
+
+INTERNAL i32 histogramBucket(u32 microseconds)
+{
+	const u32 maxValue = (1u << (HISTOGRAM_MAX_BIT + 1)) - 1;
+	microseconds       = MIN(microseconds, maxValue);
+	if (microseconds < HISTOGRAM_SUB_BUCKETS) return CAST(i32) microseconds;
+
+	i32 msb = DEBUG_HISTOGRAM_SUB_BITS;
+	while ((microseconds >> (msb + 1)) != 0) msb++;
+
+	i32 shift  = msb - DEBUG_HISTOGRAM_SUB_BITS;
+	i32 sub    = CAST(i32)(microseconds >> shift) - HISTOGRAM_SUB_BUCKETS;
+	i32 result = ((shift + 1) * HISTOGRAM_SUB_BUCKETS) + sub;
+	return result;
+}
+
+/* Largest value that falls in the bucket */
+INTERNAL u32 histogramBucketValue(const i32 bucket)
+{
+	if (bucket < HISTOGRAM_SUB_BUCKETS) return CAST(u32) bucket;
+
+	i32 shift  = (bucket / HISTOGRAM_SUB_BUCKETS) - 1;
+	u32 sub    = CAST(u32)(bucket % HISTOGRAM_SUB_BUCKETS);
+	u32 low    = (HISTOGRAM_SUB_BUCKETS + sub) << shift;
+	u32 result = low + (1u << shift) - 1;
+	return result;
+}
+
+/* p50, p95 and p99 in ms, clamped to the max which goes in w */
+INTERNAL v4 histogramPercentiles(const DebugHistogram *const histogram,
+                                 const u32 maxMicroseconds)
+{
+	v4 result = V4(0, 0, 0, 0);
+	if (histogram->total == 0) return result;
+
+	const f32 percentiles[3] = {0.50f, 0.95f, 0.99f};
+	i32 percentileIndex      = 0;
+	i32 count                = 0;
+	for (i32 i = 0; i < HISTOGRAM_NUM_BUCKETS && percentileIndex < 3; i++)
+	{
+		count += histogram->counts[i];
+		while (percentileIndex < 3 &&
+		       count >= percentiles[percentileIndex] * histogram->total)
+		{
+			u32 value = MIN(histogramBucketValue(i), maxMicroseconds);
+			result.e[percentileIndex++] = CAST(f32) value / 1000.0f;
+		}
+	}
+
+	result.w = CAST(f32) maxMicroseconds / 1000.0f;
+	return result;
+}
+
+INTERNAL void frameStatsRefresh(DebugFrameStats *const stats)
+{
+	for (i32 phase = 0; phase < debugphase_num; phase++)
+	{
+		u32 maxMicroseconds = 0;
+		for (i32 i = 0; i < stats->windowSize; i++)
+			maxMicroseconds = MAX(maxMicroseconds, stats->window[i][phase]);
+
+		stats->msRecent[phase] =
+		    histogramPercentiles(&stats->recent[phase], maxMicroseconds);
+	}
+}
+
+INTERNAL void frameStatsHitch(DebugFrameStats *const stats,
+                              const f32 msThreshold)
+{
+	DebugHitch *hitch =
+	    &stats->hitches[stats->numHitches % DEBUG_MAX_HITCHES];
+	stats->numHitches++;
+
+	hitch->frameIndex  = stats->frameIndex;
+	hitch->msThreshold = msThreshold;
+	for (i32 i = 0; i < debugphase_num; i++)
+		hitch->msPhase[i] = CAST(f32) stats->phaseMicroseconds[i] / 1000.0f;
+	for (i32 i = 0; i < debugcount_num; i++)
+		hitch->callCount[i] = GLOBAL_debug.lastCallCount[i];
+}
+
+void debug_phaseMark(enum DebugPhase phase)
+{
+	ASSERT(phase < debugphase_frame);
+	DebugFrameStats *stats = &GLOBAL_debug.frameStats;
+
+	f64 now = platform_getTimeInSeconds();
+	if (stats->frameStart == 0)
+	{
+		stats->frameStart = now;
+		stats->lastMark   = now;
+	}
+
+	stats->phaseMicroseconds[phase] +=
+	    CAST(u32)((now - stats->lastMark) * 1000000.0);
+	stats->lastMark = now;
+}
+
+void debug_frameEnd()
+{
+	DebugFrameStats *stats = &GLOBAL_debug.frameStats;
+
+	f64 now = platform_getTimeInSeconds();
+	if (stats->frameStart == 0) stats->frameStart = now;
+	stats->phaseMicroseconds[debugphase_frame] =
+	    CAST(u32)((now - stats->frameStart) * 1000000.0);
+
+	/* Replace the oldest frame of the window */
+	u32 *windowFrame = stats->window[stats->windowIndex];
+	for (i32 i = 0; i < debugphase_num; i++)
+	{
+		u32 microseconds = stats->phaseMicroseconds[i];
+		if (stats->windowSize == DEBUG_FRAME_WINDOW)
+			stats->recent[i].counts[histogramBucket(windowFrame[i])]--;
+		else
+			stats->recent[i].total++;
+
+		windowFrame[i] = microseconds;
+		stats->recent[i].counts[histogramBucket(microseconds)]++;
+
+		stats->run[i].counts[histogramBucket(microseconds)]++;
+		stats->run[i].total++;
+		stats->runSumMs[i] += microseconds / 1000.0;
+		stats->runMaxMicroseconds[i] =
+		    MAX(stats->runMaxMicroseconds[i], microseconds);
+	}
+
+	stats->windowIndex = (stats->windowIndex + 1) % DEBUG_FRAME_WINDOW;
+	stats->windowSize  = MIN(stats->windowSize + 1, DEBUG_FRAME_WINDOW);
+
+	f32 msFrame =
+	    CAST(f32) stats->phaseMicroseconds[debugphase_frame] / 1000.0f;
+	f32 msThreshold =
+	    MAX(DEBUG_HITCH_MIN_MS, stats->msRecent[debugphase_frame].x * 2.0f);
+	if (msFrame > msThreshold) frameStatsHitch(stats, msThreshold);
+
+	if ((stats->frameIndex % FRAME_STATS_REFRESH_FRAMES) == 0)
+		frameStatsRefresh(stats);
+
+	stats->frameIndex++;
+	stats->frameStart = now;
+	stats->lastMark   = now;
+	for (i32 i = 0; i < debugphase_num; i++) stats->phaseMicroseconds[i] = 0;
+}
+
+i32 debug_frameStatsExport(const char *path)
+{
+	PlatformFileWrite file = {0};
+	if (platform_fileWriteOpen(&file, path))
+	{
+		DEBUG_LOG("debug_frameStatsExport() failed: Could not open file");
+		return -1;
+	}
+
+	DebugFrameStats *stats = &GLOBAL_debug.frameStats;
+	char line[1024];
+	i32 len = snprintf(line, ARRAY_COUNT(line),
+	                   "Frames: %d, Hitches: %d\n\n"
+	                   "%-10s %9s %9s %9s %9s %9s\n",
+	                   stats->run[debugphase_frame].total, stats->numHitches,
+	                   "Ms", "p50", "p95", "p99", "Max", "Mean");
+	i32 result = platform_fileWrite(&file, line, len);
+
+	for (i32 i = 0; i < debugphase_num && result == 0; i++)
+	{
+		const DebugHistogram *histogram = &stats->run[i];
+		v4 ms = histogramPercentiles(histogram, stats->runMaxMicroseconds[i]);
+		f64 msMean =
+		    (histogram->total) ? stats->runSumMs[i] / histogram->total : 0;
+
+		len = snprintf(line, ARRAY_COUNT(line),
+		               "%-10s %9.2f %9.2f %9.2f %9.2f %9.2f\n", PHASE_NAMES[i],
+		               ms.x, ms.y, ms.z, ms.w, msMean);
+		result = platform_fileWrite(&file, line, len);
+	}
+
+	/* Oldest kept hitch first */
+	i32 numHitches = MIN(stats->numHitches, DEBUG_MAX_HITCHES);
+	for (i32 i = 0; i < numHitches && result == 0; i++)
+	{
+		i32 index = stats->numHitches - numHitches + i;
+		DebugHitch *hitch = &stats->hitches[index % DEBUG_MAX_HITCHES];
+
+		len = snprintf(line, ARRAY_COUNT(line),
+		               "%sHitch at frame %u, over %.2f ms\n",
+		               (i == 0) ? "\n" : "", hitch->frameIndex,
+		               hitch->msThreshold);
+		for (i32 j = 0; j < debugphase_num; j++)
+		{
+			len += snprintf(line + len, ARRAY_COUNT(line) - len,
+			                "    %s: %.2f ms\n", PHASE_NAMES[j],
+			                hitch->msPhase[j]);
+		}
+		for (i32 j = 0; j < debugcount_num; j++)
+		{
+			len += snprintf(line + len, ARRAY_COUNT(line) - len,
+			                "    %s: %d\n", COUNT_NAMES[j],
+			                hitch->callCount[j]);
+		}
+
+		result = platform_fileWrite(&file, line, len);
+	}
+
+	platform_fileWriteClose(&file);
+	return result;
+}
@@ -8,9 +8,9 @@ SubTexture entity_subTexGetCurr(Entity *const entity)
 {
 	EntityAnim *entityAnim = &entity->animList[entity->animListIndex];
 	Animation *anim        = entityAnim->anim;
-	char *frameName        = anim->frameList[entityAnim->currFrame];
+	i32 frameIndex         = anim->frameSubTexList[entityAnim->currFrame];
 
-	SubTexture result = asset_atlasGetSubTex(anim->atlas, frameName);
+	SubTexture result = asset_atlasGetSubTexFromIndex(anim->atlas, frameIndex);
 	return result;
 }
 
@@ -65,8 +65,8 @@ void entity_animUpdate(Entity *const entity, const f32 dt)
 		currEntityAnim->currDuration = anim->frameDuration;
 	}
 
-	char *frameName    = anim->frameList[currEntityAnim->currFrame];
-	SubTexture texRect = asset_atlasGetSubTex(anim->atlas, frameName);
+	i32 frameIndex     = anim->frameSubTexList[currEntityAnim->currFrame];
+	SubTexture texRect = asset_atlasGetSubTexFromIndex(anim->atlas, frameIndex);
 	entity->size       = v2_scale(texRect.rect.max, entity->scale);
 }
 
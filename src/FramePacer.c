@@ -0,0 +1,203 @@
+#include "Dengine/FramePacer.h"
+#include "Dengine/Debug.h"
+#include "Dengine/Math.h"
+#include "Dengine/Platform.h"
+
+#include <math.h>
+
+// NOTE(doyle): Weight of each sleep in the running overshoot estimate
+#define OVERSHOOT_ALPHA 0.1
+#define OVERSHOOT_MAX_SECONDS 0.05
+
+void framepacer_init(FramePacer *const pacer, const enum FramePaceMode mode,
+                     const f64 targetHz)
+{
+	ASSERT(mode < framepacemode_count);
+	ASSERT(mode != framepacemode_fixed || targetHz > 0);
+
+	common_memset(CAST(u8 *) pacer, 0, sizeof(*pacer));
+	pacer->mode = mode;
+	if (targetHz > 0) pacer->targetSecondsPerFrame = 1.0 / targetHz;
+
+	// NOTE(doyle): Pessimistic until the first sleeps are measured
+	pacer->overshootMean      = 0.001;
+	pacer->overshootDeviation = 0.0005;
+
+	pacer->frameStart   = platform_getTimeInSeconds();
+	pacer->lastFrameEnd = pacer->frameStart;
+}
+
+INTERNAL f64 overshootEstimate(const FramePacer *const pacer)
+{
+	f64 result = pacer->overshootMean + (2.0 * pacer->overshootDeviation);
+	return result;
+}
+
+INTERNAL void overshootLearn(FramePacer *const pacer, const f64 overshoot)
+{
+	f64 sample = MIN(MAX(overshoot, 0.0), OVERSHOOT_MAX_SECONDS);
+	f64 delta  = sample - pacer->overshootMean;
+
+	pacer->overshootMean      += OVERSHOOT_ALPHA * delta;
+	pacer->overshootDeviation +=
+	    OVERSHOOT_ALPHA * (ABS(delta) - pacer->overshootDeviation);
+}
+
+INTERNAL void historyPush(FramePacer *const pacer, const f32 msFrame)
+{
+	pacer->msFrameHistory[pacer->historyIndex++] = msFrame;
+	if (pacer->historyIndex >= ARRAY_COUNT(pacer->msFrameHistory))
+		pacer->historyIndex = 0;
+
+	if (pacer->historySize < ARRAY_COUNT(pacer->msFrameHistory))
+		pacer->historySize++;
+
+	f32 sum = 0;
+	f32 max = 0;
+	for (i32 i = 0; i < pacer->historySize; i++)
+	{
+		sum += pacer->msFrameHistory[i];
+		max  = MAX(max, pacer->msFrameHistory[i]);
+	}
+	f32 mean = sum / CAST(f32) pacer->historySize;
+
+	f32 sumSquares = 0;
+	for (i32 i = 0; i < pacer->historySize; i++)
+	{
+		f32 delta   = pacer->msFrameHistory[i] - mean;
+		sumSquares += delta * delta;
+	}
+
+	pacer->msFrameMean      = mean;
+	pacer->msFrameDeviation =
+	    sqrtf(sumSquares / CAST(f32) pacer->historySize);
+	pacer->msFrameMax = max;
+}
+
+f64 framepacer_endFrame(FramePacer *const pacer)
+{
+	f64 now         = platform_getTimeInSeconds();
+	pacer->msWorked = CAST(f32)((now - pacer->frameStart) * 1000.0);
+	pacer->msSlept  = 0;
+	pacer->msSpun   = 0;
+
+	if (pacer->mode == framepacemode_fixed)
+	{
+		f64 deadline = pacer->frameStart + pacer->targetSecondsPerFrame;
+		if (now > deadline) pacer->numMissedFrames++;
+
+		f64 wakeEarly    = overshootEstimate(pacer) + FRAME_PACER_SPIN_SECONDS;
+		f64 sleepSeconds = deadline - now - wakeEarly;
+		if (sleepSeconds > 0)
+		{
+			f64 sleepStart = now;
+			platform_sleep(sleepSeconds);
+			now = platform_getTimeInSeconds();
+
+			overshootLearn(pacer, (now - sleepStart) - sleepSeconds);
+			pacer->msSlept = CAST(f32)((now - sleepStart) * 1000.0);
+		}
+
+		f64 spinStart = now;
+		while (now < deadline)
+			now = platform_getTimeInSeconds();
+		pacer->msSpun = CAST(f32)((now - spinStart) * 1000.0);
+
+		if (now - deadline < pacer->targetSecondsPerFrame)
+			pacer->frameStart = deadline;
+		else
+			pacer->frameStart = now;
+	}
+	else
+	{
+		pacer->frameStart = now;
+	}
+
+	f64 result          = now - pacer->lastFrameEnd;
+	pacer->lastFrameEnd = now;
+	historyPush(pacer, CAST(f32)(result * 1000.0));
+
+	return result;
+}
+
+/* Returns how long the frame ended after its deadline, in seconds */
+INTERNAL f64 unitTestFrame(FramePacer *const pacer, const f64 workSeconds)
+{
+	f64 deadline  = pacer->frameStart + pacer->targetSecondsPerFrame;
+	f64 workStart = platform_getTimeInSeconds();
+	while (platform_getTimeInSeconds() - workStart < workSeconds)
+		;
+
+	framepacer_endFrame(pacer);
+	f64 result = pacer->lastFrameEnd - deadline;
+	return result;
+}
+
+void framepacer_unitTest()
+{
+	{ // Frame time stats over the history, wrapping once it is full
+		FramePacer pacer = {0};
+		historyPush(&pacer, 4.0f);
+		historyPush(&pacer, 6.0f);
+		ASSERT(pacer.historySize == 2);
+		ASSERT(pacer.msFrameMean == 5.0f);
+		ASSERT(pacer.msFrameDeviation == 1.0f);
+		ASSERT(pacer.msFrameMax == 6.0f);
+
+		for (i32 i = 0; i < FRAME_PACER_HISTORY; i++)
+			historyPush(&pacer, 2.0f);
+		ASSERT(pacer.historySize == FRAME_PACER_HISTORY);
+		ASSERT(pacer.historyIndex == 2);
+		ASSERT(pacer.msFrameMean == 2.0f);
+		ASSERT(pacer.msFrameDeviation == 0.0f);
+		ASSERT(pacer.msFrameMax == 2.0f);
+	}
+
+	{ // Overshoot estimate follows the sleeps, outliers are clamped
+		FramePacer pacer = {0};
+		for (i32 i = 0; i < 200; i++)
+			overshootLearn(&pacer, 0.002);
+		ASSERT(ABS(pacer.overshootMean - 0.002) < 0.00001);
+		ASSERT(pacer.overshootDeviation < 0.00001);
+
+		f64 mean = pacer.overshootMean;
+		overshootLearn(&pacer, 10.0);
+		ASSERT(pacer.overshootMean <=
+		       mean + (OVERSHOOT_ALPHA * OVERSHOOT_MAX_SECONDS));
+
+		overshootLearn(&pacer, -1.0);
+		ASSERT(pacer.overshootMean > 0);
+	}
+
+	{ // Fixed mode never ends a frame before its deadline
+		// NOTE(doyle): Runs on the wall clock at startup, kept to a few short
+		// frames. How well the rate holds depends on the machine's load
+		FramePacer pacer = {0};
+		framepacer_init(&pacer, framepacemode_fixed, 1000.0);
+		for (i32 i = 0; i < 3; i++)
+		{
+			f64 late = unitTestFrame(&pacer, i * 0.0002);
+			ASSERT(late >= 0);
+		}
+	}
+
+	{ // Work longer than a frame is a miss and restarts the cadence
+		FramePacer pacer = {0};
+		framepacer_init(&pacer, framepacemode_fixed, 1000.0);
+		unitTestFrame(&pacer, 0.003);
+		ASSERT(pacer.numMissedFrames == 1);
+		ASSERT(pacer.frameStart == pacer.lastFrameEnd);
+	}
+
+	{ // Uncapped never waits
+		FramePacer pacer = {0};
+		framepacer_init(&pacer, framepacemode_uncapped, 0);
+		for (i32 i = 0; i < 10; i++)
+		{
+			framepacer_endFrame(&pacer);
+			ASSERT(pacer.msSlept == 0 && pacer.msSpun == 0);
+		}
+		ASSERT(pacer.historySize == 10);
+		ASSERT(pacer.numMissedFrames == 0);
+	}
+}
@@ -22,7 +22,7 @@ TempMemory memory_beginTempRegion(MemoryArena_ *arena)
 void memory_endTempRegion(TempMemory tempMemory)
 {
 	MemoryArena_ *arena = tempMemory.arena;
-	ASSERT(arena->used > tempMemory.used)
+	ASSERT(arena->used >= tempMemory.used)
 
 	arena->used        = tempMemory.used;
 	ASSERT(arena->tempMemoryCount > 0)
@@ -0,0 +1,1043 @@
+#ifndef _WIN32
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/io_uring.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#endif
+
+#include "Dengine/Platform.h"
+#include "Dengine/Debug.h"
+#include "Dengine/MemoryArena.h"
+
+void platform_closeFileRead(MemoryArena_ *arena, PlatformFileRead *file)
+{
+	if (file->isMapped && file->buffer) munmap(file->buffer, file->size);
+
+	// TODO(doyle): Mem free for arena reads
+	if (file->isMapped)
+	{
+		PlatformFileRead empty = {0};
+		*file                  = empty;
+	}
+}
+
+/* Fill the buffer with read(), retrying short reads and interrupts */
+INTERNAL i32 readAll(const i32 fd, u8 *const buffer, const i32 size)
+{
+	i32 numBytesRead = 0;
+	while (numBytesRead < size)
+	{
+		ssize_t result = read(fd, buffer + numBytesRead, size - numBytesRead);
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) break;
+
+		numBytesRead += CAST(i32) result;
+	}
+
+	return numBytesRead;
+}
+
+/*
+   NOTE(doyle): Files are mapped read only and private so the buffer is zero
+   copy, the sequential hint lets the kernel read ahead aggressively. If the
+   file can't be mapped (pipes, some network mounts) it is read into the arena
+   like on Windows.
+ */
+i32 platform_readFileToBuffer(MemoryArena_ *arena, const char *const filePath,
+                              PlatformFileRead *file)
+{
+	i32 fd = open(filePath, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+	{
+		printf("open() failed: %s: %s\n", filePath, strerror(errno));
+		return -1;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) == -1)
+	{
+		printf("fstat() failed: %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	// TODO(doyle): Warning we assume files less than 2GB
+	i32 fileSize   = CAST(i32) fileStat.st_size;
+	file->buffer   = NULL;
+	file->size     = fileSize;
+	file->isMapped = FALSE;
+	if (fileSize == 0)
+	{
+		close(fd);
+		return 0;
+	}
+
+	void *base = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (base != MAP_FAILED)
+	{
+		madvise(base, fileSize, MADV_SEQUENTIAL);
+		close(fd);
+
+		file->buffer   = base;
+		file->isMapped = TRUE;
+		return 0;
+	}
+
+	file->buffer = memory_pushBytes(arena, fileSize * sizeof(char));
+	i32 numBytesRead = readAll(fd, CAST(u8 *) file->buffer, fileSize);
+	close(fd);
+
+	if (numBytesRead != fileSize)
+	{
+		printf(
+		    "read() failed: Number of bytes read doesn't match file size\n");
+		// TODO(doyle): Mem free
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ *********************************
+ * Batched Reads
+ *********************************
+ */
+#define READ_POOL_MAX_THREADS 4
+
+typedef struct ReadBatch
+{
+	const char *const *filePaths;
+	PlatformFileRead *files;
+	i32 fds[PLATFORM_READ_BATCH_MAX];
+	i32 numFiles;
+
+	// NOTE(doyle): Batches are chunked, callbacks report the index into the
+	// caller's full list
+	i32 indexOffset;
+
+	// NOTE(doyle): Files with a read in flight, empty or failed opens are
+	// reported up front
+	i32 numToRead;
+
+	PlatformReadCallback *callback;
+	void *userData;
+} ReadBatch;
+
+/* Open and size every file and push the buffers, returns the number failed */
+INTERNAL i32 readBatchOpen(MemoryArena_ *arena, ReadBatch *batch)
+{
+	i32 numFailed    = 0;
+	batch->numToRead = 0;
+	for (i32 i = 0; i < batch->numFiles; i++)
+	{
+		PlatformFileRead *file = &batch->files[i];
+		PlatformFileRead empty = {0};
+		*file                  = empty;
+		batch->fds[i]          = -1;
+
+		i32 fd = open(batch->filePaths[i], O_RDONLY | O_CLOEXEC);
+		struct stat fileStat;
+		if (fd == -1 || fstat(fd, &fileStat) == -1)
+		{
+			printf("open() failed: %s: %s\n", batch->filePaths[i],
+			       strerror(errno));
+			if (fd != -1) close(fd);
+
+			numFailed++;
+			batch->callback(batch->userData, batch->indexOffset + i, file,
+			                -1);
+			continue;
+		}
+
+		file->size = CAST(i32) fileStat.st_size;
+		if (file->size == 0)
+		{
+			close(fd);
+			batch->callback(batch->userData, batch->indexOffset + i, file, 0);
+			continue;
+		}
+
+		file->buffer  = memory_pushBytes(arena, file->size * sizeof(char));
+		batch->fds[i] = fd;
+		batch->numToRead++;
+	}
+
+	return numFailed;
+}
+
+INTERNAL void readBatchComplete(ReadBatch *batch, i32 index, i32 result)
+{
+	close(batch->fds[index]);
+	batch->fds[index] = -1;
+
+	if (result) printf("read() failed: %s\n", batch->filePaths[index]);
+	batch->callback(batch->userData, batch->indexOffset + index,
+	                &batch->files[index], result);
+}
+
+#ifdef __linux__
+/*
+   NOTE(doyle): io_uring driven with raw syscalls, there's no liburing
+   dependency. Reads use READV which every io_uring capable kernel has.
+ */
+typedef struct IoUring
+{
+	i32 fd;
+	u32 numEntries;
+
+	void *sqRing;
+	size_t sqRingSize;
+	u32 *sqHead;
+	u32 *sqTail;
+	u32 *sqMask;
+	u32 *sqArray;
+	struct io_uring_sqe *sqes;
+	size_t sqesSize;
+
+	void *cqRing;
+	size_t cqRingSize;
+	u32 *cqHead;
+	u32 *cqTail;
+	u32 *cqMask;
+	struct io_uring_cqe *cqes;
+} IoUring;
+
+INTERNAL void ioUringFree(IoUring *ring)
+{
+	if (ring->sqes) munmap(ring->sqes, ring->sqesSize);
+	if (ring->cqRing) munmap(ring->cqRing, ring->cqRingSize);
+	if (ring->sqRing) munmap(ring->sqRing, ring->sqRingSize);
+	if (ring->fd != -1) close(ring->fd);
+
+	IoUring empty = {0};
+	*ring         = empty;
+	ring->fd      = -1;
+}
+
+/* Returns -1 if the kernel has no io_uring or it is disabled */
+INTERNAL i32 ioUringInit(IoUring *ring, u32 numEntries)
+{
+	IoUring empty = {0};
+	*ring         = empty;
+
+	struct io_uring_params params = {0};
+	ring->fd = CAST(i32) syscall(__NR_io_uring_setup, numEntries, &params);
+	if (ring->fd < 0)
+	{
+		ring->fd = -1;
+		return -1;
+	}
+
+	ring->numEntries = params.sq_entries;
+	ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+	ring->cqRingSize =
+	    params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	i32 prot     = PROT_READ | PROT_WRITE;
+	i32 flags    = MAP_SHARED | MAP_POPULATE;
+	ring->sqRing = mmap(NULL, ring->sqRingSize, prot, flags, ring->fd,
+	                    IORING_OFF_SQ_RING);
+	ring->cqRing = mmap(NULL, ring->cqRingSize, prot, flags, ring->fd,
+	                    IORING_OFF_CQ_RING);
+	ring->sqes   = mmap(NULL, ring->sqesSize, prot, flags, ring->fd,
+	                    IORING_OFF_SQES);
+	if (ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED ||
+	    ring->sqes == MAP_FAILED)
+	{
+		if (ring->sqRing == MAP_FAILED) ring->sqRing = NULL;
+		if (ring->cqRing == MAP_FAILED) ring->cqRing = NULL;
+		if (ring->sqes == MAP_FAILED) ring->sqes = NULL;
+		ioUringFree(ring);
+		return -1;
+	}
+
+	u8 *sq        = CAST(u8 *) ring->sqRing;
+	ring->sqHead  = CAST(u32 *)(sq + params.sq_off.head);
+	ring->sqTail  = CAST(u32 *)(sq + params.sq_off.tail);
+	ring->sqMask  = CAST(u32 *)(sq + params.sq_off.ring_mask);
+	ring->sqArray = CAST(u32 *)(sq + params.sq_off.array);
+
+	u8 *cq       = CAST(u8 *) ring->cqRing;
+	ring->cqHead = CAST(u32 *)(cq + params.cq_off.head);
+	ring->cqTail = CAST(u32 *)(cq + params.cq_off.tail);
+	ring->cqMask = CAST(u32 *)(cq + params.cq_off.ring_mask);
+	ring->cqes   = CAST(struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+	return 0;
+}
+
+/* Queue a read of the rest of the file, submitted on the next enter */
+INTERNAL void ioUringQueueRead(IoUring *ring, ReadBatch *batch,
+                               struct iovec *iovecs, const i32 *bytesRead,
+                               i32 index)
+{
+	PlatformFileRead *file = &batch->files[index];
+	iovecs[index].iov_base = CAST(u8 *) file->buffer + bytesRead[index];
+	iovecs[index].iov_len  = file->size - bytesRead[index];
+
+	u32 tail              = *ring->sqTail;
+	u32 slot              = tail & *ring->sqMask;
+	struct io_uring_sqe *sqe = &ring->sqes[slot];
+
+	struct io_uring_sqe empty = {0};
+	*sqe                      = empty;
+	sqe->opcode               = IORING_OP_READV;
+	sqe->fd                   = batch->fds[index];
+	sqe->addr                 = CAST(u64)(uintptr_t) &iovecs[index];
+	sqe->len                  = 1;
+	sqe->off                  = bytesRead[index];
+	sqe->user_data            = index;
+
+	ring->sqArray[slot] = slot;
+	__atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/* Reads queued since the last enter that the kernel has not taken yet */
+INTERNAL u32 ioUringNumUnsubmitted(IoUring *ring)
+{
+	u32 head   = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+	u32 result = *ring->sqTail - head;
+	return result;
+}
+
+/*
+   NOTE(doyle): The ring can't be trusted after io_uring_enter fails. Reads
+   still queued were never seen by the kernel and fail straight away, but
+   reads already submitted may still be writing into their buffers, so their
+   completions are waited on before the buffers go back to the caller. Closing
+   the ring does not wait for them. If even waiting fails the buffers are
+   abandoned in the arena rather than handed back.
+ */
+INTERNAL i32 ioUringAbort(IoUring *ring, ReadBatch *batch, const i32 *bytesRead,
+                          b32 *inFlight)
+{
+	i32 numFailed = 0;
+
+	u32 tail = *ring->sqTail;
+	for (u32 head = *ring->sqHead; head != tail; head++)
+	{
+		i32 index = CAST(i32) ring->sqes[head & *ring->sqMask].user_data;
+		inFlight[index] = FALSE;
+		readBatchComplete(batch, index, -1);
+		numFailed++;
+	}
+
+	i32 numOutstanding = 0;
+	for (i32 i = 0; i < batch->numFiles; i++)
+		if (inFlight[i]) numOutstanding++;
+
+	while (numOutstanding > 0)
+	{
+		i32 result = CAST(i32) syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+		                               IORING_ENTER_GETEVENTS, NULL, 0);
+		if (result < 0 && errno == EINTR) continue;
+		if (result < 0) break;
+
+		u32 cqHead = *ring->cqHead;
+		u32 cqTail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+		for (; cqHead != cqTail; cqHead++)
+		{
+			struct io_uring_cqe *cqe = &ring->cqes[cqHead & *ring->cqMask];
+			i32 index                = CAST(i32) cqe->user_data;
+			i32 size                 = batch->files[index].size;
+
+			i32 readResult = -1;
+			if (cqe->res > 0 && bytesRead[index] + cqe->res == size)
+				readResult = 0;
+			if (readResult) numFailed++;
+
+			inFlight[index] = FALSE;
+			readBatchComplete(batch, index, readResult);
+			numOutstanding--;
+		}
+		__atomic_store_n(ring->cqHead, cqHead, __ATOMIC_RELEASE);
+	}
+
+	for (i32 i = 0; i < batch->numFiles && numOutstanding > 0; i++)
+	{
+		if (!inFlight[i]) continue;
+
+		PlatformFileRead *file = &batch->files[i];
+		file->buffer           = NULL;
+		file->size             = 0;
+		readBatchComplete(batch, i, -1);
+		numFailed++;
+	}
+
+	ioUringFree(ring);
+	return numFailed;
+}
+
+/* Returns -1 and frees the ring if it failed, the batch is done either way */
+INTERNAL i32 readBatchIoUring(IoUring *ring, ReadBatch *batch, i32 *numFailed)
+{
+	struct iovec iovecs[PLATFORM_READ_BATCH_MAX];
+	i32 bytesRead[PLATFORM_READ_BATCH_MAX] = {0};
+	b32 inFlight[PLATFORM_READ_BATCH_MAX]  = {0};
+
+	i32 numInFlight = 0;
+	i32 nextIndex   = 0;
+	i32 numDone     = 0;
+	while (numDone < batch->numToRead)
+	{
+		/* Keep the submission queue full */
+		for (; nextIndex < batch->numFiles; nextIndex++)
+		{
+			if (numInFlight >= CAST(i32) ring->numEntries) break;
+			if (batch->fds[nextIndex] == -1) continue;
+
+			ioUringQueueRead(ring, batch, iovecs, bytesRead, nextIndex);
+			inFlight[nextIndex] = TRUE;
+			numInFlight++;
+		}
+
+		i32 result = CAST(i32) syscall(
+		    __NR_io_uring_enter, ring->fd, ioUringNumUnsubmitted(ring), 1,
+		    IORING_ENTER_GETEVENTS, NULL, 0);
+		if (result < 0)
+		{
+			if (errno == EINTR) continue;
+
+			printf("io_uring_enter() failed: %s\n", strerror(errno));
+			*numFailed += ioUringAbort(ring, batch, bytesRead, inFlight);
+			return -1;
+		}
+
+		/* Reap completions */
+		u32 head = *ring->cqHead;
+		u32 tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++)
+		{
+			struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+			i32 index                = CAST(i32) cqe->user_data;
+			i32 res                  = cqe->res;
+
+			if (res == -EINTR || res == -EAGAIN)
+			{
+				ioUringQueueRead(ring, batch, iovecs, bytesRead, index);
+				continue;
+			}
+
+			if (res > 0) bytesRead[index] += res;
+			if (res > 0 && bytesRead[index] < batch->files[index].size)
+			{
+				ioUringQueueRead(ring, batch, iovecs, bytesRead, index);
+				continue;
+			}
+
+			// NOTE(doyle): An error or EOF before the size we stat'd
+			i32 readResult =
+			    (bytesRead[index] == batch->files[index].size) ? 0 : -1;
+			if (readResult) (*numFailed)++;
+
+			inFlight[index] = FALSE;
+			readBatchComplete(batch, index, readResult);
+			numInFlight--;
+			numDone++;
+		}
+		__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+	}
+
+	return 0;
+}
+#endif
+
+typedef struct ReadPool
+{
+	ReadBatch *batch;
+	volatile i32 nextIndex;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t completedCond;
+	i32 completedIndex[PLATFORM_READ_BATCH_MAX];
+	i32 completedResult[PLATFORM_READ_BATCH_MAX];
+	i32 numCompleted;
+} ReadPool;
+
+INTERNAL i32 preadAll(const i32 fd, u8 *const buffer, const i32 size)
+{
+	i32 numBytesRead = 0;
+	while (numBytesRead < size)
+	{
+		ssize_t result =
+		    pread(fd, buffer + numBytesRead, size - numBytesRead, numBytesRead);
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) break;
+
+		numBytesRead += CAST(i32) result;
+	}
+
+	return numBytesRead;
+}
+
+INTERNAL void *readPoolThread(void *param)
+{
+	ReadPool *pool   = CAST(ReadPool *) param;
+	ReadBatch *batch = pool->batch;
+	for (;;)
+	{
+		i32 index = __sync_fetch_and_add(&pool->nextIndex, 1);
+		if (index >= batch->numFiles) break;
+		if (batch->fds[index] == -1) continue;
+
+		PlatformFileRead *file = &batch->files[index];
+		i32 numBytesRead =
+		    preadAll(batch->fds[index], CAST(u8 *) file->buffer, file->size);
+		i32 result = (numBytesRead == file->size) ? 0 : -1;
+
+		pthread_mutex_lock(&pool->mutex);
+		pool->completedIndex[pool->numCompleted]  = index;
+		pool->completedResult[pool->numCompleted] = result;
+		pool->numCompleted++;
+		pthread_cond_signal(&pool->completedCond);
+		pthread_mutex_unlock(&pool->mutex);
+	}
+
+	return NULL;
+}
+
+/* Fallback when there's no io_uring, a short lived pool of pread threads */
+INTERNAL i32 readBatchThreadPool(ReadBatch *batch)
+{
+	ReadPool pool  = {0};
+	pool.batch     = batch;
+	pthread_mutex_init(&pool.mutex, NULL);
+	pthread_cond_init(&pool.completedCond, NULL);
+
+	i32 numThreads = batch->numToRead;
+	if (numThreads > READ_POOL_MAX_THREADS) numThreads = READ_POOL_MAX_THREADS;
+
+	pthread_t threads[READ_POOL_MAX_THREADS];
+	i32 numThreadsCreated = 0;
+	for (i32 i = 0; i < numThreads; i++)
+	{
+		if (pthread_create(&threads[i], NULL, readPoolThread, &pool)) break;
+		numThreadsCreated++;
+	}
+
+	// NOTE(doyle): No threads, read serially on the calling thread
+	if (numThreadsCreated == 0) readPoolThread(&pool);
+
+	i32 numFailed = 0;
+	i32 numReaped = 0;
+	while (numReaped < batch->numToRead)
+	{
+		pthread_mutex_lock(&pool.mutex);
+		while (numReaped == pool.numCompleted)
+			pthread_cond_wait(&pool.completedCond, &pool.mutex);
+		i32 numCompleted = pool.numCompleted;
+		pthread_mutex_unlock(&pool.mutex);
+
+		for (; numReaped < numCompleted; numReaped++)
+		{
+			i32 index  = pool.completedIndex[numReaped];
+			i32 result = pool.completedResult[numReaped];
+			if (result) numFailed++;
+
+			readBatchComplete(batch, index, result);
+		}
+	}
+
+	for (i32 i = 0; i < numThreadsCreated; i++) pthread_join(threads[i], NULL);
+	pthread_cond_destroy(&pool.completedCond);
+	pthread_mutex_destroy(&pool.mutex);
+
+	return numFailed;
+}
+
+void platform_fileReaderInit(PlatformFileReader *reader)
+{
+	reader->handle = NULL;
+
+#ifdef __linux__
+	IoUring *ring = CAST(IoUring *) platform_memoryAlloc(NULL, sizeof(IoUring));
+	if (!ring) return;
+
+	if (ioUringInit(ring, PLATFORM_READ_BATCH_MAX))
+	{
+		platform_memoryFree(NULL, ring, sizeof(IoUring));
+		return;
+	}
+
+	reader->handle = ring;
+#endif
+}
+
+i32 platform_readFileBatch(PlatformFileReader *reader, MemoryArena_ *arena,
+                           const char *const *filePaths,
+                           PlatformFileRead *files, i32 numFiles,
+                           PlatformReadCallback *callback, void *userData)
+{
+	i32 numFailed = 0;
+	for (i32 offset = 0; offset < numFiles; offset += PLATFORM_READ_BATCH_MAX)
+	{
+		ReadBatch batch = {0};
+		batch.filePaths = filePaths + offset;
+		batch.files     = files + offset;
+		batch.numFiles    = numFiles - offset;
+		batch.indexOffset = offset;
+		batch.callback    = callback;
+		batch.userData    = userData;
+		if (batch.numFiles > PLATFORM_READ_BATCH_MAX)
+			batch.numFiles = PLATFORM_READ_BATCH_MAX;
+
+		numFailed += readBatchOpen(arena, &batch);
+		if (batch.numToRead == 0) continue;
+
+#ifdef __linux__
+		IoUring *ring = CAST(IoUring *) reader->handle;
+		if (ring)
+		{
+			// NOTE(doyle): A failed ring has finished the batch, later ones
+			// use the pool
+			if (readBatchIoUring(ring, &batch, &numFailed))
+			{
+				platform_memoryFree(NULL, ring, sizeof(IoUring));
+				reader->handle = NULL;
+			}
+			continue;
+		}
+#endif
+		numFailed += readBatchThreadPool(&batch);
+	}
+
+	return numFailed;
+}
+
+i32 platform_writeBufferToFile(const char *const filePath,
+                               const void *const buffer, const i32 size)
+{
+	i32 fd = open(filePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd == -1)
+	{
+		printf("open() failed: %s: %s\n", filePath, strerror(errno));
+		return -1;
+	}
+
+	i32 numBytesWritten = 0;
+	while (numBytesWritten < size)
+	{
+		ssize_t result = write(fd, CAST(const u8 *) buffer + numBytesWritten,
+		                       size - numBytesWritten);
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) break;
+
+		numBytesWritten += CAST(i32) result;
+	}
+	close(fd);
+
+	if (numBytesWritten != size)
+	{
+		printf("write() failed: %d bytes of %d written\n", numBytesWritten,
+		       size);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Write all of the buffer at the offset, or at the end if offset is -1 */
+INTERNAL i32 fdWriteAll(const i32 fd, const void *const buffer, const i32 size,
+                        const i32 offset)
+{
+	i32 numBytesWritten = 0;
+	while (numBytesWritten < size)
+	{
+		const u8 *src    = CAST(const u8 *) buffer + numBytesWritten;
+		i32 numRemaining = size - numBytesWritten;
+		ssize_t result   = (offset == -1)
+		                     ? write(fd, src, numRemaining)
+		                     : pwrite(fd, src, numRemaining,
+		                              offset + numBytesWritten);
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) break;
+
+		numBytesWritten += CAST(i32) result;
+	}
+
+	if (numBytesWritten != size)
+	{
+		printf("write() failed: %d bytes of %d written\n", numBytesWritten,
+		       size);
+		return -1;
+	}
+
+	return 0;
+}
+
+i32 platform_fileWriteOpen(PlatformFileWrite *file,
+                           const char *const filePath)
+{
+	i32 fd = open(filePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd == -1)
+	{
+		printf("open() failed: %s: %s\n", filePath, strerror(errno));
+		return -1;
+	}
+
+	file->handle = CAST(void *) CAST(intptr_t) fd;
+	file->isOpen = TRUE;
+	return 0;
+}
+
+i32 platform_fileWrite(PlatformFileWrite *file, const void *const buffer,
+                       const i32 size)
+{
+	if (!file->isOpen) return -1;
+
+	// NOTE(doyle): pwrite leaves the file offset alone, an append after the
+	// header was written would land on top of it. O_APPEND is not an option,
+	// Linux appends pwrites on such files as well.
+	i32 fd = CAST(i32) CAST(intptr_t) file->handle;
+	if (lseek(fd, 0, SEEK_END) == -1) return -1;
+
+	i32 result = fdWriteAll(fd, buffer, size, -1);
+	return result;
+}
+
+i32 platform_fileWriteAt(PlatformFileWrite *file, const i32 offset,
+                         const void *const buffer, const i32 size)
+{
+	if (!file->isOpen) return -1;
+
+	i32 fd     = CAST(i32) CAST(intptr_t) file->handle;
+	i32 result = fdWriteAll(fd, buffer, size, offset);
+	return result;
+}
+
+void platform_fileWriteClose(PlatformFileWrite *file)
+{
+	if (file->isOpen) close(CAST(i32) CAST(intptr_t) file->handle);
+
+	PlatformFileWrite empty = {0};
+	*file                   = empty;
+}
+
+i32 platform_mapFile(const char *const filePath, PlatformFileMap *map)
+{
+	i32 fd = open(filePath, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) return -1;
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) == -1 || fileStat.st_size == 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	void *base = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+	{
+		printf("mmap() failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	// NOTE(doyle): The mapping keeps the file referenced, no handles to keep
+	map->base       = base;
+	map->size       = CAST(i32) fileStat.st_size;
+	map->fileHandle = NULL;
+	map->mapHandle  = NULL;
+	return 0;
+}
+
+void platform_unmapFile(PlatformFileMap *map)
+{
+	if (map->base) munmap(map->base, map->size);
+
+	PlatformFileMap empty = {0};
+	*map                  = empty;
+}
+
+f64 platform_getTimeInSeconds()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	f64 result = CAST(f64) now.tv_sec + (CAST(f64) now.tv_nsec * 1.0e-9);
+	return result;
+}
+
+void platform_sleep(f64 seconds)
+{
+	if (seconds <= 0) return;
+
+	struct timespec duration;
+	duration.tv_sec  = CAST(time_t) seconds;
+	duration.tv_nsec = CAST(long)((seconds - duration.tv_sec) * 1.0e9);
+
+	// NOTE(doyle): Resume with the remaining time if a signal interrupts
+	while (nanosleep(&duration, &duration) == -1 && errno == EINTR)
+		;
+}
+
+#ifdef __linux__
+/*
+   NOTE(doyle): inotify does not recurse, every directory in the tree gets its
+   own watch. Directories created later are added as they appear.
+ */
+#define FILE_WATCH_MAX_DIRS 128
+
+typedef struct FileWatchLinux
+{
+	i32 fd;
+	i32 numDirs;
+	i32 watchDescriptor[FILE_WATCH_MAX_DIRS];
+	char dir[FILE_WATCH_MAX_DIRS][256];
+} FileWatchLinux;
+
+INTERNAL void fileWatchAddTree(FileWatchLinux *const watch,
+                               const char *const directory)
+{
+	if (watch->numDirs >= FILE_WATCH_MAX_DIRS)
+	{
+		DEBUG_LOG("fileWatchAddTree() failed: Too many directories to watch");
+		return;
+	}
+
+	u32 mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+	i32 wd   = inotify_add_watch(watch->fd, directory, mask);
+	if (wd == -1)
+	{
+		printf("inotify_add_watch() failed: %s, %s\n", directory,
+		       strerror(errno));
+		return;
+	}
+
+	// NOTE(doyle): Watching a directory twice returns its existing watch
+	for (i32 i = 0; i < watch->numDirs; i++)
+	{
+		if (watch->watchDescriptor[i] == wd) return;
+	}
+
+	watch->watchDescriptor[watch->numDirs] = wd;
+	snprintf(watch->dir[watch->numDirs], ARRAY_COUNT(watch->dir[0]), "%s",
+	         directory);
+	watch->numDirs++;
+
+	DIR *dir = opendir(directory);
+	if (!dir) return;
+
+	struct dirent *dirEntry;
+	while ((dirEntry = readdir(dir)))
+	{
+		char *name = dirEntry->d_name;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		char path[256];
+		snprintf(path, ARRAY_COUNT(path), "%s/%s", directory, name);
+
+		struct stat fileStat;
+		if (stat(path, &fileStat) == 0 && S_ISDIR(fileStat.st_mode))
+			fileWatchAddTree(watch, path);
+	}
+
+	closedir(dir);
+}
+
+i32 platform_fileWatchInit(PlatformFileWatch *watch,
+                           const char *const directory)
+{
+	FileWatchLinux *linuxWatch =
+	    CAST(FileWatchLinux *) calloc(1, sizeof(FileWatchLinux));
+	if (!linuxWatch) return -1;
+
+	linuxWatch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (linuxWatch->fd == -1)
+	{
+		printf("inotify_init1() failed: %s\n", strerror(errno));
+		free(linuxWatch);
+		return -1;
+	}
+
+	fileWatchAddTree(linuxWatch, directory);
+	if (linuxWatch->numDirs == 0)
+	{
+		close(linuxWatch->fd);
+		free(linuxWatch);
+		return -1;
+	}
+
+	watch->handle = linuxWatch;
+	return 0;
+}
+
+void platform_fileWatchPoll(PlatformFileWatch *watch,
+                            PlatformFileChangedCallback *callback,
+                            void *userData)
+{
+	FileWatchLinux *linuxWatch = CAST(FileWatchLinux *) watch->handle;
+	if (!linuxWatch) return;
+
+	// NOTE(doyle): Events are variable length, u64 aligns the buffer for them
+	u64 buffer[4096 / sizeof(u64)];
+	char *events = CAST(char *) buffer;
+	for (;;)
+	{
+		ssize_t bytesRead = read(linuxWatch->fd, buffer, sizeof(buffer));
+		if (bytesRead <= 0) break;
+
+		for (char *ptr = events; ptr < events + bytesRead;)
+		{
+			struct inotify_event *event = CAST(struct inotify_event *) ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				DEBUG_LOG("platform_fileWatchPoll() warning: Events dropped");
+				continue;
+			}
+
+			if (event->len == 0) continue;
+
+			char *directory = NULL;
+			for (i32 i = 0; i < linuxWatch->numDirs; i++)
+			{
+				if (linuxWatch->watchDescriptor[i] == event->wd)
+				{
+					directory = linuxWatch->dir[i];
+					break;
+				}
+			}
+			if (!directory) continue;
+
+			char path[256];
+			snprintf(path, ARRAY_COUNT(path), "%s/%s", directory,
+			         event->name);
+
+			if (event->mask & IN_ISDIR)
+			{
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					fileWatchAddTree(linuxWatch, path);
+			}
+			else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+			{
+				callback(userData, path);
+			}
+		}
+	}
+}
+
+void platform_fileWatchClose(PlatformFileWatch *watch)
+{
+	FileWatchLinux *linuxWatch = CAST(FileWatchLinux *) watch->handle;
+	if (!linuxWatch) return;
+
+	close(linuxWatch->fd);
+	free(linuxWatch);
+	watch->handle = NULL;
+}
+
+#else
+i32 platform_fileWatchInit(PlatformFileWatch *watch,
+                           const char *const directory)
+{
+	return -1;
+}
+
+void platform_fileWatchPoll(PlatformFileWatch *watch,
+                            PlatformFileChangedCallback *callback,
+                            void *userData)
+{
+}
+
+void platform_fileWatchClose(PlatformFileWatch *watch) {}
+#endif
+
+typedef struct ThreadStartInfo
+{
+	PlatformThreadProc *proc;
+	void *userData;
+} ThreadStartInfo;
+
+INTERNAL void *threadStart(void *param)
+{
+	ThreadStartInfo info = *(CAST(ThreadStartInfo *) param);
+	free(param);
+
+	info.proc(info.userData);
+	return NULL;
+}
+
+i32 platform_threadCreate(PlatformThreadProc *proc, void *userData)
+{
+	ThreadStartInfo *info = CAST(ThreadStartInfo *) malloc(sizeof(*info));
+	if (!info) return -1;
+
+	info->proc     = proc;
+	info->userData = userData;
+
+	pthread_t thread;
+	i32 result = pthread_create(&thread, NULL, threadStart, info);
+	if (result != 0)
+	{
+		printf("pthread_create() failed: %s\n", strerror(result));
+		free(info);
+		return -1;
+	}
+
+	// NOTE(doyle): Threads are never joined
+	pthread_detach(thread);
+	return 0;
+}
+
+i32 platform_semaphoreInit(PlatformSemaphore *semaphore, i32 initialCount,
+                           i32 maxCount)
+{
+	// NOTE(doyle): POSIX semaphores have no maximum count
+	sem_t *handle = CAST(sem_t *) malloc(sizeof(sem_t));
+	if (!handle || sem_init(handle, 0, initialCount) == -1)
+	{
+		printf("sem_init() failed: %s\n", strerror(errno));
+		free(handle);
+		return -1;
+	}
+
+	semaphore->handle = handle;
+	return 0;
+}
+
+void platform_semaphoreWait(PlatformSemaphore *semaphore)
+{
+	sem_t *handle = CAST(sem_t *) semaphore->handle;
+	while (sem_wait(handle) == -1 && errno == EINTR)
+		;
+}
+
+void platform_semaphoreRelease(PlatformSemaphore *semaphore, i32 count)
+{
+	sem_t *handle = CAST(sem_t *) semaphore->handle;
+	for (i32 i = 0; i < count; i++) sem_post(handle);
+}
+
+i32 platform_atomicCompareSwap(volatile i32 *dest, i32 swapValue,
+                               i32 compareValue)
+{
+	i32 result = __sync_val_compare_and_swap(dest, compareValue, swapValue);
+	return result;
+}
+
+i32 platform_atomicAdd(volatile i32 *dest, i32 value)
+{
+	i32 result = __sync_fetch_and_add(dest, value);
+	return result;
+}
+
+#endif
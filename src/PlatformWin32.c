@@ -0,0 +1,482 @@
+#ifdef _WIN32
+#include <Windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Dengine/Platform.h"
+#include "Dengine/Debug.h"
+#include "Dengine/MemoryArena.h"
+
+// TODO(doyle): If we use arena temporary memory this is not necessary
+void platform_closeFileRead(MemoryArena_ *arena, PlatformFileRead *file)
+{
+	// TODO(doyle): Mem free
+	// PLATFORM_MEM_FREE(arena, file->buffer, file->size);
+}
+
+i32 platform_readFileToBuffer(MemoryArena_ *arena, const char *const filePath,
+                              PlatformFileRead *file)
+{
+	HANDLE fileHandle = CreateFile(filePath, GENERIC_READ, FILE_SHARE_READ,
+	                               NULL, OPEN_EXISTING, 0, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		printf("CreateFile() failed: INVALID_HANDLE_VALUE\n");
+		return -1;
+	}
+
+	LARGE_INTEGER fileSize;
+	BOOL status = GetFileSizeEx(fileHandle, &fileSize);
+	if (!status)
+	{
+
+		printf("GetFileSizeEx() failed: %d error number\n",
+		       status);
+		CloseHandle(fileHandle);
+		return -1;
+	}
+
+	// TODO(doyle): Warning we assume files less than 4GB
+	file->buffer = memory_pushBytes(arena, fileSize.LowPart * sizeof(char));
+	file->size   = fileSize.LowPart;
+
+	DWORD numBytesRead = 0;
+
+	status =
+	    ReadFile(fileHandle, file->buffer, file->size, &numBytesRead, NULL);
+	CloseHandle(fileHandle);
+	if (!status)
+	{
+		printf("ReadFile() failed: %d error number\n",
+		       status);
+
+		char msgBuffer[512] = {0};
+		DWORD dw = GetLastError();
+
+		FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER |
+		                  FORMAT_MESSAGE_FROM_SYSTEM |
+		                  FORMAT_MESSAGE_IGNORE_INSERTS,
+		              NULL, dw, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+		              (LPTSTR)msgBuffer, 0, NULL);
+
+
+		// TODO(doyle): Mem free
+		// PLATFORM_MEM_FREE(arena, file->buffer, file->size);
+		return -1;
+	}
+	else if (numBytesRead != file->size)
+	{
+		printf(
+		    "ReadFile() failed: Number of bytes read doesn't match file "
+		    "size\n");
+		// TODO(doyle): Mem free
+		// PLATFORM_MEM_FREE(arena, file->buffer, file->size);
+		return -1;
+	}
+
+	return 0;
+}
+
+// TODO(doyle): Overlapped IO, batched reads are serial on Windows for now
+void platform_fileReaderInit(PlatformFileReader *reader)
+{
+	reader->handle = NULL;
+}
+
+i32 platform_readFileBatch(PlatformFileReader *reader, MemoryArena_ *arena,
+                           const char *const *filePaths,
+                           PlatformFileRead *files, i32 numFiles,
+                           PlatformReadCallback *callback, void *userData)
+{
+	i32 numFailed = 0;
+	for (i32 i = 0; i < numFiles; i++)
+	{
+		PlatformFileRead empty = {0};
+		files[i]               = empty;
+
+		i32 result = platform_readFileToBuffer(arena, filePaths[i], &files[i]);
+		if (result) numFailed++;
+
+		callback(userData, i, &files[i], result);
+	}
+
+	return numFailed;
+}
+
+i32 platform_writeBufferToFile(const char *const filePath,
+                               const void *const buffer, const i32 size)
+{
+	HANDLE fileHandle = CreateFile(filePath, GENERIC_WRITE, 0, NULL,
+	                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		printf("CreateFile() failed: INVALID_HANDLE_VALUE\n");
+		return -1;
+	}
+
+	DWORD numBytesWritten = 0;
+	BOOL status =
+	    WriteFile(fileHandle, buffer, size, &numBytesWritten, NULL);
+	CloseHandle(fileHandle);
+
+	if (!status || numBytesWritten != CAST(DWORD) size)
+	{
+		printf("WriteFile() failed: %d bytes of %d written\n",
+		       numBytesWritten, size);
+		return -1;
+	}
+
+	return 0;
+}
+
+i32 platform_fileWriteOpen(PlatformFileWrite *file,
+                           const char *const filePath)
+{
+	HANDLE fileHandle = CreateFile(filePath, GENERIC_WRITE, FILE_SHARE_READ,
+	                               NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+	                               NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		printf("CreateFile() failed: %d error number\n", GetLastError());
+		return -1;
+	}
+
+	file->handle = fileHandle;
+	file->isOpen = TRUE;
+	return 0;
+}
+
+INTERNAL i32 fileWriteAll(HANDLE fileHandle, const void *const buffer,
+                          const i32 size)
+{
+	DWORD numBytesWritten = 0;
+	BOOL status =
+	    WriteFile(fileHandle, buffer, size, &numBytesWritten, NULL);
+	if (!status || numBytesWritten != CAST(DWORD) size)
+	{
+		printf("WriteFile() failed: %d bytes of %d written\n",
+		       numBytesWritten, size);
+		return -1;
+	}
+
+	return 0;
+}
+
+i32 platform_fileWrite(PlatformFileWrite *file, const void *const buffer,
+                       const i32 size)
+{
+	if (!file->isOpen) return -1;
+
+	// NOTE(doyle): Writes at an offset move the file pointer, append from
+	// the end explicitly
+	LARGE_INTEGER zero = {0};
+	SetFilePointerEx(file->handle, zero, NULL, FILE_END);
+
+	i32 result = fileWriteAll(file->handle, buffer, size);
+	return result;
+}
+
+i32 platform_fileWriteAt(PlatformFileWrite *file, const i32 offset,
+                         const void *const buffer, const i32 size)
+{
+	if (!file->isOpen) return -1;
+
+	LARGE_INTEGER position = {0};
+	position.QuadPart      = offset;
+	SetFilePointerEx(file->handle, position, NULL, FILE_BEGIN);
+
+	i32 result = fileWriteAll(file->handle, buffer, size);
+	return result;
+}
+
+void platform_fileWriteClose(PlatformFileWrite *file)
+{
+	if (file->isOpen) CloseHandle(file->handle);
+
+	PlatformFileWrite empty = {0};
+	*file                   = empty;
+}
+
+i32 platform_mapFile(const char *const filePath, PlatformFileMap *map)
+{
+	HANDLE fileHandle = CreateFile(filePath, GENERIC_READ, FILE_SHARE_READ,
+	                               NULL, OPEN_EXISTING, 0, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) return -1;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return -1;
+	}
+
+	HANDLE mapHandle =
+	    CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapHandle)
+	{
+		printf("CreateFileMapping() failed: %d error number\n",
+		       GetLastError());
+		CloseHandle(fileHandle);
+		return -1;
+	}
+
+	void *base = MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+	if (!base)
+	{
+		printf("MapViewOfFile() failed: %d error number\n", GetLastError());
+		CloseHandle(mapHandle);
+		CloseHandle(fileHandle);
+		return -1;
+	}
+
+	// TODO(doyle): Warning we assume files less than 4GB
+	map->base       = base;
+	map->size       = fileSize.LowPart;
+	map->fileHandle = fileHandle;
+	map->mapHandle  = mapHandle;
+	return 0;
+}
+
+void platform_unmapFile(PlatformFileMap *map)
+{
+	if (map->base) UnmapViewOfFile(map->base);
+	if (map->mapHandle) CloseHandle(map->mapHandle);
+	if (map->fileHandle) CloseHandle(map->fileHandle);
+
+	PlatformFileMap empty = {0};
+	*map                  = empty;
+}
+
+f64 platform_getTimeInSeconds()
+{
+	LOCAL_PERSIST f64 secondsPerCount = 0;
+	if (secondsPerCount == 0)
+	{
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		secondsPerCount = 1.0 / CAST(f64) frequency.QuadPart;
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	f64 result = CAST(f64) counter.QuadPart * secondsPerCount;
+	return result;
+}
+
+void platform_sleep(f64 seconds)
+{
+	if (seconds <= 0) return;
+
+	// NOTE(doyle): The scheduler ticks every 15.6ms by default, ask for 1ms
+	// once for the life of the process
+	LOCAL_PERSIST b32 timerPeriodSet = FALSE;
+	if (!timerPeriodSet)
+	{
+		timeBeginPeriod(1);
+		timerPeriodSet = TRUE;
+	}
+
+	DWORD milliseconds = CAST(DWORD)(seconds * 1000.0);
+	Sleep(milliseconds);
+}
+
+/*
+   NOTE(doyle): One recursive ReadDirectoryChangesW on the root is kept in
+   flight, polling checks the overlapped result without waiting.
+ */
+typedef struct FileWatchWin32
+{
+	HANDLE directory;
+	OVERLAPPED overlapped;
+	char root[256];
+
+	// NOTE(doyle): FILE_NOTIFY_INFORMATION must be DWORD aligned
+	DWORD buffer[4096];
+} FileWatchWin32;
+
+INTERNAL b32 fileWatchIssueRead(FileWatchWin32 *const watch)
+{
+	DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+	BOOL result  = ReadDirectoryChangesW(watch->directory, watch->buffer,
+	                                    sizeof(watch->buffer), TRUE, filter,
+	                                    NULL, &watch->overlapped, NULL);
+	if (!result)
+	{
+		printf("ReadDirectoryChangesW() failed: %d error number\n",
+		       GetLastError());
+	}
+
+	return result;
+}
+
+i32 platform_fileWatchInit(PlatformFileWatch *watch,
+                           const char *const directory)
+{
+	FileWatchWin32 *winWatch =
+	    CAST(FileWatchWin32 *) calloc(1, sizeof(FileWatchWin32));
+	if (!winWatch) return -1;
+
+	winWatch->directory = CreateFile(
+	    directory, FILE_LIST_DIRECTORY,
+	    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+	    OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+	if (winWatch->directory == INVALID_HANDLE_VALUE)
+	{
+		printf("CreateFile() failed: %d error number\n", GetLastError());
+		free(winWatch);
+		return -1;
+	}
+
+	winWatch->overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	snprintf(winWatch->root, ARRAY_COUNT(winWatch->root), "%s", directory);
+	if (!winWatch->overlapped.hEvent || !fileWatchIssueRead(winWatch))
+	{
+		if (winWatch->overlapped.hEvent)
+			CloseHandle(winWatch->overlapped.hEvent);
+		CloseHandle(winWatch->directory);
+		free(winWatch);
+		return -1;
+	}
+
+	watch->handle = winWatch;
+	return 0;
+}
+
+void platform_fileWatchPoll(PlatformFileWatch *watch,
+                            PlatformFileChangedCallback *callback,
+                            void *userData)
+{
+	FileWatchWin32 *winWatch = CAST(FileWatchWin32 *) watch->handle;
+	if (!winWatch) return;
+
+	DWORD bytesRead = 0;
+	if (!GetOverlappedResult(winWatch->directory, &winWatch->overlapped,
+	                         &bytesRead, FALSE))
+	{
+		// NOTE(doyle): ERROR_IO_INCOMPLETE, nothing has changed yet
+		return;
+	}
+
+	// NOTE(doyle): Zero bytes means the buffer overflowed and events were lost
+	if (bytesRead == 0)
+		DEBUG_LOG("platform_fileWatchPoll() warning: Events dropped");
+
+	u8 *ptr = CAST(u8 *) winWatch->buffer;
+	while (bytesRead > 0)
+	{
+		FILE_NOTIFY_INFORMATION *info = CAST(FILE_NOTIFY_INFORMATION *) ptr;
+		if (info->Action == FILE_ACTION_ADDED ||
+		    info->Action == FILE_ACTION_MODIFIED ||
+		    info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+		{
+			char name[256] = {0};
+			i32 nameLen    = WideCharToMultiByte(
+			    CP_UTF8, 0, info->FileName,
+			    info->FileNameLength / sizeof(WCHAR), name,
+			    ARRAY_COUNT(name) - 1, NULL, NULL);
+
+			for (i32 i = 0; i < nameLen; i++)
+			{
+				if (name[i] == '\\') name[i] = '/';
+			}
+
+			char path[512];
+			snprintf(path, ARRAY_COUNT(path), "%s/%s", winWatch->root, name);
+			callback(userData, path);
+		}
+
+		if (info->NextEntryOffset == 0) break;
+		ptr += info->NextEntryOffset;
+	}
+
+	ResetEvent(winWatch->overlapped.hEvent);
+	fileWatchIssueRead(winWatch);
+}
+
+void platform_fileWatchClose(PlatformFileWatch *watch)
+{
+	FileWatchWin32 *winWatch = CAST(FileWatchWin32 *) watch->handle;
+	if (!winWatch) return;
+
+	CancelIo(winWatch->directory);
+	CloseHandle(winWatch->overlapped.hEvent);
+	CloseHandle(winWatch->directory);
+	free(winWatch);
+	watch->handle = NULL;
+}
+
+typedef struct ThreadStartInfo
+{
+	PlatformThreadProc *proc;
+	void *userData;
+} ThreadStartInfo;
+
+INTERNAL DWORD WINAPI threadStart(LPVOID param)
+{
+	ThreadStartInfo info = *(CAST(ThreadStartInfo *) param);
+	free(param);
+
+	info.proc(info.userData);
+	return 0;
+}
+
+i32 platform_threadCreate(PlatformThreadProc *proc, void *userData)
+{
+	ThreadStartInfo *info = CAST(ThreadStartInfo *) malloc(sizeof(*info));
+	if (!info) return -1;
+
+	info->proc     = proc;
+	info->userData = userData;
+
+	HANDLE thread = CreateThread(NULL, 0, threadStart, info, 0, NULL);
+	if (!thread)
+	{
+		printf("CreateThread() failed: %d error number\n", GetLastError());
+		free(info);
+		return -1;
+	}
+
+	// NOTE(doyle): Threads are never joined, the handle is not needed
+	CloseHandle(thread);
+	return 0;
+}
+
+i32 platform_semaphoreInit(PlatformSemaphore *semaphore, i32 initialCount,
+                           i32 maxCount)
+{
+	semaphore->handle = CreateSemaphore(NULL, initialCount, maxCount, NULL);
+	if (!semaphore->handle)
+	{
+		printf("CreateSemaphore() failed: %d error number\n", GetLastError());
+		return -1;
+	}
+
+	return 0;
+}
+
+void platform_semaphoreWait(PlatformSemaphore *semaphore)
+{
+	WaitForSingleObject(semaphore->handle, INFINITE);
+}
+
+void platform_semaphoreRelease(PlatformSemaphore *semaphore, i32 count)
+{
+	ReleaseSemaphore(semaphore->handle, count, NULL);
+}
+
+i32 platform_atomicCompareSwap(volatile i32 *dest, i32 swapValue,
+                               i32 compareValue)
+{
+	i32 result = InterlockedCompareExchange(CAST(volatile LONG *) dest,
+	                                        swapValue, compareValue);
+	return result;
+}
+
+i32 platform_atomicAdd(volatile i32 *dest, i32 value)
+{
+	i32 result = InterlockedExchangeAdd(CAST(volatile LONG *) dest, value);
+	return result;
+}
+
+#endif
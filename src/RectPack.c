@@ -0,0 +1,295 @@
+#include "Dengine/RectPack.h"
+#include "Dengine/MemoryArena.h"
+
+void rectpack_init(RectPack *const pack, MemoryArena_ *const arena,
+                   const i32 width, const i32 height)
+{
+	// NOTE(doyle): Each segment is at least 1 pixel wide so the skyline can
+	// never have more segments than the pack is wide
+	pack->maxNodes   = width;
+	pack->nodes      = MEMORY_PUSH_ARRAY(arena, pack->maxNodes, RectPackNode);
+	pack->numNodes   = 1;
+	pack->width      = width;
+	pack->height     = height;
+	pack->usedHeight = 0;
+
+	pack->nodes[0] = CAST(RectPackNode){0, 0, width};
+}
+
+/* Returns the y the rect rests at if placed at the node's x, or -1 */
+INTERNAL i32 skylineFit(RectPack *const pack, const i32 nodeIndex,
+                        const i32 width, const i32 height)
+{
+	i32 x = pack->nodes[nodeIndex].x;
+	if (x + width > pack->width) return -1;
+
+	i32 result         = 0;
+	i32 widthRemaining = width;
+	for (i32 i = nodeIndex; widthRemaining > 0; i++)
+	{
+		if (i >= pack->numNodes) return -1;
+
+		RectPackNode *node = &pack->nodes[i];
+		if (node->y > result) result = node->y;
+		if (result + height > pack->height) return -1;
+
+		widthRemaining -= node->width;
+	}
+
+	return result;
+}
+
+INTERNAL void removeNode(RectPack *const pack, const i32 index)
+{
+	for (i32 i = index; i < pack->numNodes - 1; i++)
+		pack->nodes[i] = pack->nodes[i + 1];
+
+	pack->numNodes--;
+}
+
+b32 rectpack_insert(RectPack *const pack, const i32 width, const i32 height,
+                    v2 *const pos)
+{
+	if (width <= 0 || height <= 0) return FALSE;
+	if (pack->numNodes >= pack->maxNodes) return FALSE;
+
+	/* Find the segment that places the rect lowest, ties go to narrowest */
+	i32 bestIndex = -1;
+	i32 bestY     = pack->height;
+	i32 bestWidth = pack->width + 1;
+	for (i32 i = 0; i < pack->numNodes; i++)
+	{
+		i32 y = skylineFit(pack, i, width, height);
+		if (y == -1) continue;
+
+		if (y < bestY || (y == bestY && pack->nodes[i].width < bestWidth))
+		{
+			bestIndex = i;
+			bestY     = y;
+			bestWidth = pack->nodes[i].width;
+		}
+	}
+
+	if (bestIndex == -1) return FALSE;
+
+	/* Raise the skyline over the new rect */
+	RectPackNode newNode = {pack->nodes[bestIndex].x, bestY + height, width};
+	for (i32 i = pack->numNodes; i > bestIndex; i--)
+		pack->nodes[i] = pack->nodes[i - 1];
+	pack->nodes[bestIndex] = newNode;
+	pack->numNodes++;
+
+	/* Trim segments now covered by the new one */
+	for (i32 i = bestIndex + 1; i < pack->numNodes;)
+	{
+		RectPackNode *prev = &pack->nodes[i - 1];
+		RectPackNode *node = &pack->nodes[i];
+
+		i32 prevRight = prev->x + prev->width;
+		if (node->x >= prevRight) break;
+
+		i32 shrink = prevRight - node->x;
+		node->x += shrink;
+		node->width -= shrink;
+
+		if (node->width > 0) break;
+		removeNode(pack, i);
+	}
+
+	/* Merge neighbouring segments at the same height */
+	for (i32 i = 0; i < pack->numNodes - 1;)
+	{
+		if (pack->nodes[i].y == pack->nodes[i + 1].y)
+		{
+			pack->nodes[i].width += pack->nodes[i + 1].width;
+			removeNode(pack, i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	if (newNode.y > pack->usedHeight) pack->usedHeight = newNode.y;
+
+	*pos = V2i(newNode.x, bestY);
+	return TRUE;
+}
+
+/*
+ *********************************
+ * MaxRects
+ *********************************
+ */
+void rectpack_maxInit(RectPackMax *const pack, MemoryArena_ *const arena,
+                      const i32 width, const i32 height,
+                      const i32 maxFreeRects)
+{
+	pack->maxFreeRects = maxFreeRects;
+	pack->freeRects =
+	    MEMORY_PUSH_ARRAY(arena, pack->maxFreeRects, RectPackFree);
+	pack->numFreeRects = 1;
+	pack->width        = width;
+	pack->height       = height;
+	pack->usedArea     = 0;
+
+	pack->freeRects[0] = CAST(RectPackFree){0, 0, width, height};
+}
+
+INTERNAL b32 freeRectContains(const RectPackFree a, const RectPackFree b)
+{
+	b32 result = (b.x >= a.x && b.y >= a.y &&
+	              b.x + b.width <= a.x + a.width &&
+	              b.y + b.height <= a.y + a.height);
+	return result;
+}
+
+INTERNAL b32 freeRectOverlaps(const RectPackFree rect, const RectPackFree used)
+{
+	b32 result = (used.x < rect.x + rect.width &&
+	              rect.x < used.x + used.width &&
+	              used.y < rect.y + rect.height &&
+	              rect.y < used.y + used.height);
+	return result;
+}
+
+/* Returns the number of rects left of rect around the used rect, up to 4 */
+INTERNAL i32 freeRectSplit(const RectPackFree rect, const RectPackFree used,
+                           RectPackFree *const split)
+{
+	i32 result = 0;
+	if (used.x > rect.x)
+	{
+		split[result++] =
+		    CAST(RectPackFree){rect.x, rect.y, used.x - rect.x, rect.height};
+	}
+	if (used.x + used.width < rect.x + rect.width)
+	{
+		i32 x = used.x + used.width;
+		split[result++] = CAST(RectPackFree){
+		    x, rect.y, (rect.x + rect.width) - x, rect.height};
+	}
+	if (used.y > rect.y)
+	{
+		split[result++] =
+		    CAST(RectPackFree){rect.x, rect.y, rect.width, used.y - rect.y};
+	}
+	if (used.y + used.height < rect.y + rect.height)
+	{
+		i32 y = used.y + used.height;
+		split[result++] = CAST(RectPackFree){
+		    rect.x, y, rect.width, (rect.y + rect.height) - y};
+	}
+
+	return result;
+}
+
+/* Replace the free rects the used rect overlaps with what remains of them */
+INTERNAL b32 splitFreeRects(RectPackMax *const pack, const RectPackFree used)
+{
+	// NOTE(doyle): Check the list can take the split before touching it, a
+	// half split list would hand out space that is already used. Rects are
+	// removed and appended one at a time so count the worst case order.
+	i32 peakFreeRects = pack->numFreeRects;
+	for (i32 i = 0; i < pack->numFreeRects; i++)
+	{
+		RectPackFree rect = pack->freeRects[i];
+		if (!freeRectOverlaps(rect, used)) continue;
+
+		RectPackFree split[4];
+		i32 numSplit = freeRectSplit(rect, used, split);
+		if (numSplit > 1) peakFreeRects += numSplit - 1;
+	}
+
+	if (peakFreeRects > pack->maxFreeRects) return FALSE;
+
+	// NOTE(doyle): Rects appended by the split are after numToCheck and never
+	// overlap the used rect, so they are not revisited
+	i32 numToCheck = pack->numFreeRects;
+	for (i32 i = 0; i < numToCheck;)
+	{
+		RectPackFree rect = pack->freeRects[i];
+		if (!freeRectOverlaps(rect, used))
+		{
+			i++;
+			continue;
+		}
+
+		RectPackFree split[4];
+		i32 numSplit = freeRectSplit(rect, used, split);
+
+		/* Swap the last unchecked rect in, then the last rect overall */
+		numToCheck--;
+		pack->freeRects[i]          = pack->freeRects[numToCheck];
+		pack->freeRects[numToCheck] = pack->freeRects[--pack->numFreeRects];
+
+		for (i32 j = 0; j < numSplit; j++)
+			pack->freeRects[pack->numFreeRects++] = split[j];
+	}
+
+	return TRUE;
+}
+
+/* Drop free rects wholly inside another, they can never be a better fit */
+INTERNAL void pruneFreeRects(RectPackMax *const pack)
+{
+	for (i32 i = 0; i < pack->numFreeRects; i++)
+	{
+		for (i32 j = i + 1; j < pack->numFreeRects;)
+		{
+			if (freeRectContains(pack->freeRects[i], pack->freeRects[j]))
+			{
+				pack->freeRects[j] = pack->freeRects[--pack->numFreeRects];
+			}
+			else if (freeRectContains(pack->freeRects[j],
+			                          pack->freeRects[i]))
+			{
+				pack->freeRects[i] = pack->freeRects[--pack->numFreeRects];
+				j                  = i + 1;
+			}
+			else
+			{
+				j++;
+			}
+		}
+	}
+}
+
+b32 rectpack_maxInsert(RectPackMax *const pack, const i32 width,
+                       const i32 height, v2 *const pos)
+{
+	if (width <= 0 || height <= 0) return FALSE;
+
+	/* Best short side fit, ties broken on the long side */
+	i32 bestIndex     = -1;
+	i32 bestShortSide = 0;
+	i32 bestLongSide  = 0;
+	for (i32 i = 0; i < pack->numFreeRects; i++)
+	{
+		RectPackFree *rect = &pack->freeRects[i];
+		if (rect->width < width || rect->height < height) continue;
+
+		i32 leftoverX = rect->width - width;
+		i32 leftoverY = rect->height - height;
+		i32 shortSide = MIN(leftoverX, leftoverY);
+		i32 longSide  = MAX(leftoverX, leftoverY);
+		if (bestIndex == -1 || shortSide < bestShortSide ||
+		    (shortSide == bestShortSide && longSide < bestLongSide))
+		{
+			bestIndex     = i;
+			bestShortSide = shortSide;
+			bestLongSide  = longSide;
+		}
+	}
+
+	if (bestIndex == -1) return FALSE;
+
+	RectPackFree *best = &pack->freeRects[bestIndex];
+	RectPackFree used  = {best->x, best->y, width, height};
+	if (!splitFreeRects(pack, used)) return FALSE;
+	pruneFreeRects(pack);
+
+	pack->usedArea += width * height;
+	*pos = V2i(used.x, used.y);
+	return TRUE;
+}
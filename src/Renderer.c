@@ -58,11 +58,24 @@ void renderer_updateSize(Renderer *renderer, AssetManager *assetManager, v2 wind
 
 	renderer->activeShaderId = renderer->shaderList[shaderlist_default];
 	GL_CHECK_ERROR();
+
+	// NOTE(doyle): Recorded UI was laid out for the old size, and this is also
+	// called after hot reloads which can rebuild fonts in place
+	RenderGeometryCache *cache = &renderer->geometryCache;
+	for (i32 i = 0; i < ARRAY_COUNT(cache->entries); i++)
+		cache->entries[i].valid = FALSE;
+	cache->numRuns     = 0;
+	cache->numVertexes = 0;
+
+	RenderTextCache *textCache = &renderer->textCache;
+	for (i32 i = 0; i < ARRAY_COUNT(textCache->layouts); i++)
+		textCache->layouts[i].valid = FALSE;
 }
 
 void renderer_init(Renderer *renderer, AssetManager *assetManager,
                    MemoryArena_ *persistentArena, v2 windowSize)
 {
+	renderer->assetManager   = assetManager;
 	renderer->referenceScale = V2(1280, 720);
 	renderer_updateSize(renderer, assetManager, windowSize);
 
@@ -98,6 +111,21 @@ void renderer_init(Renderer *renderer, AssetManager *assetManager,
 		renderer->groups[i].vertexList = memory_pushBytes(
 		    persistentArena, renderer->groupCapacity * sizeof(RenderVertex));
 	}
+
+	RenderGeometryCache *cache = &renderer->geometryCache;
+	cache->runs     = MEMORY_PUSH_ARRAY(persistentArena,
+	                                    RENDER_GEOMETRY_MAX_RUNS,
+	                                    RenderGeometryRun);
+	cache->vertexes = MEMORY_PUSH_ARRAY(persistentArena,
+	                                    RENDER_GEOMETRY_MAX_VERTEXES,
+	                                    RenderVertex);
+
+	RenderTextCache *textCache = &renderer->textCache;
+	for (i32 i = 0; i < ARRAY_COUNT(textCache->layouts); i++)
+	{
+		textCache->layouts[i].vertexes = MEMORY_PUSH_ARRAY(
+		    persistentArena, RENDER_TEXT_MAX_VERTEXES, RenderVertex);
+	}
 }
 
 
@@ -177,6 +205,74 @@ INTERNAL void applyRotationToVertexes(v2 pos, v2 pivotPoint, Radians rotate,
 	}
 }
 
+/*
+ *********************************
+ * Geometry Cache
+ *********************************
+ */
+/* Append a batch to the geometry being recorded, joining it to the last run
+ * if that run has the same group state */
+INTERNAL void geometryRecord(RenderGeometryCache *const cache, Texture *tex,
+                             v4 color, i32 zDepth,
+                             const RenderVertex *const vertexList,
+                             i32 numVertexes, enum RenderMode mode,
+                             RenderFlags flags)
+{
+	RenderGeometryEntry *entry = cache->recording;
+	if (!entry->valid) return;
+
+	RenderGeometryRun *run = NULL;
+	if (entry->numRuns > 0 && mode == rendermode_quad)
+	{
+		run = &cache->runs[cache->numRuns - 1];
+		if (run->mode != mode || run->tex != tex ||
+		    !v4_equals(run->color, color) || run->flags != flags ||
+		    run->zDepth != zDepth)
+		{
+			run = NULL;
+		}
+	}
+
+	// NOTE(doyle): A joined batch keeps the degenerate vertexes that would
+	// have ended the last batch and started this one
+	i32 numDegenerateVertexes = (run) ? 2 : 0;
+	if (cache->numVertexes + numDegenerateVertexes + numVertexes >
+	        RENDER_GEOMETRY_MAX_VERTEXES ||
+	    (!run && cache->numRuns >= RENDER_GEOMETRY_MAX_RUNS))
+	{
+		entry->valid = FALSE;
+		return;
+	}
+
+	if (run)
+	{
+		cache->vertexes[cache->numVertexes] =
+		    cache->vertexes[cache->numVertexes - 1];
+		cache->vertexes[cache->numVertexes + 1] = vertexList[0];
+		cache->numVertexes += numDegenerateVertexes;
+		run->numVertexes   += numDegenerateVertexes;
+	}
+	else
+	{
+		run              = &cache->runs[cache->numRuns++];
+		run->tex         = tex;
+		run->color       = color;
+		run->zDepth      = zDepth;
+		run->mode        = mode;
+		run->flags       = flags;
+		run->firstVertex = cache->numVertexes;
+		run->numVertexes = 0;
+		entry->numRuns++;
+	}
+
+	for (i32 i = 0; i < numVertexes; i++)
+		cache->vertexes[cache->numVertexes++] = vertexList[i];
+
+	run->numVertexes              += numVertexes;
+	entry->numVertexes            += numVertexes;
+	cache->numVertexesRegenerated += numVertexes;
+}
+
 INTERNAL void addVertexToRenderGroup_(Renderer *renderer, Texture *tex,
                                       v4 color, i32 zDepth,
                                       RenderVertex *vertexList, i32 numVertexes,
@@ -186,6 +282,14 @@ INTERNAL void addVertexToRenderGroup_(Renderer *renderer, Texture *tex,
 	ASSERT(renderer->vertexBatchState != vertexbatchstate_off);
 	ASSERT(numVertexes > 0);
 
+	// NOTE(doyle): Recorded before triangles are rewound, a replay rewinds
+	// them for the group they land in then
+	if (renderer->geometryCache.recording)
+	{
+		geometryRecord(&renderer->geometryCache, tex, color, zDepth,
+		               vertexList, numVertexes, targetRenderMode, flags);
+	}
+
 #ifdef DENGINE_DEBUG
 	for (i32 i = 0; i < numVertexes; i++)
 		debug_countIncrement(debugcount_numVertex);
@@ -208,9 +312,10 @@ INTERNAL void addVertexToRenderGroup_(Renderer *renderer, Texture *tex,
 			if (!(group->zDepth == zDepth)) continue;
 			if (!tex && group->tex) continue;
 
+			// NOTE(doyle): Evicted textures all have id 0, compare the textures
 			if (tex && group->tex)
 			{
-				if (!(group->tex->id == tex->id)) continue;
+				if (!(group->tex == tex)) continue;
 			}
 
 			groupIsValid = TRUE;
@@ -426,13 +531,223 @@ INTERNAL void renderGLBufferedData(Renderer *renderer, RenderGroup *group)
 {
 }
 
+b32 renderer_geometryBegin(Renderer *const renderer, const u32 key,
+                           const u64 contentHash)
+{
+	RenderGeometryCache *cache = &renderer->geometryCache;
+	ASSERT(!cache->recording);
+
+	RenderGeometryEntry *entry  = NULL;
+	RenderGeometryEntry *oldest = &cache->entries[0];
+	for (i32 i = 0; i < ARRAY_COUNT(cache->entries); i++)
+	{
+		RenderGeometryEntry *check = &cache->entries[i];
+		if (check->key == key)
+		{
+			entry = check;
+			break;
+		}
+
+		if (!check->valid ||
+		    (oldest->valid && check->frameLastUsed < oldest->frameLastUsed))
+		{
+			oldest = check;
+		}
+	}
+
+	if (entry && entry->valid && entry->contentHash == contentHash)
+	{
+		entry->frameLastUsed = cache->frame;
+		for (i32 i = 0; i < entry->numRuns; i++)
+		{
+			RenderGeometryRun *run   = &cache->runs[entry->firstRun + i];
+			RenderVertex *vertexList = &cache->vertexes[run->firstVertex];
+
+			// NOTE(doyle): Triangles are rewound in place, keep the recording
+			RenderVertex triangle[3];
+			if (run->numVertexes == 3)
+			{
+				common_memcpy(CAST(u8 *) triangle, CAST(u8 *) vertexList,
+				              sizeof(triangle));
+				vertexList = triangle;
+			}
+
+			beginVertexBatch(renderer);
+			addVertexToRenderGroup_(renderer, run->tex, run->color,
+			                        run->zDepth, vertexList, run->numVertexes,
+			                        run->mode, run->flags);
+			endVertexBatch(renderer);
+		}
+
+		cache->numVertexesReused += entry->numVertexes;
+		return TRUE;
+	}
+
+	// NOTE(doyle): Space of replaced recordings is only reclaimed by starting
+	// over, the other entries record again the next time they are drawn
+	if (cache->numVertexes > (RENDER_GEOMETRY_MAX_VERTEXES * 3) / 4 ||
+	    cache->numRuns > (RENDER_GEOMETRY_MAX_RUNS * 3) / 4)
+	{
+		for (i32 i = 0; i < ARRAY_COUNT(cache->entries); i++)
+			cache->entries[i].valid = FALSE;
+		cache->numRuns     = 0;
+		cache->numVertexes = 0;
+	}
+
+	if (!entry) entry = oldest;
+	entry->key           = key;
+	entry->contentHash   = contentHash;
+	entry->valid         = TRUE;
+	entry->frameLastUsed = cache->frame;
+	entry->firstRun      = cache->numRuns;
+	entry->numRuns       = 0;
+	entry->numVertexes   = 0;
+
+	cache->recording = entry;
+	return FALSE;
+}
+
+void renderer_geometryEnd(Renderer *const renderer)
+{
+	renderer->geometryCache.recording = NULL;
+}
+
+/*
+ *********************************
+ * Text Layout Cache
+ *********************************
+ */
+/* Lay out the string from the pen origin, unrotated, into the layout */
+INTERNAL void textLayoutBuild(Renderer *const renderer,
+                              RenderTextLayout *const layout,
+                              const Font *const font, const char *const string,
+                              const i32 strLen)
+{
+	layout->dim         = V2(0, 0);
+	layout->numVertexes = 0;
+
+	Texture *tex = font->atlas->tex;
+	v2 pos       = V2(0, 0);
+	f32 baseline = pos.y - font->verticalSpacing + 1;
+	for (i32 i = 0; i < strLen; i++)
+	{
+		const CharMetrics *metric = asset_fontGetCharMetrics(font, string[i]);
+		if (!metric) continue;
+
+		layout->dim.y = MAX(metric->trueSize.y, layout->dim.y);
+
+		v2 quadP = V2(pos.x + metric->quadOffset.x,
+		              baseline + metric->quadOffset.y);
+
+		v4 charTexRect      = {0};
+		charTexRect.vec2[0] = metric->texRect.min;
+		charTexRect.vec2[1] = v2_add(metric->texRect.min, metric->texRect.max);
+		flipTexCoord(&charTexRect, FALSE, TRUE);
+
+		RenderTex renderTex = {tex, charTexRect};
+		RenderQuad quad = createRenderQuad(renderer, quadP, metric->quadSize,
+		                                   V2(0, 0), 0, renderTex);
+
+		// NOTE(doyle): The vertexes that would end the last glyph's batch and
+		// start this one
+		RenderVertex *vertexes = layout->vertexes;
+		if (layout->numVertexes > 0)
+		{
+			vertexes[layout->numVertexes] = vertexes[layout->numVertexes - 1];
+			vertexes[layout->numVertexes + 1] = quad.vertexList[0];
+			layout->numVertexes += 2;
+		}
+
+		for (i32 j = 0; j < ARRAY_COUNT(quad.vertexList); j++)
+			vertexes[layout->numVertexes++] = quad.vertexList[j];
+
+		i32 nextCodepoint = (i + 1 < strLen) ? string[i + 1] : 0;
+		pos.x += asset_fontPenAdvance(font, metric, nextCodepoint);
+	}
+
+	layout->dim.x = pos.x;
+	ASSERT(layout->numVertexes <= RENDER_TEXT_MAX_VERTEXES);
+}
+
+/* Returns NULL if the string is too long to be cached */
+INTERNAL RenderTextLayout *textLayoutGet(Renderer *const renderer,
+                                         const Font *const font,
+                                         const char *const string,
+                                         const i32 strLen)
+{
+	if (strLen >= RENDER_TEXT_MAX_CHARS) return NULL;
+
+	RenderTextCache *cache = &renderer->textCache;
+	cache->numLookups++;
+
+	u64 hash = common_murmurHash64A(string, strLen, RANDOM_SEED);
+	RenderTextLayout *oldest = &cache->layouts[0];
+	for (i32 i = 0; i < ARRAY_COUNT(cache->layouts); i++)
+	{
+		RenderTextLayout *layout = &cache->layouts[i];
+		if (layout->valid && layout->hash == hash && layout->font == font &&
+		    layout->strLen == strLen &&
+		    layout->charMetrics == font->charMetrics &&
+		    common_strcmp(layout->string, string) == 0)
+		{
+			layout->lastUsed = ++cache->useCounter;
+			cache->numHits++;
+			return layout;
+		}
+
+		if (!layout->valid ||
+		    (oldest->valid && layout->lastUsed < oldest->lastUsed))
+		{
+			oldest = layout;
+		}
+	}
+
+	RenderTextLayout *result = oldest;
+	result->font        = font;
+	result->charMetrics = font->charMetrics;
+	result->hash        = hash;
+	result->strLen      = strLen;
+	result->valid       = TRUE;
+	result->lastUsed    = ++cache->useCounter;
+	common_memcpy(CAST(u8 *) result->string, CAST(const u8 *) string,
+	              strLen + 1);
+
+	textLayoutBuild(renderer, result, font, string, strLen);
+	return result;
+}
+
+v2 renderer_stringDim(Renderer *const renderer, Font *const font,
+                      const char *const string)
+{
+	i32 strLen               = common_strlen(string);
+	RenderTextLayout *layout = textLayoutGet(renderer, font, string, strLen);
+
+	v2 result;
+	if (layout) result = layout->dim;
+	else        result = asset_fontStringDimInPixels(font, string);
+
+	return result;
+}
+
 RenderTex renderer_createNullRenderTex(AssetManager *const assetManager)
 {
-	Texture *emptyTex = asset_texGet(assetManager, "nullTex");
+	Texture *emptyTex = asset_texGet(assetManager, texlist_null);
 	RenderTex result  = {emptyTex, V4(0, 1, 1, 0)};
 	return result;
 }
 
+RenderTex renderer_createRenderTex(AssetManager *const assetManager,
+                                   const enum TexList type)
+{
+	Texture *tex = asset_texGet(assetManager, type);
+	Rect region  = asset_texGetRegion(assetManager, type);
+	v2 topRight  = v2_add(region.min, region.max);
+
+	RenderTex result = {
+	    tex, V4(region.min.x, topRight.y, topRight.x, region.min.y)};
+	return result;
+}
+
 void renderer_rect(Renderer *const renderer, Rect camera, v2 pos, v2 size,
                    v2 pivotPoint, Radians rotate, RenderTex *renderTex,
                    v4 color, i32 zDepth, RenderFlags flags)
@@ -566,48 +881,72 @@ void renderer_string(Renderer *const renderer, MemoryArena_ *arena, Rect camera,
 	    v2_add(pos, V2((CAST(f32) font->maxSize.w * CAST(f32) strLen),
 	                   CAST(f32) font->maxSize.h));
 	v2 leftAlignedP = pos;
-	if (math_rectContainsP(camera, leftAlignedP) ||
-	    math_rectContainsP(camera, rightAlignedP))
+	if (!math_rectContainsP(camera, leftAlignedP) &&
+	    !math_rectContainsP(camera, rightAlignedP))
 	{
-		i32 vertexIndex        = 0;
-		i32 numVertexPerQuad   = 4;
-		i32 numVertexesToAlloc = (strLen * (numVertexPerQuad + 2));
-		RenderVertex *vertexList =
-		    memory_pushBytes(arena, numVertexesToAlloc * sizeof(RenderVertex));
+		return;
+	}
+
+	v2 posInCameraSpace = v2_sub(pos, camera.min);
+	pos = posInCameraSpace;
+
+	// NOTE(doyle): Glyphs rotate about their own position, so only unrotated
+	// layouts can be offset into place
+	RenderTextLayout *layout = NULL;
+	if (rotate == 0) layout = textLayoutGet(renderer, font, string, strLen);
+
+	if (layout)
+	{
+		if (layout->numVertexes == 0) return;
 
-		v2 posInCameraSpace = v2_sub(pos, camera.min);
-		pos = posInCameraSpace;
+		RenderVertex *vertexList =
+		    MEMORY_PUSH_ARRAY(arena, layout->numVertexes, RenderVertex);
+		for (i32 i = 0; i < layout->numVertexes; i++)
+		{
+			vertexList[i].pos      = v2_add(layout->vertexes[i].pos, pos);
+			vertexList[i].texCoord = layout->vertexes[i].texCoord;
+		}
 
+		Texture *tex = font->atlas->tex;
+		beginVertexBatch(renderer);
+		addVertexToRenderGroup_(renderer, tex, color, zDepth, vertexList,
+		                        layout->numVertexes, rendermode_quad,
+		                        flags | renderflag_sdf);
+		endVertexBatch(renderer);
+	}
+	else
+	{
 		// TODO(doyle): Find why font is 1px off, might be arial font semantics
 		Texture *tex = font->atlas->tex;
 		f32 baseline = pos.y - font->verticalSpacing + 1;
 		for (i32 i = 0; i < strLen; i++)
 		{
-			i32 codepoint     = string[i];
-			i32 relativeIndex = CAST(i32)(codepoint - font->codepointRange.x);
-			CharMetrics metric = font->charMetrics[relativeIndex];
-			pos.y              = baseline - (metric.offset.y);
+			i32 codepoint = string[i];
+			const CharMetrics *metric =
+			    asset_fontGetCharMetrics(font, codepoint);
+			if (!metric) continue;
 
-			/* Get texture out */
-			SubTexture subTexture =
-			    asset_atlasGetSubTex(font->atlas, &CAST(char)codepoint);
+			v2 quadP = V2(pos.x + metric->quadOffset.x,
+			              baseline + metric->quadOffset.y);
 
 			v4 charTexRect      = {0};
-			charTexRect.vec2[0] = subTexture.rect.min;
+			charTexRect.vec2[0] = metric->texRect.min;
 			charTexRect.vec2[1] =
-			    v2_add(subTexture.rect.min, subTexture.rect.max);
+			    v2_add(metric->texRect.min, metric->texRect.max);
 			flipTexCoord(&charTexRect, FALSE, TRUE);
 
 			RenderTex renderTex = {tex, charTexRect};
-			RenderQuad quad     = createRenderQuad(renderer, pos, font->maxSize,
+			RenderQuad quad = createRenderQuad(renderer, quadP, metric->quadSize,
 			                                   pivotPoint, rotate, renderTex);
 
 			beginVertexBatch(renderer);
 			addVertexToRenderGroup_(renderer, tex, color, zDepth, quad.vertexList,
 			                        ARRAY_COUNT(quad.vertexList),
-			                        rendermode_quad, flags);
+			                        rendermode_quad, flags | renderflag_sdf);
 			endVertexBatch(renderer);
-			pos.x += metric.advance;
+
+			i32 nextCodepoint = (i + 1 < strLen) ? string[i + 1] : 0;
+			pos.x += asset_fontPenAdvance(font, metric, nextCodepoint);
 		}
 	}
 }
@@ -626,8 +965,9 @@ void renderer_entity(Renderer *renderer, MemoryArena_ *transientArena,
 		if (entityAnim->anim)
 		{
 			Animation *anim   = entityAnim->anim;
-			char *frameName   = anim->frameList[entityAnim->currFrame];
-			SubTexture subTex = asset_atlasGetSubTex(anim->atlas, frameName);
+			i32 frameIndex    = anim->frameSubTexList[entityAnim->currFrame];
+			SubTexture subTex =
+			    asset_atlasGetSubTexFromIndex(anim->atlas, frameIndex);
 
 			texRect.vec2[0] = subTex.rect.min;
 			texRect.vec2[1] = v2_add(subTex.rect.min, subTex.rect.max);
@@ -743,12 +1083,15 @@ void renderer_renderGroups(Renderer *renderer)
 			}
 			else
 			{
-				renderer->activeShaderId =
-				    renderer->shaderList[shaderlist_default];
+				enum ShaderList shader = (group->flags & renderflag_sdf)
+				                             ? shaderlist_sdf
+				                             : shaderlist_default;
+				renderer->activeShaderId = renderer->shaderList[shader];
 				shaderUse(renderer->activeShaderId);
 				Texture *tex = group->tex;
 				if (tex)
 				{
+					asset_texUse(renderer->assetManager, tex);
 					glActiveTexture(GL_TEXTURE0);
 					glBindTexture(GL_TEXTURE_2D, tex->id);
 					shaderUniformSet1i(renderer->activeShaderId, "tex", 0);
@@ -781,4 +1124,18 @@ void renderer_renderGroups(Renderer *renderer)
 	}
 
 	renderer->groupsInUse = 0;
+
+	RenderGeometryCache *cache    = &renderer->geometryCache;
+	cache->numVertexesRegenerated = 0;
+	cache->numVertexesReused      = 0;
+	cache->frame++;
+
+	RenderTextCache *textCache = &renderer->textCache;
+	if (textCache->numLookups > 0)
+	{
+		textCache->hitRate = CAST(f32) textCache->numHits /
+		                     CAST(f32) textCache->numLookups;
+	}
+	textCache->numLookups = 0;
+	textCache->numHits    = 0;
 }
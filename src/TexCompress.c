@@ -0,0 +1,1195 @@
+#include "Dengine/TexCompress.h"
+#include "Dengine/Math.h"
+#include "Dengine/MemoryArena.h"
+
+/*
+ *********************************
+ * Mip Chain
+ *********************************
+ */
+i32 texcompress_getMipDim(const i32 dim, const i32 level)
+{
+	i32 result = MAX(dim >> level, 1);
+	return result;
+}
+
+i32 texcompress_getNumMips(const i32 width, const i32 height)
+{
+	i32 result  = 1;
+	i32 maxSide = MAX(width, height);
+	while ((maxSide >> result) > 0 && result < TEX_MAX_MIPS)
+		result++;
+
+	return result;
+}
+
+#define KAISER_WIDTH 2.0f
+#define KAISER_BETA 4.0f
+
+/* Zeroth order modified bessel function, the series converges quickly */
+INTERNAL f32 besselI0(const f32 x)
+{
+	f32 result = 1.0f;
+	f32 term   = 1.0f;
+	f32 halfX  = x * 0.5f;
+	for (i32 k = 1; k < 16; k++)
+	{
+		term *= (halfX / k) * (halfX / k);
+		result += term;
+	}
+
+	return result;
+}
+
+/* t is the distance from the destination texel centre in destination texels */
+INTERNAL f32 mipFilterWeight(const enum TexMipFilter filter, f32 t)
+{
+	t = ABS(t);
+	if (filter == texmipfilter_box) return (t < 0.5f) ? 1.0f : 0.0f;
+	if (t >= KAISER_WIDTH) return 0.0f;
+
+	f32 sinc =
+	    (t < 0.00001f) ? 1.0f : sinf(MATH_PI * t) / (MATH_PI * t);
+	f32 ratio  = t / KAISER_WIDTH;
+	f32 window = besselI0(KAISER_BETA * sqrtf(1.0f - (ratio * ratio))) /
+	             besselI0(KAISER_BETA);
+	f32 result = sinc * window;
+	return result;
+}
+
+/*
+   Resample one row or column of premultiplied texels, strides are in texels.
+   Taps past the edge repeat the edge texel.
+ */
+INTERNAL void mipResampleLine(const f32 *const src, const i32 srcLen,
+                              const i32 srcStride, f32 *const dest,
+                              const i32 destLen, const i32 destStride,
+                              const enum TexMipFilter filter)
+{
+	f32 scale   = CAST(f32) srcLen / CAST(f32) destLen;
+	f32 support = ((filter == texmipfilter_box) ? 0.5f : KAISER_WIDTH) * scale;
+
+	for (i32 i = 0; i < destLen; i++)
+	{
+		f32 centre = ((i + 0.5f) * scale) - 0.5f;
+		i32 first  = CAST(i32) ceilf(centre - support);
+		i32 last   = CAST(i32) floorf(centre + support);
+
+		f32 sum[4]      = {0};
+		f32 totalWeight = 0.0f;
+		for (i32 tap = first; tap <= last; tap++)
+		{
+			f32 weight = mipFilterWeight(filter, (tap - centre) / scale);
+			if (weight == 0.0f) continue;
+
+			i32 index = MIN(MAX(tap, 0), srcLen - 1);
+			const f32 *texel = &src[index * srcStride * 4];
+			for (i32 c = 0; c < 4; c++)
+				sum[c] += texel[c] * weight;
+			totalWeight += weight;
+		}
+
+		f32 *out = &dest[i * destStride * 4];
+		for (i32 c = 0; c < 4; c++)
+			out[c] = (totalWeight != 0.0f) ? sum[c] / totalWeight : 0.0f;
+	}
+}
+
+void texcompress_mipDownsample(MemoryArena_ *const arena,
+                               const u8 *const src, const i32 srcWidth,
+                               const i32 srcHeight, u8 *const dest,
+                               const enum TexMipFilter filter)
+{
+	i32 destWidth  = texcompress_getMipDim(srcWidth, 1);
+	i32 destHeight = texcompress_getMipDim(srcHeight, 1);
+
+	TempMemory tempRegion = memory_beginTempRegion(arena);
+	f32 *texels = MEMORY_PUSH_ARRAY(arena, srcWidth * srcHeight * 4, f32);
+	f32 *rows   = MEMORY_PUSH_ARRAY(arena, destWidth * srcHeight * 4, f32);
+	f32 *result = MEMORY_PUSH_ARRAY(arena, destWidth * destHeight * 4, f32);
+
+	/* Premultiply so colour is weighted by coverage */
+	for (i32 i = 0; i < srcWidth * srcHeight; i++)
+	{
+		f32 alpha         = src[(i * 4) + 3] / 255.0f;
+		texels[(i * 4) + 0] = (src[(i * 4) + 0] / 255.0f) * alpha;
+		texels[(i * 4) + 1] = (src[(i * 4) + 1] / 255.0f) * alpha;
+		texels[(i * 4) + 2] = (src[(i * 4) + 2] / 255.0f) * alpha;
+		texels[(i * 4) + 3] = alpha;
+	}
+
+	/* Separable, rows then columns */
+	for (i32 y = 0; y < srcHeight; y++)
+	{
+		mipResampleLine(&texels[y * srcWidth * 4], srcWidth, 1,
+		                &rows[y * destWidth * 4], destWidth, 1, filter);
+	}
+
+	for (i32 x = 0; x < destWidth; x++)
+	{
+		mipResampleLine(&rows[x * 4], srcHeight, destWidth, &result[x * 4],
+		                destHeight, destWidth, filter);
+	}
+
+	for (i32 i = 0; i < destWidth * destHeight; i++)
+	{
+		f32 *texel = &result[i * 4];
+		f32 alpha  = MIN(MAX(texel[3], 0.0f), 1.0f);
+		for (i32 c = 0; c < 3; c++)
+		{
+			f32 value = (alpha > (0.5f / 255.0f)) ? texel[c] / alpha : 0.0f;
+			value     = MIN(MAX(value, 0.0f), 1.0f);
+			dest[(i * 4) + c] = CAST(u8)((value * 255.0f) + 0.5f);
+		}
+		dest[(i * 4) + 3] = CAST(u8)((alpha * 255.0f) + 0.5f);
+	}
+
+	memory_endTempRegion(tempRegion);
+}
+
+/*
+ *********************************
+ * Block Helpers
+ *********************************
+ */
+typedef struct TexBlock
+{
+	u8 texels[16][4];
+} TexBlock;
+
+/* Fetch a 4x4 block, texels past the edge repeat the edge */
+INTERNAL void blockFetch(const u8 *const rgba, const i32 width,
+                         const i32 height, const i32 blockX,
+                         const i32 blockY, TexBlock *const block)
+{
+	for (i32 y = 0; y < 4; y++)
+	{
+		i32 srcY = MIN((blockY * 4) + y, height - 1);
+		for (i32 x = 0; x < 4; x++)
+		{
+			i32 srcX     = MIN((blockX * 4) + x, width - 1);
+			const u8 *in = &rgba[(srcX + (srcY * width)) * 4];
+			u8 *out      = block->texels[x + (y * 4)];
+			out[0] = in[0];
+			out[1] = in[1];
+			out[2] = in[2];
+			out[3] = in[3];
+		}
+	}
+}
+
+INTERNAL void blockStore(const TexBlock *const block, u8 *const rgba,
+                         const i32 width, const i32 height,
+                         const i32 blockX, const i32 blockY)
+{
+	for (i32 y = 0; y < 4; y++)
+	{
+		i32 destY = (blockY * 4) + y;
+		if (destY >= height) break;
+
+		for (i32 x = 0; x < 4; x++)
+		{
+			i32 destX = (blockX * 4) + x;
+			if (destX >= width) break;
+
+			u8 *out      = &rgba[(destX + (destY * width)) * 4];
+			const u8 *in = block->texels[x + (y * 4)];
+			out[0] = in[0];
+			out[1] = in[1];
+			out[2] = in[2];
+			out[3] = in[3];
+		}
+	}
+}
+
+INTERNAL i32 colorDistSq(const u8 *const a, const f32 *const b,
+                         const i32 channels)
+{
+	f32 result = 0.0f;
+	for (i32 c = 0; c < channels; c++)
+	{
+		f32 diff = a[c] - b[c];
+		result += diff * diff;
+	}
+
+	return CAST(i32) result;
+}
+
+/*
+   Fit a line through the masked texels with the principal axis of their
+   covariance, found by power iteration. The endpoints are the extremes of
+   the texels projected onto the axis, inset slightly since the palette
+   between them is what most texels map to.
+ */
+INTERNAL void blockFitEndpoints(const TexBlock *const block,
+                                const u16 mask, const i32 channels,
+                                f32 *const endpoint0, f32 *const endpoint1)
+{
+	f32 mean[4] = {0};
+	i32 count   = 0;
+	for (i32 i = 0; i < 16; i++)
+	{
+		if (!(mask & (1 << i))) continue;
+		for (i32 c = 0; c < channels; c++)
+			mean[c] += block->texels[i][c];
+		count++;
+	}
+
+	for (i32 c = 0; c < channels; c++)
+		mean[c] /= count;
+
+	f32 covariance[4][4] = {0};
+	for (i32 i = 0; i < 16; i++)
+	{
+		if (!(mask & (1 << i))) continue;
+		for (i32 a = 0; a < channels; a++)
+		{
+			for (i32 b = 0; b < channels; b++)
+			{
+				covariance[a][b] += (block->texels[i][a] - mean[a]) *
+				                    (block->texels[i][b] - mean[b]);
+			}
+		}
+	}
+
+	f32 axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+	for (i32 iteration = 0; iteration < 8; iteration++)
+	{
+		f32 next[4] = {0};
+		f32 length  = 0.0f;
+		for (i32 a = 0; a < channels; a++)
+		{
+			for (i32 b = 0; b < channels; b++)
+				next[a] += covariance[a][b] * axis[b];
+			length += next[a] * next[a];
+		}
+
+		// NOTE(doyle): Flat blocks have no axis, both endpoints are the mean
+		if (length < 0.00001f)
+		{
+			for (i32 c = 0; c < channels; c++)
+				axis[c] = 0.0f;
+			break;
+		}
+
+		length = sqrtf(length);
+		for (i32 c = 0; c < channels; c++)
+			axis[c] = next[c] / length;
+	}
+
+	f32 minT = 0.0f;
+	f32 maxT = 0.0f;
+	for (i32 i = 0; i < 16; i++)
+	{
+		if (!(mask & (1 << i))) continue;
+
+		f32 t = 0.0f;
+		for (i32 c = 0; c < channels; c++)
+			t += (block->texels[i][c] - mean[c]) * axis[c];
+
+		minT = MIN(minT, t);
+		maxT = MAX(maxT, t);
+	}
+
+	f32 inset = (maxT - minT) / 16.0f;
+	minT += inset;
+	maxT -= inset;
+	for (i32 c = 0; c < channels; c++)
+	{
+		endpoint0[c] = MIN(MAX(mean[c] + (axis[c] * maxT), 0.0f), 255.0f);
+		endpoint1[c] = MIN(MAX(mean[c] + (axis[c] * minT), 0.0f), 255.0f);
+	}
+}
+
+/*
+   Least squares endpoints for the texels' current palette weights, weight is
+   how much of endpoint1 each texel takes. Returns FALSE if degenerate.
+ */
+INTERNAL b32 blockSolveEndpoints(const TexBlock *const block, const u16 mask,
+                                 const i32 channels, const f32 *const weights,
+                                 f32 *const endpoint0, f32 *const endpoint1)
+{
+	f32 aa = 0, ab = 0, bb = 0;
+	f32 ax[4] = {0};
+	f32 bx[4] = {0};
+	for (i32 i = 0; i < 16; i++)
+	{
+		if (!(mask & (1 << i))) continue;
+
+		f32 b = weights[i];
+		f32 a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (i32 c = 0; c < channels; c++)
+		{
+			ax[c] += a * block->texels[i][c];
+			bx[c] += b * block->texels[i][c];
+		}
+	}
+
+	f32 det = (aa * bb) - (ab * ab);
+	if (ABS(det) < 0.0001f) return FALSE;
+
+	for (i32 c = 0; c < channels; c++)
+	{
+		f32 e0 = ((bb * ax[c]) - (ab * bx[c])) / det;
+		f32 e1 = ((aa * bx[c]) - (ab * ax[c])) / det;
+		endpoint0[c] = MIN(MAX(e0, 0.0f), 255.0f);
+		endpoint1[c] = MIN(MAX(e1, 0.0f), 255.0f);
+	}
+
+	return TRUE;
+}
+
+/* Little endian bit stream for the 128 bit BC7 blocks */
+typedef struct BitStream
+{
+	u8 *data;
+	i32 pos;
+} BitStream;
+
+INTERNAL void bitsWrite(BitStream *const stream, u32 value, const i32 count)
+{
+	for (i32 i = 0; i < count; i++)
+	{
+		if (value & (1 << i))
+			stream->data[stream->pos >> 3] |= (1 << (stream->pos & 7));
+		stream->pos++;
+	}
+}
+
+INTERNAL u32 bitsRead(BitStream *const stream, const i32 count)
+{
+	u32 result = 0;
+	for (i32 i = 0; i < count; i++)
+	{
+		if (stream->data[stream->pos >> 3] & (1 << (stream->pos & 7)))
+			result |= (1 << i);
+		stream->pos++;
+	}
+
+	return result;
+}
+
+/*
+ *********************************
+ * BC1
+ *********************************
+ */
+INTERNAL u16 rgb565Pack(const f32 *const color)
+{
+	u32 r = CAST(u32)((color[0] * 31.0f / 255.0f) + 0.5f);
+	u32 g = CAST(u32)((color[1] * 63.0f / 255.0f) + 0.5f);
+	u32 b = CAST(u32)((color[2] * 31.0f / 255.0f) + 0.5f);
+
+	u16 result = CAST(u16)((r << 11) | (g << 5) | b);
+	return result;
+}
+
+INTERNAL void rgb565Unpack(const u16 packed, f32 *const color)
+{
+	u32 r = (packed >> 11) & 31;
+	u32 g = (packed >> 5) & 63;
+	u32 b = packed & 31;
+
+	color[0] = CAST(f32)((r << 3) | (r >> 2));
+	color[1] = CAST(f32)((g << 2) | (g >> 4));
+	color[2] = CAST(f32)((b << 3) | (b >> 2));
+	color[3] = 255.0f;
+}
+
+/*
+   Palette of a BC1 colour block. Colour 0 greater than colour 1 selects 4
+   colours, otherwise 3 and transparent black, unless forced to 4 colours as
+   BC3 colour blocks are.
+ */
+INTERNAL void bc1Palette(const u16 color0, const u16 color1,
+                         const b32 forceFourColor, f32 palette[4][4])
+{
+	rgb565Unpack(color0, palette[0]);
+	rgb565Unpack(color1, palette[1]);
+	if (color0 > color1 || forceFourColor)
+	{
+		for (i32 c = 0; c < 4; c++)
+		{
+			palette[2][c] = CAST(f32)(
+			    (CAST(i32)(2 * palette[0][c]) + CAST(i32) palette[1][c]) / 3);
+			palette[3][c] = CAST(f32)(
+			    (CAST(i32) palette[0][c] + CAST(i32)(2 * palette[1][c])) / 3);
+		}
+	}
+	else
+	{
+		for (i32 c = 0; c < 4; c++)
+		{
+			palette[2][c] = CAST(f32)(
+			    (CAST(i32) palette[0][c] + CAST(i32) palette[1][c]) / 2);
+			palette[3][c] = 0.0f;
+		}
+	}
+}
+
+/* Assign indices and return the squared error of the masked texels */
+INTERNAL i32 bc1AssignIndices(const TexBlock *const block, const u16 mask,
+                              f32 palette[4][4], const i32 numColors,
+                              u32 *const indices, f32 *const weights)
+{
+	LOCAL_PERSIST const f32 paletteWeight[4] = {0.0f, 1.0f, 1.0f / 3.0f,
+	                                            2.0f / 3.0f};
+	i32 result = 0;
+	*indices   = 0;
+	for (i32 i = 0; i < 16; i++)
+	{
+		// NOTE(doyle): Unmasked texels are transparent, index 3 in 3 colour
+		if (!(mask & (1 << i)))
+		{
+			*indices |= (3 << (i * 2));
+			continue;
+		}
+
+		i32 best     = 0;
+		i32 bestDist = colorDistSq(block->texels[i], palette[0], 3);
+		for (i32 j = 1; j < numColors; j++)
+		{
+			i32 dist = colorDistSq(block->texels[i], palette[j], 3);
+			if (dist < bestDist)
+			{
+				best     = j;
+				bestDist = dist;
+			}
+		}
+
+		*indices |= (CAST(u32) best << (i * 2));
+		weights[i] = (numColors == 4) ? paletteWeight[best]
+		                              : ((best == 2) ? 0.5f : CAST(f32) best);
+		result += bestDist;
+	}
+
+	return result;
+}
+
+/* Encode the colour of a block, returns the squared error */
+INTERNAL i32 bc1EncodeColor(const TexBlock *const block, const u16 mask,
+                            const b32 threeColor, u8 *const dest)
+{
+	u16 color0   = 0;
+	u16 color1   = 0;
+	u32 indices  = 0xFFFFFFFF;
+	i32 result   = 0;
+	f32 weights[16] = {0};
+
+	if (mask)
+	{
+		f32 endpoint0[4], endpoint1[4];
+		blockFitEndpoints(block, mask, 3, endpoint0, endpoint1);
+
+		for (i32 pass = 0; pass < 2; pass++)
+		{
+			u16 c0 = rgb565Pack(endpoint0);
+			u16 c1 = rgb565Pack(endpoint1);
+
+			// NOTE(doyle): The endpoint order selects the palette mode
+			if ((threeColor && c0 > c1) || (!threeColor && c0 < c1))
+			{
+				u16 swap = c0;
+				c0       = c1;
+				c1       = swap;
+			}
+
+			f32 palette[4][4];
+			bc1Palette(c0, c1, !threeColor, palette);
+
+			i32 numColors =
+			    (threeColor || c0 == c1) ? ((c0 == c1) ? 1 : 3) : 4;
+
+			u32 passIndices = 0;
+			f32 passWeights[16] = {0};
+			i32 error = bc1AssignIndices(block, mask, palette, numColors,
+			                             &passIndices, passWeights);
+			if (pass == 0 || error < result)
+			{
+				color0  = c0;
+				color1  = c1;
+				indices = passIndices;
+				result  = error;
+				common_memcpy(CAST(u8 *) weights, CAST(u8 *) passWeights,
+				              sizeof(weights));
+			}
+
+			if (numColors != 4 ||
+			    !blockSolveEndpoints(block, mask, 3, weights, endpoint0,
+			                         endpoint1))
+				break;
+
+			/* Weights are for the possibly swapped order */
+			if (color0 != c0)
+			{
+				f32 swap[4];
+				common_memcpy(CAST(u8 *) swap, CAST(u8 *) endpoint0,
+				              sizeof(swap));
+				common_memcpy(CAST(u8 *) endpoint0, CAST(u8 *) endpoint1,
+				              sizeof(swap));
+				common_memcpy(CAST(u8 *) endpoint1, CAST(u8 *) swap,
+				              sizeof(swap));
+			}
+		}
+	}
+
+	dest[0] = CAST(u8)(color0 & 0xFF);
+	dest[1] = CAST(u8)(color0 >> 8);
+	dest[2] = CAST(u8)(color1 & 0xFF);
+	dest[3] = CAST(u8)(color1 >> 8);
+	dest[4] = CAST(u8)(indices & 0xFF);
+	dest[5] = CAST(u8)((indices >> 8) & 0xFF);
+	dest[6] = CAST(u8)((indices >> 16) & 0xFF);
+	dest[7] = CAST(u8)(indices >> 24);
+	return result;
+}
+
+INTERNAL void bc1EncodeBlock(const TexBlock *const block, u8 *const dest)
+{
+	u16 opaqueMask = 0;
+	for (i32 i = 0; i < 16; i++)
+	{
+		if (block->texels[i][3] >= 128) opaqueMask |= (1 << i);
+	}
+
+	bc1EncodeColor(block, opaqueMask, (opaqueMask != 0xFFFF), dest);
+}
+
+INTERNAL void bc1DecodeColor(const u8 *const src, const b32 forceFourColor,
+                             TexBlock *const block)
+{
+	u16 color0  = CAST(u16)(src[0] | (src[1] << 8));
+	u16 color1  = CAST(u16)(src[2] | (src[3] << 8));
+	u32 indices = src[4] | (src[5] << 8) | (src[6] << 16) |
+	              (CAST(u32) src[7] << 24);
+
+	f32 palette[4][4];
+	bc1Palette(color0, color1, forceFourColor, palette);
+	for (i32 i = 0; i < 16; i++)
+	{
+		f32 *color = palette[(indices >> (i * 2)) & 3];
+		for (i32 c = 0; c < 4; c++)
+			block->texels[i][c] = CAST(u8) color[c];
+	}
+}
+
+/*
+ *********************************
+ * BC3
+ *********************************
+ */
+INTERNAL void bc3AlphaPalette(const u8 alpha0, const u8 alpha1,
+                              i32 palette[8])
+{
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	if (alpha0 > alpha1)
+	{
+		for (i32 i = 1; i < 7; i++)
+			palette[i + 1] = (((7 - i) * alpha0) + (i * alpha1)) / 7;
+	}
+	else
+	{
+		for (i32 i = 1; i < 5; i++)
+			palette[i + 1] = (((5 - i) * alpha0) + (i * alpha1)) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+INTERNAL void bc3EncodeAlpha(const TexBlock *const block, u8 *const dest)
+{
+	u8 alpha0 = 0;
+	u8 alpha1 = 255;
+	for (i32 i = 0; i < 16; i++)
+	{
+		alpha0 = MAX(alpha0, block->texels[i][3]);
+		alpha1 = MIN(alpha1, block->texels[i][3]);
+	}
+
+	i32 palette[8];
+	bc3AlphaPalette(alpha0, alpha1, palette);
+
+	u64 indices = 0;
+	if (alpha0 != alpha1)
+	{
+		for (i32 i = 0; i < 16; i++)
+		{
+			i32 best     = 0;
+			i32 bestDist = 256;
+			for (i32 j = 0; j < 8; j++)
+			{
+				i32 dist = ABS(block->texels[i][3] - palette[j]);
+				if (dist < bestDist)
+				{
+					best     = j;
+					bestDist = dist;
+				}
+			}
+			indices |= (CAST(u64) best << (i * 3));
+		}
+	}
+
+	dest[0] = alpha0;
+	dest[1] = alpha1;
+	for (i32 i = 0; i < 6; i++)
+		dest[2 + i] = CAST(u8)((indices >> (i * 8)) & 0xFF);
+}
+
+INTERNAL void bc3DecodeAlpha(const u8 *const src, TexBlock *const block)
+{
+	i32 palette[8];
+	bc3AlphaPalette(src[0], src[1], palette);
+
+	u64 indices = 0;
+	for (i32 i = 0; i < 6; i++)
+		indices |= (CAST(u64) src[2 + i] << (i * 8));
+
+	for (i32 i = 0; i < 16; i++)
+		block->texels[i][3] = CAST(u8) palette[(indices >> (i * 3)) & 7];
+}
+
+/*
+ *********************************
+ * BC7
+ *********************************
+ */
+/*
+   NOTE(doyle): Only mode 6 is encoded, one subset of 7 bit RGBA endpoints
+   with a shared low bit per endpoint and 4 bit indices. It is the mode most
+   suited to smooth sprite art, the partitioned modes are a much larger search
+   for a gain mostly on hard edged multi colour blocks. The decoder handles
+   only mode 6 and writes black for other modes.
+ */
+LOCAL_PERSIST const i32 bc7Weights4[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                           34, 38, 43, 47, 51, 55, 60, 64};
+
+INTERNAL void bc7Interpolate(const u8 *const endpoint0,
+                             const u8 *const endpoint1, f32 palette[16][4])
+{
+	for (i32 i = 0; i < 16; i++)
+	{
+		i32 weight = bc7Weights4[i];
+		for (i32 c = 0; c < 4; c++)
+		{
+			i32 value = ((64 - weight) * endpoint0[c]) +
+			            (weight * endpoint1[c]) + 32;
+			palette[i][c] = CAST(f32)(value >> 6);
+		}
+	}
+}
+
+/* Quantise to 7 bits and the shared low bit that best reconstructs it */
+INTERNAL void bc7QuantiseEndpoint(const f32 *const endpoint, u8 *const quant,
+                                  u8 *const pBit, u8 *const recon)
+{
+	i32 bestError = -1;
+	for (i32 p = 0; p < 2; p++)
+	{
+		u8 candidate[4];
+		u8 candidateRecon[4];
+		i32 error = 0;
+		for (i32 c = 0; c < 4; c++)
+		{
+			i32 q = CAST(i32) floorf(((endpoint[c] - p) / 2.0f) + 0.5f);
+			q     = MIN(MAX(q, 0), 127);
+
+			candidate[c]      = CAST(u8) q;
+			candidateRecon[c] = CAST(u8)((q << 1) | p);
+
+			i32 diff = CAST(i32) endpoint[c] - candidateRecon[c];
+			error += diff * diff;
+		}
+
+		if (bestError == -1 || error < bestError)
+		{
+			bestError = error;
+			*pBit     = CAST(u8) p;
+			common_memcpy(quant, candidate, 4);
+			common_memcpy(recon, candidateRecon, 4);
+		}
+	}
+}
+
+INTERNAL void bc7EncodeBlock(const TexBlock *const block, u8 *const dest)
+{
+	f32 endpoint0[4], endpoint1[4];
+	blockFitEndpoints(block, 0xFFFF, 4, endpoint0, endpoint1);
+
+	u8 bestQuant[2][4], bestPBit[2];
+	u8 bestIndices[16];
+	i32 bestError = -1;
+
+	for (i32 pass = 0; pass < 2; pass++)
+	{
+		u8 quant[2][4], pBit[2], recon[2][4];
+		bc7QuantiseEndpoint(endpoint0, quant[0], &pBit[0], recon[0]);
+		bc7QuantiseEndpoint(endpoint1, quant[1], &pBit[1], recon[1]);
+
+		f32 palette[16][4];
+		bc7Interpolate(recon[0], recon[1], palette);
+
+		u8 indices[16];
+		f32 weights[16];
+		i32 error = 0;
+		for (i32 i = 0; i < 16; i++)
+		{
+			i32 best     = 0;
+			i32 bestDist = colorDistSq(block->texels[i], palette[0], 4);
+			for (i32 j = 1; j < 16; j++)
+			{
+				i32 dist = colorDistSq(block->texels[i], palette[j], 4);
+				if (dist < bestDist)
+				{
+					best     = j;
+					bestDist = dist;
+				}
+			}
+
+			indices[i] = CAST(u8) best;
+			weights[i] = bc7Weights4[best] / 64.0f;
+			error += bestDist;
+		}
+
+		if (bestError == -1 || error < bestError)
+		{
+			bestError = error;
+			common_memcpy(CAST(u8 *) bestQuant, CAST(u8 *) quant,
+			              sizeof(quant));
+			common_memcpy(bestPBit, pBit, sizeof(pBit));
+			common_memcpy(bestIndices, indices, sizeof(indices));
+		}
+
+		if (!blockSolveEndpoints(block, 0xFFFF, 4, weights, endpoint0,
+		                         endpoint1))
+			break;
+	}
+
+	/* The first index's high bit is implied 0, swap the endpoints if set */
+	if (bestIndices[0] & 8)
+	{
+		for (i32 c = 0; c < 4; c++)
+		{
+			u8 swap         = bestQuant[0][c];
+			bestQuant[0][c] = bestQuant[1][c];
+			bestQuant[1][c] = swap;
+		}
+
+		u8 swap     = bestPBit[0];
+		bestPBit[0] = bestPBit[1];
+		bestPBit[1] = swap;
+
+		for (i32 i = 0; i < 16; i++)
+			bestIndices[i] = 15 - bestIndices[i];
+	}
+
+	common_memset(dest, 0, 16);
+	BitStream stream = {dest, 0};
+	bitsWrite(&stream, 1 << 6, 7);
+	for (i32 c = 0; c < 4; c++)
+	{
+		bitsWrite(&stream, bestQuant[0][c], 7);
+		bitsWrite(&stream, bestQuant[1][c], 7);
+	}
+	bitsWrite(&stream, bestPBit[0], 1);
+	bitsWrite(&stream, bestPBit[1], 1);
+
+	bitsWrite(&stream, bestIndices[0], 3);
+	for (i32 i = 1; i < 16; i++)
+		bitsWrite(&stream, bestIndices[i], 4);
+
+	ASSERT(stream.pos == 128);
+}
+
+INTERNAL void bc7DecodeBlock(const u8 *const src, TexBlock *const block)
+{
+	if ((src[0] & 0x7F) != (1 << 6))
+	{
+		common_memset(CAST(u8 *) block, 0, sizeof(TexBlock));
+		return;
+	}
+
+	BitStream stream = {CAST(u8 *) src, 7};
+	u8 quant[2][4];
+	for (i32 c = 0; c < 4; c++)
+	{
+		quant[0][c] = CAST(u8) bitsRead(&stream, 7);
+		quant[1][c] = CAST(u8) bitsRead(&stream, 7);
+	}
+
+	u8 pBit0 = CAST(u8) bitsRead(&stream, 1);
+	u8 pBit1 = CAST(u8) bitsRead(&stream, 1);
+
+	u8 endpoint0[4], endpoint1[4];
+	for (i32 c = 0; c < 4; c++)
+	{
+		endpoint0[c] = CAST(u8)((quant[0][c] << 1) | pBit0);
+		endpoint1[c] = CAST(u8)((quant[1][c] << 1) | pBit1);
+	}
+
+	f32 palette[16][4];
+	bc7Interpolate(endpoint0, endpoint1, palette);
+	for (i32 i = 0; i < 16; i++)
+	{
+		u32 index = bitsRead(&stream, (i == 0) ? 3 : 4);
+		for (i32 c = 0; c < 4; c++)
+			block->texels[i][c] = CAST(u8) palette[index][c];
+	}
+}
+
+/*
+ *********************************
+ * Images
+ *********************************
+ */
+INTERNAL i32 getBlockSize(const enum TexFormat format)
+{
+	switch (format)
+	{
+	case texformat_bc1: return 8;
+	case texformat_bc3: return 16;
+	case texformat_bc7: return 16;
+	default: return 0;
+	}
+}
+
+i32 texcompress_getSize(const enum TexFormat format, const i32 width,
+                        const i32 height)
+{
+	if (format == texformat_rgba8) return width * height * 4;
+
+	i32 blocksX = (width + 3) / 4;
+	i32 blocksY = (height + 3) / 4;
+	i32 result  = blocksX * blocksY * getBlockSize(format);
+	return result;
+}
+
+void texcompress_encode(const enum TexFormat format, const u8 *const rgba,
+                        const i32 width, const i32 height, u8 *const dest)
+{
+	if (format == texformat_rgba8)
+	{
+		common_memcpy(dest, rgba, width * height * 4);
+		return;
+	}
+
+	i32 blocksX   = (width + 3) / 4;
+	i32 blocksY   = (height + 3) / 4;
+	i32 blockSize = getBlockSize(format);
+	for (i32 blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (i32 blockX = 0; blockX < blocksX; blockX++)
+		{
+			TexBlock block;
+			blockFetch(rgba, width, height, blockX, blockY, &block);
+
+			u8 *out = dest + ((blockX + (blockY * blocksX)) * blockSize);
+			switch (format)
+			{
+			case texformat_bc1:
+				bc1EncodeBlock(&block, out);
+				break;
+
+			case texformat_bc3:
+				bc3EncodeAlpha(&block, out);
+				bc1EncodeColor(&block, 0xFFFF, FALSE, out + 8);
+				break;
+
+			case texformat_bc7:
+				bc7EncodeBlock(&block, out);
+				break;
+
+			default:
+				ASSERT(FALSE);
+				break;
+			}
+		}
+	}
+}
+
+void texcompress_decode(const enum TexFormat format, const u8 *const src,
+                        const i32 width, const i32 height, u8 *const rgba)
+{
+	if (format == texformat_rgba8)
+	{
+		common_memcpy(rgba, src, width * height * 4);
+		return;
+	}
+
+	i32 blocksX   = (width + 3) / 4;
+	i32 blocksY   = (height + 3) / 4;
+	i32 blockSize = getBlockSize(format);
+	for (i32 blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (i32 blockX = 0; blockX < blocksX; blockX++)
+		{
+			const u8 *in = src + ((blockX + (blockY * blocksX)) * blockSize);
+
+			TexBlock block;
+			switch (format)
+			{
+			case texformat_bc1:
+				bc1DecodeColor(in, FALSE, &block);
+				break;
+
+			case texformat_bc3:
+				bc1DecodeColor(in + 8, TRUE, &block);
+				bc3DecodeAlpha(in, &block);
+				break;
+
+			case texformat_bc7:
+				bc7DecodeBlock(in, &block);
+				break;
+
+			default:
+				ASSERT(FALSE);
+				break;
+			}
+
+			blockStore(&block, rgba, width, height, blockX, blockY);
+		}
+	}
+}
+
+u8 *texcompress_buildFile(MemoryArena_ *const arena, const u8 *const rgba,
+                          const i32 width, const i32 height,
+                          const enum TexFormat format,
+                          const enum TexMipFilter filter, i32 *const fileSize)
+{
+	TexFileHeader header = {0};
+	header.magic         = TEX_FILE_MAGIC;
+	header.version       = TEX_FILE_VERSION;
+	header.format        = format;
+	header.width         = width;
+	header.height        = height;
+	header.numMips       = texcompress_getNumMips(width, height);
+
+	u32 offset = sizeof(TexFileHeader);
+	for (u32 level = 0; level < header.numMips; level++)
+	{
+		header.mipOffset[level] = offset;
+		header.mipSize[level] =
+		    texcompress_getSize(format, texcompress_getMipDim(width, level),
+		                        texcompress_getMipDim(height, level));
+		offset += header.mipSize[level];
+	}
+
+	/* The file and twice the base level for the working mips */
+	i32 imageSize = width * height * 4;
+	if (arena->used + offset + (imageSize * 2) + (imageSize * 8) >
+	    arena->size)
+		return NULL;
+
+	u8 *result = CAST(u8 *) memory_pushBytes(arena, offset);
+	common_memcpy(result, CAST(u8 *) &header, sizeof(TexFileHeader));
+
+	TempMemory tempRegion = memory_beginTempRegion(arena);
+	u8 *level = CAST(u8 *) memory_pushBytes(arena, imageSize);
+	u8 *next  = CAST(u8 *) memory_pushBytes(arena, imageSize);
+	common_memcpy(level, rgba, imageSize);
+
+	for (u32 i = 0; i < header.numMips; i++)
+	{
+		i32 levelWidth  = texcompress_getMipDim(width, i);
+		i32 levelHeight = texcompress_getMipDim(height, i);
+		texcompress_encode(format, level, levelWidth, levelHeight,
+		                   result + header.mipOffset[i]);
+
+		if (i + 1 < header.numMips)
+		{
+			texcompress_mipDownsample(arena, level, levelWidth, levelHeight,
+			                          next, filter);
+			u8 *swap = level;
+			level    = next;
+			next     = swap;
+		}
+	}
+
+	memory_endTempRegion(tempRegion);
+	*fileSize = offset;
+	return result;
+}
+
+const TexFileHeader *texcompress_getFileHeader(const void *const buffer,
+                                               const i32 size)
+{
+	if (!buffer || size < sizeof(TexFileHeader)) return NULL;
+
+	const TexFileHeader *header = CAST(const TexFileHeader *) buffer;
+	if (header->magic != TEX_FILE_MAGIC ||
+	    header->version != TEX_FILE_VERSION ||
+	    header->format >= texformat_count || header->numMips == 0 ||
+	    header->numMips > TEX_MAX_MIPS)
+		return NULL;
+
+	for (u32 level = 0; level < header->numMips; level++)
+	{
+		i32 expected = texcompress_getSize(
+		    CAST(enum TexFormat) header->format,
+		    texcompress_getMipDim(header->width, level),
+		    texcompress_getMipDim(header->height, level));
+		if (header->mipSize[level] != CAST(u32) expected ||
+		    header->mipOffset[level] + header->mipSize[level] >
+		        CAST(u32) size)
+			return NULL;
+	}
+
+	return header;
+}
+
+/*
+ *********************************
+ * Unit Test
+ *********************************
+ */
+INTERNAL f32 imagePsnr(const u8 *const a, const u8 *const b, const i32 size,
+                       const i32 channels)
+{
+	f64 error = 0.0;
+	i32 count = 0;
+	for (i32 i = 0; i < size; i += 4)
+	{
+		for (i32 c = 0; c < channels; c++)
+		{
+			f64 diff = CAST(f64) a[i + c] - CAST(f64) b[i + c];
+			error += diff * diff;
+			count++;
+		}
+	}
+
+	if (error == 0.0) return 100.0f;
+
+	f64 meanSq = error / count;
+	f32 result = CAST(f32)(10.0 * log10((255.0 * 255.0) / meanSq));
+	return result;
+}
+
+void texcompress_unitTest(MemoryArena_ *const arena)
+{
+	TempMemory tempRegion = memory_beginTempRegion(arena);
+
+	ASSERT(texcompress_getNumMips(1, 1) == 1);
+	ASSERT(texcompress_getNumMips(256, 64) == 9);
+	ASSERT(texcompress_getNumMips(5, 3) == 3);
+	ASSERT(texcompress_getSize(texformat_bc1, 5, 3) == 16);
+	ASSERT(texcompress_getSize(texformat_bc7, 8, 8) == 64);
+
+	/* A smooth image with some noise, odd sized to cover partial blocks */
+	const i32 width  = 61;
+	const i32 height = 37;
+	const i32 size   = width * height * 4;
+	u8 *image        = CAST(u8 *) memory_pushBytes(arena, size);
+	u8 *decoded      = CAST(u8 *) memory_pushBytes(arena, size);
+	u8 *blocks       = CAST(u8 *) memory_pushBytes(arena, size);
+	u32 seed         = 1;
+	for (i32 y = 0; y < height; y++)
+	{
+		for (i32 x = 0; x < width; x++)
+		{
+			seed  = (seed * 1103515245) + 12345;
+			i32 n = CAST(i32)((seed >> 16) & 7) - 4;
+
+			u8 *texel = &image[(x + (y * width)) * 4];
+			texel[0]  = CAST(u8) MIN(MAX((x * 4) + n, 0), 255);
+			texel[1]  = CAST(u8) MIN(MAX((y * 6) + n, 0), 255);
+			texel[2]  = CAST(u8) MIN(MAX(255 - (x * 2) - (y * 2) + n, 0), 255);
+			texel[3]  = 255;
+		}
+	}
+
+	{ // Encode and decode each format
+		texcompress_encode(texformat_bc1, image, width, height, blocks);
+		texcompress_decode(texformat_bc1, blocks, width, height, decoded);
+		ASSERT(imagePsnr(image, decoded, size, 4) > 30.0f);
+
+		for (i32 y = 0; y < height; y++)
+		{
+			for (i32 x = 0; x < width; x++)
+				image[((x + (y * width)) * 4) + 3] = CAST(u8)((x + y) * 2);
+		}
+
+		texcompress_encode(texformat_bc3, image, width, height, blocks);
+		texcompress_decode(texformat_bc3, blocks, width, height, decoded);
+		ASSERT(imagePsnr(image, decoded, size, 3) > 30.0f);
+		ASSERT(imagePsnr(image, decoded, size, 4) > 30.0f);
+
+		texcompress_encode(texformat_bc7, image, width, height, blocks);
+		texcompress_decode(texformat_bc7, blocks, width, height, decoded);
+		ASSERT(imagePsnr(image, decoded, size, 4) > 36.0f);
+	}
+
+	{ // BC1 keeps cut out alpha, transparent texels decode to transparent
+		u8 cutout[16 * 4];
+		for (i32 i = 0; i < 16; i++)
+		{
+			cutout[(i * 4) + 0] = 200;
+			cutout[(i * 4) + 1] = CAST(u8)(i * 10);
+			cutout[(i * 4) + 2] = 50;
+			cutout[(i * 4) + 3] = (i & 1) ? 255 : 0;
+		}
+
+		u8 block[8];
+		u8 cutoutDecoded[16 * 4];
+		texcompress_encode(texformat_bc1, cutout, 4, 4, block);
+		texcompress_decode(texformat_bc1, block, 4, 4, cutoutDecoded);
+		for (i32 i = 0; i < 16; i++)
+			ASSERT(cutoutDecoded[(i * 4) + 3] == cutout[(i * 4) + 3]);
+	}
+
+	{ // Mips of a checker average to grey, alpha weights the colour
+		u8 checker[16 * 16 * 4];
+		for (i32 i = 0; i < 16 * 16; i++)
+		{
+			u8 value = (((i % 16) + (i / 16)) & 1) ? 255 : 0;
+			checker[(i * 4) + 0] = value;
+			checker[(i * 4) + 1] = value;
+			checker[(i * 4) + 2] = value;
+			checker[(i * 4) + 3] = 255;
+		}
+
+		/* The Kaiser taps reach past the edge, check the interior only */
+		for (i32 filter = 0; filter < texmipfilter_count; filter++)
+		{
+			u8 mip[8 * 8 * 4];
+			texcompress_mipDownsample(arena, checker, 16, 16, mip,
+			                          CAST(enum TexMipFilter) filter);
+			for (i32 y = 2; y < 6; y++)
+			{
+				for (i32 x = 2; x < 6; x++)
+				{
+					u8 *texel = &mip[(x + (y * 8)) * 4];
+					ASSERT(ABS(texel[0] - 128) <= 2);
+					ASSERT(texel[3] == 255);
+				}
+			}
+		}
+
+		/* Red opaque next to invisible blue must not turn purple */
+		u8 edge[2 * 1 * 4] = {255, 0, 0, 255, 0, 0, 255, 0};
+		u8 edgeMip[4];
+		texcompress_mipDownsample(arena, edge, 2, 1, edgeMip,
+		                          texmipfilter_box);
+		ASSERT(edgeMip[0] == 255 && edgeMip[2] == 0 && edgeMip[3] == 128);
+	}
+
+	{ // Texture files validate and hold the whole chain
+		i32 fileSize = 0;
+		u8 *file = texcompress_buildFile(arena, image, width, height,
+		                                 texformat_bc3, texmipfilter_kaiser,
+		                                 &fileSize);
+		ASSERT(file);
+
+		const TexFileHeader *header =
+		    texcompress_getFileHeader(file, fileSize);
+		ASSERT(header);
+		ASSERT(header->numMips ==
+		       CAST(u32) texcompress_getNumMips(width, height));
+		ASSERT(header->mipSize[header->numMips - 1] == 16);
+		ASSERT(!texcompress_getFileHeader(file, fileSize - 1));
+	}
+
+	memory_endTempRegion(tempRegion);
+}
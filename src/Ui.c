@@ -5,7 +5,202 @@
 #include "Dengine/Debug.h"
 #include "Dengine/Renderer.h"
 
-void ui_beginState(UiState *state) { state->hotItem = 0; }
+/*
+ *********************************
+ * Widget Table
+ *********************************
+ */
+/* Spread sequential ids over the table, murmur3's 32 bit finaliser */
+INTERNAL u32 widgetIdHash(const i32 id)
+{
+	u32 result = CAST(u32) id;
+	result ^= result >> 16;
+	result *= 0x85EBCA6B;
+	result ^= result >> 13;
+	result *= 0xC2B2AE35;
+	result ^= result >> 16;
+	return result;
+}
+
+/* Robin hood insert, the same as the asset hash tables. Caller checks load */
+INTERNAL UiWidget *widgetTableInsert(UiWidgetTable *const table,
+                                     const UiWidget *const widget)
+{
+	UiWidget toInsert  = *widget;
+	toInsert.inUse     = TRUE;
+	toInsert.probeDist = 0;
+
+	UiWidget *result = NULL;
+	u32 mask         = table->size - 1;
+	u32 index        = widgetIdHash(toInsert.id) & mask;
+	for (;;)
+	{
+		UiWidget *entry = &table->widgets[index];
+		if (!entry->inUse)
+		{
+			*entry = toInsert;
+			if (!result) result = entry;
+			break;
+		}
+
+		if (entry->probeDist < toInsert.probeDist)
+		{
+			UiWidget displaced = *entry;
+			*entry             = toInsert;
+			toInsert           = displaced;
+
+			if (!result) result = entry;
+		}
+
+		toInsert.probeDist++;
+		index = (index + 1) & mask;
+	}
+
+	table->count++;
+	return result;
+}
+
+INTERNAL UiWidget *widgetTableFind(UiWidgetTable *const table, const i32 id)
+{
+	if (table->size == 0) return NULL;
+
+	u32 mask  = table->size - 1;
+	u32 index = widgetIdHash(id) & mask;
+	for (i32 probeDist = 0; probeDist < table->size; probeDist++)
+	{
+		UiWidget *entry = &table->widgets[index];
+		if (!entry->inUse || entry->probeDist < probeDist) break;
+		if (entry->id == id) return entry;
+
+		index = (index + 1) & mask;
+	}
+
+	return NULL;
+}
+
+/*
+   Move the widgets seen in the last UI_WIDGET_EVICT_FRAMES frames to a table
+   of the new size, which also drops the stale ones. Returns -1 and leaves the
+   table as is if it could not be allocated.
+ */
+INTERNAL i32 widgetTableRebuild(UiWidgetTable *const table, const i32 size,
+                                const u32 frame)
+{
+	UiWidgetTable newTable = {0};
+	newTable.size          = size;
+	newTable.widgets       = PLATFORM_MEM_ALLOC_(NULL, size, UiWidget);
+	if (!newTable.widgets) return -1;
+
+	for (i32 i = 0; i < table->size; i++)
+	{
+		UiWidget *widget = &table->widgets[i];
+		if (widget->inUse &&
+		    frame - widget->frameLastSeen <= UI_WIDGET_EVICT_FRAMES)
+		{
+			widgetTableInsert(&newTable, widget);
+		}
+	}
+
+	PLATFORM_MEM_FREE_(NULL, table->widgets, table->size * sizeof(UiWidget));
+	*table = newTable;
+	return 0;
+}
+
+INTERNAL void widgetTableFree(UiWidgetTable *const table)
+{
+	PLATFORM_MEM_FREE_(NULL, table->widgets, table->size * sizeof(UiWidget));
+	common_memset(CAST(u8 *) table, 0, sizeof(*table));
+}
+
+/* Retained state of the widget, created the first time the id is drawn */
+INTERNAL UiWidget *widgetGet(UiState *const uiState, const i32 id,
+                             const enum UiType type)
+{
+	UiWidgetTable *table = &uiState->widgetTable;
+	UiWidget *result     = widgetTableFind(table, id);
+	if (!result)
+	{
+		if ((table->count + 1) * 100 >
+		    table->size * UI_WIDGET_MAX_LOAD_PERCENT)
+		{
+			i32 newSize = MAX(table->size * 2, UI_WIDGET_TABLE_MIN_SIZE);
+			if (widgetTableRebuild(table, newSize, uiState->frame))
+			{
+				DEBUG_LOG("widgetGet() failed: Widget table could not grow");
+				common_memset(CAST(u8 *) & uiState->scratchWidget, 0,
+				              sizeof(uiState->scratchWidget));
+				uiState->scratchWidget.id   = id;
+				uiState->scratchWidget.type = type;
+				return &uiState->scratchWidget;
+			}
+		}
+
+		UiWidget widget = {0};
+		widget.id       = id;
+		widget.type     = type;
+		result          = widgetTableInsert(table, &widget);
+	}
+
+	result->frameLastSeen = uiState->frame;
+	return result;
+}
+
+/*
+   Offset of the label from the rect's min that centres it, measured again
+   only when the label, font or rect differ from the last time it was drawn
+ */
+INTERNAL v2 widgetLabelLayout(UiState *const uiState, UiWidget *const widget,
+                              const Font *const font, const Rect rect,
+                              const char *const label)
+{
+	i32 labelLen  = common_strlen(label);
+	u32 labelHash = common_murmurHash2(label, labelLen, RANDOM_SEED);
+	if (widget->font == font && widget->labelHash == labelHash &&
+	    widget->labelLen == labelLen && v2_equals(widget->rect.min, rect.min) &&
+	    v2_equals(widget->rect.max, rect.max))
+	{
+		uiState->numLabelCached++;
+		return widget->labelOffset;
+	}
+
+	widget->font      = font;
+	widget->labelHash = labelHash;
+	widget->labelLen  = labelLen;
+	widget->rect      = rect;
+	widget->labelDim  = asset_fontStringDimInPixels(font, label);
+
+	// Initially position the label to half the width of the button, then move
+	// it back half the length of the string (i.e. center it)
+	v2 rectSize    = math_rectGetSize(rect);
+	v2 labelDim    = widget->labelDim;
+	v2 labelOffset = V2((rectSize.w * 0.5f) - (labelDim.w * 0.5f), 0);
+	if (labelDim.h < rectSize.h)
+		labelOffset.y = (rectSize.h * 0.5f) - (labelDim.h * 0.5f);
+
+	widget->labelOffset = labelOffset;
+	uiState->numLabelMeasures++;
+	return labelOffset;
+}
+
+/*
+ *********************************
+ * Widgets
+ *********************************
+ */
+void ui_beginState(UiState *state)
+{
+	state->hotItem          = 0;
+	state->numLabelMeasures = 0;
+	state->numLabelCached   = 0;
+	state->frame++;
+}
+
+void ui_invalidateLayout(UiState *const uiState)
+{
+	UiWidgetTable *table = &uiState->widgetTable;
+	for (i32 i = 0; i < table->size; i++)
+		table->widgets[i].font = NULL;
+}
 
 void ui_endState(UiState *state, InputBuffer *input)
 {
@@ -23,6 +218,23 @@ void ui_endState(UiState *state, InputBuffer *input)
 
 	state->keyEntered = keycode_null;
 	state->keyChar    = keycode_null;
+
+	// NOTE(doyle): Drop the widgets of screens no longer drawn now and then,
+	// rebuilding at the same size so the table keeps its room
+	UiWidgetTable *table = &state->widgetTable;
+	if (table->count > 0 && (state->frame % UI_WIDGET_EVICT_FRAMES) == 0)
+	{
+		for (i32 i = 0; i < table->size; i++)
+		{
+			UiWidget *widget = &table->widgets[i];
+			if (widget->inUse &&
+			    state->frame - widget->frameLastSeen > UI_WIDGET_EVICT_FRAMES)
+			{
+				widgetTableRebuild(table, table->size, state->frame);
+				break;
+			}
+		}
+	}
 }
 
 i32 ui_button(UiState *const uiState, MemoryArena_ *const arena,
@@ -85,21 +297,10 @@ i32 ui_button(UiState *const uiState, MemoryArena_ *const arena,
 
 	if (label)
 	{
-		v2 labelDim = asset_fontStringDimInPixels(font, label);
-		v2 labelPos = rect.min;
-
-		// Initially position the label to half the width of the button
-		labelPos.x += (rectSize.w * 0.5f);
-
-		// Move the label pos back half the length of the string (i.e.
-		// center it)
-		labelPos.x -= (CAST(f32) labelDim.w * 0.5f);
-
-		if (labelDim.h < rectSize.h)
-		{
-			labelPos.y += (rectSize.h * 0.5f);
-			labelPos.y -= (CAST(f32) labelDim.h * 0.5f);
-		}
+		UiWidget *widget = widgetGet(uiState, id, uitype_button);
+		v2 labelOffset =
+		    widgetLabelLayout(uiState, widget, font, rect, label);
+		v2 labelPos = v2_add(rect.min, labelOffset);
 
 		// TODO(doyle): We're using odd colors to overcome z-sorting by forcing
 		// button text into another render group
@@ -354,3 +555,79 @@ i32 ui_textfield(UiState *const uiState, MemoryArena_ *const arena,
 	if (changed) return id;
 	return 0;
 }
+
+void ui_unitTest()
+{
+	LOCAL_PERSIST UiState uiState;
+	LOCAL_PERSIST CharMetrics charMetrics[96];
+	LOCAL_PERSIST i32 kerning[96];
+	common_memset(CAST(u8 *) & uiState, 0, sizeof(uiState));
+
+	Font font           = {0};
+	font.codepointRange = V2(32, 127);
+	font.charMetrics    = charMetrics;
+	font.numCharMetrics = ARRAY_COUNT(charMetrics);
+	for (i32 i = 0; i < ARRAY_COUNT(charMetrics); i++)
+	{
+		charMetrics[i].advance  = 9;
+		charMetrics[i].trueSize = V2(8, 12);
+		charMetrics[i].kerning  = kerning;
+	}
+
+	// NOTE(doyle): Anything followed by a 'p' is pulled in, labels are
+	// measured with the kerning they are drawn with
+	kerning['p' - 32] = -5;
+
+	{ // Widgets keep their state as the table grows past its first size
+		const i32 numWidgets = UI_WIDGET_TABLE_MIN_SIZE * 4;
+		ui_beginState(&uiState);
+		for (i32 id = 1; id <= numWidgets; id++)
+			widgetGet(&uiState, id, uitype_button)->labelLen = id;
+
+		UiWidgetTable *table = &uiState.widgetTable;
+		ASSERT(table->count == numWidgets);
+		ASSERT(table->count * 100 <= table->size * UI_WIDGET_MAX_LOAD_PERCENT);
+		for (i32 id = 1; id <= numWidgets; id++)
+			ASSERT(widgetTableFind(table, id)->labelLen == id);
+		ASSERT(widgetTableFind(table, numWidgets + 1) == NULL);
+	}
+
+	{ // Labels are measured once until the label or rect change
+		Rect rect   = math_rectCreate(V2(10, 10), V2(100, 20));
+		UiWidget *w = widgetGet(&uiState, 1, uitype_button);
+		w->font     = NULL;
+
+		uiState.numLabelMeasures = 0;
+		uiState.numLabelCached   = 0;
+		v2 offset = widgetLabelLayout(&uiState, w, &font, rect, "Apply");
+		ASSERT(v2_equals(offset, V2(32.5f, 4)));
+		ASSERT(v2_equals(w->labelDim, V2(35, 12)));
+
+		widgetLabelLayout(&uiState, w, &font, rect, "Apply");
+		ASSERT(uiState.numLabelMeasures == 1 && uiState.numLabelCached == 1);
+
+		widgetLabelLayout(&uiState, w, &font, rect, "Cancel");
+		rect = math_rectCreate(V2(10, 10), V2(120, 20));
+		widgetLabelLayout(&uiState, w, &font, rect, "Cancel");
+		ASSERT(uiState.numLabelMeasures == 3);
+
+		ui_invalidateLayout(&uiState);
+		widgetLabelLayout(&uiState, w, &font, rect, "Cancel");
+		ASSERT(uiState.numLabelMeasures == 4);
+	}
+
+	{ // Widgets not drawn for a while are dropped, the drawn ones stay
+		InputBuffer input = {0};
+		for (i32 frame = 0; frame < UI_WIDGET_EVICT_FRAMES * 2; frame++)
+		{
+			ui_beginState(&uiState);
+			widgetGet(&uiState, 7, uitype_button);
+			ui_endState(&uiState, &input);
+		}
+
+		ASSERT(uiState.widgetTable.count == 1);
+		ASSERT(widgetTableFind(&uiState.widgetTable, 7));
+	}
+
+	widgetTableFree(&uiState.widgetTable);
+}
@@ -26,10 +26,17 @@ REM Include directories
 set includeFlags=/I ..\src\include /I %GLEW%\include /I %GLFW%\include /I %STB%\include /I %OAL%\include
 
 REM Link libraries
-set linkLibraries=/link opengl32.lib %GLFW%\lib-vc2015\glfw3.lib %GLEW%\lib\Release\Win32\glew32s.lib %OAL%\lib\Win32\OpenAL32.lib gdi32.lib user32.lib shell32.lib
+set linkLibraries=/link opengl32.lib %GLFW%\lib-vc2015\glfw3.lib %GLEW%\lib\Release\Win32\glew32s.lib %OAL%\lib\Win32\OpenAL32.lib gdi32.lib user32.lib shell32.lib winmm.lib
 set ignoreLibraries=/NODEFAULTLIB:"libc.lib" /NODEFAULTLIB:"libcmt.lib" /NODEFAULTLIB:"libcd.lib" /NODEFAULTLIB:"libcmtd.lib" /NODEFAULTLIB:"msvcrtd.lib"
 
 cl %compileFlags%  ..\src\*.c %includeFlags% %linkLibraries% %ignoreLibraries% /OUT:"Dengine.exe"
 REM /SUBSYSTEM:CONSOLE
 
+REM Offline asset packer, run from the directory the game runs from to pack
+REM the data directory into data\assets.pack
+cl %compileFlags% ..\src\tools\AssetPacker.c ..\src\Common.c ..\src\MemoryArena.c ..\src\TexCompress.c /I ..\src\include /I %STB%\include /link /OUT:"AssetPacker.exe"
+
+REM Offline sprite sheet builder, e.g. AtlasBuilder data\sprites data\textures\sheet
+cl %compileFlags% ..\src\tools\AtlasBuilder.c ..\src\Common.c ..\src\MemoryArena.c ..\src\RectPack.c /I ..\src\include /I %STB%\include /link /OUT:"AtlasBuilder.exe"
+
 popd
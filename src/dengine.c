@@ -2,6 +2,7 @@
 #include "Dengine/Asteroid.h"
 #include "Dengine/Common.h"
 #include "Dengine/Debug.h"
+#include "Dengine/FramePacer.h"
 #include "Dengine/Math.h"
 #include "Dengine/MemoryArena.h"
 #include "Dengine/OpenGL.h"
@@ -107,11 +108,25 @@ INTERNAL void setGlfwWindowHints()
 	glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
 }
 
-i32 main(void)
+i32 main(i32 argc, char **argv)
 {
 
 #ifdef DENGINE_DEBUG
 	common_unitTest();
+	audio_mixerUnitTest();
+	ui_unitTest();
+	framepacer_unitTest();
+
+	{ // Asset tests need scratch memory, freed before the game allocates
+		MemoryIndex testSize = MEGABYTES(16);
+		u8 *testMemory       = PLATFORM_MEM_ALLOC_(NULL, testSize, u8);
+
+		MemoryArena_ testArena = {0};
+		memory_arenaInit(&testArena, testMemory, testSize);
+		asset_unitTest(&testArena);
+
+		PLATFORM_MEM_FREE_(NULL, testMemory, testSize);
+	}
 #endif
 
 	/*
@@ -277,23 +292,39 @@ i32 main(void)
 	 * GAME LOOP
 	 *******************
 	 */
-	f32 startTime      = CAST(f32)(glfwGetTime());
-	f32 secondsElapsed = 0.0f; // Time between current frame and last frame
+	FramePacer pacer = {0};
+	{ // Choose frame pacing, vsync by default
+		// NOTE(doyle): Fixed paces to the monitor's refresh rate without
+		// waiting on the swap, so it can tear
+		enum FramePaceMode paceMode = framepacemode_vsync;
+		for (i32 i = 1; i < argc; i++)
+		{
+			if (common_strcmp(argv[i], "-fixed") == 0)
+				paceMode = framepacemode_fixed;
+			else if (common_strcmp(argv[i], "-uncapped") == 0)
+				paceMode = framepacemode_uncapped;
+		}
 
-#if 0
-	// TODO(doyle): Get actual monitor refresh rate
-	f32 targetSecondsPerFrame = 1.0f / CAST(f32)(monitorRefreshHz);
-#else
-	// TODO(doyle): http://gafferongames.com/game-physics/fix-your-timestep/
-	// NOTE(doyle): Prevent glfwSwapBuffer until a vertical retrace has
-	// occurred, i.e. limit framerate to monitor refresh rate
-	glfwSwapInterval(1);
-#endif
+		const GLFWvidmode *videoMode =
+		    glfwGetVideoMode(glfwGetPrimaryMonitor());
+		f64 refreshHz = 60;
+		if (videoMode && videoMode->refreshRate > 0)
+			refreshHz = videoMode->refreshRate;
+
+		// TODO(doyle): http://gafferongames.com/game-physics/fix-your-timestep/
+		// NOTE(doyle): Vsync prevents glfwSwapBuffer until a vertical retrace
+		// has occurred, the other modes must not wait on it
+		glfwSwapInterval((paceMode == framepacemode_vsync) ? 1 : 0);
+		framepacer_init(&pacer, paceMode, refreshHz);
+	}
+
+	f32 secondsElapsed = 0.0f; // Time between current frame and last frame
 
 	while (!glfwWindowShouldClose(window))
 	{
 		/* Check and call events */
 		glfwPollEvents();
+		debug_phaseMark(debugphase_input);
 
 		/* Rendering commands here*/
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -305,18 +336,10 @@ i32 main(void)
 
 		/* Swap the buffers */
 		glfwSwapBuffers(window);
+		debug_phaseMark(debugphase_glFlush);
 
-		f32 endTime    = CAST(f32) glfwGetTime();
-		secondsElapsed = endTime - startTime;
-
-#if 0
-		// TODO(doyle): Busy waiting, should sleep
-		while (secondsElapsed < targetSecondsPerFrame)
-		{
-			endTime        = CAST(f32)(glfwGetTime());
-			secondsElapsed = endTime - startTime;
-		}
-#endif
+		secondsElapsed = CAST(f32) framepacer_endFrame(&pacer);
+		debug_frameEnd();
 
 		LOCAL_PERSIST f32 titleUpdateFrequencyInSeconds = 0.5f;
 
@@ -334,15 +357,15 @@ i32 main(void)
 
 			char textBuffer[256];
 			snprintf(textBuffer, ARRAY_COUNT(textBuffer),
-			         "Dengine | %f ms/f | %f fps | Entity Count: %d",
-			         msPerFrame, framesPerSecond, entityCount);
+			         "Dengine | %f ms/f | %f fps | %.2f ms dev | "
+			         "Entity Count: %d",
+			         msPerFrame, framesPerSecond, pacer.msFrameDeviation,
+			         entityCount);
 
 			glfwSetWindowTitle(window, textBuffer);
 			titleUpdateFrequencyInSeconds = 0.5f;
 		}
 
-		startTime = endTime;
-
 		StartMenuState *menuState =
 		    ASTEROID_GET_STATE_DATA(gameState, StartMenuState);
 		if (menuState)
@@ -360,6 +383,11 @@ i32 main(void)
 		}
 	}
 
+#ifdef DENGINE_DEBUG
+	audio_traceExport(&gameState->audioManager, "audio_trace.json");
+	debug_frameStatsExport("frame_stats.txt");
+#endif
+
 	glfwTerminate();
 	return 0;
 }
@@ -1,11 +1,192 @@
 #ifndef DENGINE_ASSET_MANAGER_H
 #define DENGINE_ASSET_MANAGER_H
 
+#include "Dengine/AssetPack.h"
 #include "Dengine/Assets.h"
+#include "Dengine/Platform.h"
 
 /* Forward declaration */
 typedef struct MemoryArena MemoryArena_;
-typedef struct PlatformFileRead PlatformFileRead;
+
+/*
+ *********************************
+ * Asynchronous Loading
+ *********************************
+ */
+/*
+   NOTE(doyle): File IO and decoding run on worker threads, the main thread
+   creates GPU resources for a bounded number of finished jobs per frame. Until
+   an asset is uploaded its compile time id resolves to a placeholder, the null
+   texture, a silent vorbis or an empty font.
+
+   Jobs live in a ring written only by the main thread, workers claim the next
+   job by compare and swap on the read index. Job indexes only ever increase
+   and are masked into the ring, so ASSET_LOAD_MAX_JOBS must be a power of 2.
+ */
+#define ASSET_LOAD_MAX_JOBS 64
+#define ASSET_LOAD_NUM_WORKERS 2
+#define ASSET_LOAD_UPLOADS_PER_FRAME 2
+
+// NOTE(doyle): Max run of queued jobs of one type a worker claims at once, the
+// file reads of a run are issued together through platform_readFileBatch
+#define ASSET_LOAD_BATCH_SIZE 16
+
+enum AssetLoadType
+{
+	assetloadtype_texture,
+	assetloadtype_audio,
+	assetloadtype_font,
+	assetloadtype_count,
+};
+
+/*
+   NOTE(doyle): Short sound effects are decoded to PCM once by the load workers
+   so playing them is a buffer upload. Long tracks keep only the compressed
+   file. Auto decodes clips up to ASSET_AUDIO_PCM_MAX_SECONDS long.
+ */
+#define ASSET_AUDIO_PCM_MAX_SECONDS 4.0f
+
+enum AudioDecode
+{
+	audiodecode_auto,
+	audiodecode_compressed,
+	audiodecode_pcm,
+	audiodecode_count,
+};
+
+typedef struct AudioLoadStat
+{
+	b32 loaded;
+	f32 lengthInSeconds;
+	i32 compressedSize;
+	i32 pcmSize;
+
+	// NOTE(doyle): Time to open the file and decode it to PCM on the worker
+	f32 decodeInMs;
+} AudioLoadStat;
+
+enum AssetLoadState
+{
+	assetloadstate_free,
+	assetloadstate_queued,
+	assetloadstate_decoding,
+	assetloadstate_decoded,
+	assetloadstate_failed,
+	assetloadstate_count,
+};
+
+typedef struct AssetLoadJob
+{
+	volatile i32 state;
+	enum AssetLoadType type;
+
+	// NOTE(doyle): Id in the TexList, AudioList or FontList of the type
+	i32 id;
+	char *path;
+	u64 keyHash;
+	i32 fontSize;
+	enum AudioDecode audioDecode;
+
+	/* Decoded by the worker, consumed by the upload */
+	u8 *pixels;
+	i32 width;
+	i32 height;
+	i32 bytesPerPixel;
+	AudioVorbis vorbis;
+
+	// NOTE(doyle): Non zero if pixels is a copy of a compressed texture file
+	i32 texFileSize;
+	f32 decodeInMs;
+} AssetLoadJob;
+
+typedef struct AssetLoadQueue
+{
+	AssetLoadJob jobs[ASSET_LOAD_MAX_JOBS];
+	volatile i32 nextJobToWrite;
+	volatile i32 nextJobToRead;
+	i32 nextJobToRetire;
+
+	/* Jobs pushed inside a load group, published on asset_loadGroupEnd */
+	b32 inGroup;
+	i32 numUnpublished;
+
+	PlatformSemaphore semaphore;
+	struct AssetLoadWorker *workers;
+	i32 numWorkers;
+} AssetLoadQueue;
+
+#define ASSET_MAX_SHEETS 8
+
+/*
+ *********************************
+ * Texture Residency
+ *********************************
+ */
+/*
+   NOTE(doyle): Textures loaded from a path count against a GPU memory budget.
+   While over budget the least recently used textures not drawn last frame are
+   deleted and reloaded from the pack or disk when next bound. Textures drawn
+   every frame are never evicted, the budget is exceeded instead of thrashing.
+ */
+#define ASSET_TEX_MAX_MANAGED 256
+#define ASSET_TEX_BUDGET_DEFAULT MEGABYTES(64)
+
+typedef struct TexResidency
+{
+	Texture *textures[ASSET_TEX_MAX_MANAGED];
+	i32 numTextures;
+
+	u32 budgetInBytes;
+	u32 residentInBytes;
+	u32 frame;
+
+	// NOTE(doyle): Reloads read through the transient arena of the frame
+	MemoryArena_ *scratchArena;
+
+	i32 numEvictions;
+	i32 numReloads;
+} TexResidency;
+
+/*
+ *********************************
+ * Hot Reload
+ *********************************
+ */
+/*
+   NOTE(doyle): Development only. Changed files under the watched directory are
+   collected as they are reported and rebuilt once they have settled, at the
+   frame boundary in asset_hotReloadUpdate. Entries are rebuilt in place so
+   pointers and GL program ids held by the game stay valid. Reloads read loose
+   files, skipping the asset pack, and leak their old data on the arenas.
+ */
+#define ASSET_HOT_RELOAD_MAX_PENDING 32
+#define ASSET_HOT_RELOAD_SETTLE_SECONDS 0.1f
+
+typedef struct AssetHotReloadPending
+{
+	char path[256];
+	f64 lastChangeTime;
+} AssetHotReloadPending;
+
+typedef struct AssetHotReload
+{
+	PlatformFileWatch watch;
+	b32 enabled;
+
+	// NOTE(doyle): Set while rebuilding so reads skip the asset pack
+	b32 reading;
+
+	AssetHotReloadPending pending[ASSET_HOT_RELOAD_MAX_PENDING];
+	i32 numPending;
+
+	/* Sources of entries that do not record their own path */
+	char *shaderPath[shaderlist_count][2];
+	char *sheetPath[ASSET_MAX_SHEETS];
+	i32 numSheetPaths;
+
+	i32 numReloads;
+	i32 numFailed;
+} AssetHotReload;
 
 typedef struct AssetManager
 {
@@ -17,21 +198,137 @@ typedef struct AssetManager
 
 	/* Primitive Array */
 	u32 shaders[shaderlist_count];
-	FontPack fontPack[4];
-	i32 fontPackIndex;
+	Texture *texList[texlist_count];
+	AudioVorbis *audioList[audiolist_count];
+	AudioLoadStat audioLoadStats[audiolist_count];
+	FontPack fontPack[fontlist_count];
+
+	/* Memory mapped asset pack, NULL header if no pack is open */
+	PlatformFileMap packMap;
+	AssetPackHeader *pack;
+	AssetPackEntry *packEntries;
+
+	/*
+	   Sprite sheets built offline by tools/AtlasBuilder.c, texture loads of a
+	   sprite packed in a sheet are remapped to its region of the sheet
+	 */
+	TexAtlas *sheets[ASSET_MAX_SHEETS];
+	i32 numSheets;
+
+	// NOTE(doyle): Region of the texture each id resolves to in pixels, min
+	// is the bottom left and max the size like a SubTexture rect
+	Rect texListRegion[texlist_count];
 
+	// NOTE(doyle): Sprite name of ids remapped into a sheet, to find the
+	// region again when the sheet is hot reloaded. NULL for other ids
+	char *texListSheetSprite[texlist_count];
+
+	/* Placeholders handed out until an asynchronous load is uploaded */
+	AudioVorbis silentVorbis;
+	TexAtlas emptyFontAtlas;
+	Font emptyFont;
+
+	AssetLoadQueue loadQueue;
+	TexResidency texResidency;
+	AssetHotReload hotReload;
 } AssetManager;
 
 #define MAX_TEXTURE_SIZE 1024
 
 void asset_init(AssetManager *assetManager, MemoryArena_ *arena);
 
+////////////////////////////////////////////////////////////////////////////////
+// Asset Pack
+////////////////////////////////////////////////////////////////////////////////
+// NOTE(doyle): Once a pack is open, asset loads look up their path in the pack
+// first and fall back to loose files in the data directory
+i32 asset_packOpen(AssetManager *const assetManager, const char *const path);
+void asset_packClose(AssetManager *const assetManager);
+
+// NOTE(doyle): file->buffer points into the read only mapping, no copy is made
+b32 asset_packGetFile(AssetManager *const assetManager,
+                      const char *const path, PlatformFileRead *const file);
+
+////////////////////////////////////////////////////////////////////////////////
+// Hot Reload
+////////////////////////////////////////////////////////////////////////////////
+// NOTE(doyle): Watch the directory tree the assets are loaded from, i.e. "data"
+i32 asset_hotReloadInit(AssetManager *const assetManager,
+                        const char *const directory);
+
+// NOTE(doyle): Call once a frame at the frame boundary, before rendering.
+// Returns the number of entries rebuilt
+i32 asset_hotReloadUpdate(AssetManager *const assetManager,
+                          MemoryArena_ *const persistentArena,
+                          MemoryArena_ *const transientArena);
+
+////////////////////////////////////////////////////////////////////////////////
+// Asynchronous Loading
+////////////////////////////////////////////////////////////////////////////////
+// NOTE(doyle): Starts the load workers, without them queued jobs are decoded
+// on the main thread in asset_loadQueueUpdate instead
+i32 asset_loadQueueInit(AssetManager *const assetManager,
+                        MemoryArena_ *const arena);
+
+// NOTE(doyle): Upload at most maxUploads finished jobs, call once a frame.
+// Returns the number of jobs still in flight
+i32 asset_loadQueueUpdate(AssetManager *const assetManager,
+                          MemoryArena_ *const persistentArena,
+                          MemoryArena_ *const transientArena,
+                          const i32 maxUploads);
+
+/*
+   NOTE(doyle): Requests made between begin and end are published to the
+   workers together, so their file reads can be batched into one submission
+ */
+void asset_loadGroupBegin(AssetManager *const assetManager);
+void asset_loadGroupEnd(AssetManager *const assetManager);
+
+/*
+   NOTE(doyle): Requests return immediately, the asset id resolves to its
+   placeholder until the load is uploaded. Returns -1 if the queue is full.
+ */
+i32 asset_texLoadAsync(AssetManager *const assetManager,
+                       MemoryArena_ *const arena, const char *const path,
+                       const enum TexList type);
+i32 asset_vorbisLoadAsync(AssetManager *const assetManager,
+                          MemoryArena_ *const arena, const char *const path,
+                          const char *const key, const enum AudioList type,
+                          const enum AudioDecode decode);
+i32 asset_fontLoadAsync(AssetManager *const assetManager,
+                        MemoryArena_ *const arena, const char *const path,
+                        const enum FontList type, const i32 size);
+
+/*
+   NOTE(doyle): Hash a key once for repeated lookups with the *FromHash
+   functions, which skip hashing and comparing the key string
+ */
+u64 asset_keyHash(const char *const key);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Texture Managing
 ////////////////////////////////////////////////////////////////////////////////
 const SubTexture asset_atlasGetSubTex(TexAtlas *const atlas,
                                       const char *const key);
-Texture *asset_texGet(AssetManager *const assetManager, const char *const key);
+
+// NOTE(doyle): Returns -1 if the key is not in the atlas
+i32 asset_atlasGetSubTexIndex(TexAtlas *const atlas, const char *const key);
+inline SubTexture asset_atlasGetSubTexFromIndex(TexAtlas *const atlas,
+                                                const i32 index)
+{
+	SubTexture result = {0};
+	if (index >= 0 && index < atlas->numSubTex)
+		result = atlas->subTexList[index];
+
+	return result;
+}
+
+Texture *asset_texGet(AssetManager *const assetManager,
+                      const enum TexList type);
+Rect asset_texGetRegion(AssetManager *const assetManager,
+                        const enum TexList type);
+Texture *asset_texGetByKey(AssetManager *const assetManager,
+                           const char *const key);
 TexAtlas *asset_atlasGetFreeSlot(AssetManager *const assetManager,
                                  MemoryArena_ *arena, const char *const key,
                                  i32 numSubTex);
@@ -42,6 +339,16 @@ Texture *asset_texGetFreeSlot(AssetManager *const assetManager,
 Texture *asset_texLoadImage(AssetManager *assetManager, MemoryArena_ *arena,
                             const char *const path, const char *const key);
 
+// NOTE(doyle): Call once a frame before rendering, evicts while over budget
+void asset_texResidencyUpdate(AssetManager *const assetManager,
+                              MemoryArena_ *const transientArena);
+void asset_texSetBudget(AssetManager *const assetManager,
+                        const u32 budgetInBytes);
+
+// NOTE(doyle): Marks the texture used this frame, call before binding it.
+// Evicted textures are reloaded synchronously.
+void asset_texUse(AssetManager *const assetManager, Texture *const tex);
+
 u8 *asset_imageLoad(i32 *width, i32 *height, i32 *bpp, const char *const path,
                     b32 flipVertically);
 
@@ -61,9 +368,16 @@ Animation *asset_animGet(AssetManager *const assetManager,
 // Audio
 ////////////////////////////////////////////////////////////////////////////////
 AudioVorbis *const asset_vorbisGet(AssetManager *const assetManager,
-                                   const char *const key);
+                                   const enum AudioList type);
+AudioVorbis *const asset_vorbisGetByKey(AssetManager *const assetManager,
+                                        const char *const key);
 const i32 asset_vorbisLoad(AssetManager *assetManager, MemoryArena_ *arena,
-                           const char *const path, const char *const key);
+                           const char *const path, const char *const key,
+                           const enum AudioList type,
+                           const enum AudioDecode decode);
+
+// NOTE(doyle): Print the length, memory and decode time of each loaded clip
+void asset_audioLoadReport(AssetManager *const assetManager);
 
 ////////////////////////////////////////////////////////////////////////////////
 // Everything else
@@ -72,6 +386,13 @@ const i32 asset_xmlLoad(AssetManager *const assetManager,
                         MemoryArena_ *const arena,
                         const PlatformFileRead *const fileRead);
 
+// NOTE(doyle): Load the xml and sheets written by tools/AtlasBuilder.c, load
+// sheets before the sprites they hold are requested through asset_texLoadAsync
+i32 asset_sheetLoad(AssetManager *const assetManager,
+                    MemoryArena_ *const persistentArena,
+                    MemoryArena_ *const transientArena,
+                    const char *const xmlPath);
+
 u32 asset_shaderGet(AssetManager *assetManager, const enum ShaderList type);
 const i32 asset_shaderLoad(AssetManager *assetManager, MemoryArena_ *arena,
                            const char *const vertexPath,
@@ -80,14 +401,42 @@ const i32 asset_shaderLoad(AssetManager *assetManager, MemoryArena_ *arena,
 
 Font *asset_fontGetOrCreateOnDemand(AssetManager *assetManager,
                                     MemoryArena_ *persistentArena,
-                                    MemoryArena_ *transientArena, char *name,
-                                    i32 size);
-Font *asset_fontGet(AssetManager *assetManager, char *name, i32 size);
+                                    MemoryArena_ *transientArena,
+                                    const enum FontList type, i32 size);
+Font *asset_fontGet(AssetManager *assetManager, const enum FontList type,
+                    i32 size);
 const i32 asset_fontLoadTTF(AssetManager *assetManager,
                             MemoryArena_ *persistentArena,
                             MemoryArena_ *transientArena, char *filePath,
-                            char *name, i32 targetFontHeight);
+                            const enum FontList type, i32 targetFontHeight);
+
+inline const CharMetrics *asset_fontGetCharMetrics(const Font *const font,
+                                                  const i32 codepoint)
+{
+	i32 relativeIndex = codepoint - CAST(i32) font->codepointRange.x;
+	if (relativeIndex < 0 || relativeIndex >= font->numCharMetrics)
+		return NULL;
+
+	const CharMetrics *result = &font->charMetrics[relativeIndex];
+	return result;
+}
+
+// NOTE(doyle): How far the pen moves past the glyph, kerned against the next
+// character of the string. Pass 0 for the last character
+inline i32 asset_fontPenAdvance(const Font *const font,
+                                const CharMetrics *const metric,
+                                const i32 nextCodepoint)
+{
+	i32 result    = metric->advance;
+	i32 nextIndex = nextCodepoint - CAST(i32) font->codepointRange.x;
+	if (nextCodepoint && nextIndex >= 0 && nextIndex < font->numCharMetrics)
+		result += metric->kerning[nextIndex];
+
+	return result;
+}
 
+// NOTE(doyle): Width is where the pen ends up, the same walk renderer_string
+// lays glyphs out with
 const v2 asset_fontStringDimInPixels(const Font *const font,
                                      const char *const string);
 
@@ -0,0 +1,63 @@
+#ifndef DENGINE_ASSET_PACK_H
+#define DENGINE_ASSET_PACK_H
+
+#include "Dengine/Common.h"
+
+/*
+   NOTE(doyle): Binary asset pack, built offline by tools/AssetPacker.c from
+   the data directory and memory mapped at startup. Assets are read in place
+   out of the mapping, no copies into the arenas.
+
+   Layout
+   AssetPackHeader
+   AssetPackEntry[numEntries] sorted by hash for binary search
+   Entry names, each null terminated
+   Entry data, each blob aligned to ASSET_PACK_ALIGNMENT and followed by a
+   null terminator (not counted in size) so text assets can be used directly
+ */
+#define ASSET_PACK_MAGIC 0x4B415044 // "DPAK"
+#define ASSET_PACK_VERSION 2
+#define ASSET_PACK_ALIGNMENT 64
+#define ASSET_PACK_DEFAULT_PATH "data/assets.pack"
+
+enum AssetPackType
+{
+	assetpacktype_unknown,
+	assetpacktype_shader,
+	assetpacktype_audio,
+	assetpacktype_font,
+	assetpacktype_texture,
+	assetpacktype_fontCache,
+	assetpacktype_count,
+};
+
+typedef struct AssetPackHeader
+{
+	u32 magic;
+	u32 version;
+	u32 numEntries;
+	u32 entryOffset;
+	u32 nameOffset;
+	u32 dataOffset;
+	u32 packSize;
+	u32 unused;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry
+{
+	// NOTE(doyle): common_murmurHash64A of the name with RANDOM_SEED, the same
+	// hash the asset manager uses for keys
+	u64 hash;
+
+	// NOTE(doyle): Offsets are from the start of the pack, name is the path
+	// relative to the executable's working directory with forward slashes
+	u32 nameOffset;
+	u32 nameLen;
+	u32 dataOffset;
+	u32 dataSize;
+
+	u32 type;
+	u32 unused;
+} AssetPackEntry;
+
+#endif
@@ -10,43 +10,45 @@
 /* Forward Declaration */
 typedef struct Texture Texture;
 
+enum ShaderList
+{
+	shaderlist_default,
+	shaderlist_default_no_tex,
+	shaderlist_sdf,
+	shaderlist_count,
+};
+
 /*
- *********************************
- * XML
- *********************************
+   NOTE(doyle): Compile time asset ids. Game code refers to assets by these ids
+   which index flat arrays in the asset manager, string keyed lookups are only
+   for data driven assets (atlases, animations) resolved on load, tools and
+   debug.
  */
-// TODO(doyle): We only expose this to for debug.h to print out xml trees
-typedef struct XmlAttribute
+enum TexList
 {
-	b32 init;
-	char *name;
-	char *value;
-
-	struct XmlAttribute *next;
-} XmlAttribute;
+	texlist_null,
+	texlist_count,
+};
 
-typedef struct XmlNode
+enum AudioList
 {
-	char *name;
-	XmlAttribute attribute;
-
-	// NOTE(doyle): Track if node has more children
-	b32 isClosed;
-
-	// NOTE(doyle): Direct child/parent
-	struct XmlNode *parent;
-	struct XmlNode *child;
-
-	// NOTE(doyle): Else all other nodes
-	struct XmlNode *next;
-} XmlNode;
-
+	audiolist_bang_large,
+	audiolist_bang_medium,
+	audiolist_bang_small,
+	audiolist_beat1,
+	audiolist_beat2,
+	audiolist_extra_ship,
+	audiolist_fire,
+	audiolist_saucer_big,
+	audiolist_saucer_small,
+	audiolist_thrust,
+	audiolist_count,
+};
 
-enum ShaderList
+enum FontList
 {
-	shaderlist_default,
-	shaderlist_default_no_tex,
-	shaderlist_count,
+	fontlist_arial,
+	fontlist_count,
 };
 
 /*
@@ -54,18 +56,33 @@ enum ShaderList
  * Hash Table
  *********************************
  */
+/*
+   NOTE(doyle): Flat open addressing table using robin hood probing. Entries
+   store the full 64 bit hash and key length so a probe only touches the key
+   string when the hashes already match. Callers that look up the same key
+   every frame can hash it once and look up by hash directly.
+
+   The table does not grow, size is rounded up to a power of two at init so
+   that the load factor stays under HASH_TABLE_MAX_LOAD_PERCENT.
+ */
+#define HASH_TABLE_MAX_LOAD_PERCENT 75
 typedef struct HashTableEntry
 {
-	void *data;
+	u64 hash;
 	char *key;
+	i32 keyLen;
 
-	void *next;
+	// NOTE(doyle): Number of slots this entry is from its ideal slot
+	i32 probeDist;
+
+	void *data;
 } HashTableEntry;
 
 typedef struct HashTable
 {
 	HashTableEntry *entries;
 	i32 size;
+	i32 count;
 } HashTable;
 
 /*
@@ -88,6 +105,11 @@ typedef struct AudioVorbis
 
 	u8 *data;
 	i32 size;
+
+	// NOTE(doyle): Interleaved samples of clips decoded on load, NULL if the
+	// clip is decoded from data when played
+	i16 *pcm;
+	i32 pcmSize;
 } AudioVorbis;
 
 /*
@@ -105,8 +127,12 @@ typedef struct TexAtlas
 {
 	Texture *tex;
 
+	// NOTE(doyle): Sub textures are stored flat, the hash table maps sub
+	// texture names to their index in the list
 	HashTable subTex;
+	SubTexture *subTexList;
 	i32 numSubTex;
+	i32 subTexCapacity;
 } TexAtlas;
 
 typedef struct Animation
@@ -119,6 +145,10 @@ typedef struct Animation
 	TexAtlas *atlas;
 	char **frameList;
 
+	// NOTE(doyle): Sub texture index of each frame in the atlas, resolved from
+	// frameList on load for the animation update and render
+	i32 *frameSubTexList;
+
 	i32 numFrames;
 	f32 frameDuration;
 } Animation;
@@ -149,6 +179,17 @@ typedef struct Texture
 	u32 filterMinification;
 	// Filtering mode if texture pixels > screen pixels
 	u32 filterMagnification;
+
+	// NOTE(doyle): Textures loaded from a path are managed by the residency
+	// budget, evicted textures have id 0 until reloaded by asset_texUse. Fonts
+	// and placeholders have no path and stay resident.
+	char *path;
+	u32 sizeInBytes;
+	u32 lastUsedFrame;
+
+	// NOTE(doyle): Set once hot reloaded, reloads after eviction then read the
+	// loose file that was edited rather than the stale copy in the pack
+	b32 loose;
 } Texture;
 
 /*
@@ -164,14 +205,25 @@ typedef struct FontMetrics
 	i32 lineGap;
 } FontMetrics;
 
+// NOTE(doyle): Per codepoint glyph record, text layout indexes these directly
 typedef struct CharMetrics
 {
 	i32 advance;
 	i32 leftSideBearing;
-	// TODO(doyle): Utilise kerning
+
+	// NOTE(doyle): Row of the font's kerning table, kerning[i] is the extra
+	// advance when the next character is codepointRange.x + i
 	i32 *kerning;
 	v2 offset;
 	v2 trueSize;
+
+	// NOTE(doyle): Glyph cell in the font's distance field atlas in pixels
+	Rect texRect;
+
+	// NOTE(doyle): The atlas cell scaled to this font size, the offset is from
+	// the pen x position and the text baseline to the bottom left of the quad
+	v2 quadOffset;
+	v2 quadSize;
 } CharMetrics;
 
 typedef struct Font
@@ -189,6 +241,7 @@ typedef struct Font
 	// NOTE(doyle): Array of character's by ASCII value starting from
 	// codepointRange and their metrics
 	CharMetrics *charMetrics;
+	i32 numCharMetrics;
 
 	i32 verticalSpacing;
 
@@ -196,12 +249,26 @@ typedef struct Font
 	v2 maxSize;
 } Font;
 
-// NOTE(doyle): A font pack is a singular font at different sizes
+/*
+   NOTE(doyle): A font pack is a singular font at different sizes. Glyphs are
+   rasterised once as a signed distance field into a single channel atlas
+   that every size samples from, so a new size only computes its metrics.
+ */
 typedef struct FontPack
 {
-	char *name;
 	char *filePath;
-	Font font[4];
+	u8 *ttfData;
+	i32 ttfSize;
+
+	TexAtlas *sdfAtlas;
+	Rect *sdfGlyphRect;
+	i32 numSdfGlyphs;
+
+	Font font[8];
 	i32 fontIndex;
+
+	// NOTE(doyle): Set while a load worker owns the pack, the main thread must
+	// not touch it until the atlas is uploaded
+	b32 loadQueued;
 } FontPack;
 #endif
@@ -52,10 +52,6 @@ typedef struct GameWorldState
 	b32 starFadeAway;
 	i32 numStarP;
 
-	// TODO(doyle): Audio mixing instead of multiple renderers
-	AudioRenderer *audioRenderer;
-	i32 numAudioRenderers;
-
 	f32 pixelsPerMeter;
 	Rect camera;
 	v2 size;
@@ -91,6 +87,8 @@ typedef struct StartMenuState
 typedef struct GameState
 {
 	b32 init;
+	b32 debugInit;
+	b32 audioReported;
 	enum AppState currState;
 	void *appStateData[appstate_count];
 
@@ -1,66 +1,214 @@
 #ifndef DENGINE_AUDIO_H
 #define DENGINE_AUDIO_H
 
-#include <OpenAL/al.h>
-
+#include "Dengine/AudioDevice.h"
+#include "Dengine/AudioMixer.h"
 #include "Dengine/Common.h"
+#include "Dengine/MemoryArena.h"
+
+/*
+   NOTE(doyle): Every sound is a voice of the software mixer, the mix is
+   handed to the audio device a block at a time as the device wants them.
+
+   The mixer, stb_vorbis and the device are only used on the audio thread. The
+   game thread owns the sound slots and sends commands through a single
+   producer, single consumer ring, slots come back through a second ring once
+   their voice has finished. Without a thread the audio update runs in
+   audio_update, unthrottled devices never get one so a headless run mixes the
+   same blocks for the same calls every time.
+ */
+#define AUDIO_THREAD_SLEEP_SECONDS 0.005
+
+#define AUDIO_MAX_SOUNDS AUDIO_MIXER_MAX_VOICES
+
+// NOTE(doyle): Indexes only ever increase and are masked into the ring, so the
+// size must be a power of 2
+#define AUDIO_COMMAND_RING_SIZE 256
+
+// NOTE(doyle): Blocks kept for the trace, about 95 seconds of audio. Also a
+// power of 2.
+#define AUDIO_TRACE_SIZE 4096
 
-/* Forward Declaration */
-typedef struct MemoryArena MemoryArena_;
+// NOTE(doyle): Seconds the high and low marks of the stats are kept over
+#define AUDIO_STATS_WINDOW_SECONDS 1.0
 
-#define AUDIO_NO_FREE_SOURCE -1
-typedef struct AudioSourceEntry
+// NOTE(doyle): Index of the sound slot in the low 16 bits, its generation
+// above, the same as a voice handle
+typedef i32 AudioSoundHandle;
+#define AUDIO_SOUND_INVALID -1
+
+enum AudioCommandType
 {
-	u32 id;
-	b32 isFree;
-} AudioSourceEntry;
+	audiocommand_play,
+	audiocommand_stop,
+	audiocommand_pause,
+	audiocommand_resume,
+	audiocommand_setGainPan,
+	audiocommand_count,
+};
 
-// TODO(doyle): Incorporate memory arena into managers?
-#define AUDIO_MAX_SOURCES 32
-typedef struct AudioManager
+typedef struct AudioCommand
 {
-	// NOTE(doyle): Source entries point to the next free index
-	AudioSourceEntry sourceList[AUDIO_MAX_SOURCES];
-} AudioManager;
+	enum AudioCommandType type;
+	i32 sound;
+
+	AudioVorbis *vorbis;
+	f32 gain;
+	f32 pan;
+	i32 numPlays;
+	enum AudioPriority priority;
+
+	// NOTE(doyle): When the game thread asked to play the sound
+	f64 timeRequested;
+} AudioCommand;
 
-enum AudioState
+typedef struct AudioCommandRing
 {
-	audiostate_stopped = 0,
-	audiostate_paused,
-	audiostate_playing,
-	audiostate_count,
-};
+	AudioCommand commands[AUDIO_COMMAND_RING_SIZE];
+	volatile i32 writeIndex;
+	volatile i32 readIndex;
+} AudioCommandRing;
 
-// TODO(doyle): Add object pool for assets, in particular audio
-#define AUDIO_REPEAT_INFINITE -10
-#define AUDIO_SOURCE_UNASSIGNED -1
-typedef struct AudioRenderer
+// NOTE(doyle): Never overflows, each slot is released once per play
+typedef struct AudioReleaseRing
 {
-	i32 sourceIndex;
-	ALuint bufferId[3];
+	i32 sounds[AUDIO_MAX_SOUNDS];
+	volatile i32 writeIndex;
+	volatile i32 readIndex;
+} AudioReleaseRing;
+
+typedef struct AudioSound
+{
+	AudioVorbis *vorbis;
+	u16 generation;
+	b32 inUse;
+	i32 nextFree;
+} AudioSound;
+
+// NOTE(doyle): Written by the audio thread only
+typedef struct AudioStats
+{
+	/* Totals since init */
+	volatile i32 numUnderruns;
+	volatile i32 numBlocksMixed;
+	volatile i32 numCommands;
+
+	// NOTE(doyle): Of the last block mixed
+	volatile i32 numVoicesAudible;
+	volatile i32 numVoicesVirtual;
+
+	// NOTE(doyle): Audio left in the device when it was last refilled, the
+	// lowest it got over the window and the blocks queued after the refill
+	volatile f32 msQueued;
+	volatile f32 msQueuedLow;
+	volatile i32 numBlocksQueued;
+
+	// NOTE(doyle): Time taken to mix a block, decoding included
+	volatile f32 msMix;
+	volatile f32 msMixHigh;
+
+	// NOTE(doyle): From audio_play to the first frame of the sound leaving the
+	// device, averaged over the sounds started in the last block
+	volatile f32 msPlayLatency;
+	volatile f32 msPlayLatencyHigh;
+} AudioStats;
 
-	AudioVorbis *audio;
-	ALuint format;
+// NOTE(doyle): Running marks of the stats' window and the plays waiting on
+// their first block, audio thread only
+typedef struct AudioMetrics
+{
+	f64 windowStart;
+	f32 msQueuedLow;
+	f32 msMixHigh;
+	f32 msPlayLatencyHigh;
+
+	i32 numPendingPlays;
+	f64 pendingRequestedSum;
+	f64 pendingRequestedOldest;
+} AudioMetrics;
+
+typedef struct AudioTraceBlock
+{
+	f64 time;
+
+	// NOTE(doyle): Audio queued ahead of the block when it was submitted
+	f32 msQueued;
+	f32 msMix;
+
+	// NOTE(doyle): Mean latency of the sounds starting in the block
+	f32 msPlayLatency;
 	i32 numPlays;
 
-	b32 isStreaming;
-	enum AudioState state;
-} AudioRenderer;
-
-
-const i32 audio_init(AudioManager *audioManager);
-const i32 audio_vorbisPlay(MemoryArena_ *arena, AudioManager *audioManager,
-                           AudioRenderer *audioRenderer, AudioVorbis *vorbis,
-                           i32 numPlays);
-const i32 audio_vorbisStream(MemoryArena_ *arena, AudioManager *audioManager,
-                                 AudioRenderer *audioRenderer,
-                                 AudioVorbis *vorbis, i32 numPlays);
-const i32 audio_vorbisStop(MemoryArena_ *arena, AudioManager *audioManager,
-                                 AudioRenderer *audioRenderer);
-const i32 audio_vorbisPause(AudioManager *audioManager,
-                                  AudioRenderer *audioRenderer);
-const i32 audio_vorbisResume(AudioManager *audioManager,
-                                   AudioRenderer *audioRenderer);
-const i32 audio_updateAndPlay(MemoryArena_ *arena, AudioManager *audioManager,
-                              AudioRenderer *audioRenderer);
+	i32 numUnderruns;
+	i32 numVoicesAudible;
+	i32 numVoicesVirtual;
+} AudioTraceBlock;
+
+// NOTE(doyle): Every block mixed, the oldest are overwritten
+typedef struct AudioTrace
+{
+	AudioTraceBlock blocks[AUDIO_TRACE_SIZE];
+	volatile i32 writeIndex;
+} AudioTrace;
+
+typedef struct AudioManager
+{
+	/* Game thread */
+	AudioSound sounds[AUDIO_MAX_SOUNDS];
+	i32 firstFreeSound;
+	i32 numCommandsDropped;
+
+	AudioCommandRing commandRing;
+	AudioReleaseRing releaseRing;
+
+	/* Audio thread */
+	AudioMixer mixer;
+	AudioVoiceHandle soundVoice[AUDIO_MAX_SOUNDS];
+
+	AudioDevice device;
+	i16 streamBuffer[AUDIO_DEVICE_BLOCK_FRAMES * AUDIO_MIXER_NUM_CHANNELS];
+
+	AudioStats stats;
+	AudioMetrics metrics;
+	AudioTrace trace;
+	b32 deviceOpened;
+	b32 threadRunning;
+} AudioManager;
+
+// NOTE(doyle): Falls back to the null sink if OpenAL has no device
+const i32 audio_init(AudioManager *audioManager, MemoryArena_ *arena,
+                     const AudioDeviceConfig *const deviceConfig);
+
+/*
+   NOTE(doyle): Returns AUDIO_SOUND_INVALID if no slot is free or the ring is
+   full. The sound may still fail to play, i.e. the clip is still loading.
+   Under load the lowest priority sounds are the ones that go unheard.
+ */
+AudioSoundHandle audio_play(AudioManager *const audioManager,
+                            AudioVorbis *const vorbis, const f32 gain,
+                            const f32 pan, const i32 numPlays,
+                            const enum AudioPriority priority);
+void audio_stop(AudioManager *const audioManager,
+                const AudioSoundHandle sound);
+void audio_pause(AudioManager *const audioManager,
+                 const AudioSoundHandle sound);
+void audio_resume(AudioManager *const audioManager,
+                  const AudioSoundHandle sound);
+void audio_setGainPan(AudioManager *const audioManager,
+                      const AudioSoundHandle sound, const f32 gain,
+                      const f32 pan);
+
+// NOTE(doyle): Sounds of the clip requested and not yet finished
+i32 audio_numPlaying(AudioManager *const audioManager,
+                     const AudioVorbis *const vorbis);
+
+// NOTE(doyle): Reclaim finished sounds, call once a frame
+const i32 audio_update(AudioManager *const audioManager);
+
+/*
+   NOTE(doyle): Write the blocks in the trace as Chrome trace event counters,
+   open the file in chrome://tracing. Safe while the audio thread runs, the
+   blocks it may be overwriting are left out.
+ */
+i32 audio_traceExport(AudioManager *const audioManager, const char *path);
 #endif
@@ -0,0 +1,77 @@
+#ifndef DENGINE_AUDIO_DEVICE_H
+#define DENGINE_AUDIO_DEVICE_H
+
+#include <OpenAL/al.h>
+#include <OpenAL/alc.h>
+
+#include "Dengine/AudioMixer.h"
+#include "Dengine/Common.h"
+#include "Dengine/Platform.h"
+
+/*
+   NOTE(doyle): Output for the mix, taken in blocks of AUDIO_DEVICE_BLOCK_FRAMES
+   interleaved stereo 16 bit frames at the mixer's sample rate. At most
+   AUDIO_DEVICE_NUM_BLOCKS are queued, which is the latency of the stream.
+
+   OpenAL plays the blocks through one source. The null sink discards them and
+   the WAV sink writes them to a file, neither needs sound hardware. Sinks
+   either consume at real time like a device would, or unthrottled want a full
+   queue every time they are asked so a headless run mixes as fast as it can.
+ */
+#define AUDIO_DEVICE_BLOCK_FRAMES 1024
+#define AUDIO_DEVICE_NUM_BLOCKS 4
+
+enum AudioDeviceType
+{
+	audiodevice_openal,
+	audiodevice_null,
+	audiodevice_wav,
+	audiodevice_count,
+};
+
+typedef struct AudioDeviceConfig
+{
+	enum AudioDeviceType type;
+	b32 unthrottled;
+
+	// NOTE(doyle): File the WAV sink writes, overwritten if it exists
+	const char *wavPath;
+} AudioDeviceConfig;
+
+typedef struct AudioDevice
+{
+	AudioDeviceConfig config;
+	i32 numUnderruns;
+
+	// NOTE(doyle): Frames left to play, measured when the device was last
+	// asked for blocks and counting the blocks submitted since
+	i32 numFramesQueued;
+
+	/* OpenAL */
+	ALCdevice *deviceAL;
+	ALCcontext *contextAL;
+	u32 sourceId;
+	ALuint bufferId[AUDIO_DEVICE_NUM_BLOCKS];
+	ALuint freeBuffers[AUDIO_DEVICE_NUM_BLOCKS];
+	i32 numFreeBuffers;
+	b32 sourceStarted;
+
+	/* Sinks */
+	f64 clockStart;
+	i32 numFramesSubmitted;
+
+	// NOTE(doyle): The header is patched after every block so a capture cut
+	// short by the program exiting is still a valid file
+	PlatformFileWrite wavFile;
+	i32 wavDataSize;
+} AudioDevice;
+
+i32 audio_deviceOpen(AudioDevice *const device,
+                     const AudioDeviceConfig *const config);
+
+// NOTE(doyle): Blocks the device can take without overrunning its queue
+i32 audio_deviceNumBlocksWanted(AudioDevice *const device);
+void audio_deviceSubmit(AudioDevice *const device, const i16 *const block);
+void audio_deviceClose(AudioDevice *const device);
+
+#endif
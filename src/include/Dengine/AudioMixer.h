@@ -0,0 +1,174 @@
+#ifndef DENGINE_AUDIO_MIXER_H
+#define DENGINE_AUDIO_MIXER_H
+
+#include "Dengine/Assets.h"
+#include "Dengine/Common.h"
+#include "Dengine/MemoryArena.h"
+
+/*
+   NOTE(doyle): Software mixer, every playing sound is a voice summed into one
+   stereo float buffer which is converted to 16 bit for the output stream.
+   Clips decoded to PCM on load are read in place, compressed clips decode
+   through a stb_vorbis stream owned by the voice.
+
+   Voices are virtual, only the AUDIO_MIXER_MAX_AUDIBLE most important are
+   mixed each block. The rest only advance their position so they come back
+   in time once there is room for them. Compressed voices hold a stream while
+   audible only, decoding into one of AUDIO_MIXER_MAX_STREAMS blocks of memory
+   reserved on init.
+
+   Clips at another sample rate are resampled to the mixer's with a windowed
+   sinc. The filter of each rate is built the first time a clip of it plays.
+   No OpenAL or platform calls, the caller hands the output to the device.
+ */
+#define AUDIO_MIXER_MAX_VOICES 512
+#define AUDIO_MIXER_MAX_AUDIBLE 32
+#define AUDIO_MIXER_MAX_STREAMS 8
+#define AUDIO_MIXER_STREAM_MEMORY KILOBYTES(256)
+#define AUDIO_MIXER_SAMPLE_RATE 44100
+#define AUDIO_MIXER_NUM_CHANNELS 2
+
+// NOTE(doyle): Max frames produced by one call to audio_mixerMix
+#define AUDIO_MIXER_MAX_FRAMES 1024
+
+#define AUDIO_REPEAT_INFINITE -10
+
+#define AUDIO_RESAMPLE_TAPS 32
+#define AUDIO_RESAMPLE_PHASE_BITS 7
+#define AUDIO_RESAMPLE_PHASES (1 << AUDIO_RESAMPLE_PHASE_BITS)
+#define AUDIO_RESAMPLE_MAX_RATES 4
+
+// NOTE(doyle): Clips can be at most this many times the mixer's rate
+#define AUDIO_RESAMPLE_MAX_RATIO 4
+#define AUDIO_RESAMPLE_MAX_INPUT_FRAMES                                        \
+	((AUDIO_MIXER_MAX_FRAMES * AUDIO_RESAMPLE_MAX_RATIO) +                     \
+	 AUDIO_RESAMPLE_TAPS + 1)
+
+// NOTE(doyle): Index of the voice in the low 16 bits, its generation above so
+// a handle to a finished voice does not touch the sound reusing the slot
+typedef i32 AudioVoiceHandle;
+#define AUDIO_VOICE_INVALID -1
+
+// NOTE(doyle): Ranks before gain when choosing the voices to mix
+enum AudioPriority
+{
+	audiopriority_low,
+	audiopriority_normal,
+	audiopriority_high,
+	audiopriority_count,
+};
+
+typedef struct AudioResampler
+{
+	i32 sampleRate;
+
+	// NOTE(doyle): Source frames per mixed frame, 32.32 fixed point
+	u64 step;
+
+	// NOTE(doyle): Taps of each phase, plus the first phase of the next frame
+	// to blend towards
+	f32 filter[(AUDIO_RESAMPLE_PHASES + 1) * AUDIO_RESAMPLE_TAPS];
+} AudioResampler;
+
+typedef struct AudioVoice
+{
+	AudioVorbis *audio;
+	stb_vorbis *stream;
+
+	// NOTE(doyle): Block of stream memory the stream decodes into, -1 if it
+	// was allocated by stb_vorbis
+	i32 streamIndex;
+
+	// NOTE(doyle): Frame of the clip to mix next
+	i32 position;
+	i32 numPlays;
+
+	f32 gain;
+	f32 pan;
+	enum AudioPriority priority;
+
+	// NOTE(doyle): Index of the resampler, -1 for clips at the mixer's rate.
+	// History holds the taps around the current source frame, the source has
+	// been read up to the end of it.
+	i32 resampler;
+	u32 resampleFrac;
+	b32 resamplePrimed;
+	b32 sourceEnded;
+	i32 numTailFrames;
+	i16 resampleHistory[AUDIO_RESAMPLE_TAPS * AUDIO_MIXER_NUM_CHANNELS];
+
+	u16 generation;
+	b32 active;
+	b32 paused;
+	b32 audible;
+
+	// NOTE(doyle): Index in the mixer's active list or next free voice
+	i32 activeIndex;
+	i32 nextFree;
+} AudioVoice;
+
+typedef struct AudioMixer
+{
+	AudioVoice voices[AUDIO_MIXER_MAX_VOICES];
+	i32 firstFreeVoice;
+
+	// NOTE(doyle): Packed indexes of the playing voices
+	i32 activeVoices[AUDIO_MIXER_MAX_VOICES];
+	i32 numActive;
+	f32 masterGain;
+
+	u8 *streamMemory;
+	i32 freeStreams[AUDIO_MIXER_MAX_STREAMS];
+	i32 numFreeStreams;
+
+	// NOTE(doyle): Voices mixed and skipped in the last block
+	i32 numAudible;
+	i32 numVirtual;
+
+	AudioResampler resamplers[AUDIO_RESAMPLE_MAX_RATES];
+	i32 numResamplers;
+
+	f32 mixBuffer[AUDIO_MIXER_MAX_FRAMES * AUDIO_MIXER_NUM_CHANNELS];
+	i16 decodeBuffer[AUDIO_MIXER_MAX_FRAMES * AUDIO_MIXER_NUM_CHANNELS];
+
+	i16 resampleInput[AUDIO_RESAMPLE_MAX_INPUT_FRAMES *
+	                  AUDIO_MIXER_NUM_CHANNELS];
+	f32 resampleWork[AUDIO_MIXER_NUM_CHANNELS]
+	                [AUDIO_RESAMPLE_MAX_INPUT_FRAMES];
+} AudioMixer;
+
+// NOTE(doyle): Stream memory is pushed on the arena, without one compressed
+// voices let stb_vorbis allocate
+void audio_mixerInit(AudioMixer *const mixer, MemoryArena_ *const arena);
+
+/*
+   NOTE(doyle): Gain is linear, pan ranges from -1 (left) to 1 (right). Returns
+   AUDIO_VOICE_INVALID if the clip has no data, every voice is busy or its
+   sample rate is unsupported.
+ */
+AudioVoiceHandle audio_mixerPlay(AudioMixer *const mixer,
+                                 AudioVorbis *const audio, const f32 gain,
+                                 const f32 pan, const i32 numPlays,
+                                 const enum AudioPriority priority);
+void audio_mixerStop(AudioMixer *const mixer, const AudioVoiceHandle handle);
+void audio_mixerSetGainPan(AudioMixer *const mixer,
+                           const AudioVoiceHandle handle, const f32 gain,
+                           const f32 pan);
+void audio_mixerSetPaused(AudioMixer *const mixer,
+                          const AudioVoiceHandle handle, const b32 paused);
+
+// NOTE(doyle): False once the voice has finished or was stopped
+b32 audio_mixerIsPlaying(AudioMixer *const mixer,
+                         const AudioVoiceHandle handle);
+
+// NOTE(doyle): Number of voices playing the clip
+i32 audio_mixerNumPlaying(const AudioMixer *const mixer,
+                          const AudioVorbis *const audio);
+
+// NOTE(doyle): Mix numFrames of interleaved stereo into out
+void audio_mixerMix(AudioMixer *const mixer, i16 *const out,
+                    const i32 numFrames);
+
+void audio_mixerUnitTest();
+
+#endif
@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 typedef uint8_t u8;
+typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
 
@@ -81,6 +82,7 @@ void common_strncat(char *dest, const char *src, i32 numChars);
 char *common_strncpy(char *dest, const char *src, i32 numChars);
 
 u8 *common_memset(u8 *const ptr, const i32 value, const i32 numBytes);
+u8 *common_memcpy(u8 *const dest, const u8 *const src, const i32 numBytes);
 
 // Max buffer size should be 11 for 32 bit integers
 #define COMMON_ITOA_MAX_BUFFER_32BIT 11
@@ -145,6 +147,7 @@ inline void common_unitTest()
 // 2. It will not produce the same results on little-endian and big-endian
 //    machines.
 u32 common_murmurHash2(const void *key, i32 len, u32 seed);
+u64 common_murmurHash64A(const void *key, i32 len, u64 seed);
 
 // TODO(doyle): Use a proper random seed
 #define RANDOM_SEED 0xDEADBEEF
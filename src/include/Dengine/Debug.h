@@ -17,13 +17,36 @@ enum DebugCount
 	debugcount_platformMemFree,
 	debugcount_numVertex,
 	debugcount_renderGroups,
+	debugcount_assetStringLookup,
 	debugcount_num,
 };
 
-void debug_init(v2 windowSize, Font font);
+/*
+   NOTE(doyle): Frame times are split into phases by marking the end of each
+   phase as the frame runs, the time the frame pacer waits only counts towards
+   the whole frame. Every phase is kept in a log-linear histogram of the last
+   DEBUG_FRAME_WINDOW frames and another of the whole run, accurate to 1 part
+   in 2^DEBUG_HISTOGRAM_SUB_BITS.
 
-#define DEBUG_RECURSIVE_PRINT_XML_TREE(sig) debug_recursivePrintXmlTree(sig, 1)
-void debug_recursivePrintXmlTree(XmlNode *root, i32 levelsDeep);
+   A frame over DEBUG_HITCH_MIN_MS and twice the recent median is a hitch, its
+   phase times and debug counters are kept for the overlay and the summary.
+ */
+#define DEBUG_FRAME_WINDOW 600
+#define DEBUG_HISTOGRAM_SUB_BITS 7
+#define DEBUG_HITCH_MIN_MS 25.0f
+#define DEBUG_MAX_HITCHES 32
+
+enum DebugPhase
+{
+	debugphase_input,
+	debugphase_simulate,
+	debugphase_render,
+	debugphase_glFlush,
+	debugphase_frame,
+	debugphase_num,
+};
+
+void debug_init(v2 windowSize, Font font);
 
 void debug_countIncrement(enum DebugCount id);
 
@@ -37,4 +60,13 @@ void debug_pushString(char *formatString, void *data, char *dataType);
 
 void debug_drawUi(GameState *state, f32 dt);
 
+// NOTE(doyle): The time since the last mark is added to the phase
+void debug_phaseMark(enum DebugPhase phase);
+
+// NOTE(doyle): Call once the frame has been paced, starts the next frame
+void debug_frameEnd();
+
+// NOTE(doyle): Percentiles of the whole run and the hitches as text
+i32 debug_frameStatsExport(const char *path);
+
 #endif
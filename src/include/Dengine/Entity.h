@@ -5,7 +5,6 @@
 #include "Dengine/Common.h"
 #include "Dengine/Renderer.h"
 
-typedef struct AudioRenderer AudioRenderer;
 typedef struct MemoryArena_ MemoryArena;
 
 enum Direction
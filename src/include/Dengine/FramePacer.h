@@ -0,0 +1,65 @@
+#ifndef DENGINE_FRAME_PACER_H
+#define DENGINE_FRAME_PACER_H
+
+#include "Dengine/Common.h"
+
+/*
+   NOTE(doyle): Ends each frame of the main loop. In fixed mode the rest of the
+   frame's budget is slept off, waking early by how much the OS has been
+   overshooting sleeps and spinning on the timer for what is left. Uncapped
+   and vsync modes don't wait, vsync leaves it to the buffer swap.
+
+   Overshoot is learnt from every sleep as a running mean and deviation,
+   so a coarse OS timer just means more of the wait is spun.
+ */
+#define FRAME_PACER_HISTORY 120
+
+// NOTE(doyle): Always spun, about what a thread takes to be scheduled again
+#define FRAME_PACER_SPIN_SECONDS 0.0002
+
+enum FramePaceMode
+{
+	framepacemode_uncapped,
+	framepacemode_fixed,
+	framepacemode_vsync,
+	framepacemode_count,
+};
+
+typedef struct FramePacer
+{
+	enum FramePaceMode mode;
+	f64 targetSecondsPerFrame;
+
+	// NOTE(doyle): Deadlines are a frame apart from the last one so waking
+	// late doesn't drift the cadence, unless the frame ran a whole frame over
+	f64 frameStart;
+	f64 lastFrameEnd;
+
+	f64 overshootMean;
+	f64 overshootDeviation;
+
+	f32 msFrameHistory[FRAME_PACER_HISTORY];
+	i32 historyIndex;
+	i32 historySize;
+
+	/* Stats, of the last frame or the frames in the history */
+	f32 msWorked;
+	f32 msSlept;
+	f32 msSpun;
+	f32 msFrameMean;
+	f32 msFrameDeviation;
+	f32 msFrameMax;
+	i32 numMissedFrames;
+} FramePacer;
+
+// NOTE(doyle): Target rate is only used in fixed mode
+void framepacer_init(FramePacer *const pacer, const enum FramePaceMode mode,
+                     const f64 targetHz);
+
+// NOTE(doyle): Waits out the frame in fixed mode, returns the seconds between
+// the end of the last frame and this one
+f64 framepacer_endFrame(FramePacer *const pacer);
+
+void framepacer_unitTest();
+
+#endif
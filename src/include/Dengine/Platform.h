@@ -153,8 +153,23 @@ typedef struct PlatformFileRead
 {
 	void *buffer;
 	i32 size;
+
+	// NOTE(doyle): Buffer is a read only file mapping instead of arena memory,
+	// platform_closeFileRead releases it
+	b32 isMapped;
 } PlatformFileRead;
 
+// NOTE(doyle): Read only memory mapping of a whole file, handles are platform
+// specific and only used to unmap
+typedef struct PlatformFileMap
+{
+	void *base;
+	i32 size;
+
+	void *fileHandle;
+	void *mapHandle;
+} PlatformFileMap;
+
 // TODO(doyle): Create own custom memory allocator
 #define PLATFORM_MEM_FREE_(arena, ptr, bytes)                                  \
 	platform_memoryFree(arena, CAST(void *) ptr, bytes)
@@ -171,6 +186,107 @@ void platform_closeFileRead(MemoryArena_ *arena, PlatformFileRead *file);
 i32 platform_readFileToBuffer(MemoryArena_ *arena, const char *const filePath,
                               PlatformFileRead *file);
 
+/*
+   NOTE(doyle): Reads a group of files with all reads in flight at once,
+   io_uring on Linux with a pread thread pool fallback. Buffers are pushed on
+   the arena by the calling thread before any read is issued. The callback
+   runs on the calling thread as each read completes, in completion order,
+   result is 0 on success. Returns the number of files that failed.
+
+   The reader holds the io_uring so it is set up once rather than per batch,
+   one reader per thread that reads, kept for the life of the thread. A reader
+   whose ring could not be created or has failed reads with the pool.
+ */
+typedef struct PlatformFileReader
+{
+	void *handle;
+} PlatformFileReader;
+
+typedef void PlatformReadCallback(void *userData, i32 index,
+                                  PlatformFileRead *file, i32 result);
+#define PLATFORM_READ_BATCH_MAX 64
+void platform_fileReaderInit(PlatformFileReader *reader);
+i32 platform_readFileBatch(PlatformFileReader *reader, MemoryArena_ *arena,
+                           const char *const *filePaths,
+                           PlatformFileRead *files, i32 numFiles,
+                           PlatformReadCallback *callback, void *userData);
+
+// NOTE(doyle): Creates or overwrites the file with the buffer contents
+i32 platform_writeBufferToFile(const char *const filePath,
+                               const void *const buffer, const i32 size);
+
+/*
+   NOTE(doyle): File written a piece at a time, i.e. a capture whose size is not
+   known up front. Writes append, writing at an offset is for patching a header
+   already written.
+ */
+typedef struct PlatformFileWrite
+{
+	void *handle;
+	b32 isOpen;
+} PlatformFileWrite;
+
+i32 platform_fileWriteOpen(PlatformFileWrite *file,
+                           const char *const filePath);
+i32 platform_fileWrite(PlatformFileWrite *file, const void *const buffer,
+                       const i32 size);
+i32 platform_fileWriteAt(PlatformFileWrite *file, const i32 offset,
+                         const void *const buffer, const i32 size);
+void platform_fileWriteClose(PlatformFileWrite *file);
+
+i32 platform_mapFile(const char *const filePath, PlatformFileMap *map);
+void platform_unmapFile(PlatformFileMap *map);
+
+// NOTE(doyle): High resolution monotonic timer, arbitrary epoch
+f64 platform_getTimeInSeconds();
+
+// NOTE(doyle): Sleeps at least the duration, granularity is OS dependent and
+// is around a millisecond on Windows
+void platform_sleep(f64 seconds);
+
+/*
+   NOTE(doyle): Watches a directory tree for files that finished being written
+   or were moved in, inotify on Linux and ReadDirectoryChangesW on Windows.
+   Polling never blocks. Changed paths are joined to the watched directory with
+   forward slashes, i.e. "data/shaders/sdf.frag.glsl". A save can report the
+   same file more than once.
+ */
+typedef struct PlatformFileWatch
+{
+	void *handle;
+} PlatformFileWatch;
+
+typedef void PlatformFileChangedCallback(void *userData,
+                                         const char *const path);
+i32 platform_fileWatchInit(PlatformFileWatch *watch,
+                           const char *const directory);
+void platform_fileWatchPoll(PlatformFileWatch *watch,
+                            PlatformFileChangedCallback *callback,
+                            void *userData);
+void platform_fileWatchClose(PlatformFileWatch *watch);
+
+/*
+   NOTE(doyle): Minimal threading for background work. Threads run detached
+   for the lifetime of the program. The atomics are full memory barriers and
+   return the value in dest before the operation.
+ */
+typedef void PlatformThreadProc(void *userData);
+i32 platform_threadCreate(PlatformThreadProc *proc, void *userData);
+
+typedef struct PlatformSemaphore
+{
+	void *handle;
+} PlatformSemaphore;
+
+i32 platform_semaphoreInit(PlatformSemaphore *semaphore, i32 initialCount,
+                           i32 maxCount);
+void platform_semaphoreWait(PlatformSemaphore *semaphore);
+void platform_semaphoreRelease(PlatformSemaphore *semaphore, i32 count);
+
+i32 platform_atomicCompareSwap(volatile i32 *dest, i32 swapValue,
+                               i32 compareValue);
+i32 platform_atomicAdd(volatile i32 *dest, i32 value);
+
 /*
    NOTE(doyle): The keyinput functions are technically not for "communicating to
    the platform layer", but I've decided to group it here alongside the input
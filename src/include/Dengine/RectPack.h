@@ -0,0 +1,81 @@
+#ifndef DENGINE_RECT_PACK_H
+#define DENGINE_RECT_PACK_H
+
+#include "Dengine/Common.h"
+#include "Dengine/Math.h"
+
+/* Forward Declaration */
+typedef struct MemoryArena MemoryArena_;
+
+/*
+   NOTE(doyle): Skyline bottom-left rectangle packer. The skyline is the top
+   edge of everything packed so far, stored as horizontal segments from left to
+   right. New rects are placed on the segment that keeps them lowest, so
+   differently sized rects (glyphs, sprites) pack tightly into an atlas.
+ */
+typedef struct RectPackNode
+{
+	i32 x;
+	i32 y;
+	i32 width;
+} RectPackNode;
+
+typedef struct RectPack
+{
+	RectPackNode *nodes;
+	i32 numNodes;
+	i32 maxNodes;
+
+	i32 width;
+	i32 height;
+
+	// NOTE(doyle): Highest point of the skyline, i.e. the atlas height in use
+	i32 usedHeight;
+} RectPack;
+
+void rectpack_init(RectPack *const pack, MemoryArena_ *const arena,
+                   const i32 width, const i32 height);
+
+// NOTE(doyle): Returns FALSE if the rect does not fit, pos is the bottom left
+// (lowest x, y) corner of the packed rect
+b32 rectpack_insert(RectPack *const pack, const i32 width, const i32 height,
+                    v2 *const pos);
+
+/*
+   NOTE(doyle): MaxRects packer, tracks every maximal free rectangle left in
+   the pack and places each rect in the free rect it fits most snugly (best
+   short side fit). Slower than the skyline since the free list is split and
+   pruned on each insert, but it packs sprites of mixed sizes tighter, so it
+   is used for offline sprite sheets where pack time does not matter.
+ */
+typedef struct RectPackFree
+{
+	i32 x;
+	i32 y;
+	i32 width;
+	i32 height;
+} RectPackFree;
+
+typedef struct RectPackMax
+{
+	RectPackFree *freeRects;
+	i32 numFreeRects;
+	i32 maxFreeRects;
+
+	i32 width;
+	i32 height;
+	i32 usedArea;
+} RectPackMax;
+
+// NOTE(doyle): maxFreeRects bounds the free list, an insert that would need
+// more fails. A few per rect to be packed is plenty in practice
+void rectpack_maxInit(RectPackMax *const pack, MemoryArena_ *const arena,
+                      const i32 width, const i32 height,
+                      const i32 maxFreeRects);
+
+// NOTE(doyle): Returns FALSE if the rect does not fit, pos is the lowest x, y
+// corner of the packed rect
+b32 rectpack_maxInsert(RectPackMax *const pack, const i32 width,
+                       const i32 height, v2 *const pos);
+
+#endif
@@ -28,6 +28,7 @@ typedef u32 RenderFlags;
 enum RenderFlag {
 	renderflag_wireframe = 0x1,
 	renderflag_no_texture = 0x2,
+	renderflag_sdf = 0x4,
 };
 
 // TODO(doyle): Since all vertexes are built with degenerate vertices and
@@ -60,6 +61,106 @@ typedef struct RenderGroup
 
 } RenderGroup;
 
+/*
+   NOTE(doyle): Vertexes of a piece of screen space UI are tessellated once and
+   replayed into the render groups each frame until the content hash the
+   caller gives for it changes. Batches recorded back to back with the same
+   group state are joined into one run, so replaying a string is one group
+   lookup rather than one per glyph.
+
+   Vertexes of stale recordings are only reclaimed by clearing the whole
+   cache, which happens once it fills past three quarters, and on resize or
+   hot reload since the recorded positions and glyphs depend on them.
+ */
+#define RENDER_GEOMETRY_MAX_ENTRIES 32
+#define RENDER_GEOMETRY_MAX_RUNS 512
+#define RENDER_GEOMETRY_MAX_VERTEXES 16384
+
+typedef struct RenderGeometryRun
+{
+	Texture *tex;
+	v4 color;
+	i32 zDepth;
+	enum RenderMode mode;
+	RenderFlags flags;
+
+	i32 firstVertex;
+	i32 numVertexes;
+} RenderGeometryRun;
+
+typedef struct RenderGeometryEntry
+{
+	u32 key;
+	u64 contentHash;
+
+	// NOTE(doyle): False while unused or if the recording ran out of room
+	b32 valid;
+	u32 frameLastUsed;
+
+	i32 firstRun;
+	i32 numRuns;
+	i32 numVertexes;
+} RenderGeometryEntry;
+
+typedef struct RenderGeometryCache
+{
+	RenderGeometryEntry entries[RENDER_GEOMETRY_MAX_ENTRIES];
+	RenderGeometryEntry *recording;
+	u32 frame;
+
+	RenderGeometryRun *runs;
+	i32 numRuns;
+	RenderVertex *vertexes;
+	i32 numVertexes;
+
+	// NOTE(doyle): Of the frame being built
+	i32 numVertexesRegenerated;
+	i32 numVertexesReused;
+} RenderGeometryCache;
+
+/*
+   NOTE(doyle): Glyph quads of recently drawn strings, laid out from the pen
+   origin as one triangle strip with the degenerate vertexes between glyphs
+   already in place. Drawing a cached string offsets the strip to its position
+   and adds it to a render group as one batch. The least recently used layout
+   is replaced on a miss.
+
+   Only unrotated strings shorter than RENDER_TEXT_MAX_CHARS are cached, the
+   rest are laid out every draw.
+ */
+#define RENDER_TEXT_CACHE_SIZE 128
+#define RENDER_TEXT_MAX_CHARS 64
+#define RENDER_TEXT_MAX_VERTEXES ((RENDER_TEXT_MAX_CHARS * 6) - 2)
+
+typedef struct RenderTextLayout
+{
+	// NOTE(doyle): The metrics are compared as well, a font that was still
+	// loading when the string was laid out keeps its pointer once it loads
+	const Font *font;
+	const CharMetrics *charMetrics;
+	u64 hash;
+	i32 strLen;
+	char string[RENDER_TEXT_MAX_CHARS];
+
+	b32 valid;
+	u32 lastUsed;
+
+	v2 dim;
+	RenderVertex *vertexes;
+	i32 numVertexes;
+} RenderTextLayout;
+
+typedef struct RenderTextCache
+{
+	RenderTextLayout layouts[RENDER_TEXT_CACHE_SIZE];
+	u32 useCounter;
+
+	// NOTE(doyle): Of the frame being built, and the hit rate of the last
+	i32 numLookups;
+	i32 numHits;
+	f32 hitRate;
+} RenderTextCache;
+
 enum VertexBatchState {
 	vertexbatchstate_off,
 	vertexbatchstate_initial_add,
@@ -92,6 +193,12 @@ typedef struct Renderer
 	RenderGroup groups[128];
 	i32 groupsInUse;
 	i32 groupCapacity;
+
+	// NOTE(doyle): Bound textures are marked used for the residency budget
+	AssetManager *assetManager;
+
+	RenderGeometryCache geometryCache;
+	RenderTextCache textCache;
 } Renderer;
 
 void renderer_updateSize(Renderer *renderer, AssetManager *assetManager, v2 windowSize);
@@ -100,6 +207,26 @@ void renderer_init(Renderer *renderer, AssetManager *assetManager,
 
 RenderTex renderer_createNullRenderTex(AssetManager *const assetManager);
 
+/*
+   NOTE(doyle): Returns TRUE if the geometry of key was replayed, otherwise the
+   caller draws it and everything drawn until renderer_geometryEnd is
+   recorded. Only for fixed camera drawing, i.e. the HUD and menus.
+
+   if (!renderer_geometryBegin(renderer, key, hash))
+   {
+       renderer_stringFixed(...);
+   }
+   renderer_geometryEnd(renderer);
+ */
+b32 renderer_geometryBegin(Renderer *const renderer, const u32 key,
+                           const u64 contentHash);
+void renderer_geometryEnd(Renderer *const renderer);
+
+// NOTE(doyle): Covers the id's region of its texture, which for sprites packed
+// into a sheet is the whole sheet texture so they share a render group
+RenderTex renderer_createRenderTex(AssetManager *const assetManager,
+                                   const enum TexList type);
+
 // TODO(doyle): Rectangles with gradient alphas/gradient colours
 void renderer_rect(Renderer *const renderer, Rect camera, v2 pos, v2 size,
                    v2 pivotPoint, Radians rotate, RenderTex *renderTex,
@@ -165,6 +292,10 @@ void renderer_string(Renderer *const renderer, MemoryArena_ *arena, Rect camera,
                      v2 pivotPoint, Radians rotate, v4 color, i32 zDepth,
                      RenderFlags flags);
 
+// NOTE(doyle): Same as asset_fontStringDimInPixels, from the text cache
+v2 renderer_stringDim(Renderer *const renderer, Font *const font,
+                      const char *const string);
+
 inline void renderer_stringFixed(Renderer *const renderer, MemoryArena_ *arena,
                                  Font *const font, const char *const string,
                                  v2 pos, v2 pivotPoint, Radians rotate,
@@ -184,7 +315,7 @@ inline void renderer_stringFixedCentered(Renderer *const renderer,
 {
 	Rect staticCamera = {V2(0, 0), renderer->size};
 
-	v2 dim     = asset_fontStringDimInPixels(font, string);
+	v2 dim     = renderer_stringDim(renderer, font, string);
 	v2 halfDim = v2_scale(dim, 0.5f);
 	pos        = v2_sub(pos, halfDim);
 
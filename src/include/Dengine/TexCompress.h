@@ -0,0 +1,92 @@
+#ifndef DENGINE_TEX_COMPRESS_H
+#define DENGINE_TEX_COMPRESS_H
+
+#include "Dengine/Common.h"
+
+/* Forward Declaration */
+typedef struct MemoryArena MemoryArena_;
+
+/*
+   NOTE(doyle): CPU side of the texture pipeline, no GL. Mip chains and block
+   compression are done offline by tools/AssetPacker.c, the engine uploads the
+   blocks as is, or decodes them when the driver lacks the format.
+
+   Texture file layout, stored in the asset pack under the image's path
+   TexFileHeader
+   Mip levels, largest first, each at its offset from the start of the file
+
+   Blocks are 4x4 texels, levels not a multiple of 4 are padded by repeating
+   their edge texels. Rows are stored bottom row first, the order GL expects
+   and the same flip applied to images the engine loads.
+ */
+#define TEX_FILE_MAGIC 0x58455444 // "DTEX"
+#define TEX_FILE_VERSION 1
+#define TEX_MAX_MIPS 16
+
+enum TexFormat
+{
+	texformat_rgba8,
+	texformat_bc1, // RGB, 1 bit alpha, 8 bytes per block
+	texformat_bc3, // RGBA, interpolated alpha, 16 bytes per block
+	texformat_bc7, // RGBA, mode 6 only, 16 bytes per block
+	texformat_count,
+};
+
+enum TexMipFilter
+{
+	texmipfilter_box,
+	texmipfilter_kaiser,
+	texmipfilter_count,
+};
+
+typedef struct TexFileHeader
+{
+	u32 magic;
+	u32 version;
+	u32 format;
+	u32 width;
+	u32 height;
+	u32 numMips;
+	u32 mipOffset[TEX_MAX_MIPS];
+	u32 mipSize[TEX_MAX_MIPS];
+} TexFileHeader;
+
+// NOTE(doyle): Number of levels down to and including 1x1
+i32 texcompress_getNumMips(const i32 width, const i32 height);
+i32 texcompress_getMipDim(const i32 dim, const i32 level);
+
+// NOTE(doyle): Bytes of one level of the given size in the format
+i32 texcompress_getSize(const enum TexFormat format, const i32 width,
+                        const i32 height);
+
+/*
+   NOTE(doyle): Halve an RGBA8 image, dest is the size of the next mip level.
+   Colour is weighted by alpha so transparent texels do not darken the edges
+   of sprites. Kaiser is a windowed sinc, sharper than the box but wider.
+ */
+void texcompress_mipDownsample(MemoryArena_ *const arena,
+                               const u8 *const src, const i32 srcWidth,
+                               const i32 srcHeight, u8 *const dest,
+                               const enum TexMipFilter filter);
+
+void texcompress_encode(const enum TexFormat format, const u8 *const rgba,
+                        const i32 width, const i32 height, u8 *const dest);
+void texcompress_decode(const enum TexFormat format, const u8 *const src,
+                        const i32 width, const i32 height, u8 *const rgba);
+
+/*
+   NOTE(doyle): Build a texture file with the full mip chain from an RGBA8
+   image. Returns NULL if the arena is too small
+ */
+u8 *texcompress_buildFile(MemoryArena_ *const arena, const u8 *const rgba,
+                          const i32 width, const i32 height,
+                          const enum TexFormat format,
+                          const enum TexMipFilter filter, i32 *const fileSize);
+
+// NOTE(doyle): Returns NULL if the buffer is not a valid texture file
+const TexFileHeader *texcompress_getFileHeader(const void *const buffer,
+                                               const i32 size);
+
+void texcompress_unitTest(MemoryArena_ *const arena);
+
+#endif
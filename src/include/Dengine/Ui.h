@@ -21,26 +21,59 @@ enum UiType
 	uitype_count,
 };
 
-typedef struct UiItem
+/*
+   NOTE(doyle): Widgets are drawn immediate mode, but the state each one needs
+   across frames is kept in a table keyed by its id. Labels are measured and
+   laid out once and only again when the label, font or rect change.
+
+   The table is open addressed with robin hood probing like the asset tables,
+   doubling once it passes UI_WIDGET_MAX_LOAD_PERCENT. Widgets not drawn for
+   UI_WIDGET_EVICT_FRAMES frames are dropped.
+ */
+#define UI_WIDGET_TABLE_MIN_SIZE 256
+#define UI_WIDGET_MAX_LOAD_PERCENT 75
+#define UI_WIDGET_EVICT_FRAMES 128
+
+typedef struct UiWidget
 {
 	i32 id;
-	char label[64];
+	b32 inUse;
 	enum UiType type;
+	u32 frameLastSeen;
 
+	// NOTE(doyle): Number of slots this widget is from its ideal slot
+	i32 probeDist;
+
+	/* Label layout, valid for this rect, font and label */
 	Rect rect;
+	const Font *font;
+	u32 labelHash;
+	i32 labelLen;
+	v2 labelDim;
+	v2 labelOffset;
+} UiWidget;
 
-	// TODO(doyle): ECS this? Not all elements need
-	i32 value;
-	i32 maxValue;
-	char string[80];
-} UiItem;
+typedef struct UiWidgetTable
+{
+	UiWidget *widgets;
+	i32 size;
+	i32 count;
+} UiWidgetTable;
 
 typedef struct UiState
 {
 	i32 uniqueId;
 
-	UiItem uiList[128];
-	i32 numItems;
+	UiWidgetTable widgetTable;
+	u32 frame;
+
+	// NOTE(doyle): Stands in for a widget when the table can not grow, it is
+	// laid out again every time it is used
+	UiWidget scratchWidget;
+
+	// NOTE(doyle): Labels laid out this frame and the ones reused
+	i32 numLabelMeasures;
+	i32 numLabelCached;
 
 	i32 hotItem;
 	i32 activeItem;
@@ -61,6 +94,9 @@ inline i32 ui_generateId(UiState *const uiState)
 void ui_beginState(UiState *state);
 void ui_endState(UiState *state, InputBuffer *input);
 
+// NOTE(doyle): Lay out every label again, i.e. fonts were reloaded in place
+void ui_invalidateLayout(UiState *const uiState);
+
 i32 ui_button(UiState *const uiState, MemoryArena_ *const arena,
               AssetManager *const assetManager, Renderer *const renderer,
               Font *const font, const InputBuffer input, const i32 id,
@@ -75,4 +111,6 @@ i32 ui_scrollbar(UiState *const uiState, AssetManager *const assetManager,
                  Renderer *const renderer, const InputBuffer input,
                  const i32 id, const Rect scrollBarRect, i32 *const value,
                  const i32 maxValue, i32 zDepth);
+
+void ui_unitTest();
 #endif
@@ -0,0 +1,349 @@
+/*
+   NOTE(doyle): Offline tool that packs the data directory into a single
+   binary asset pack (see Dengine/AssetPack.h) for the engine to memory map.
+
+   Usage: AssetPacker [dataDirectory] [outputPath] [auto|bc7|png]
+   Defaults to "data" and ASSET_PACK_DEFAULT_PATH, run from the directory the
+   engine runs from so entry names match the paths the game loads.
+
+   Images are stored as texture files (see Dengine/TexCompress.h) under their
+   original path with a full mip chain. auto picks BC1 for opaque and cut out
+   images and BC3 otherwise, bc7 uses BC7 for all and png keeps the images.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <STB/stb_image.h>
+
+#include "Dengine/AssetPack.h"
+#include "Dengine/Common.h"
+#include "Dengine/MemoryArena.h"
+#include "Dengine/TexCompress.h"
+
+enum TexMode
+{
+	texmode_auto,
+	texmode_bc7,
+	texmode_png,
+};
+
+typedef struct PackFile
+{
+	char path[256];
+	enum AssetPackType type;
+	u64 hash;
+
+	u8 *data;
+	u32 size;
+} PackFile;
+
+typedef struct PackFileList
+{
+	PackFile *files;
+	i32 count;
+	i32 capacity;
+} PackFileList;
+
+INTERNAL b32 stringEndsWith(const char *const string, const char *const end)
+{
+	i32 stringLen = common_strlen(string);
+	i32 endLen    = common_strlen(end);
+	if (endLen > stringLen) return FALSE;
+
+	b32 result = (strcmp(string + (stringLen - endLen), end) == 0);
+	return result;
+}
+
+INTERNAL enum AssetPackType getPackType(const char *const path)
+{
+	if (strstr(path, "font_cache_") && stringEndsWith(path, ".bin"))
+		return assetpacktype_fontCache;
+	if (stringEndsWith(path, ".glsl")) return assetpacktype_shader;
+	if (stringEndsWith(path, ".ogg")) return assetpacktype_audio;
+	if (stringEndsWith(path, ".ttf")) return assetpacktype_font;
+	if (stringEndsWith(path, ".png")) return assetpacktype_texture;
+
+	// NOTE(doyle): Atlas and animation xml is not packed, nothing the game
+	// loads reads it yet. Bake it to a binary format once something does,
+	// rather than parsing text out of the pack.
+	return assetpacktype_unknown;
+}
+
+/*
+   Convert an image to a texture file, returns NULL to keep the image as is.
+   The result is heap allocated, the arena is scratch for the mip chain.
+ */
+INTERNAL u8 *convertImage(MemoryArena_ *const arena, const enum TexMode mode,
+                          const char *const path, const u8 *const data,
+                          const i32 size, u32 *const convertedSize)
+{
+	if (mode == texmode_png) return NULL;
+
+	i32 width, height, channels;
+	stbi_set_flip_vertically_on_load(TRUE);
+	u8 *rgba = stbi_load_from_memory(data, size, &width, &height, &channels, 4);
+	if (!rgba)
+	{
+		printf("stbi_load_from_memory() failed: %s\n", path);
+		return NULL;
+	}
+
+	/* Alpha that is only on or off fits in BC1's punch through alpha */
+	b32 binaryAlpha = TRUE;
+	for (i32 i = 0; i < width * height && binaryAlpha; i++)
+	{
+		u8 alpha    = rgba[(i * 4) + 3];
+		binaryAlpha = (alpha == 0 || alpha == 255);
+	}
+
+	enum TexFormat format = texformat_bc7;
+	if (mode == texmode_auto)
+		format = (binaryAlpha) ? texformat_bc1 : texformat_bc3;
+
+	memory_arenaInit(arena, arena->base, arena->size);
+	i32 fileSize = 0;
+	u8 *file = texcompress_buildFile(arena, rgba, width, height, format,
+	                                 texmipfilter_kaiser, &fileSize);
+	stbi_image_free(rgba);
+
+	if (!file)
+	{
+		printf("texcompress_buildFile() failed: %s is too large\n", path);
+		return NULL;
+	}
+
+	u8 *result = CAST(u8 *) malloc(fileSize);
+	memcpy(result, file, fileSize);
+	*convertedSize = CAST(u32) fileSize;
+	return result;
+}
+
+INTERNAL void addFile(PackFileList *const list, MemoryArena_ *const arena,
+                      const enum TexMode mode, const char *const path,
+                      const char *const outputPath)
+{
+	enum AssetPackType type = getPackType(path);
+	if (type == assetpacktype_unknown || strcmp(path, outputPath) == 0)
+	{
+		printf("Skipping: %s\n", path);
+		return;
+	}
+
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		printf("fopen() failed: %s\n", path);
+		return;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	u8 *data = CAST(u8 *) malloc(size);
+	if (!data || fread(data, 1, size, file) != CAST(size_t) size)
+	{
+		printf("fread() failed: %s\n", path);
+		free(data);
+		fclose(file);
+		return;
+	}
+	fclose(file);
+
+	if (type == assetpacktype_texture)
+	{
+		u32 convertedSize = 0;
+		u8 *converted =
+		    convertImage(arena, mode, path, data, size, &convertedSize);
+		if (converted)
+		{
+			free(data);
+			data = converted;
+			size = convertedSize;
+		}
+	}
+
+	if (list->count == list->capacity)
+	{
+		list->capacity = (list->capacity == 0) ? 64 : list->capacity * 2;
+		list->files    = CAST(PackFile *) realloc(
+		    list->files, list->capacity * sizeof(PackFile));
+	}
+
+	PackFile *packFile = &list->files[list->count++];
+	memset(packFile, 0, sizeof(PackFile));
+	strncpy(packFile->path, path, ARRAY_COUNT(packFile->path) - 1);
+	packFile->type = type;
+	packFile->hash = common_murmurHash64A(path, common_strlen(path), RANDOM_SEED);
+	packFile->data = data;
+	packFile->size = CAST(u32) size;
+}
+
+INTERNAL void addDirectory(PackFileList *const list,
+                           MemoryArena_ *const arena, const enum TexMode mode,
+                           const char *const directory,
+                           const char *const outputPath)
+{
+	char path[256] = {0};
+
+#ifdef _WIN32
+	char search[256] = {0};
+	snprintf(search, ARRAY_COUNT(search), "%s/*", directory);
+
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA(search, &findData);
+	if (findHandle == INVALID_HANDLE_VALUE) return;
+
+	do
+	{
+		char *name = findData.cFileName;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		snprintf(path, ARRAY_COUNT(path), "%s/%s", directory, name);
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			addDirectory(list, arena, mode, path, outputPath);
+		else
+			addFile(list, arena, mode, path, outputPath);
+	} while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+#else
+	DIR *dir = opendir(directory);
+	if (!dir) return;
+
+	struct dirent *dirEntry;
+	while ((dirEntry = readdir(dir)))
+	{
+		char *name = dirEntry->d_name;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		snprintf(path, ARRAY_COUNT(path), "%s/%s", directory, name);
+
+		struct stat fileStat;
+		if (stat(path, &fileStat) != 0) continue;
+
+		if (S_ISDIR(fileStat.st_mode))
+			addDirectory(list, arena, mode, path, outputPath);
+		else
+			addFile(list, arena, mode, path, outputPath);
+	}
+
+	closedir(dir);
+#endif
+}
+
+INTERNAL int comparePackFileHash(const void *a, const void *b)
+{
+	const PackFile *fileA = CAST(const PackFile *) a;
+	const PackFile *fileB = CAST(const PackFile *) b;
+
+	if (fileA->hash < fileB->hash) return -1;
+	if (fileA->hash > fileB->hash) return 1;
+	return strcmp(fileA->path, fileB->path);
+}
+
+INTERNAL u32 alignOffset(u32 offset, u32 alignment)
+{
+	u32 result = (offset + (alignment - 1)) & ~(alignment - 1);
+	return result;
+}
+
+int main(int argc, char **argv)
+{
+	const char *dataDirectory = (argc > 1) ? argv[1] : "data";
+	const char *outputPath    = (argc > 2) ? argv[2] : ASSET_PACK_DEFAULT_PATH;
+
+	const char *texModeArg    = (argc > 3) ? argv[3] : "auto";
+
+	enum TexMode texMode = texmode_auto;
+	if (strcmp(texModeArg, "bc7") == 0) texMode = texmode_bc7;
+	else if (strcmp(texModeArg, "png") == 0) texMode = texmode_png;
+
+	// NOTE(doyle): Scratch for the mip chains, enough for 2048x2048 images
+	MemoryArena_ arena = {0};
+	size_t arenaSize   = MEGABYTES(256);
+	memory_arenaInit(&arena, malloc(arenaSize), arenaSize);
+
+	PackFileList list = {0};
+	addDirectory(&list, &arena, texMode, dataDirectory, outputPath);
+	qsort(list.files, list.count, sizeof(PackFile), comparePackFileHash);
+
+	/*
+	 *********************************
+	 * Layout the pack
+	 *********************************
+	 */
+	AssetPackHeader header = {0};
+	header.magic           = ASSET_PACK_MAGIC;
+	header.version         = ASSET_PACK_VERSION;
+	header.numEntries      = list.count;
+	header.entryOffset     = sizeof(AssetPackHeader);
+	header.nameOffset =
+	    header.entryOffset + (list.count * sizeof(AssetPackEntry));
+
+	AssetPackEntry *entries =
+	    CAST(AssetPackEntry *) calloc(list.count + 1, sizeof(AssetPackEntry));
+
+	u32 offset = header.nameOffset;
+	for (i32 i = 0; i < list.count; i++)
+	{
+		entries[i].hash       = list.files[i].hash;
+		entries[i].type       = list.files[i].type;
+		entries[i].nameOffset = offset;
+		entries[i].nameLen    = common_strlen(list.files[i].path);
+		offset += entries[i].nameLen + 1;
+	}
+
+	header.dataOffset = alignOffset(offset, ASSET_PACK_ALIGNMENT);
+	offset            = header.dataOffset;
+	for (i32 i = 0; i < list.count; i++)
+	{
+		// NOTE(doyle): +1 for the null terminator after every blob
+		entries[i].dataOffset = offset;
+		entries[i].dataSize   = list.files[i].size;
+		offset = alignOffset(offset + list.files[i].size + 1,
+		                     ASSET_PACK_ALIGNMENT);
+	}
+	header.packSize = offset;
+
+	/*
+	 *********************************
+	 * Write the pack
+	 *********************************
+	 */
+	u8 *pack = CAST(u8 *) calloc(1, header.packSize);
+	memcpy(pack, &header, sizeof(AssetPackHeader));
+	memcpy(pack + header.entryOffset, entries,
+	       list.count * sizeof(AssetPackEntry));
+
+	for (i32 i = 0; i < list.count; i++)
+	{
+		PackFile *file = &list.files[i];
+		memcpy(pack + entries[i].nameOffset, file->path, entries[i].nameLen);
+		memcpy(pack + entries[i].dataOffset, file->data, file->size);
+		printf("Packed: %-48s %8u bytes\n", file->path, file->size);
+	}
+
+	FILE *outFile = fopen(outputPath, "wb");
+	if (!outFile ||
+	    fwrite(pack, 1, header.packSize, outFile) != header.packSize)
+	{
+		printf("AssetPacker failed: Could not write %s\n", outputPath);
+		return -1;
+	}
+	fclose(outFile);
+
+	printf("AssetPacker: %d assets, %u bytes written to %s\n", list.count,
+	       header.packSize, outputPath);
+	return 0;
+}
@@ -0,0 +1,408 @@
+/*
+   NOTE(doyle): Offline tool that packs loose sprites into power of two sprite
+   sheets, so sprites drawn together share one texture and one render group.
+
+   Usage: AtlasBuilder inputDirectory outputPath [maxSheetSize]
+   Every .png under inputDirectory is packed into sheets written to
+   outputPath_0.png, outputPath_1.png, ... with outputPath.xml describing them
+   in the TextureAtlas/SubTexture format. Sub textures are named by the sprite
+   path, so run from the directory the engine runs from and the names match
+   the paths the game loads. asset_sheetLoad then remaps loads of those paths
+   to the sheet regions.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <STB/stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <STB/stb_image_write.h>
+
+#include "Dengine/Common.h"
+#include "Dengine/MemoryArena.h"
+#include "Dengine/RectPack.h"
+
+#define ATLAS_DEFAULT_MAX_SIZE 2048
+#define ATLAS_MIN_SIZE 64
+#define ATLAS_MAX_SHEETS 64
+
+// NOTE(doyle): Sprite edges are repeated into a border of this many pixels so
+// filtering at the edge of a region never samples the neighbouring sprite
+#define ATLAS_EXTRUDE 1
+#define ATLAS_BORDER (ATLAS_EXTRUDE * 2)
+
+typedef struct Sprite
+{
+	char path[256];
+	u8 *pixels;
+	i32 width;
+	i32 height;
+
+	i32 sheet;
+	i32 x;
+	i32 y;
+} Sprite;
+
+typedef struct SpriteList
+{
+	Sprite *sprites;
+	i32 count;
+	i32 capacity;
+} SpriteList;
+
+INTERNAL b32 stringEndsWith(const char *const string, const char *const end)
+{
+	i32 stringLen = common_strlen(string);
+	i32 endLen    = common_strlen(end);
+	if (endLen > stringLen) return FALSE;
+
+	b32 result = (strcmp(string + (stringLen - endLen), end) == 0);
+	return result;
+}
+
+INTERNAL void addSprite(SpriteList *const list, const char *const path)
+{
+	if (!stringEndsWith(path, ".png")) return;
+
+	// NOTE(doyle): Sheets are written top row first, the engine flips them on
+	// load the same as any other image
+	i32 width, height, bytesPerPixel;
+	u8 *pixels = stbi_load(path, &width, &height, &bytesPerPixel, 4);
+	if (!pixels)
+	{
+		printf("stbi_load() failed: %s\n", path);
+		return;
+	}
+
+	if (list->count == list->capacity)
+	{
+		list->capacity = (list->capacity == 0) ? 64 : list->capacity * 2;
+		list->sprites  = CAST(Sprite *) realloc(
+		    list->sprites, list->capacity * sizeof(Sprite));
+	}
+
+	Sprite *sprite = &list->sprites[list->count++];
+	memset(sprite, 0, sizeof(Sprite));
+	strncpy(sprite->path, path, ARRAY_COUNT(sprite->path) - 1);
+	sprite->pixels = pixels;
+	sprite->width  = width;
+	sprite->height = height;
+	sprite->sheet  = -1;
+}
+
+INTERNAL void addDirectory(SpriteList *const list, const char *const directory)
+{
+	char path[256] = {0};
+
+#ifdef _WIN32
+	char search[256] = {0};
+	snprintf(search, ARRAY_COUNT(search), "%s/*", directory);
+
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA(search, &findData);
+	if (findHandle == INVALID_HANDLE_VALUE) return;
+
+	do
+	{
+		char *name = findData.cFileName;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		snprintf(path, ARRAY_COUNT(path), "%s/%s", directory, name);
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			addDirectory(list, path);
+		else
+			addSprite(list, path);
+	} while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+#else
+	DIR *dir = opendir(directory);
+	if (!dir) return;
+
+	struct dirent *dirEntry;
+	while ((dirEntry = readdir(dir)))
+	{
+		char *name = dirEntry->d_name;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		snprintf(path, ARRAY_COUNT(path), "%s/%s", directory, name);
+
+		struct stat fileStat;
+		if (stat(path, &fileStat) != 0) continue;
+
+		if (S_ISDIR(fileStat.st_mode))
+			addDirectory(list, path);
+		else
+			addSprite(list, path);
+	}
+
+	closedir(dir);
+#endif
+}
+
+/* Largest side first, MaxRects does best placing the big rects early */
+INTERNAL int compareSpriteSize(const void *a, const void *b)
+{
+	const Sprite *spriteA = CAST(const Sprite *) a;
+	const Sprite *spriteB = CAST(const Sprite *) b;
+
+	i32 sideA = MAX(spriteA->width, spriteA->height);
+	i32 sideB = MAX(spriteB->width, spriteB->height);
+	if (sideA != sideB) return sideB - sideA;
+
+	i32 areaA = spriteA->width * spriteA->height;
+	i32 areaB = spriteB->width * spriteB->height;
+	if (areaA != areaB) return areaB - areaA;
+
+	return strcmp(spriteA->path, spriteB->path);
+}
+
+/*
+   Pack the unplaced sprites into a width x height sheet, returns the number
+   placed. Placements are only kept if commit is set.
+ */
+INTERNAL i32 packSheet(MemoryArena_ *const arena, SpriteList *const list,
+                       const i32 sheet, const i32 width, const i32 height,
+                       const b32 commit)
+{
+	memory_arenaInit(arena, arena->base, arena->size);
+
+	RectPackMax pack = {0};
+	rectpack_maxInit(&pack, arena, width, height, list->count * 4 + 64);
+
+	i32 result = 0;
+	for (i32 i = 0; i < list->count; i++)
+	{
+		Sprite *sprite = &list->sprites[i];
+		if (sprite->sheet != -1) continue;
+
+		v2 pos = {0};
+		if (!rectpack_maxInsert(&pack, sprite->width + ATLAS_BORDER,
+		                        sprite->height + ATLAS_BORDER, &pos))
+			continue;
+
+		result++;
+		if (commit)
+		{
+			sprite->sheet = sheet;
+			sprite->x     = CAST(i32) pos.x + ATLAS_EXTRUDE;
+			sprite->y     = CAST(i32) pos.y + ATLAS_EXTRUDE;
+		}
+	}
+
+	return result;
+}
+
+INTERNAL void blitSprite(u8 *const sheetPixels, const i32 sheetWidth,
+                         const Sprite *const sprite)
+{
+	// NOTE(doyle): Source coordinates are clamped so the border repeats the
+	// sprite's edge pixels
+	for (i32 y = -ATLAS_EXTRUDE; y < sprite->height + ATLAS_EXTRUDE; y++)
+	{
+		i32 srcY = MIN(MAX(y, 0), sprite->height - 1);
+		for (i32 x = -ATLAS_EXTRUDE; x < sprite->width + ATLAS_EXTRUDE; x++)
+		{
+			i32 srcX  = MIN(MAX(x, 0), sprite->width - 1);
+			u32 *src  = CAST(u32 *) sprite->pixels + srcX +
+			           (srcY * sprite->width);
+			u32 *dest = CAST(u32 *) sheetPixels + (sprite->x + x) +
+			            ((sprite->y + y) * sheetWidth);
+			*dest = *src;
+		}
+	}
+}
+
+INTERNAL const char *getFileName(const char *const path)
+{
+	const char *result = path;
+	for (const char *c = path; *c; c++)
+	{
+		if (*c == '/' || *c == '\\') result = c + 1;
+	}
+
+	return result;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		printf("Usage: AtlasBuilder inputDirectory outputPath "
+		       "[maxSheetSize]\n");
+		return -1;
+	}
+
+	const char *inputDirectory = argv[1];
+	const char *outputPath     = argv[2];
+	i32 maxSize = (argc > 3) ? atoi(argv[3]) : ATLAS_DEFAULT_MAX_SIZE;
+	if (maxSize < ATLAS_MIN_SIZE || (maxSize & (maxSize - 1)) != 0)
+	{
+		printf("AtlasBuilder failed: maxSheetSize must be a power of two of "
+		       "at least %d\n", ATLAS_MIN_SIZE);
+		return -1;
+	}
+
+	SpriteList list = {0};
+	addDirectory(&list, inputDirectory);
+	if (list.count == 0)
+	{
+		printf("AtlasBuilder failed: No .png files in %s\n", inputDirectory);
+		return -1;
+	}
+	qsort(list.sprites, list.count, sizeof(Sprite), compareSpriteSize);
+
+	MemoryArena_ arena = {0};
+	size_t arenaSize   = MEGABYTES(16);
+	memory_arenaInit(&arena, malloc(arenaSize), arenaSize);
+
+	/* Sprites too big for any sheet are left out */
+	i32 numToPlace = 0;
+	i32 numPacked  = 0;
+	for (i32 i = 0; i < list.count; i++)
+	{
+		Sprite *sprite = &list.sprites[i];
+		if (sprite->width + ATLAS_BORDER > maxSize ||
+		    sprite->height + ATLAS_BORDER > maxSize)
+		{
+			printf("Skipping: %s is larger than a %dx%d sheet\n",
+			       sprite->path, maxSize, maxSize);
+			sprite->sheet = -2;
+			continue;
+		}
+		numToPlace++;
+	}
+	numPacked = numToPlace;
+
+	/*
+	 *********************************
+	 * Pack the sheets
+	 *********************************
+	 */
+	/*
+	   NOTE(doyle): Each sheet starts at the smallest power of two that could
+	   hold what is left and doubles its short side until everything fits. If
+	   a full size sheet cannot hold the rest, it takes what fits and the
+	   remainder goes to the next sheet.
+	 */
+	v2 sheetSize[ATLAS_MAX_SHEETS];
+	i32 numSheets = 0;
+	while (numToPlace > 0 && numSheets < ATLAS_MAX_SHEETS)
+	{
+		i32 areaLeft = 0;
+		for (i32 i = 0; i < list.count; i++)
+		{
+			Sprite *sprite = &list.sprites[i];
+			if (sprite->sheet != -1) continue;
+			areaLeft += (sprite->width + ATLAS_BORDER) *
+			            (sprite->height + ATLAS_BORDER);
+		}
+
+		i32 width  = ATLAS_MIN_SIZE;
+		i32 height = ATLAS_MIN_SIZE;
+		while (width * height < areaLeft &&
+		       (width < maxSize || height < maxSize))
+		{
+			if (width <= height) width *= 2;
+			else height *= 2;
+		}
+
+		for (;;)
+		{
+			i32 numPlaced = packSheet(&arena, &list, numSheets, width, height,
+			                          FALSE);
+			b32 atMaxSize = (width == maxSize && height == maxSize);
+			if (numPlaced == numToPlace || atMaxSize)
+			{
+				packSheet(&arena, &list, numSheets, width, height, TRUE);
+				numToPlace -= numPlaced;
+				break;
+			}
+
+			if (width <= height) width *= 2;
+			else height *= 2;
+		}
+
+		sheetSize[numSheets++] = V2i(width, height);
+	}
+
+	if (numToPlace > 0)
+	{
+		printf("AtlasBuilder failed: Sprites need more than %d sheets\n",
+		       ATLAS_MAX_SHEETS);
+		return -1;
+	}
+
+	/*
+	 *********************************
+	 * Write the sheets and xml
+	 *********************************
+	 */
+	char path[256] = {0};
+	snprintf(path, ARRAY_COUNT(path), "%s.xml", outputPath);
+	FILE *xmlFile = fopen(path, "wb");
+	if (!xmlFile)
+	{
+		printf("AtlasBuilder failed: Could not write %s\n", path);
+		return -1;
+	}
+
+	fprintf(xmlFile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	fprintf(xmlFile, "<!-- Generated by AtlasBuilder from %s -->\n",
+	        inputDirectory);
+
+	for (i32 sheet = 0; sheet < numSheets; sheet++)
+	{
+		i32 width  = CAST(i32) sheetSize[sheet].w;
+		i32 height = CAST(i32) sheetSize[sheet].h;
+		u8 *pixels = CAST(u8 *) calloc(width * height, 4);
+
+		snprintf(path, ARRAY_COUNT(path), "%s_%d.png", outputPath, sheet);
+		fprintf(xmlFile, "<TextureAtlas imagePath=\"%s\">\n",
+		        getFileName(path));
+
+		i32 numSprites = 0;
+		i32 usedArea   = 0;
+		for (i32 i = 0; i < list.count; i++)
+		{
+			Sprite *sprite = &list.sprites[i];
+			if (sprite->sheet != sheet) continue;
+
+			blitSprite(pixels, width, sprite);
+			fprintf(xmlFile,
+			        "\t<SubTexture name=\"%s\" x=\"%d\" y=\"%d\" "
+			        "width=\"%d\" height=\"%d\"/>\n",
+			        sprite->path, sprite->x, sprite->y, sprite->width,
+			        sprite->height);
+
+			numSprites++;
+			usedArea += sprite->width * sprite->height;
+		}
+		fprintf(xmlFile, "</TextureAtlas>\n");
+
+		if (!stbi_write_png(path, width, height, 4, pixels, width * 4))
+		{
+			printf("AtlasBuilder failed: Could not write %s\n", path);
+			return -1;
+		}
+		free(pixels);
+
+		printf("Sheet: %-40s %4dx%-4d %4d sprites %5.1f%% used\n", path,
+		       width, height, numSprites,
+		       (usedArea * 100.0f) / (width * height));
+	}
+	fclose(xmlFile);
+
+	printf("AtlasBuilder: %d sprites packed into %d sheets, %s.xml written\n",
+	       numPacked, numSheets, outputPath);
+	return 0;
+}